@@ -65,8 +65,8 @@ public:
 	~radTApplication() {}
 
 	void Initialize()
-	{
-		GlobalUniqueMapKey = 1;
+	{// Also called after an error or an abort: keys of existing elements must not be reused
+		if(GlobalMapOfHandlers.empty()) GlobalUniqueMapKey = 1;
 		CompCriterium.BasedOnPrecLevel = 0;
 		SendingIsRequired = 1;
 		TreatRecMagsAsExtrPolygons = TreatRecMagsAsPolyhedrons = TreatExtrPgnsAsPolyhedrons = 0;
@@ -195,11 +195,13 @@ public:
 	int MakeManualRelax(int InteractElemKey, int MethNo, int IterNumber, double RelaxParam);
 	int MakeAutoRelax(int InteractElemKey, double PrecOnMagnetiz, int MaxIterNumber, int MethNo, const char** arOptionNames=0, const char** arOptionValues=0, int numOptions=0);
 	int UpdateSourcesForRelax(int InteractElemKey);
+	void InteractMatrixProduct(int InteractElemKey, double* pM, int nM, int Transposed);
 	int SolveGen(int ObjKey, double PrecOnMagnetiz, int MaxIterNumber, int MethNo);
 
 	void ComputeField(int ElemKey, char* FieldChar, double* StObsPoi, long lenStObsPoi, double* FiObsPoi, long lenFiObsPoi, int Np, char* ShowArgFlag, double StrtArg);
 	void ComputeField(int ElemKey, char* FieldChar, radTVectorOfVector3d& VectorOfVector3d, radTVectInputCell& VectInputCell);
 	void ComputeField(int ElemKey, char* FieldChar, double** Points, long LenPoints);
+	bool ComputeFieldBatch(radTg3d* g3dPtr, const radTFieldKey& FieldKey, const TVector3d* Points, long Np, radTField* FieldArray);
 
 	void ComputeFieldInt(int ElemKey, char* IntID, char* FieldIntChar, double* StPoi, long lenStPoi, double* FiPoi, long lenFiPoi);
 	void ComputeFieldForce(int ElemKey, int ShapeElemKey);
@@ -95,7 +95,8 @@ public:
 		J_IsNotZero = 0; InternalFacesAfterCut = 0; ConsiderOnlyWithTrans = 0;
 	}
 
-	int Type_g3d() { return 3;}
+	static const int TypeID_g3d = 3;
+	int Type_g3d() { return TypeID_g3d;}
 
 	void ComputeCentrPoint()
 	{
@@ -133,7 +133,7 @@ void FieldForceThroughEnergy( int, int, char*, int,int,int );
 void FieldTorqueThroughEnergy( int, int, char*, double,double,double, int,int,int );
 void CompCriterium( double, double, double, double, double,double );
 void CompPrecision();
-void CompPrecisionOpt( const char*, const char*, const char*, const char*, const char*, const char*, const char*, const char* );
+void CompPrecisionOpt( const char*, const char*, const char*, const char*, const char*, const char*, const char*, const char*, const char* );
 void MultipoleThresholds(double, double, double, double); // Maybe to be removed later
 void PreRelax( int, int );
 void ShowInteractMatrix(int);
@@ -144,6 +144,7 @@ void ManualRelax( int, int, int, double );
 void AutoRelax();
 void AutoRelaxOpt( int, double, int, int, const char* );
 void UpdateSourcesForRelax( int );
+void InteractMatrixProduct( int, double*, int, int );
 void SolveGen( int, double, int, int );
 void ParticleTrajectory( int, double, double,double,double,double, double,double, int );
 void FocusingPotential( int, double,double,double, double,double,double, int );
@@ -1544,6 +1545,13 @@ void UpdateSourcesForRelax(int InteractElemKey)
 
 //-------------------------------------------------------------------------
 
+void InteractMatrixProduct(int InteractElemKey, double* pM, int nM, int Transposed)
+{
+	rad.InteractMatrixProduct(InteractElemKey, pM, nM, Transposed);
+}
+
+//-------------------------------------------------------------------------
+
 void SolveGen(int ObjKey, double PrecOnMagnetiz, int MaxIterNumber, int MethNo)
 {
 	if(MethNo == 0) MethNo = 4; //Default method
@@ -1567,17 +1575,16 @@ void CompPrecision()
 
 //-------------------------------------------------------------------------
 
-void CompPrecisionOpt(const char* Opt1, const char* Opt2, const char* Opt3, const char* Opt4, const char* Opt5, const char* Opt6, const char* Opt7, const char* Opt8)
-//void CompPrecisionOpt(const char* Opt1, const char* Opt2, const char* Opt3, const char* Opt4, const char* Opt5, const char* Opt6, const char* Opt7, const char* Opt8, const char* Opt9)
+void CompPrecisionOpt(const char* Opt1, const char* Opt2, const char* Opt3, const char* Opt4, const char* Opt5, const char* Opt6, const char* Opt7, const char* Opt8, const char* Opt9)
 {
 	const char* OptionNames[] = {0,0,0,0,0,0,0,0,0};
 	double OptionValues[] = {0,0,0,0,0,0,0,0,0};
 	int OptionCount = 0;
 
-	int MaxAmOfOptions = 8;
-	std::array<char, 200> CharBuf1, CharBuf2, CharBuf3, CharBuf4, CharBuf5, CharBuf6, CharBuf7, CharBuf8;
-	char *TotCharBuf[] = {CharBuf1.data(), CharBuf2.data(), CharBuf3.data(), CharBuf4.data(), CharBuf5.data(), CharBuf6.data(), CharBuf7.data(), CharBuf8.data()};
-	const char *InOpt[] = {Opt1, Opt2,  Opt3, Opt4, Opt5, Opt6, Opt7, Opt8};
+	int MaxAmOfOptions = 9;
+	std::array<char, 200> CharBuf1, CharBuf2, CharBuf3, CharBuf4, CharBuf5, CharBuf6, CharBuf7, CharBuf8, CharBuf9;
+	char *TotCharBuf[] = {CharBuf1.data(), CharBuf2.data(), CharBuf3.data(), CharBuf4.data(), CharBuf5.data(), CharBuf6.data(), CharBuf7.data(), CharBuf8.data(), CharBuf9.data()};
+	const char *InOpt[] = {Opt1, Opt2,  Opt3, Opt4, Opt5, Opt6, Opt7, Opt8, Opt9};
 	for(int i=0; i<MaxAmOfOptions; i++)
 	{
 		if(InOpt[i] != 0) //OC240108
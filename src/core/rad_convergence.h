@@ -4,7 +4,7 @@
 *
 * Project:        RADIA
 *
-* Description:    Randomization
+* Description:    Randomization (deterministic perturbation of lengths)
 *
 * Author(s):      Oleg Chubar, Pascal Elleaume
 *
@@ -20,6 +20,8 @@
 #include <stdlib.h>
 #include <time.h>
 #include <math.h>
+#include <string.h>
+#include <stdint.h>
 
 #include "gmvect.h"
 
@@ -41,8 +43,6 @@ public:
 		AbsRand = 1.E-09;
 		RelRand = 1.E-11;
 		ZeroRand = AbsRand;
-
-		//srand((unsigned)time(nullptr)); // To seed random generator by current time
 	}
 
 	void SwitchActOnDoubles(short InActOnDoubles, double InAbsRand =0., double InRelRand =0., double InZeroRand =0.)
@@ -52,36 +52,49 @@ public:
 		AbsRand = InAbsRand;
 		RelRand = InRelRand;
 		ZeroRand = InZeroRand;
+	}
 
-		srand((unsigned)time(nullptr));
+	static double UnitRand(double A, int Stream)
+	{// Pseudo-random number in [0, 1) hashed from the bits of A (splitmix64 finalizer): the perturbations below are
+	 // stateless, so that field values do not depend on the evaluation history or on the thread computing them
+		uint64_t x;
+		memcpy(&x, &A, sizeof(x));
+		x += 0x9E3779B97F4A7C15ULL*(uint64_t)(Stream + 1);
+		x = (x ^ (x >> 30))*0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27))*0x94D049BB133111EBULL;
+		x ^= (x >> 31);
+		return double(x >> 11)*(1./9007199254740992.);
 	}
 
-	double Double(double A)
+	double Double(double A) const
 	{
 		if(!ActOnDoubles) return A;
-		A += AbsRand*(double(rand())/double(RAND_MAX) - 0.5);
-		A *= (1. + RelRand*(double(rand())/double(RAND_MAX) - 0.5));
-		if(A==0.) A = ZeroRand*(double(rand())/double(RAND_MAX) - 0.5);
+		double A0 = A;
+		A += AbsRand*(UnitRand(A0, 0) - 0.5);
+		A *= (1. + RelRand*(UnitRand(A0, 1) - 0.5));
+		if(A==0.) A = ZeroRand*(UnitRand(A0, 2) - 0.5);
 		return A;
 	}
-	double DoublePlus(double A)
+	double DoublePlus(double A) const
 	{
 		if(!ActOnDoubles) return A;
-		A += AbsRand*(double(rand())/double(RAND_MAX));
-		A *= (1. + RelRand*(double(rand())/double(RAND_MAX)));
-		if(A == 0.) A = ZeroRand*(double(rand())/double(RAND_MAX));
+		double A0 = A;
+		A += AbsRand*UnitRand(A0, 0);
+		A *= (1. + RelRand*UnitRand(A0, 1));
+		if(A == 0.) A = ZeroRand*UnitRand(A0, 2);
 		return A;
 	}
-	double DoubleMinus(double A)
+	double DoubleMinus(double A) const
 	{
 		if(!ActOnDoubles) return A;
-		A -= AbsRand*(double(rand())/double(RAND_MAX));
-		A *= (1. - RelRand*(double(rand())/double(RAND_MAX)));
-		if(A == 0.) A = -ZeroRand*(double(rand())/double(RAND_MAX));
+		double A0 = A;
+		A -= AbsRand*UnitRand(A0, 0);
+		A *= (1. - RelRand*UnitRand(A0, 1));
+		if(A == 0.) A = -ZeroRand*UnitRand(A0, 2);
 		return A;
 	}
 
-	double AbsRandMagnitude(double A)
+	double AbsRandMagnitude(double A) const
 	{
 		if(!ActOnDoubles) return 0.;
 		double AbsFromRel = RelRand*A;
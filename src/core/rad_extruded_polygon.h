@@ -56,7 +56,8 @@ public:
 	}
 	radTExtrPolygon() : radTg3dRelax() {}
 
-	int Type_g3dRelax() { return 2;}
+	static const int TypeID_g3dRelax = 2;
+	int Type_g3dRelax() { return TypeID_g3dRelax;}
 
 	void B_comp(radTField*);
 	void B_intComp(radTField*);
@@ -0,0 +1,422 @@
+/*-------------------------------------------------------------------------
+*
+* File name:      rad_field_batch.cpp
+*
+* Project:        RADIA
+*
+* Description:    Batch field evaluation of homogeneous sets of
+*                 rectangular magnet blocks
+*
+* Author(s):      Radia Development Team
+*
+* First release:  2026
+*
+*------------------------------------------------------------------------*/
+
+#include "rad_field_batch.h"
+#include "rad_type_cast.h"
+#include "rad_group.h"
+#include "rad_rectangular_block.h"
+#include "rad_subdivided_rectangle.h"
+#include "rad_polyhedron.h"
+#include "rad_transform_def.h"
+#include "rad_yield.h"
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+extern radTYield radYield;
+
+//-------------------------------------------------------------------------
+
+bool radTRecMagBatchField::Setup(radTg3d* obj, bool WithOwnTrans)
+{
+	vChains.clear();
+	if(obj == 0) return false;
+
+	std::vector<std::pair<radTrans*, int> > Trans;
+	bool Res;
+	if(WithOwnTrans) Res = Collect(obj, Trans);
+	else
+	{
+		radTlphg OwnTrans;
+		OwnTrans.swap(obj->g3dListOfTransform);
+		Res = Collect(obj, Trans);
+		OwnTrans.swap(obj->g3dListOfTransform);
+	}
+	if(!Res) vChains.clear();
+	return Res && !vChains.empty();
+}
+
+//-------------------------------------------------------------------------
+
+int radTRecMagBatchField::NumBlocks() const
+{
+	int AmOfBlocks = 0;
+	for(size_t k = 0; k < vChains.size(); k++) AmOfBlocks += (int)vChains[k].Blocks.size();
+	return AmOfBlocks;
+}
+
+//-------------------------------------------------------------------------
+
+bool radTRecMagBatchField::Collect(radTg3d* g3dPtr, std::vector<std::pair<radTrans*, int> >& Trans)
+{
+	size_t AmOfOuterTrans = Trans.size();
+	for(radTlphg::iterator Iter = g3dPtr->g3dListOfTransform.begin(); Iter != g3dPtr->g3dListOfTransform.end(); ++Iter)
+		Trans.push_back(std::make_pair((radTrans*)((*Iter).Handler_g.rep), (*Iter).m));
+
+	bool Res = true;
+	radTGroup* GroupPtr = radTCast::GroupCast(g3dPtr);
+	if(GroupPtr != 0)
+	{// Subdivided blocks only if their field is the sum over the sub-blocks (as for subdivided polyhedra, which radTGroup::B_comp evaluates)
+		radTSubdividedRecMag* SubdRecMagPtr = radTCast::SubdividedRecMagCast(GroupPtr);
+		if((SubdRecMagPtr != 0) && (SubdRecMagPtr->FldCmpMeth != 0) && !SubdRecMagPtr->AlgsBasedOnKsQsMayNotWork) Res = false;
+
+		for(radTmhg::iterator Iter = GroupPtr->GroupMapOfHandlers.begin(); Res && (Iter != GroupPtr->GroupMapOfHandlers.end()); ++Iter)
+			Res = Collect((radTg3d*)((*Iter).second.rep), Trans);
+	}
+	else
+	{
+		radTg3dRelax* g3dRelaxPtr = radTCast::g3dRelaxCast(g3dPtr);
+		radTRecMag* RecMagPtr = (g3dRelaxPtr != 0)? radTCast::RecMagCast(g3dRelaxPtr) : 0;
+		if((RecMagPtr == 0) || RecMagPtr->J_IsNotZero || (RecMagPtr->J.x != 0.) || (RecMagPtr->J.y != 0.) || (RecMagPtr->J.z != 0.)) Res = false;
+		else AddImages(RecMagPtr, Trans);
+	}
+	Trans.resize(AmOfOuterTrans);
+	return Res;
+}
+
+//-------------------------------------------------------------------------
+
+void radTRecMagBatchField::AddImages(radTRecMag* RecMagPtr, const std::vector<std::pair<radTrans*, int> >& Trans)
+{// Transformation with multiplicity m > 1: images T^0 ... T^(m-1); m = 1: T (as radTg3d::NestedFor_B)
+	std::vector<int> Power(Trans.size(), 0);
+	for(size_t i = 0; i < Trans.size(); i++) if(Trans[i].second <= 1) Power[i] = 1;
+	std::vector<radTrans*> Chain;
+	for(;;)
+	{
+		Chain.clear();
+		for(size_t i = 0; i < Trans.size(); i++)
+			for(int k = 0; k < Power[i]; k++) Chain.push_back(Trans[i].first);
+
+		size_t c = 0;
+		while((c < vChains.size()) && (vChains[c].Chain != Chain)) c++;
+		if(c == vChains.size())
+		{
+			vChains.push_back(radTChainBlocks());
+			vChains.back().Chain = Chain;
+		}
+		vChains[c].Blocks.push_back(RecMagPtr);
+
+		// Next combination of powers
+		size_t i = Trans.size();
+		for(;;)
+		{
+			if(i == 0) return;
+			i--;
+			if(Trans[i].second <= 1) continue;
+			if(++Power[i] < Trans[i].second) break;
+			Power[i] = 0;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------
+
+void radTRecMagBatchField::Compute(const TVector3d* Points, long Np, TVector3d* H, TVector3d* B) const
+{
+	const long ChunkSize = 256;
+	long AmOfChunks = (Np + ChunkSize - 1)/ChunkSize;
+	TVector3d ZeroVect(0., 0., 0.);
+	for(long i = 0; i < Np; i++)
+	{
+		if(H != 0) H[i] = ZeroVect;
+		if(B != 0) B[i] = ZeroVect;
+	}
+
+	#pragma omp parallel for schedule(dynamic) if(AmOfChunks > 1)
+	for(long c = 0; c < AmOfChunks; c++)
+	{
+		long Start = c*ChunkSize;
+		int n = (int)std::min(ChunkSize, Np - Start);
+
+		// Chunk points in the frame of a chain, and the fields there (structure of arrays)
+		std::vector<double> Buf(9*ChunkSize);
+		double *X = Buf.data(), *Y = X + ChunkSize, *Z = Y + ChunkSize;
+		double *Hx = Z + ChunkSize, *Hy = Hx + ChunkSize, *Hz = Hy + ChunkSize;
+		double *Bx = Hz + ChunkSize, *By = Bx + ChunkSize, *Bz = By + ChunkSize;
+		if(B == 0) Bx = By = Bz = 0;
+
+		for(size_t k = 0; k < vChains.size(); k++)
+		{
+			const std::vector<radTrans*>& Chain = vChains[k].Chain;
+			for(int i = 0; i < n; i++)
+			{
+				TVector3d P = Points[Start + i];
+				for(size_t t = 0; t < Chain.size(); t++) P = Chain[t]->TrPoint_inv(P);
+				X[i] = P.x; Y[i] = P.y; Z[i] = P.z;
+			}
+			std::fill(Hx, Hx + 6*ChunkSize, 0.);
+
+			const std::vector<radTRecMag*>& Blocks = vChains[k].Blocks;
+			for(size_t b = 0; b < Blocks.size(); b++) Blocks[b]->B_compBatch(X, Y, Z, n, Hx, Hy, Hz, Bx, By, Bz);
+
+			for(int i = 0; i < n; i++)
+			{
+				TVector3d LocH(Hx[i], Hy[i], Hz[i]);
+				for(size_t t = Chain.size(); t > 0; t--) LocH = Chain[t - 1]->TrVectField(LocH);
+				if(H != 0) H[Start + i] += LocH;
+				if(B != 0)
+				{
+					TVector3d LocB(Bx[i], By[i], Bz[i]);
+					for(size_t t = Chain.size(); t > 0; t--) LocB = Chain[t - 1]->TrVectField(LocB);
+					B[Start + i] += LocB;
+				}
+			}
+		}
+	}
+}
+
+//-------------------------------------------------------------------------
+// Evaluation plan
+//-------------------------------------------------------------------------
+
+bool radTFieldPlan::Setup(radTg3d* obj, const radTFieldKey& InFieldKey, const radTCompCriterium& InCompCriterium)
+{
+	vGroups.clear();
+	if(obj == 0) return false;
+
+	const radTFieldKey& K = InFieldKey;
+	if(!K.B_ && !K.H_ && !K.A_ && !K.M_) return false;
+	if(K.J_ || K.Phi_ || K.PreRelax_ || K.Ib_ || K.Ih_ || K.FinInt_ || K.Force_ || K.ForceEnr_ || K.Torque_ || K.Energy_ || K.Q_) return false;
+	FieldKey = InFieldKey;
+	CompCriterium = InCompCriterium;
+
+	// Blocks by the batch kernel: B and H without the multipole approximation of B_comp
+	BatchBlocks = !K.A_ && !K.M_;
+	for(int k=0; k<4; k++) if(CompCriterium.MltplThresh[k] > 0.) BatchBlocks = false;
+
+	// Polyhedra by the lean kernel: B, H, B and H, or A alone
+	LeanKey = 0;
+	if(!K.M_)
+	{
+		if(!K.A_) LeanKey = (char)((K.B_? 1 : 0) + (K.H_? 2 : 0));
+		else if(!K.B_ && !K.H_) LeanKey = 4;
+	}
+
+	std::vector<std::pair<radTrans*, int> > Trans;
+	Collect(obj, Trans);
+
+	TVector3d E0(1., 0., 0.), E1(0., 1., 0.), E2(0., 0., 1.);
+	for(size_t k = 0; k < vGroups.size(); k++)
+	{
+		radTPlanGroup& Group = vGroups[k];
+		Group.Identity = Group.Chain.empty();
+		radTrans Trans = radIdentTrans();
+		for(size_t t = 0; t < Group.Chain.size(); t++) Trans = Product(Trans, *(Group.Chain[t]));
+
+		TVector3d F0 = Trans.TrVectField(E0), F1 = Trans.TrVectField(E1), F2 = Trans.TrVectField(E2);
+		TVector3d A0 = Trans.TrVectPoten(E0), A1 = Trans.TrVectPoten(E1), A2 = Trans.TrVectPoten(E2);
+		Group.MF = TMatrix3d(TVector3d(F0.x, F1.x, F2.x), TVector3d(F0.y, F1.y, F2.y), TVector3d(F0.z, F1.z, F2.z));
+		Group.MA = TMatrix3d(TVector3d(A0.x, A1.x, A2.x), TVector3d(A0.y, A1.y, A2.y), TVector3d(A0.z, A1.z, A2.z));
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------
+
+int radTFieldPlan::NumLeaves() const
+{
+	int AmOfLeaves = 0;
+	for(size_t k = 0; k < vGroups.size(); k++) AmOfLeaves += (int)(vGroups[k].Leaves.size() + vGroups[k].Blocks.size() + vGroups[k].Polyhedra.size());
+	return AmOfLeaves;
+}
+
+//-------------------------------------------------------------------------
+
+void radTFieldPlan::Collect(radTg3d* g3dPtr, std::vector<std::pair<radTrans*, int> >& Trans)
+{
+	size_t AmOfOuterTrans = Trans.size();
+	for(radTlphg::iterator Iter = g3dPtr->g3dListOfTransform.begin(); Iter != g3dPtr->g3dListOfTransform.end(); ++Iter)
+		Trans.push_back(std::make_pair((radTrans*)((*Iter).Handler_g.rep), (*Iter).m));
+
+	radTGroup* GroupPtr = radTCast::GroupCast(g3dPtr);
+	bool OwnField = (GroupPtr == 0);
+	if(!OwnField)
+	{// Subdivided blocks with their own field computation method are leaves
+		radTSubdividedRecMag* SubdRecMagPtr = radTCast::SubdividedRecMagCast(GroupPtr);
+		OwnField = (SubdRecMagPtr != 0) && (SubdRecMagPtr->FldCmpMeth != 0) && !SubdRecMagPtr->AlgsBasedOnKsQsMayNotWork;
+	}
+	if(OwnField) AddImages(g3dPtr, Trans);
+	else
+	{
+		for(radTmhg::iterator Iter = GroupPtr->GroupMapOfHandlers.begin(); Iter != GroupPtr->GroupMapOfHandlers.end(); ++Iter)
+			Collect((radTg3d*)((*Iter).second.rep), Trans);
+	}
+	Trans.resize(AmOfOuterTrans);
+}
+
+//-------------------------------------------------------------------------
+
+void radTFieldPlan::AddImages(radTg3d* g3dPtr, const std::vector<std::pair<radTrans*, int> >& Trans)
+{// Transformation with multiplicity m > 1: images T^0 ... T^(m-1); m = 1: T (as radTg3d::NestedFor_B)
+	radTRecMag* BlockPtr = 0;
+	if(BatchBlocks && (radTCast::GroupCast(g3dPtr) == 0))
+	{
+		radTg3dRelax* g3dRelaxPtr = radTCast::g3dRelaxCast(g3dPtr);
+		BlockPtr = (g3dRelaxPtr != 0)? radTCast::RecMagCast(g3dRelaxPtr) : 0;
+		if((BlockPtr != 0) && (BlockPtr->J_IsNotZero || (BlockPtr->J.x != 0.) || (BlockPtr->J.y != 0.) || (BlockPtr->J.z != 0.))) BlockPtr = 0;
+	}
+	radTPolyhedron* PolyhedronPtr = 0;
+	if((LeanKey != 0) && (radTCast::GroupCast(g3dPtr) == 0))
+	{
+		radTg3dRelax* g3dRelaxPtr = radTCast::g3dRelaxCast(g3dPtr);
+		PolyhedronPtr = (g3dRelaxPtr != 0)? radTCast::PolyhedronCast(g3dRelaxPtr) : 0;
+		if((PolyhedronPtr != 0) && !PolyhedronPtr->LeanFieldIsAvailable()) PolyhedronPtr = 0;
+		if((PolyhedronPtr != 0) && PolyhedronPtr->Magn.isZero()) return; // No field (as radTPolyhedron::B_comp)
+	}
+
+	std::vector<int> Power(Trans.size(), 0);
+	for(size_t i = 0; i < Trans.size(); i++) if(Trans[i].second <= 1) Power[i] = 1;
+	std::vector<radTrans*> Chain;
+	for(;;)
+	{
+		Chain.clear();
+		for(size_t i = 0; i < Trans.size(); i++)
+			for(int k = 0; k < Power[i]; k++) Chain.push_back(Trans[i].first);
+
+		size_t c = 0;
+		while((c < vGroups.size()) && (vGroups[c].Chain != Chain)) c++;
+		if(c == vGroups.size())
+		{
+			vGroups.push_back(radTPlanGroup());
+			vGroups.back().Chain = Chain;
+		}
+		if(BlockPtr != 0) vGroups[c].Blocks.push_back(BlockPtr);
+		else if(PolyhedronPtr != 0) vGroups[c].Polyhedra.push_back(PolyhedronPtr);
+		else vGroups[c].Leaves.push_back(g3dPtr);
+
+		// Next combination of powers
+		size_t i = Trans.size();
+		for(;;)
+		{
+			if(i == 0) return;
+			i--;
+			if(Trans[i].second <= 1) continue;
+			if(++Power[i] < Trans[i].second) break;
+			Power[i] = 0;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------
+
+void radTFieldPlan::Compute(const TVector3d* Points, long Np, radTField* FieldArray) const
+{
+	const long ChunkSize = 256;
+	long AmOfChunks = (Np + ChunkSize - 1)/ChunkSize;
+	TVector3d ZeroVect(0., 0., 0.);
+	for(long i = 0; i < Np; i++) FieldArray[i] = radTField(FieldKey, CompCriterium, Points[i], ZeroVect, ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.);
+
+	#pragma omp parallel for schedule(dynamic) if(AmOfChunks > 1)
+	for(long c = 0; c < AmOfChunks; c++)
+	{
+		long Start = c*ChunkSize;
+		int n = (int)std::min(ChunkSize, Np - Start);
+		radTField* Out = FieldArray + Start;
+
+		// Chunk points in the frame of a composed transformation, and the block fields there (structure of arrays)
+		std::vector<double> Buf(9*ChunkSize);
+		double *X = Buf.data(), *Y = X + ChunkSize, *Z = Y + ChunkSize;
+		double *Hx = Z + ChunkSize, *Hy = Hx + ChunkSize, *Hz = Hy + ChunkSize;
+		double *Bx = Hz + ChunkSize, *By = Bx + ChunkSize, *Bz = By + ChunkSize;
+		double *OutHx = FieldKey.H_? Hx : 0, *OutBx = FieldKey.B_? Bx : 0;
+
+		radTField LocField(FieldKey, CompCriterium, ZeroVect, ZeroVect, ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.);
+		for(size_t k = 0; k < vGroups.size(); k++)
+		{
+			if(radYield.CancelIsRequested()) break; // reported by the caller after the parallel loop
+			const radTPlanGroup& Group = vGroups[k];
+			const std::vector<radTrans*>& Chain = Group.Chain;
+			for(int i = 0; i < n; i++)
+			{
+				TVector3d P = Points[Start + i];
+				for(size_t t = 0; t < Chain.size(); t++) P = Chain[t]->TrPoint_inv(P); // same rounding as the tree walk (points on faces)
+				X[i] = P.x; Y[i] = P.y; Z[i] = P.z;
+			}
+			const TMatrix3d &MF = Group.MF, &MA = Group.MA;
+
+			if(!Group.Blocks.empty())
+			{
+				std::fill(Hx, Hx + 6*ChunkSize, 0.);
+				for(size_t b = 0; b < Group.Blocks.size(); b++) Group.Blocks[b]->B_compBatch(X, Y, Z, n, OutHx, Hy, Hz, OutBx, By, Bz);
+				for(int i = 0; i < n; i++)
+				{
+					TVector3d LocH(Hx[i], Hy[i], Hz[i]);
+					if(FieldKey.H_) Out[i].H += Group.Identity? LocH : MF*LocH;
+					if(FieldKey.B_)
+					{
+						TVector3d LocB(Bx[i], By[i], Bz[i]);
+						Out[i].B += Group.Identity? LocB : MF*LocB;
+					}
+				}
+			}
+
+			if(!Group.Polyhedra.empty())
+			{
+				switch(LeanKey)
+				{
+				case 1: AddPolyhedra<radTFieldB>(Group, X, Y, Z, n, Out); break;
+				case 2: AddPolyhedra<radTFieldH>(Group, X, Y, Z, n, Out); break;
+				case 3: AddPolyhedra<radTFieldBH>(Group, X, Y, Z, n, Out); break;
+				case 4: AddPolyhedra<radTFieldA>(Group, X, Y, Z, n, Out); break;
+				}
+			}
+			if(Group.Leaves.empty()) continue;
+
+			for(int i = 0; i < n; i++)
+			{
+				LocField.P = TVector3d(X[i], Y[i], Z[i]);
+				LocField.B = LocField.H = LocField.A = LocField.M = ZeroVect;
+				for(size_t e = 0; e < Group.Leaves.size(); e++)
+				{
+					LocField.PointIsInsideFrame = 0;
+					Group.Leaves[e]->B_comp(&LocField);
+				}
+				radTField& F = Out[i];
+				if(Group.Identity)
+				{
+					if(FieldKey.B_) F.B += LocField.B;
+					if(FieldKey.H_) F.H += LocField.H;
+					if(FieldKey.A_) F.A += LocField.A;
+					if(FieldKey.M_) F.M += LocField.M;
+				}
+				else
+				{
+					if(FieldKey.B_) F.B += MF*LocField.B;
+					if(FieldKey.H_) F.H += MF*LocField.H;
+					if(FieldKey.A_) F.A += MA*LocField.A;
+					if(FieldKey.M_) F.M += MF*LocField.M;
+				}
+			}
+		}
+		if(!radYield.CancelIsRequested()) radYield.ProgressAdd(n);
+	}
+}
+
+//-------------------------------------------------------------------------
+
+template<class TLean> void radTFieldPlan::AddPolyhedra(const radTPlanGroup& Group, const double* X, const double* Y, const double* Z, int n, radTField* Out) const
+{
+	const std::vector<radTPolyhedron*>& Polyhedra = Group.Polyhedra;
+	for(int i = 0; i < n; i++)
+	{
+		TVector3d P(X[i], Y[i], Z[i]);
+		TLean Acc;
+		for(size_t e = 0; e < Polyhedra.size(); e++) Polyhedra[e]->B_compLean(P, Polyhedra[e]->Magn, Acc);
+		if(Group.Identity) Acc.AddTo(Out[i]);
+		else Acc.AddTo(Out[i], Group.MF, Group.MA);
+	}
+}
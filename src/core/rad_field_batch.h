@@ -0,0 +1,113 @@
+/*-------------------------------------------------------------------------
+*
+* File name:      rad_field_batch.h
+*
+* Project:        RADIA
+*
+* Description:    Batch field evaluation of homogeneous sets of
+*                 rectangular magnet blocks; flattened evaluation plans
+*
+* Author(s):      Radia Development Team
+*
+* First release:  2026
+*
+*------------------------------------------------------------------------*/
+
+#ifndef __RADFIELDBATCH_H
+#define __RADFIELDBATCH_H
+
+#include "rad_geometry_3d.h"
+#include <vector>
+#include <utility>
+
+class radTg3d;
+class radTRecMag;
+class radTPolyhedron;
+
+//-------------------------------------------------------------------------
+// An object whose field sources are all magnetized parallelepipeds
+// (radTRecMag without current density, possibly in containers, subdivided
+// blocks and symmetries) is evaluated block by block at all points with the
+// structure-of-arrays kernel radTRecMag::B_compBatch, instead of one
+// B_genComp call (and one radTField record) per point. Images of the
+// transformations are separate sources, grouped by transformation chain:
+// points are mapped to the frame of a chain once, for all of its blocks.
+//-------------------------------------------------------------------------
+
+class radTRecMagBatchField
+{
+public:
+	// Collects the blocks of obj; false if obj has other field sources.
+	// WithOwnTrans: transformations of obj itself are applied (as B_genComp; B_comp does not apply them)
+	bool Setup(radTg3d* obj, bool WithOwnTrans);
+
+	int NumBlocks() const;
+
+	// H and/or B at the points (a null output is not computed)
+	void Compute(const TVector3d* Points, long Np, TVector3d* H, TVector3d* B) const;
+
+private:
+	struct radTChainBlocks
+	{
+		std::vector<radTrans*> Chain;      // Outermost transformation first, repeated for powers
+		std::vector<radTRecMag*> Blocks;
+	};
+	std::vector<radTChainBlocks> vChains;
+
+	bool Collect(radTg3d* g3dPtr, std::vector<std::pair<radTrans*, int> >& Trans);
+	void AddImages(radTRecMag* RecMagPtr, const std::vector<std::pair<radTrans*, int> >& Trans);
+};
+
+//-------------------------------------------------------------------------
+// Evaluation plan of an object: the group and transformation tree is
+// flattened once into leaf elements (non-group objects, and subdivided
+// blocks whose B_comp is not the sum over their sub-blocks), each symmetry
+// image with its transformation chain and the composed field matrices of
+// the chain (radTrans Product). The plan is then executed for all points
+// without the recursion of B_genComp / NestedFor_B: points are mapped once
+// per chain (in the order of the tree walk, so that points on faces get the
+// same local coordinates), fields are transformed back by one matrix,
+// magnetized blocks are evaluated by the structure-of-arrays kernel (B and
+// H only). For B, H, B and H, or A alone, polyhedra are evaluated by their
+// lean kernel (radTPolyhedron::B_compLean on radTFieldB, ... radTFieldA).
+// Other leaves are evaluated by B_comp on one reused field record per thread.
+//
+// A plan keeps raw pointers to the leaves and is compiled per field request
+// (it is invalid after any change of the object tree, which is never
+// detected). Supported: B, H, A and M (transformed as by radTrans::TrField).
+//-------------------------------------------------------------------------
+
+class radTFieldPlan
+{
+public:
+	// Flattens obj with its own transformations (as B_genComp); false if FieldKey has other quantities
+	bool Setup(radTg3d* obj, const radTFieldKey& InFieldKey, const radTCompCriterium& InCompCriterium);
+
+	int NumLeaves() const;
+	int NumTransforms() const { return (int)vGroups.size();}
+
+	// Field records (FieldKey, CompCriterium, point) at the points
+	void Compute(const TVector3d* Points, long Np, radTField* FieldArray) const;
+
+private:
+	struct radTPlanGroup
+	{
+		std::vector<radTrans*> Chain;      // Outermost transformation first, repeated for powers
+		TMatrix3d MF, MA;                  // Composed transformation of the chain: field s*M*B, potential s*detM*M*A
+		bool Identity;
+		std::vector<radTg3d*> Leaves;
+		std::vector<radTRecMag*> Blocks;   // Evaluated by radTRecMag::B_compBatch
+		std::vector<radTPolyhedron*> Polyhedra; // Evaluated by radTPolyhedron::B_compLean
+	};
+	std::vector<radTPlanGroup> vGroups;
+	radTFieldKey FieldKey;
+	radTCompCriterium CompCriterium;
+	bool BatchBlocks;
+	char LeanKey; // 0- other quantities; 1- B; 2- H; 3- B and H; 4- A
+
+	void Collect(radTg3d* g3dPtr, std::vector<std::pair<radTrans*, int> >& Trans);
+	void AddImages(radTg3d* g3dPtr, const std::vector<std::pair<radTrans*, int> >& Trans);
+	template<class TLean> void AddPolyhedra(const radTPlanGroup& Group, const double* X, const double* Y, const double* Z, int n, radTField* Out) const;
+};
+
+#endif
@@ -51,7 +51,8 @@ public:
 
 	radTFlmLinCur() {}
 
-	int Type_g3d() { return 4;}
+	static const int TypeID_g3d = 4;
+	int Type_g3d() { return TypeID_g3d;}
 
 	void SetNativeRotation(const TVector3d&, double);
 
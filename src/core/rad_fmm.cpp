@@ -0,0 +1,878 @@
+/*-------------------------------------------------------------------------
+*
+* File name:      rad_fmm.cpp
+*
+* Project:        RADIA
+*
+* Description:    Cartesian-Taylor fast multipole method for the far field
+*                 of magnetized elements (relaxation and field evaluation)
+*
+* Author(s):      Radia Development Team
+*
+* First release:  2026
+*
+*------------------------------------------------------------------------*/
+
+#include "rad_fmm.h"
+#include "rad_type_cast.h"
+#include "rad_group.h"
+#include "rad_transform_def.h"
+#include "rad_yield.h"
+#include "../ext/HACApK_LH-Cimplm/hacapk.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+extern radTYield radYield;
+
+//-------------------------------------------------------------------------
+// Quadrature of relaxable elements (local frame)
+//-------------------------------------------------------------------------
+
+static void radFMMGaussLegendre(int n, std::vector<double>& x, std::vector<double>& w)
+{// Nodes and weights on [0, 1]
+	const double Pi = 3.14159265358979323846;
+	x.resize(n); w.resize(n);
+	for(int i = 0; i < n; i++)
+	{
+		double z = cos(Pi*(i + 0.75)/(n + 0.5)), z1, pp;
+		do
+		{
+			double p1 = 1., p2 = 0.;
+			for(int j = 1; j <= n; j++)
+			{
+				double p3 = p2; p2 = p1;
+				p1 = ((2*j - 1)*z*p2 - (j - 1)*p3)/j;
+			}
+			pp = n*(z*p1 - p2)/(z*z - 1.);
+			z1 = z;
+			z = z1 - p1/pp;
+		}
+		while(fabs(z - z1) > 1e-15);
+		x[i] = 0.5*(1. - z);
+		w[i] = 1./((1. - z*z)*pp*pp);
+	}
+}
+
+static void radFMMElementQuadrature(radTg3dRelax* g3dRelaxPtr, int Degree, std::vector<TVector3d>& Points, std::vector<double>& Weights)
+{// Exact for polynomials up to total degree Degree
+	Points.clear(); Weights.clear();
+	std::vector<double> x, w;
+
+	radTRecMag* RecMagPtr = radTCast::RecMagCast(g3dRelaxPtr);
+	if(RecMagPtr != 0)
+	{
+		radFMMGaussLegendre(Degree/2 + 1, x, w);
+		const TVector3d& L = RecMagPtr->Dimensions;
+		TVector3d Corner = RecMagPtr->CentrPoint - 0.5*L;
+		for(size_t i = 0; i < x.size(); i++)
+			for(size_t j = 0; j < x.size(); j++)
+				for(size_t k = 0; k < x.size(); k++)
+				{
+					Points.push_back(Corner + TVector3d(x[i]*L.x, x[j]*L.y, x[k]*L.z));
+					Weights.push_back(w[i]*w[j]*w[k]*L.x*L.y*L.z);
+				}
+		return;
+	}
+
+	radTPolyhedron* PolyhedronPtr = radTCast::PolyhedronCast(g3dRelaxPtr);
+	if(PolyhedronPtr != 0)
+	{// Tetrahedra (centre, triangles of the convex faces), collapsed cube u, u*v, u*v*w with Jacobian u^2 v
+		radFMMGaussLegendre(Degree/2 + 2, x, w);
+		const TVector3d& C = PolyhedronPtr->CentrPoint;
+		std::vector<TVector3d> V;
+		for(radTVectHandlePgnAndTrans::iterator FaceIter = PolyhedronPtr->VectHandlePgnAndTrans.begin(); FaceIter != PolyhedronPtr->VectHandlePgnAndTrans.end(); ++FaceIter)
+		{
+			radTPolygon* PgnPtr = (*FaceIter).PgnHndl.rep;
+			radTrans* TransPtr = (*FaceIter).TransHndl.rep;
+			V.clear();
+			for(radTVect2dVect::iterator PointIter = PgnPtr->EdgePointsVector.begin(); PointIter != PgnPtr->EdgePointsVector.end(); ++PointIter)
+				V.push_back(TransPtr->TrPoint(TVector3d((*PointIter).x, (*PointIter).y, PgnPtr->CoordZ)));
+
+			for(size_t m = 1; m + 1 < V.size(); m++)
+			{
+				TVector3d E1 = V[0] - C, E2 = V[m] - V[0], E3 = V[m + 1] - V[m];
+				double Det = fabs(E1*(E2^E3));
+				for(size_t i = 0; i < x.size(); i++)
+					for(size_t j = 0; j < x.size(); j++)
+						for(size_t k = 0; k < x.size(); k++)
+						{
+							double u = x[i], uv = x[i]*x[j], uvw = uv*x[k];
+							Points.push_back(C + u*E1 + uv*E2 + uvw*E3);
+							Weights.push_back(w[i]*w[j]*w[k]*Det*u*uv);
+						}
+			}
+		}
+		return;
+	}
+
+	// Other shapes: point dipole at the centre
+	Points.push_back(g3dRelaxPtr->ReturnCentrPoint());
+	Weights.push_back(g3dRelaxPtr->Volume());
+}
+
+//-------------------------------------------------------------------------
+// Particles
+//-------------------------------------------------------------------------
+
+void radTFMMParticles::AddPoint(const TVector3d& P, double Weight)
+{
+	Centre.push_back(P);
+	Radius.push_back(0.);
+	Moment.push_back(Weight);
+	MomentStart.push_back((int)Moment.size());
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMMParticles::AddVolume(const TVector3d& InCentre, double InRadius, const TVector3d* Points, const double* Weights, int AmOfPoints)
+{
+	int NumS = radTFMM::NumTerms(MomentOrder);
+	size_t Start = Moment.size();
+	Moment.resize(Start + NumS, 0.);
+	std::vector<double> Mono(NumS);
+
+	double r = InRadius;
+	for(int q = 0; q < AmOfPoints; q++)
+	{
+		TVector3d D = Points[q] - InCentre;
+		r = std::max(r, sqrt(D*D));
+		radTFMM::Monomials(D, MomentOrder, Mono.data());
+		for(int k = 0; k < NumS; k++) Moment[Start + k] += Weights[q]*Mono[k];
+	}
+	Centre.push_back(InCentre);
+	Radius.push_back(r);
+	MomentStart.push_back((int)Moment.size());
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMMParticles::AddElement(radTg3dRelax* g3dRelaxPtr, const std::vector<std::vector<radTrans*> >& Images)
+{
+	std::vector<TVector3d> LocPoints;
+	std::vector<double> Weights;
+	radFMMElementQuadrature(g3dRelaxPtr, MomentOrder, LocPoints, Weights);
+
+	TVector3d LocCentre = g3dRelaxPtr->ReturnCentrPoint();
+	radTVectorOfVector3d Vertices;
+	g3dRelaxPtr->VerticesInLocFrame(Vertices, false);
+	double r = 0.;
+	for(size_t i = 0; i < Vertices.size(); i++) r = std::max(r, sqrt((Vertices[i] - LocCentre)*(Vertices[i] - LocCentre)));
+
+	std::vector<TVector3d> Points(LocPoints.size());
+	for(size_t k = 0; k < Images.size(); k++)
+	{
+		const std::vector<radTrans*>& Chain = Images[k];
+		auto Map = [&Chain](TVector3d P)
+		{
+			for(size_t i = Chain.size(); i > 0; i--) P = Chain[i - 1]->TrPoint(P);
+			return P;
+		};
+		TVector3d C = Map(LocCentre);
+		if(LocPoints.size() == 1)
+		{// Point dipole
+			AddPoint(C, Weights[0]);
+			Radius.back() = r;
+			continue;
+		}
+		for(size_t q = 0; q < LocPoints.size(); q++) Points[q] = Map(LocPoints[q]);
+		AddVolume(C, r, Points.data(), Weights.data(), (int)Points.size());
+	}
+}
+
+//-------------------------------------------------------------------------
+// Fast multipole method
+//-------------------------------------------------------------------------
+
+radTFMM::radTFMM(int InOrder, double InTheta, int InLeafSize)
+	: Order(InOrder), Theta(InTheta), LeafSize(InLeafSize), Targets(InOrder - 1), Sources(InOrder - 1)
+{
+	NumM2L = 0;
+	BuildTime = 0.;
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMM::Monomials(const TVector3d& D, int n, double* Mono)
+{
+	double Px[32], Py[32], Pz[32];
+	Px[0] = Py[0] = Pz[0] = 1.;
+	for(int i = 1; i <= n; i++) { Px[i] = Px[i - 1]*D.x; Py[i] = Py[i - 1]*D.y; Pz[i] = Pz[i - 1]*D.z;}
+
+	int k = 0;
+	for(int Deg = 0; Deg <= n; Deg++)
+		for(int a = Deg; a >= 0; a--)
+			for(int b = Deg - a; b >= 0; b--) Mono[k++] = Px[a]*Py[b]*Pz[Deg - a - b];
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMM::SetupTables()
+{
+	const double Pi = 3.14159265358979323846;
+	int NT = NumTerms(Order), n1 = Order + 1;
+	Exp.resize(3*NT);
+	Index.assign(n1*n1*n1, -1);
+	int k = 0;
+	for(int Deg = 0; Deg <= Order; Deg++)
+		for(int a = Deg; a >= 0; a--)
+			for(int b = Deg - a; b >= 0; b--)
+			{
+				int c = Deg - a - b;
+				Exp[3*k] = a; Exp[3*k + 1] = b; Exp[3*k + 2] = c;
+				Index[(a*n1 + b)*n1 + c] = k++;
+			}
+
+	Lower1.assign(3*NT, -1);
+	Lower2.assign(3*NT, -1);
+	for(k = 0; k < NT; k++)
+		for(int i = 0; i < 3; i++)
+		{
+			int e[] = {Exp[3*k], Exp[3*k + 1], Exp[3*k + 2]};
+			if(e[i] >= 1) { e[i]--; Lower1[3*k + i] = IndexOf(e[0], e[1], e[2]);}
+			if(e[i] >= 1) { e[i]--; Lower2[3*k + i] = IndexOf(e[0], e[1], e[2]);}
+		}
+
+	auto Binom = [](int n, int m)
+	{
+		double r = 1.;
+		for(int i = 1; i <= m; i++) r = r*(n - m + i)/i;
+		return r;
+	};
+
+	ShiftTerms.clear(); M2LTerms.clear(); DipTerms.clear();
+	for(int Out = 0; Out < NT; Out++)
+	{
+		const int* a = &Exp[3*Out];
+		for(int In = 0; In < NT; In++)
+		{
+			const int* g = &Exp[3*In];
+			if((g[0] > a[0]) || (g[1] > a[1]) || (g[2] > a[2])) continue;
+			radTShiftTerm T = {Out, In, IndexOf(a[0] - g[0], a[1] - g[1], a[2] - g[2]), Binom(a[0], g[0])*Binom(a[1], g[1])*Binom(a[2], g[2])};
+			ShiftTerms.push_back(T);
+		}
+		for(int i = 0; i < 3; i++)
+		{
+			if(a[i] == 0) continue;
+			radTShiftTerm T = {Out, Lower1[3*Out + i], i, (double)a[i]};
+			DipTerms.push_back(T);
+		}
+	}
+	for(int Out = 0; Out < NT; Out++)
+	{
+		const int* b = &Exp[3*Out];
+		int DegB = b[0] + b[1] + b[2];
+		for(int In = 1; In < NT; In++)
+		{
+			const int* a = &Exp[3*In];
+			int DegA = a[0] + a[1] + a[2];
+			if(DegA + DegB > Order) break;
+			double Sign = (DegA & 1)? -1. : 1.;
+			radTShiftTerm T = {Out, In, IndexOf(a[0] + b[0], a[1] + b[1], a[2] + b[2]),
+				Sign*Binom(a[0] + b[0], a[0])*Binom(a[1] + b[1], a[1])*Binom(a[2] + b[2], a[2])/(4.*Pi)};
+			M2LTerms.push_back(T);
+		}
+	}
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMM::DerivativesInvR(const TVector3d& R, double* T) const
+{// T_a = D^a(1/r)/a!: |a| r^2 T_a = -(2|a|-1) sum_i R_i T_(a-e_i) - (|a|-1) sum_i T_(a-2e_i)
+	int NT = NumTerms(Order);
+	double InvR2 = 1./(R*R);
+	double Ri[] = {R.x, R.y, R.z};
+	T[0] = sqrt(InvR2);
+	for(int k = 1; k < NT; k++)
+	{
+		int n = Exp[3*k] + Exp[3*k + 1] + Exp[3*k + 2];
+		const int* L1 = &Lower1[3*k];
+		const int* L2 = &Lower2[3*k];
+		double S1 = 0., S2 = 0.;
+		for(int i = 0; i < 3; i++)
+		{
+			if(L1[i] >= 0) S1 += Ri[i]*T[L1[i]];
+			if(L2[i] >= 0) S2 += T[L2[i]];
+		}
+		T[k] = -((2*n - 1)*S1 + (n - 1)*S2)*InvR2/n;
+	}
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMM::ShiftedMoments(const radTFMMParticles& Part, int p, const TVector3d& C, double* Mono, double* S) const
+{// Moments of particle p about C, up to order Order - 1
+	int NumS = NumTerms(Order - 1);
+	const double* Mp = &Part.Moment[Part.MomentStart[p]];
+	Monomials(Part.Centre[p] - C, Order - 1, Mono);
+	if(Part.IsPoint(p))
+	{
+		for(int k = 0; k < NumS; k++) S[k] = Mp[0]*Mono[k];
+		return;
+	}
+	std::fill(S, S + NumS, 0.);
+	for(const radTShiftTerm& T : ShiftTerms)
+	{
+		if(T.Out >= NumS) break;
+		S[T.Out] += T.Coef*Mono[T.Pow]*Mp[T.In];
+	}
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMM::radTFMMTree::Setup(const radTFMMParticles& Part, int LeafSize)
+{
+	int n = Part.Size();
+	std::vector<hacapk::Point3D> Points;
+	Points.reserve(n);
+	for(int i = 0; i < n; i++) Points.emplace_back(Part.Centre[i].x, Part.Centre[i].y, Part.Centre[i].z);
+	Perm.resize(n);
+	std::iota(Perm.begin(), Perm.end(), 0);
+
+	hacapk::ControlParams Params;
+	Params.leaf_size = std::max(LeafSize, 1);
+	Params.split_type = 1;  // Longest box edge at its midpoint (octree-like clusters)
+	std::shared_ptr<hacapk::Cluster> Root = hacapk::generate_cluster(Points, Perm, 0, n, 0, Params);
+
+	NodeCentre.clear(); NodeRadius.clear(); NodeStart.clear(); NodeSize.clear();
+	NodeFirstSon.clear(); NodeNumSons.clear(); NodeParent.clear();
+
+	// Breadth-first numbering: sons are consecutive and follow their parents
+	std::vector<hacapk::Cluster*> Queue(1, Root.get());
+	NodeParent.push_back(-1);
+	for(size_t k = 0; k < Queue.size(); k++)
+	{
+		hacapk::Cluster* Cl = Queue[k];
+		NodeStart.push_back(Cl->nstrt);
+		NodeSize.push_back(Cl->nsize);
+		NodeNumSons.push_back((int)Cl->sons.size());
+		NodeFirstSon.push_back(Cl->sons.empty()? -1 : (int)Queue.size());
+		for(size_t s = 0; s < Cl->sons.size(); s++)
+		{
+			Queue.push_back(Cl->sons[s].get());
+			NodeParent.push_back((int)k);
+		}
+
+		TVector3d Min = Part.Centre[Perm[Cl->nstrt]], Max = Min;
+		for(int i = Cl->nstrt; i < Cl->nstrt + Cl->nsize; i++)
+		{
+			const TVector3d& P = Part.Centre[Perm[i]];
+			Min.x = std::min(Min.x, P.x); Min.y = std::min(Min.y, P.y); Min.z = std::min(Min.z, P.z);
+			Max.x = std::max(Max.x, P.x); Max.y = std::max(Max.y, P.y); Max.z = std::max(Max.z, P.z);
+		}
+		TVector3d C = 0.5*(Min + Max);
+		double r = 0.;
+		for(int i = Cl->nstrt; i < Cl->nstrt + Cl->nsize; i++)
+		{
+			TVector3d D = Part.Centre[Perm[i]] - C;
+			r = std::max(r, sqrt(D*D) + Part.Radius[Perm[i]]);
+		}
+		NodeCentre.push_back(C);
+		NodeRadius.push_back(r);
+	}
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMM::Traverse(int t, int s, std::vector<std::vector<int> >& NearLeaves, std::vector<std::vector<int> >& M2L)
+{
+	TVector3d D = TargetTree.NodeCentre[t] - SourceTree.NodeCentre[s];
+	double rt = TargetTree.NodeRadius[t], rs = SourceTree.NodeRadius[s];
+	if(rt + rs < Theta*sqrt(D*D)) { M2L[t].push_back(s); return;}
+
+	bool tLeaf = TargetTree.IsLeaf(t), sLeaf = SourceTree.IsLeaf(s);
+	if(tLeaf && sLeaf) { NearLeaves[t].push_back(s); return;}
+
+	if(sLeaf || (!tLeaf && (rt >= rs)))
+	{
+		for(int k = 0; k < TargetTree.NodeNumSons[t]; k++) Traverse(TargetTree.NodeFirstSon[t] + k, s, NearLeaves, M2L);
+	}
+	else
+	{
+		for(int k = 0; k < SourceTree.NodeNumSons[s]; k++) Traverse(t, SourceTree.NodeFirstSon[s] + k, NearLeaves, M2L);
+	}
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMM::Build()
+{
+	auto t_start = std::chrono::high_resolution_clock::now();
+
+	if((Order < 1) || (Order > 30) || (Targets.MomentOrder != Order - 1) || (Sources.MomentOrder != Order - 1))
+		throw std::runtime_error("FMM: expansion order and particle moments do not match");
+
+	SetupTables();
+
+	int nt = Targets.Size(), ns = Sources.Size();
+	NearStart.assign(nt + 1, 0);
+	NearSource.clear();
+	M2LStart.assign(1, 0); M2LSource.clear();
+	M2LTargetStart.assign(1, 0); M2LTarget.clear();
+	NumM2L = 0;
+	TargetTree = radTFMMTree();
+	SourceTree = radTFMMTree();
+	if((nt == 0) || (ns == 0)) return;
+
+	TargetTree.Setup(Targets, LeafSize);
+	SourceTree.Setup(Sources, LeafSize);
+
+	std::vector<std::vector<int> > NearLeaves(TargetTree.Size()), M2L(TargetTree.Size());
+	Traverse(0, 0, NearLeaves, M2L);
+
+	// Far-field lists, by target and by source cluster
+	std::vector<int> Count(SourceTree.Size() + 1, 0);
+	for(int t = 0; t < TargetTree.Size(); t++)
+	{
+		M2LSource.insert(M2LSource.end(), M2L[t].begin(), M2L[t].end());
+		M2LStart.push_back((int)M2LSource.size());
+		for(int s : M2L[t]) Count[s + 1]++;
+	}
+	NumM2L = (long long)M2LSource.size();
+	std::partial_sum(Count.begin(), Count.end(), Count.begin());
+	M2LTargetStart = Count;
+	M2LTarget.resize(M2LSource.size());
+	for(int t = 0; t < TargetTree.Size(); t++)
+		for(int s : M2L[t]) M2LTarget[Count[s]++] = t;
+
+	// Near lists of the particles
+	for(int t = 0; t < TargetTree.Size(); t++)
+	{
+		if(!TargetTree.IsLeaf(t)) continue;
+		int NumNear = 0;
+		for(int s : NearLeaves[t]) NumNear += SourceTree.NodeSize[s];
+		for(int i = TargetTree.NodeStart[t]; i < TargetTree.NodeStart[t] + TargetTree.NodeSize[t]; i++) NearStart[TargetTree.Perm[i] + 1] = NumNear;
+	}
+	std::partial_sum(NearStart.begin(), NearStart.end(), NearStart.begin());
+	NearSource.resize(NearStart[nt]);
+	for(int t = 0; t < TargetTree.Size(); t++)
+	{
+		if(!TargetTree.IsLeaf(t)) continue;
+		for(int i = TargetTree.NodeStart[t]; i < TargetTree.NodeStart[t] + TargetTree.NodeSize[t]; i++)
+		{
+			int* Near = &NearSource[NearStart[TargetTree.Perm[i]]];
+			for(int s : NearLeaves[t])
+				for(int j = SourceTree.NodeStart[s]; j < SourceTree.NodeStart[s] + SourceTree.NodeSize[s]; j++) *(Near++) = SourceTree.Perm[j];
+		}
+	}
+
+	auto t_end = std::chrono::high_resolution_clock::now();
+	BuildTime = std::chrono::duration<double>(t_end - t_start).count();
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMM::Multipoles(const radTFMMTree& From, const radTFMMParticles& FromPart, const TVector3d* Dip, std::vector<double>& Mult) const
+{
+	int NT = NumTerms(Order), NumS = NumTerms(Order - 1);
+	int nFrom = From.Size();
+	Mult.assign((size_t)nFrom*NT, 0.);
+
+	// P2M: dipole densities times the particle moments about the leaf centres
+	#pragma omp parallel if(nFrom > 64)
+	{
+		std::vector<double> Mono(NT), S(NumS);
+		#pragma omp for schedule(dynamic, 16)
+		for(int k = 0; k < nFrom; k++)
+		{
+			if(!From.IsLeaf(k)) continue;
+			double* Mu = &Mult[(size_t)k*NT];
+			for(int i = From.NodeStart[k]; i < From.NodeStart[k] + From.NodeSize[k]; i++)
+			{
+				int p = From.Perm[i];
+				const double d[] = {Dip[p].x, Dip[p].y, Dip[p].z};
+				ShiftedMoments(FromPart, p, From.NodeCentre[k], Mono.data(), S.data());
+				for(const radTShiftTerm& T : DipTerms) Mu[T.Out] += T.Coef*d[T.Pow]*S[T.In];
+			}
+		}
+	}
+
+	// M2M: sons to parents
+	std::vector<double> Mono(NT);
+	for(int k = nFrom - 1; k > 0; k--)
+	{
+		int Parent = From.NodeParent[k];
+		Monomials(From.NodeCentre[k] - From.NodeCentre[Parent], Order, Mono.data());
+		const double* Mu = &Mult[(size_t)k*NT];
+		double* MuParent = &Mult[(size_t)Parent*NT];
+		for(const radTShiftTerm& T : ShiftTerms) MuParent[T.Out] += T.Coef*Mono[T.Pow]*Mu[T.In];
+	}
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMM::Pass(const radTFMMTree& From, const radTFMMParticles& FromPart, const radTFMMTree& To, const radTFMMParticles& ToPart,
+	const std::vector<int>& ListStart, const std::vector<int>& List, const TVector3d* Dip, TVector3d* H) const
+{
+	int NT = NumTerms(Order), NumS = NumTerms(Order - 1);
+	int nTo = To.Size();
+	std::vector<double> Mult, Loc((size_t)nTo*NT, 0.);
+	Multipoles(From, FromPart, Dip, Mult);
+
+	// M2L
+	#pragma omp parallel if(nTo > 64)
+	{
+		std::vector<double> Der(NT);
+		#pragma omp for schedule(dynamic, 16)
+		for(int t = 0; t < nTo; t++)
+		{
+			double* L = &Loc[(size_t)t*NT];
+			for(int i = ListStart[t]; i < ListStart[t + 1]; i++)
+			{
+				int s = List[i];
+				DerivativesInvR(To.NodeCentre[t] - From.NodeCentre[s], Der.data());
+				const double* Mu = &Mult[(size_t)s*NT];
+				for(const radTShiftTerm& T : M2LTerms) L[T.Out] += T.Coef*Der[T.Pow]*Mu[T.In];
+			}
+		}
+	}
+
+	// L2L: parents to sons
+	std::vector<double> Mono(NT);
+	for(int k = 1; k < nTo; k++)
+	{
+		int Parent = To.NodeParent[k];
+		Monomials(To.NodeCentre[k] - To.NodeCentre[Parent], Order, Mono.data());
+		double* L = &Loc[(size_t)k*NT];
+		const double* LParent = &Loc[(size_t)Parent*NT];
+		for(const radTShiftTerm& T : ShiftTerms) L[T.In] += T.Coef*Mono[T.Pow]*LParent[T.Out];
+	}
+
+	// L2P: H = -grad of the local expansions, integrated with the particle moments
+	#pragma omp parallel if(nTo > 64)
+	{
+		std::vector<double> MonoP(NT), S(NumS);
+		#pragma omp for schedule(dynamic, 16)
+		for(int k = 0; k < nTo; k++)
+		{
+			if(!To.IsLeaf(k)) continue;
+			const double* L = &Loc[(size_t)k*NT];
+			for(int i = To.NodeStart[k]; i < To.NodeStart[k] + To.NodeSize[k]; i++)
+			{
+				int p = To.Perm[i];
+				ShiftedMoments(ToPart, p, To.NodeCentre[k], MonoP.data(), S.data());
+				double h[] = {0., 0., 0.};
+				for(const radTShiftTerm& T : DipTerms) h[T.Pow] -= T.Coef*L[T.Out]*S[T.In];
+				H[p] = TVector3d(h[0], h[1], h[2]);
+			}
+		}
+	}
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMM::FarField(const TVector3d* Dip, TVector3d* H, bool Transposed) const
+{
+	const radTFMMParticles& ToPart = Transposed? Sources : Targets;
+	if((Targets.Size() == 0) || (Sources.Size() == 0) || (TargetTree.Size() == 0))
+	{
+		std::fill(H, H + ToPart.Size(), TVector3d(0., 0., 0.));
+		return;
+	}
+	if(Transposed) Pass(TargetTree, Targets, SourceTree, Sources, M2LTargetStart, M2LTarget, Dip, H);
+	else Pass(SourceTree, Sources, TargetTree, Targets, M2LStart, M2LSource, Dip, H);
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMM::BuildSourceTree(const TVector3d* Dip)
+{
+	if((Order < 1) || (Order > 30) || (Sources.MomentOrder != Order - 1))
+		throw std::runtime_error("FMM: expansion order and particle moments do not match");
+
+	SetupTables();
+	SourceTree = radTFMMTree();
+	SourceMult.clear();
+	if(Sources.Size() == 0) return;
+
+	SourceTree.Setup(Sources, LeafSize);
+	Multipoles(SourceTree, Sources, Dip, SourceMult);
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMM::TreeTraverse(int s, const TVector3d& P, double* h, std::vector<int>& Near, double* Der) const
+{
+	TVector3d D = P - SourceTree.NodeCentre[s];
+	if(SourceTree.NodeRadius[s] < Theta*sqrt(D*D))
+	{// M2P: H = -grad of the multipole expansion at P (local expansion terms of order 1)
+		DerivativesInvR(D, Der);
+		const double* Mu = &SourceMult[(size_t)s*NumTerms(Order)];
+		for(const radTShiftTerm& T : M2LTerms)
+		{
+			if(T.Out > 3) break;
+			if(T.Out > 0) h[T.Out - 1] -= T.Coef*Der[T.Pow]*Mu[T.In];
+		}
+		return;
+	}
+	if(SourceTree.IsLeaf(s))
+	{
+		for(int j = SourceTree.NodeStart[s]; j < SourceTree.NodeStart[s] + SourceTree.NodeSize[s]; j++) Near.push_back(SourceTree.Perm[j]);
+		return;
+	}
+	for(int k = 0; k < SourceTree.NodeNumSons[s]; k++) TreeTraverse(SourceTree.NodeFirstSon[s] + k, P, h, Near, Der);
+}
+
+//-------------------------------------------------------------------------
+
+TVector3d radTFMM::TreeField(const TVector3d& P, std::vector<int>& Near, std::vector<double>& Work) const
+{
+	Near.clear();
+	if(SourceTree.Size() == 0) return TVector3d(0., 0., 0.);
+	Work.resize(NumTerms(Order));
+	double h[] = {0., 0., 0.};
+	TreeTraverse(0, P, h, Near, Work.data());
+	return TVector3d(h[0], h[1], h[2]);
+}
+
+//-------------------------------------------------------------------------
+
+double radTFMM::Memory() const
+{
+	auto TreeMemory = [](const radTFMMTree& Tree)
+	{
+		return (double)Tree.Perm.size()*sizeof(int) + (double)Tree.Size()*(sizeof(TVector3d) + sizeof(double) + 5*sizeof(int));
+	};
+	auto PartMemory = [](const radTFMMParticles& Part)
+	{
+		return (double)Part.Size()*(sizeof(TVector3d) + sizeof(double) + sizeof(int)) + (double)Part.Moment.size()*sizeof(double);
+	};
+	return TreeMemory(TargetTree) + TreeMemory(SourceTree) + PartMemory(Targets) + PartMemory(Sources)
+		+ (double)(M2LSource.size() + M2LTarget.size() + NearSource.size() + NearStart.size())*sizeof(int)
+		+ (double)SourceMult.size()*sizeof(double);
+}
+
+//-------------------------------------------------------------------------
+
+double radTFMM::ExpansionMemory() const
+{
+	return (double)(TargetTree.Size() + SourceTree.Size())*NumTerms(Order)*sizeof(double);
+}
+
+//-------------------------------------------------------------------------
+// Batch field evaluation
+//-------------------------------------------------------------------------
+
+void radTFMMFieldEvaluator::CollectSources(radTg3d* g3dPtr, std::vector<std::pair<radTrans*, int> >& Trans)
+{
+	size_t AmOfOuterTrans = Trans.size();
+	for(radTlphg::iterator Iter = g3dPtr->g3dListOfTransform.begin(); Iter != g3dPtr->g3dListOfTransform.end(); ++Iter)
+		Trans.push_back(std::make_pair((radTrans*)((*Iter).Handler_g.rep), (*Iter).m));
+
+	radTGroup* GroupPtr = radTCast::GroupCast(g3dPtr);
+	if(GroupPtr != 0)
+	{
+		bool Subdivided = (radTCast::SubdividedRecMagCast(GroupPtr) != 0) || (radTCast::SubdPolyhedronCastFromGroup(GroupPtr) != 0)
+			|| (radTCast::SubdExtrPolygonCastFromGroup(GroupPtr) != 0);
+		if(Subdivided) AddImages(g3dPtr, Trans, false);
+		else
+		{
+			for(radTmhg::iterator Iter = GroupPtr->GroupMapOfHandlers.begin(); Iter != GroupPtr->GroupMapOfHandlers.end(); ++Iter)
+				CollectSources((radTg3d*)((*Iter).second.rep), Trans);
+		}
+	}
+	else
+	{
+		radTg3dRelax* g3dRelaxPtr = radTCast::g3dRelaxCast(g3dPtr);
+		bool FMMSource = (g3dRelaxPtr != 0);
+		if(FMMSource)
+		{
+			radTRecMag* RecMagPtr = radTCast::RecMagCast(g3dRelaxPtr);
+			radTPolyhedron* PolyhedronPtr = radTCast::PolyhedronCast(g3dRelaxPtr);
+			if((RecMagPtr != 0) && RecMagPtr->J_IsNotZero) FMMSource = false;
+			if((PolyhedronPtr != 0) && PolyhedronPtr->J_IsNotZero) FMMSource = false;
+		}
+		AddImages(g3dPtr, Trans, FMMSource);
+	}
+	Trans.resize(AmOfOuterTrans);
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMMFieldEvaluator::AddImages(radTg3d* g3dPtr, const std::vector<std::pair<radTrans*, int> >& Trans, bool FMMSource)
+{// Transformation with multiplicity m > 1: images T^0 ... T^(m-1); m = 1: T
+	std::vector<radTFMMSource>& vSrc = FMMSource? vFMMSrc : vDirectSrc;
+	std::vector<int> Power(Trans.size(), 0);
+	for(size_t i = 0; i < Trans.size(); i++) if(Trans[i].second <= 1) Power[i] = 1;
+	for(;;)
+	{
+		radTFMMSource Src;
+		Src.g3dPtr = g3dPtr;
+		for(size_t i = 0; i < Trans.size(); i++)
+			for(int k = 0; k < Power[i]; k++) Src.Chain.push_back(Trans[i].first);
+		vSrc.push_back(Src);
+
+		// Next combination of powers
+		size_t i = Trans.size();
+		for(;;)
+		{
+			if(i == 0) return;
+			i--;
+			if(Trans[i].second <= 1) continue;
+			if(++Power[i] < Trans[i].second) break;
+			Power[i] = 0;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMMFieldEvaluator::FieldOfSource(const radTFMMSource& Src, const TVector3d& P, TVector3d& B, TVector3d& H, const radTCompCriterium* pCompCrit)
+{
+	TVector3d ZeroVect(0., 0., 0.), LocP = P;
+	for(size_t i = 0; i < Src.Chain.size(); i++) LocP = Src.Chain[i]->TrPoint_inv(LocP);
+
+	radTFieldKey FieldKey;
+	FieldKey.B_ = FieldKey.H_ = 1;
+	radTField Field(FieldKey, LocP, ZeroVect, ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.);
+	if(pCompCrit != 0) Field.CompCriterium = *pCompCrit;
+	Src.g3dPtr->B_comp(&Field);
+
+	B = Field.B; H = Field.H;
+	for(size_t i = Src.Chain.size(); i > 0; i--)
+	{
+		B = Src.Chain[i - 1]->TrVectField(B);
+		H = Src.Chain[i - 1]->TrVectField(H);
+	}
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMMFieldEvaluator::SetupSources(radTFMM& FMM, std::vector<TVector3d>& Dip)
+{// Sources of the FMM (images of one element are consecutive) and their dipole densities
+	Dip.resize(vFMMSrc.size());
+	for(size_t s = 0; s < vFMMSrc.size();)
+	{
+		size_t e = s;
+		std::vector<std::vector<radTrans*> > Images;
+		while((e < vFMMSrc.size()) && (vFMMSrc[e].g3dPtr == vFMMSrc[s].g3dPtr)) Images.push_back(vFMMSrc[e++].Chain);
+
+		radTg3dRelax* g3dRelaxPtr = (radTg3dRelax*)vFMMSrc[s].g3dPtr;
+		FMM.Sources.AddElement(g3dRelaxPtr, Images);
+		for(size_t k = s; k < e; k++)
+		{
+			TVector3d M = g3dRelaxPtr->Magn;
+			for(size_t i = vFMMSrc[k].Chain.size(); i > 0; i--) M = vFMMSrc[k].Chain[i - 1]->TrVectField(M);
+			Dip[k] = M;
+		}
+		s = e;
+	}
+}
+
+//-------------------------------------------------------------------------
+
+int radTFMMFieldEvaluator::EvaluateField(radTg3d* obj, const std::vector<TVector3d>& ObsPoints, std::vector<TVector3d>& FieldOut, char FieldChar)
+{
+	vFMMSrc.clear();
+	vDirectSrc.clear();
+	if(obj == 0) return 0;
+
+	std::vector<std::pair<radTrans*, int> > Trans;
+	radTGroup* GroupPtr = radTCast::GroupCast(obj);
+	if((GroupPtr != 0) && (radTCast::SubdividedRecMagCast(GroupPtr) == 0) && (radTCast::SubdPolyhedronCastFromGroup(GroupPtr) == 0)
+		&& (radTCast::SubdExtrPolygonCastFromGroup(GroupPtr) == 0))
+	{
+		for(radTmhg::iterator Iter = GroupPtr->GroupMapOfHandlers.begin(); Iter != GroupPtr->GroupMapOfHandlers.end(); ++Iter)
+			CollectSources((radTg3d*)((*Iter).second.rep), Trans);
+	}
+	else
+	{// Transformations of obj itself are not applied by B_comp
+		radTlphg OwnTrans;
+		OwnTrans.swap(obj->g3dListOfTransform);
+		CollectSources(obj, Trans);
+		OwnTrans.swap(obj->g3dListOfTransform);
+	}
+	if(vFMMSrc.empty()) return 0;
+
+	radTFMM FMM(Order, Theta, LeafSize);
+	std::vector<TVector3d> Dip;
+	SetupSources(FMM, Dip);
+	for(size_t i = 0; i < ObsPoints.size(); i++) FMM.Targets.AddPoint(ObsPoints[i]);
+	FMM.Build();
+
+	std::vector<TVector3d> HFar(ObsPoints.size());
+	FMM.FarField(Dip.data(), HFar.data());
+
+	// Near elements and direct sources (B_comp of elements is not assumed to be reentrant)
+	bool OutB = (FieldChar == 'b') || (FieldChar == 'B');
+	FieldOut.resize(ObsPoints.size());
+	TVector3d B, H;
+	for(size_t i = 0; i < ObsPoints.size(); i++)
+	{
+		TVector3d Sum = HFar[i];
+		for(int k = FMM.NearStart[i]; k < FMM.NearStart[i + 1]; k++)
+		{
+			FieldOfSource(vFMMSrc[FMM.NearSource[k]], ObsPoints[i], B, H);
+			Sum += OutB? B : H;
+		}
+		for(size_t k = 0; k < vDirectSrc.size(); k++)
+		{
+			FieldOfSource(vDirectSrc[k], ObsPoints[i], B, H);
+			Sum += OutB? B : H;
+		}
+		FieldOut[i] = Sum;
+	}
+	return 1;
+}
+
+//-------------------------------------------------------------------------
+
+void radTFMMFieldEvaluator::TreeParameters(double RelPrec, int& OutOrder, double& OutTheta)
+{// Truncation error of the far field ~ 0.05 Theta^Order relative to the field magnitude; smaller Theta for higher accuracy
+	OutTheta = (RelPrec >= 1.e-04)? 0.5 : ((RelPrec >= 1.e-06)? 0.4 : 0.3);
+	OutOrder = (int)ceil(log(RelPrec/0.05)/log(OutTheta));
+	if(OutOrder < 2) OutOrder = 2;
+	if(OutOrder > 20) OutOrder = 20;
+}
+
+//-------------------------------------------------------------------------
+
+int radTFMMFieldEvaluator::EvaluateFieldTree(radTg3d* obj, const TVector3d* ObsPoints, long Np, const radTCompCriterium& CompCrit, TVector3d* B, TVector3d* H)
+{
+	vFMMSrc.clear();
+	vDirectSrc.clear();
+	if(obj == 0) return 0;
+
+	std::vector<std::pair<radTrans*, int> > Trans;
+	CollectSources(obj, Trans);
+	if((int)vFMMSrc.size() <= LeafSize) return 0;
+
+	radTFMM FMM(Order, Theta, LeafSize);
+	std::vector<TVector3d> Dip;
+	SetupSources(FMM, Dip);
+	FMM.BuildSourceTree(Dip.data());
+
+	// Points in parallel, as the direct evaluation (radTApplication::ComputeField)
+	#pragma omp parallel if(Np > 100)
+	{
+		std::vector<int> Near;
+		std::vector<double> Work;
+		TVector3d LocB, LocH;
+		#pragma omp for schedule(dynamic, 16)
+		for(long i = 0; i < Np; i++)
+		{// Far clusters do not contain the point: B = H
+			if(radYield.CancelIsRequested()) continue; // reported by the caller
+			TVector3d SumH = FMM.TreeField(ObsPoints[i], Near, Work), SumB = SumH;
+			for(int k : Near)
+			{
+				FieldOfSource(vFMMSrc[k], ObsPoints[i], LocB, LocH, &CompCrit);
+				SumB += LocB; SumH += LocH;
+			}
+			for(size_t k = 0; k < vDirectSrc.size(); k++)
+			{
+				FieldOfSource(vDirectSrc[k], ObsPoints[i], LocB, LocH, &CompCrit);
+				SumB += LocB; SumH += LocH;
+			}
+			if(B != 0) B[i] = SumB;
+			if(H != 0) H[i] = SumH;
+			radYield.ProgressAdd(1);
+		}
+	}
+	return 1;
+}
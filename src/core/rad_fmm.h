@@ -0,0 +1,214 @@
+/*-------------------------------------------------------------------------
+*
+* File name:      rad_fmm.h
+*
+* Project:        RADIA
+*
+* Description:    Cartesian-Taylor fast multipole method for the far field
+*                 of magnetized elements (relaxation and field evaluation)
+*
+* Author(s):      Radia Development Team
+*
+* First release:  2026
+*
+*------------------------------------------------------------------------*/
+
+#ifndef __RADFMM_H
+#define __RADFMM_H
+
+#include "gmvect.h"
+#include <vector>
+
+class radTg3d;
+class radTg3dRelax;
+class radTrans;
+struct radTCompCriterium;
+
+//-------------------------------------------------------------------------
+// Elements (or observation points) seen by the fast multipole method
+//
+// A particle is a volume (or a weighted point) about a centre, represented
+// by its geometric moments S_a = int (y - c)^a dV up to total order
+// MomentOrder (computed once, like the block moments of
+// radTRecMag::B_compMultipole). As a source it carries a uniform dipole
+// density d (global frame); as a target it receives the field integrated
+// over its volume (the weighted field at a point particle).
+// Radius bounds the extent of the particle about its centre.
+//-------------------------------------------------------------------------
+
+struct radTFMMParticles
+{
+	int MomentOrder;
+	std::vector<TVector3d> Centre;
+	std::vector<double> Radius;
+	std::vector<int> MomentStart;      // Moments of particle p: Moment[MomentStart[p]] ...; a single one (the weight) for points
+	std::vector<double> Moment;
+
+	radTFMMParticles(int InMomentOrder = 0) : MomentOrder(InMomentOrder) { MomentStart.push_back(0);}
+
+	int Size() const { return (int)Centre.size();}
+	bool IsPoint(int p) const { return (MomentStart[p + 1] - MomentStart[p]) == 1;}
+
+	void AddPoint(const TVector3d& P, double Weight = 1.);
+
+	// Volume given by quadrature points and weights (exact for polynomials up to MomentOrder)
+	void AddVolume(const TVector3d& InCentre, double InRadius, const TVector3d* Points, const double* Weights, int AmOfPoints);
+
+	// Relaxable element, one particle per image; an image is a chain of transformations, outermost first.
+	// Parallelepipeds and polyhedra by their exact moments, other shapes by a point dipole at their centre.
+	void AddElement(radTg3dRelax* g3dRelaxPtr, const std::vector<std::vector<radTrans*> >& Images);
+};
+
+//-------------------------------------------------------------------------
+// Fast multipole method for the field H = -grad(phi) of dipoles,
+// phi(x) = (1/4pi) int d.(x - y)/|x - y|^3 dV (Radia units: H and M in Tesla)
+//
+// Multipole and local expansions are Cartesian Taylor series of 1/r of total
+// order Order about the centres of the cluster trees (HACApK) of the targets
+// and sources. A dual-tree traversal pairs a target and a source cluster for
+// an M2L translation if (r_t + r_s) < Theta * |c_t - c_s| (radii including
+// the extent of the particles), otherwise the larger cluster is split; pairs
+// of leaves that are not separated are near pairs, left to the caller
+// (exact element kernels). Every (target, source) particle pair is thus
+// either in the far field or in the near list, exactly once.
+//
+// The dipole kernel is symmetric, so the same trees and lists give the
+// transposed operator: the dipole densities are then given on the targets
+// and the fields integrated over the sources.
+//-------------------------------------------------------------------------
+
+class radTFMM
+{
+public:
+	int Order;                       // Expansion order (total degree)
+	double Theta;                    // Separation ratio of M2L pairs
+	int LeafSize;                    // Maximum number of particles in a leaf cluster
+
+	radTFMMParticles Targets, Sources;
+
+	// Near pairs: sources NearSource[NearStart[t]] ... NearSource[NearStart[t+1]-1] of target t
+	std::vector<int> NearStart, NearSource;
+
+	// Statistics
+	long long NumM2L;                // Number of M2L cluster pairs
+	double BuildTime;                // Trees and interaction lists [s]
+
+	radTFMM(int InOrder = 8, double InTheta = 0.5, int InLeafSize = 16);
+
+	// Builds the cluster trees of Targets and Sources and the far (M2L) and near lists
+	void Build();
+
+	// Far-field part: H[t] = field of the sources (dipole densities Dip[s]) at / integrated over target t.
+	// Transposed: Dip given per target, H returned per source.
+	void FarField(const TVector3d* Dip, TVector3d* H, bool Transposed = false) const;
+
+	// Treecode: cluster tree of the Sources only, with the multipole expansions of all its clusters (P2M, M2M)
+	void BuildSourceTree(const TVector3d* Dip);
+
+	// Treecode field at P: H of the clusters with radius < Theta * distance from P (M2P);
+	// the sources of the other leaves are returned in Near. Work: expansion buffer of the caller.
+	TVector3d TreeField(const TVector3d& P, std::vector<int>& Near, std::vector<double>& Work) const;
+
+	// Memory of the trees, lists and particle moments [bytes]; expansions of one evaluation [bytes]
+	double Memory() const;
+	double ExpansionMemory() const;
+
+	// Number of expansion coefficients of total order <= n
+	static int NumTerms(int n) { return (n + 1)*(n + 2)*(n + 3)/6;}
+
+	// Monomials D^a, |a| <= n, in the order of the expansion coefficients (graded)
+	static void Monomials(const TVector3d& D, int n, double* Mono);
+
+private:
+	struct radTFMMTree
+	{
+		std::vector<int> Perm;                 // Particle at tree position
+		std::vector<TVector3d> NodeCentre;
+		std::vector<double> NodeRadius;
+		std::vector<int> NodeStart, NodeSize;  // Tree positions
+		std::vector<int> NodeFirstSon, NodeNumSons, NodeParent;  // Sons are consecutive; parents before sons
+
+		void Setup(const radTFMMParticles& Part, int LeafSize);
+		bool IsLeaf(int k) const { return NodeNumSons[k] == 0;}
+		int Size() const { return (int)NodeCentre.size();}
+	};
+	radTFMMTree TargetTree, SourceTree;
+
+	std::vector<int> M2LStart, M2LSource;          // M2L source clusters of each target cluster
+	std::vector<int> M2LTargetStart, M2LTarget;    // M2L target clusters of each source cluster (transposed)
+	std::vector<double> SourceMult;                // Multipole expansions of the source clusters (treecode)
+
+	// Exponents (Exp[3k], Exp[3k+1], Exp[3k+2]) of coefficient k; Index: inverse
+	std::vector<int> Exp, Index;
+	std::vector<int> Lower1, Lower2;        // Indices of a - e_i and a - 2e_i, i = 0, 1, 2 (-1: none)
+	int IndexOf(int a, int b, int c) const { return Index[(a*(Order + 1) + b)*(Order + 1) + c];}
+
+	struct radTShiftTerm { int Out, In, Pow; double Coef;};
+	std::vector<radTShiftTerm> ShiftTerms;  // (y-c')^a = sum C(a,g) (c-c')^(a-g) (y-c)^g, sorted by Out
+	std::vector<radTShiftTerm> M2LTerms;    // l_b += Coef T_(a+b) mu_a
+	std::vector<radTShiftTerm> DipTerms;    // mu_a += a_k d_k S_(a-e_k); H_k -= b_k l_b S_(b-e_k)
+
+	void SetupTables();
+	void Traverse(int t, int s, std::vector<std::vector<int> >& NearLeaves, std::vector<std::vector<int> >& M2L);
+	void DerivativesInvR(const TVector3d& R, double* T) const;
+	void ShiftedMoments(const radTFMMParticles& Part, int p, const TVector3d& C, double* Mono, double* S) const;
+	void Multipoles(const radTFMMTree& From, const radTFMMParticles& FromPart, const TVector3d* Dip, std::vector<double>& Mult) const;
+	void TreeTraverse(int s, const TVector3d& P, double* h, std::vector<int>& Near, double* Der) const;
+	void Pass(const radTFMMTree& From, const radTFMMParticles& FromPart, const radTFMMTree& To, const radTFMMParticles& ToPart,
+		const std::vector<int>& ListStart, const std::vector<int>& List, const TVector3d* Dip, TVector3d* H) const;
+};
+
+//-------------------------------------------------------------------------
+// Batch field evaluation of an object with the fast multipole method
+//
+// Magnetized elements (radTg3dRelax without current density) of the object
+// tree are FMM sources, one per symmetry image. Observation points near an
+// element get its exact field (B_comp); all other field sources (currents,
+// background fields, subdivided elements) are computed directly at every
+// point. As the direct evaluation (B_comp of the object), transformations
+// of the object itself are not applied.
+//
+// EvaluateFieldTree is the treecode used by the field computation of groups
+// (option PrcFar of FldCmpPrc): the magnetized elements are sorted into a
+// bounding-volume hierarchy (cluster tree) with the aggregated multipole
+// moments of every node; at each point, subtrees well separated from it are
+// evaluated by their expansions and the elements of the remaining leaves
+// exactly. As B_genComp, transformations of the object itself are applied.
+//-------------------------------------------------------------------------
+
+class radTFMMFieldEvaluator
+{
+public:
+	radTFMMFieldEvaluator(int InOrder, double InTheta, int InLeafSize) : Order(InOrder), LeafSize(InLeafSize), Theta(InTheta) {}
+
+	// H or B (FieldChar 'h' / 'b') of obj at the points; 0 if obj has no magnetized elements
+	int EvaluateField(radTg3d* obj, const std::vector<TVector3d>& ObsPoints, std::vector<TVector3d>& FieldOut, char FieldChar);
+
+	// Expansion order and separation ratio of the treecode for a relative accuracy of the far field
+	static void TreeParameters(double RelPrec, int& OutOrder, double& OutTheta);
+
+	// Treecode B and H (either may be 0) of obj at the points; 0 if obj has no more than LeafSize magnetized elements
+	int EvaluateFieldTree(radTg3d* obj, const TVector3d* ObsPoints, long Np, const radTCompCriterium& CompCrit, TVector3d* B, TVector3d* H);
+
+	int NumFMMSources() const { return (int)vFMMSrc.size();}
+	int NumDirectSources() const { return (int)vDirectSrc.size();}
+
+private:
+	int Order, LeafSize;
+	double Theta;
+
+	// Leaf of the object tree and one image of it (transformations outermost first, repeated for powers)
+	struct radTFMMSource
+	{
+		radTg3d* g3dPtr;
+		std::vector<radTrans*> Chain;
+	};
+	std::vector<radTFMMSource> vFMMSrc, vDirectSrc;
+
+	void CollectSources(radTg3d* g3dPtr, std::vector<std::pair<radTrans*, int> >& Trans);
+	void AddImages(radTg3d* g3dPtr, const std::vector<std::pair<radTrans*, int> >& Trans, bool FMMSource);
+	void SetupSources(radTFMM& FMM, std::vector<TVector3d>& Dip);
+	static void FieldOfSource(const radTFMMSource& Src, const TVector3d& P, TVector3d& B, TVector3d& H, const radTCompCriterium* pCompCrit = 0);
+};
+
+#endif
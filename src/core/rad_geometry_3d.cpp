@@ -1324,6 +1324,27 @@ void radTg3dRelax::Push_backCenterPointAndField(radTFieldKey* pFieldKey, radTVec
 	pVectPairOfVect3d->push_back(Pair);
 }
 
+//-------------------------------------------------------------------------
+
+void radTg3dRelax::B_compIntrctBatch(const TVector3d* ArrObsPoi, int AmOfObsPoi, const radTCompCriterium& CompCrit, int AmOfIntrctElemWithSym, TMatrix3d* ArrSubMatr)
+{// Generic version: one B_comp call per observation point; overridden by elements having batched kernels
+	radTFieldKey FieldKeyInteract; FieldKeyInteract.B_=FieldKeyInteract.H_=FieldKeyInteract.PreRelax_=1;
+	TVector3d ZeroVect(0.,0.,0.);
+
+	for(int i=0; i<AmOfObsPoi; i++)
+	{
+		radTField Field(FieldKeyInteract, CompCrit, ArrObsPoi[i], ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.);
+		Field.AmOfIntrctElemWithSym = AmOfIntrctElemWithSym;
+
+		B_comp(&Field);
+
+		TMatrix3d& SubMatr = ArrSubMatr[i];
+		SubMatr.Str0 = Field.B;
+		SubMatr.Str1 = Field.H;
+		SubMatr.Str2 = Field.A;
+	}
+}
+
 //-------------------------------------------------------------------------
 //-------------------------------------------------------------------------
 
@@ -30,6 +30,7 @@
 #include "rad_math_methods.h"
 
 #include <list>
+#include <type_traits>
 
 //-------------------------------------------------------------------------
 //-------------------------------------------------------------------------
@@ -173,8 +174,10 @@ public:
 	}
 	~radTg3d() {}
 
-	int Type_g() { return 1;}
-	virtual int Type_g3d() { return 0;}
+	static const int TypeID_g = 1;
+	int Type_g() { return TypeID_g;}
+	static const int TypeID_g3d = 0;
+	virtual int Type_g3d() { return TypeID_g3d;}
 
 	inline void AddTransform(int, const radThg&);
 	inline void AddTransform_OtherSide(int Multiplicity, const radThg& hg);
@@ -463,6 +466,8 @@ struct radTCompCriterium {
 
 	double WorstRelPrec;
 
+	double FarRelPrec; // Relative accuracy of the multipole far field of groups at field computation (<= 0: exact)
+
 	char BasedOnWorstRelPrec; // Used at energy - force computation
 
 	radTCompCriterium() 
@@ -477,6 +482,7 @@ struct radTCompCriterium {
 		AbsPrecTrjCoord = AbsPrecTrjAngle = -1.;
 
 		WorstRelPrec = 0.1;  // Used for Force computation through energy
+		FarRelPrec = 0.;
 		BasedOnWorstRelPrec = 0;
 
 		MltplThresh[0] = 0.; // No Computatation
@@ -701,6 +707,39 @@ inline radTField operator -(const radTField& F1, const radTField& F2)
 	return resF;
 }
 
+//-------------------------------------------------------------------------
+// Lean field accumulator of hot kernels: the quantities are fixed at compile
+// time (radTFieldB, radTFieldH, radTFieldBH, radTFieldA), members of the other
+// quantities are empty and additions to them compile to nothing. Kernels
+// test the constants B_, H_, A_ instead of radTFieldKey at run time.
+//-------------------------------------------------------------------------
+
+struct radTNoVect {
+	radTNoVect& operator +=(const TVector3d&) { return *this;}
+};
+
+template<bool InB, bool InH, bool InA> struct radTLeanField {
+	static const bool B_ = InB, H_ = InH, A_ = InA;
+	typename std::conditional<InB, TVector3d, radTNoVect>::type B;
+	typename std::conditional<InH, TVector3d, radTNoVect>::type H;
+	typename std::conditional<InA, TVector3d, radTNoVect>::type A;
+
+	void AddFrom(const radTField& F) { if(B_) B += F.B; if(H_) H += F.H; if(A_) A += F.A;}
+	void AddTo(radTField& F) const { AddVect(F.B, B); AddVect(F.H, H); AddVect(F.A, A);}
+	void AddTo(radTField& F, const TMatrix3d& MF, const TMatrix3d& MA) const { AddVect(F.B, B, MF); AddVect(F.H, H, MF); AddVect(F.A, A, MA);}
+
+private:
+	static void AddVect(TVector3d& Out, const TVector3d& V) { Out += V;}
+	static void AddVect(TVector3d& Out, const TVector3d& V, const TMatrix3d& M) { Out += M*V;}
+	static void AddVect(TVector3d&, const radTNoVect&) {}
+	static void AddVect(TVector3d&, const radTNoVect&, const TMatrix3d&) {}
+};
+
+using radTFieldB = radTLeanField<true, false, false>;
+using radTFieldH = radTLeanField<false, true, false>;
+using radTFieldBH = radTLeanField<true, true, false>;
+using radTFieldA = radTLeanField<false, false, true>;
+
 //-------------------------------------------------------------------------
 
 class radTg3dRelax : public radTg3d {
@@ -764,8 +803,10 @@ public:
 		if(pM_LinCoef != 0) delete pM_LinCoef;
 	}
 
-	int Type_g3d() { return 1;}
-	virtual int Type_g3dRelax() { return 0;}
+	static const int TypeID_g3d = 1;
+	int Type_g3d() { return TypeID_g3d;}
+	static const int TypeID_g3dRelax = 0;
+	virtual int Type_g3dRelax() { return TypeID_g3dRelax;}
 
 	void SimpleEnergyComp(radTField* FieldPtr)
 	{
@@ -791,6 +832,9 @@ public:
 
 	void Push_backCenterPointAndField(radTFieldKey*, radTVectPairOfVect3d*, radTrans*, radTg3d*, radTApplication*);
 
+	// Interaction sub-matrices (B,H,A rows of PreRelax field) of this source at many observation points (local frame)
+	virtual void B_compIntrctBatch(const TVector3d* ArrObsPoi, int AmOfObsPoi, const radTCompCriterium& CompCrit, int AmOfIntrctElemWithSym, TMatrix3d* ArrSubMatr);
+
 	virtual TVector3d& ReturnCentrPoint() { return CentrPoint;}
 	virtual radTg3dRelax* FormalIntrctMemberPtr() { return this;}
 
@@ -34,7 +34,8 @@ public:
 	radTg() {}
 	virtual ~radTg() {}
 
-	virtual int Type_g() { return 0;}
+	static const int TypeID_g = 0;
+	virtual int Type_g() { return TypeID_g;}
 	virtual void Dump(std::ostream& o, int ShortSign =0)
 	{
 		//o << "     Address: " << this << endl;
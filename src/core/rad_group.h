@@ -35,8 +35,10 @@ public:
 	radTGroup() {}
 	~radTGroup() {}
 
-	int Type_g3d() override { return 2;}
-	virtual int Type_Group() { return 0;}
+	static const int TypeID_g3d = 2;
+	int Type_g3d() override { return TypeID_g3d;}
+	static const int TypeID_Group = 0;
+	virtual int Type_Group() { return TypeID_Group;}
 
 	inline void AddElement(int, const radThg&);
 
@@ -19,6 +19,8 @@
 #include "rad_rectangular_block.h"
 #include "rad_serialization.h"
 #include "rad_geometry_3d.h"
+#include "radentry.h"
+#include "radentry_hmat.h"
 #include <iostream>
 #include <chrono>
 #include <cmath>
@@ -294,7 +296,8 @@ int radTHMatrixFieldEvaluator::Build(radTGroup* source_group)
 
 	hacapk::ControlParams params;
 	params.leaf_size = config.min_cluster_size;
-	params.eta = 2.0;  // Admissibility parameter
+	params.eta = config.eta;  // Admissibility parameter
+	params.split_type = config.split_type;
 
 	std::vector<int> indices(num_sources);
 	for(int i = 0; i < num_sources; i++) indices[i] = i;
@@ -425,7 +428,8 @@ int radTHMatrixFieldEvaluator::BuildTargetClusterTree(const std::vector<TVector3
 	// Build cluster tree using HACApK
 	hacapk::ControlParams params;
 	params.leaf_size = config.min_cluster_size;
-	params.eta = 2.0;  // Admissibility parameter
+	params.eta = config.eta;  // Admissibility parameter
+	params.split_type = config.split_type;
 
 	std::vector<int> indices(M);
 	for(int i = 0; i < M; i++) indices[i] = i;
@@ -490,7 +494,9 @@ int radTHMatrixFieldEvaluator::BuildFieldHMatrix()
 	hacapk::ControlParams params;
 	params.eps_aca = config.eps;
 	params.leaf_size = config.min_cluster_size;
-	params.eta = 2.0;  // Admissibility parameter
+	params.eta = config.eta;  // Admissibility parameter
+	params.split_type = config.split_type;
+	params.collect_stats = RadHMatrixReportStatsEnabled();  // Block statistics of the report
 
 	// Kernel function wrapper
 	auto kernel_func = [](int i, int j, void* data) -> double {
@@ -500,6 +506,7 @@ int radTHMatrixFieldEvaluator::BuildFieldHMatrix()
 	auto start_time = std::chrono::high_resolution_clock::now();
 
 	memory_usage = 0;
+	RadHMatrixReportReset(1);
 
 	// Build 3 H-matrices, one for each component
 	const char* comp_names[] = {"Hx", "Hy", "Hz"};
@@ -535,6 +542,7 @@ int radTHMatrixFieldEvaluator::BuildFieldHMatrix()
 			comp_memory += block.memory_usage();
 		}
 		memory_usage += comp_memory;
+		radHMatrixReportBlocks(1, comp, *hmat);
 
 		std::cout << "[HMatrix Field]   " << comp_names[comp] << ": "
 		          << hmat->blocks.size() << " blocks, "
@@ -553,6 +561,34 @@ int radTHMatrixFieldEvaluator::BuildFieldHMatrix()
 
 //-------------------------------------------------------------------------
 
+void radHMatrixReportBlocks(int source, int comp, const hacapk::HMatrix& hmat)
+{
+	for(size_t b = 0; b < hmat.blocks.size(); b++)
+	{
+		const hacapk::LowRankBlock& block = hmat.blocks[b];
+		hacapk::BlockStats stats;
+		if(b < hmat.stats.size()) stats = hmat.stats[b];
+
+		RadHMatrixBlockInfo info;
+		info.source = source;
+		info.comp = comp;
+		info.row_start = block.nstrtl;
+		info.num_rows = block.ndl;
+		info.col_start = block.nstrtt;
+		info.num_cols = block.ndt;
+		info.low_rank = block.is_lowrank() ? 1 : 0;
+		info.rank = block.is_lowrank() ? block.kt : 0;
+		info.kernel_calls = stats.kernel_calls;
+		info.build_time = stats.build_time;
+		info.est_error = stats.est_error;
+		info.est_norm = stats.est_norm;
+		info.memory = (double)block.memory_usage();
+		RadHMatrixReportPush(&info);
+	}
+}
+
+//-------------------------------------------------------------------------
+
 double radTHMatrixFieldEvaluator::FieldKernel(int i, int j, void* kernel_data)
 {
 	// Accurate field kernel using Radia's exact B_comp() method
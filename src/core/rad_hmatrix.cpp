@@ -239,6 +239,7 @@ int radTHMatrixFieldSource::BuildHMatrix()
 	std::cout << "  eps = " << config.eps << std::endl;
 	std::cout << "  max_rank = " << config.max_rank << std::endl;
 	std::cout << "  min_cluster_size = " << config.min_cluster_size << std::endl;
+	std::cout << "  eta = " << config.eta << std::endl;
 	std::cout << "  use_openmp = " << (config.use_openmp ? "true" : "false") << std::endl;
 
 	auto start_time = std::chrono::high_resolution_clock::now();
@@ -273,7 +274,8 @@ int radTHMatrixFieldSource::BuildHMatrix()
 		params.eps_aca = config.eps;
 		params.leaf_size = static_cast<double>(config.min_cluster_size);
 		params.aca_type = 1;  // Standard ACA
-		params.eta = 2.0;     // Distance parameter for admissibility
+		params.eta = config.eta;  // Distance parameter for admissibility
+		params.split_type = config.split_type;
 		params.print_level = 1;
 
 		if(config.use_openmp) {
@@ -37,9 +37,12 @@ namespace hacapk {
 struct radTHMatrixConfig {
 	double eps;             // ACA tolerance (default: 1e-6)
 	int max_rank;           // Maximum rank for low-rank blocks (default: 50)
-	int min_cluster_size;   // Minimum cluster size (default: 10)
+	int min_cluster_size;   // Minimum cluster size = leaf size of the cluster tree (default: 10)
 	bool use_openmp;        // Enable OpenMP parallelization (default: true)
 	int num_threads;        // Number of OpenMP threads (default: 0 = auto)
+	double eta;             // Admissibility: dist >= eta * min(diam) (default: 2.0)
+	int split_type;         // Cluster splitting: 1=longest box edge at midpoint, 2=principal axis at midpoint,
+	                        // 3=principal axis at median (default: 3)
 
 	radTHMatrixConfig()
 		: eps(1e-6)
@@ -47,6 +50,8 @@ struct radTHMatrixConfig {
 		, min_cluster_size(10)
 		, use_openmp(true)
 		, num_threads(0)
+		, eta(2.0)
+		, split_type(3)
 	{}
 };
 
@@ -96,7 +101,8 @@ public:
 	virtual ~radTHMatrixFieldSource();
 
 	// Type identifier
-	int Type_g3d() override { return 100; }  // New type for H-matrix
+	static const int TypeID_g3d = 100;
+	int Type_g3d() override { return TypeID_g3d; }  // New type for H-matrix
 
 	/**
 	 * Build H-matrix from source elements
@@ -417,4 +423,15 @@ private:
 
 //-------------------------------------------------------------------------
 
+/**
+ * Add the leaf blocks of an H-matrix to the per-block report (RadHMatrixReport)
+ *
+ * @param source 0: relaxation interaction matrix, 1: field evaluation
+ * @param comp Tensor / vector component of the H-matrix
+ * @param hmat H-matrix with construction statistics
+ */
+void radHMatrixReportBlocks(int source, int comp, const hacapk::HMatrix& hmat);
+
+//-------------------------------------------------------------------------
+
 #endif
@@ -18,12 +18,14 @@
 #include "rad_subdivided_rectangle.h"
 #include "rad_intrc_hmat.h"
 #include "radentry.h"  // For RadSolverGetHMatrixEnabled()
+#include "rad_intrc_plan.h"
+#include "rad_field_batch.h"
+#include "rad_yield.h"
 
-//-------------------------------------------------------------------------
-// Phase 2-B: Forward declaration
-//-------------------------------------------------------------------------
+#include <exception>
+#include <algorithm>
 
-static void OptimizeHMatrixParameters(int num_elements, double& eps, int& max_rank);
+extern radTYield radYield;
 
 //-------------------------------------------------------------------------
 //-------------------------------------------------------------------------
@@ -35,6 +37,7 @@ radTInteraction::radTInteraction(const radThg& In_hg, const radThg& In_hgMoreExt
 	//if(!Setup(In_hg, In_hgMoreExtSrc, InCompCriterium, InMemAllocTotAtOnce, ExtraExternFieldArrayIsNeeded, KeepTransData)) 
 	{
 		SomethingIsWrong = 1;
+		radYield.ThrowIfCancelled();
 		Send.ErrorMessage("Radia::Error118");
 		throw 0;
 	}
@@ -87,7 +90,7 @@ int radTInteraction::Setup(const radThg& In_hg, const radThg& In_hgMoreExtSrc, c
 
 	// Initialize H-matrix support
 	hmat_interaction = nullptr;
-	use_hmatrix = RadSolverGetHMatrixEnabled();  // Read global setting
+	use_hmatrix = RadSolverGetHMatrixEnabled() || RadSolverGetAutoBackend() || RadSolverGetFMMEnabled();  // Read global setting (the planner may switch back to dense)
 	geometry_hash = 0;  // Phase 2-B: Initialize geometry hash
 
 	SourceHandle = In_hg;
@@ -119,6 +122,10 @@ int radTInteraction::Setup(const radThg& In_hg, const radThg& In_hgMoreExtSrc, c
 //	if(m_rankMPI > 0) IntrctMatrMemAllocShouldBeDone = false;
 //#endif
 
+	//Bind the OpenMP threads (RadSolverNUMA) before the interaction storage is first touched,
+	//assembly and relaxation then run on the same CPUs
+	hacapk::bind_threads(RadSolverGetThreadBind());
+
 	if(IntrctMatrMemAllocShouldBeDone) //OC20122019
 	{
 		AllocateMemory(AuxOldMagnArrayIsNeeded); //In case of MPI-parallelization, this has to be executed by master only
@@ -131,6 +138,10 @@ int radTInteraction::Setup(const radThg& In_hg, const radThg& In_hgMoreExtSrc, c
 	}
 	FillInMainTransPtrArray();
 
+	//Space-filling curve order of the relaxable elements (RadSolverElemOrder); elements of subdivided blocks relaxed together stay in input order
+	vElemOrder.clear();
+	if((RadSolverGetElemOrder() != 0) && RelaxSubIntervConstrVect.empty()) ReorderRelaxElems(RadSolverGetElemOrder());
+
 	if(!SetupInteractMatrix()) { DeallocateMemory(); return 0;} //OC26122019 //Most CPU-intensive
 	//SetupInteractMatrix(); //Most CPU-intensive
 
@@ -145,6 +156,7 @@ int radTInteraction::Setup(const radThg& In_hg, const radThg& In_hgMoreExtSrc, c
 	}
 
 	mKeepTransData = KeepTransData;
+	if(radYield.CancelIsRequested()) { DeallocateMemory(); return 0;} // reported by the constructor
 	if(!KeepTransData) //OC021103
 	{
 		DestroyMainTransPtrArray();
@@ -364,20 +376,30 @@ void radTInteraction::AllocateMemory(char AuxOldMagnArrayIsNeeded)
 	vInteractMatrixPtrs.resize(AmOfMainElem, nullptr);
 	InteractMatrix = vInteractMatrixPtrs.data();
 
+	//Rows are first written by the threads multiplying them in the relaxation (static row partition),
+	//which places their memory on these threads' NUMA nodes (RadSolverNUMA)
+	bool FirstTouchByRowThreads = RadSolverGetNUMAFirstTouch() && (AmOfMainElem > 100);
+	TVector3df ZeroVectf(0.,0.,0.);
+	TMatrix3df ZeroMatrf(ZeroVectf, ZeroVectf, ZeroVectf);
+
 	if(MemAllocTotAtOnce)
 	{
-		vGenMatrStorage.resize(AmOfMainElem * AmOfMainElem);
+		vGenMatrStorage.resize((size_t)AmOfMainElem * (size_t)AmOfMainElem); //not written yet
 		TMatrix3df* GenMatrPtr = vGenMatrStorage.data();
 
+		#pragma omp parallel for schedule(static) if(FirstTouchByRowThreads)
 		for(int i=0; i<AmOfMainElem; i++)
 		{
-			InteractMatrix[i] = &(GenMatrPtr[i*AmOfMainElem]);
+			InteractMatrix[i] = &(GenMatrPtr[(size_t)i*(size_t)AmOfMainElem]);
 			vInteractMatrixPtrs[i] = InteractMatrix[i];
+			std::fill(InteractMatrix[i], InteractMatrix[i] + AmOfMainElem, ZeroMatrf);
 		}
 	}
 	else
 	{
 		vInteractMatrix.resize(AmOfMainElem);
+
+		#pragma omp parallel for schedule(static) if(FirstTouchByRowThreads)
 		for(int i=0; i<AmOfMainElem; i++)
 		{
 			vInteractMatrix[i].resize(AmOfMainElem);
@@ -458,6 +480,100 @@ void radTInteraction::FillInMainTransPtrArray()
 
 //-------------------------------------------------------------------------
 
+static unsigned long long radSpreadBits3(unsigned long long a)
+{//Inserts two zero bits after each of the lower 21 bits
+	a &= 0x1fffff;
+	a = (a | (a << 32)) & 0x1f00000000ffffULL;
+	a = (a | (a << 16)) & 0x1f0000ff0000ffULL;
+	a = (a | (a << 8)) & 0x100f00f00f00f00fULL;
+	a = (a | (a << 4)) & 0x10c30c30c30c30c3ULL;
+	a = (a | (a << 2)) & 0x1249249249249249ULL;
+	return a;
+}
+
+//-------------------------------------------------------------------------
+
+static unsigned long long radMortonKey(unsigned int x, unsigned int y, unsigned int z)
+{
+	return (radSpreadBits3(x) << 2) | (radSpreadBits3(y) << 1) | radSpreadBits3(z);
+}
+
+//-------------------------------------------------------------------------
+
+static unsigned long long radHilbertKey(unsigned int x, unsigned int y, unsigned int z)
+{//Axes to transposed Hilbert index (J. Skilling, AIP Conf. Proc. 707, 381 (2004)), then bit interleaving
+	const int nBits = 21;
+	unsigned int X[] = {x, y, z};
+	const unsigned int M = 1U << (nBits - 1);
+
+	for(unsigned int Q = M; Q > 1; Q >>= 1) //Inverse undo
+	{
+		unsigned int P = Q - 1;
+		for(int i=0; i<3; i++)
+		{
+			if(X[i] & Q) X[0] ^= P;
+			else { unsigned int t = (X[0] ^ X[i]) & P; X[0] ^= t; X[i] ^= t;}
+		}
+	}
+	X[1] ^= X[0]; X[2] ^= X[1]; //Gray encode
+	unsigned int t = 0;
+	for(unsigned int Q = M; Q > 1; Q >>= 1) if(X[2] & Q) t ^= Q - 1;
+	for(int i=0; i<3; i++) X[i] ^= t;
+
+	return radMortonKey(X[0], X[1], X[2]);
+}
+
+//-------------------------------------------------------------------------
+
+void radTInteraction::ReorderRelaxElems(int Curve)
+{//Sorts the relaxable elements along a space-filling curve through their centres, so that elements near in space
+ //are near in the interaction matrix rows, the magnetization / field arrays and the H-matrix cluster order.
+ //Must be called after FillInMainTransPtrArray and before the interaction matrix is set up.
+	vElemOrder.clear();
+	if(AmOfMainElem < 2) return;
+
+	std::vector<TVector3d> vCentr(AmOfMainElem);
+	TVector3d Min(1e+23, 1e+23, 1e+23), Max(-1e+23, -1e+23, -1e+23);
+	for(int i=0; i<AmOfMainElem; i++)
+	{
+		TVector3d P = MainTransPtrArray[i]->TrPoint(g3dRelaxPtrVect[i]->ReturnCentrPoint());
+		vCentr[i] = P;
+		Min.x = std::min(Min.x, P.x); Max.x = std::max(Max.x, P.x);
+		Min.y = std::min(Min.y, P.y); Max.y = std::max(Max.y, P.y);
+		Min.z = std::min(Min.z, P.z); Max.z = std::max(Max.z, P.z);
+	}
+	double Size = Max.x - Min.x;
+	if(Max.y - Min.y > Size) Size = Max.y - Min.y;
+	if(Max.z - Min.z > Size) Size = Max.z - Min.z;
+	double Scale = (Size > 0.)? double(0x1fffff)/Size : 0.;
+
+	std::vector<std::pair<unsigned long long, int> > vKeys(AmOfMainElem);
+	for(int i=0; i<AmOfMainElem; i++)
+	{
+		unsigned int ix = (unsigned int)((vCentr[i].x - Min.x)*Scale);
+		unsigned int iy = (unsigned int)((vCentr[i].y - Min.y)*Scale);
+		unsigned int iz = (unsigned int)((vCentr[i].z - Min.z)*Scale);
+		vKeys[i].first = (Curve == 2)? radHilbertKey(ix, iy, iz) : radMortonKey(ix, iy, iz);
+		vKeys[i].second = i;
+	}
+	std::stable_sort(vKeys.begin(), vKeys.end(), [](const std::pair<unsigned long long, int>& a, const std::pair<unsigned long long, int>& b) { return a.first < b.first;});
+
+	vElemOrder.resize(AmOfMainElem);
+	for(int i=0; i<AmOfMainElem; i++) vElemOrder[i] = vKeys[i].second;
+
+	radTVectPtrg3dRelax g3dRelaxPtrVectIn(g3dRelaxPtrVect);
+	radVectPtr_lphgPtr IntVectOfPtrToListsOfTransPtrIn(IntVectOfPtrToListsOfTransPtr);
+	std::vector<radTrans*> vMainTransPtrArrayIn(vMainTransPtrArray);
+	for(int i=0; i<AmOfMainElem; i++)
+	{//in place, MainTransPtrArray keeps pointing to vMainTransPtrArray
+		g3dRelaxPtrVect[i] = g3dRelaxPtrVectIn[vElemOrder[i]];
+		IntVectOfPtrToListsOfTransPtr[i] = IntVectOfPtrToListsOfTransPtrIn[vElemOrder[i]];
+		vMainTransPtrArray[i] = vMainTransPtrArrayIn[vElemOrder[i]];
+	}
+}
+
+//-------------------------------------------------------------------------
+
 int radTInteraction::CountRelaxElemsWithSym()
 {
 	int AmOfElemWithSym = 0;
@@ -490,7 +606,6 @@ int radTInteraction::SetupInteractMatrix() //OC26122019
 		return SetupInteractMatrix_HMatrix();
 	}
 
-	radTFieldKey FieldKeyInteract; FieldKeyInteract.B_=FieldKeyInteract.H_=FieldKeyInteract.PreRelax_=1;
 	TVector3d ZeroVect(0.,0.,0.);
 
 	//--New
@@ -503,41 +618,91 @@ int radTInteraction::SetupInteractMatrix() //OC26122019
 		//long iCntBcomp = 0;
 		//END DEBUG
 
+		//Column-oriented assembly: one source (column) is evaluated at all observation centres in one call
+		vector<TVector3d> vInitObsPoi(AmOfMainElem);
+		for(int StrNo=0; StrNo<AmOfMainElem; StrNo++)
+			vInitObsPoi[StrNo] = MainTransPtrArray[StrNo]->TrPoint((g3dRelaxPtrVect[StrNo])->ReturnCentrPoint());
+
+		vector<radTVectPtrTrans> vColTransPtrVect(AmOfMainElem);
 		for(int ColNo=0; ColNo<AmOfMainElem; ColNo++)
 		{
 			FillInTransPtrVectForElem(ColNo, 'I');
-			radTg3dRelax* g3dRelaxPtrColNo = g3dRelaxPtrVect[ColNo];
-
-			for(int StrNo=0; StrNo<AmOfMainElem; StrNo++)
-			{
-				TVector3d InitObsPoiVect = MainTransPtrArray[StrNo]->TrPoint((g3dRelaxPtrVect[StrNo])->ReturnCentrPoint());
+			vColTransPtrVect[ColNo].swap(TransPtrVect);
+		}
 
-				TMatrix3d SubMatrix(ZeroVect, ZeroVect, ZeroVect), BufSubMatrix;
-				for(unsigned i=0; i<TransPtrVect.size(); i++)
-				{
-					TVector3d ObsPoiVect = TransPtrVect[i]->TrPoint_inv(InitObsPoiVect);
+		//Consecutive columns sharing one source object (e.g. subdivided blocks with FldCmpMeth==1) keep
+		//order-dependent state in B_comp, so they form one group processed sequentially by a single thread
+		vector<int> vColGroupStart;
+		for(int ColNo=0; ColNo<AmOfMainElem; ColNo++)
+		{
+			if((ColNo == 0) || (g3dRelaxPtrVect[ColNo] != g3dRelaxPtrVect[ColNo - 1])) vColGroupStart.push_back(ColNo);
+		}
+		int AmOfColGroups = (int)vColGroupStart.size();
+		vColGroupStart.push_back(AmOfMainElem);
 
-					radTField Field(FieldKeyInteract, CompCriterium, ObsPoiVect, ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.);
-					Field.AmOfIntrctElemWithSym = AmOfElemWithSym; // New, may be changed later
+		std::exception_ptr pExcept = nullptr;
+		radYield.ProgressStart(AmOfMainElem);
 
-					g3dRelaxPtrColNo->B_comp(&Field);
+		#pragma omp parallel if(AmOfColGroups > 1 && AmOfMainElem > 100)
+		{
+			vector<TVector3d> vObsPoi;
+			vector<TMatrix3d> vSubMatr;
 
-					BufSubMatrix.Str0 = Field.B;
-					BufSubMatrix.Str1 = Field.H;
-					BufSubMatrix.Str2 = Field.A;
+			#pragma omp for schedule(dynamic)
+			for(int GrNo=0; GrNo<AmOfColGroups; GrNo++)
+			{
+				try
+				{
+					for(int ColNo=vColGroupStart[GrNo]; ColNo<vColGroupStart[GrNo + 1]; ColNo++)
+					{
+						if(radYield.CancelIsRequested()) break;
+						radTVectPtrTrans& ColTransPtrVect = vColTransPtrVect[ColNo];
+						int AmOfTrans = (int)ColTransPtrVect.size();
+						int AmOfObsPoi = AmOfMainElem*AmOfTrans;
+
+						//Observation points are ordered as in the point-by-point loop (StrNo, then symmetry)
+						vObsPoi.resize(AmOfObsPoi);
+						vSubMatr.resize(AmOfObsPoi);
+						TVector3d* tObsPoi = vObsPoi.data();
+						for(int StrNo=0; StrNo<AmOfMainElem; StrNo++)
+						{
+							for(int i=0; i<AmOfTrans; i++) *(tObsPoi++) = ColTransPtrVect[i]->TrPoint_inv(vInitObsPoi[StrNo]);
+						}
 
-					//DEBUG
-					//iCntBcomp++;
-					//END DEBUG
+						g3dRelaxPtrVect[ColNo]->B_compIntrctBatch(vObsPoi.data(), AmOfObsPoi, CompCriterium, AmOfElemWithSym, vSubMatr.data());
 
-					TransPtrVect[i]->TrMatrix(BufSubMatrix);
-					SubMatrix += BufSubMatrix;
+						TMatrix3d* tSubMatr = vSubMatr.data();
+						for(int StrNo=0; StrNo<AmOfMainElem; StrNo++)
+						{
+							TMatrix3d SubMatrix(ZeroVect, ZeroVect, ZeroVect);
+							for(int i=0; i<AmOfTrans; i++)
+							{
+								ColTransPtrVect[i]->TrMatrix(*tSubMatr);
+								SubMatrix += *(tSubMatr++);
+							}
+							MainTransPtrArray[StrNo]->TrMatrix_inv(SubMatrix);
+							InteractMatrix[StrNo][ColNo] = SubMatrix;
+						}
+						radYield.ProgressAdd(1);
+					}
+				}
+				catch(...)
+				{
+					#pragma omp critical
+					{
+						if(!pExcept) pExcept = std::current_exception();
+					}
 				}
-				MainTransPtrArray[StrNo]->TrMatrix_inv(SubMatrix);
-				InteractMatrix[StrNo][ColNo] = SubMatrix;
 			}
+		}
+
+		for(int ColNo=0; ColNo<AmOfMainElem; ColNo++)
+		{
+			TransPtrVect.swap(vColTransPtrVect[ColNo]);
 			EmptyTransPtrVect();
 		}
+		if(pExcept) std::rethrow_exception(pExcept);
+		if(radYield.CancelIsRequested()) return 0; // reported by the constructor
 
 		//DEBUG
 		//long long nTotMatrElem = ((long long)AmOfMainElem)*((long long)AmOfMainElem);
@@ -592,25 +757,7 @@ void radTInteraction::SetupExternFieldArray()
 
 void radTInteraction::AddExternFieldFromMoreExtSource()
 {
-	if(MoreExtSourceHandle.rep != 0)
-	{
-		radTFieldKey FieldKeyExtern; FieldKeyExtern.H_=1;
-		TVector3d ZeroVect(0.,0.,0.), InitObsPoiVect(0.,0.,0.);
-
-		for(int StrNo=0; StrNo<AmOfMainElem; StrNo++) 
-		{
-			radTrans* ATransPtr = MainTransPtrArray[StrNo];
-
-			InitObsPoiVect = MainTransPtrArray[StrNo]->TrPoint((g3dRelaxPtrVect[StrNo])->CentrPoint);
-			radTField Field(FieldKeyExtern, CompCriterium, InitObsPoiVect, ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.); // Improve
-
-			(static_cast<radTg3d*>(MoreExtSourceHandle.rep))->B_genComp(&Field);
-
-			//TVector3d BufVect = ExternFieldArray[StrNo];
-
-			ExternFieldArray[StrNo] += MainTransPtrArray[StrNo]->TrVectField_inv(Field.H);
-		}
-	}
+	if(MoreExtSourceHandle.rep != 0) AddMoreExternField(MoreExtSourceHandle);
 }
 
 //-------------------------------------------------------------------------
@@ -622,18 +769,19 @@ void radTInteraction::AddMoreExternField(const radThg& hExtraExtSrc)
 	radTg3d* pExtraExtSrc = static_cast<radTg3d*>(hExtraExtSrc.rep);
 
 	radTFieldKey FieldKeyExtern; FieldKeyExtern.H_=1;
-	TVector3d ZeroVect(0.,0.,0.), InitObsPoiVect(0.,0.,0.);
+	if(AmOfMainElem <= 0) return;
 
-	for(int StrNo=0; StrNo<AmOfMainElem; StrNo++) 
-	{
-		radTrans* aTransPtr = MainTransPtrArray[StrNo];
-		InitObsPoiVect = MainTransPtrArray[StrNo]->TrPoint((g3dRelaxPtrVect[StrNo])->CentrPoint);
+	// Field of the source at all element centres by its flattened evaluation plan
+	std::vector<TVector3d> vObsPoi(AmOfMainElem);
+	for(int StrNo=0; StrNo<AmOfMainElem; StrNo++) vObsPoi[StrNo] = MainTransPtrArray[StrNo]->TrPoint((g3dRelaxPtrVect[StrNo])->CentrPoint);
+	std::vector<radTField> vField(AmOfMainElem);
 
-		radTField Field(FieldKeyExtern, CompCriterium, InitObsPoiVect, ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.); // Improve
-		pExtraExtSrc->B_genComp(&Field);
+	radTFieldPlan Plan;
+	Plan.Setup(pExtraExtSrc, FieldKeyExtern, CompCriterium);
+	radYield.ProgressStart(AmOfMainElem);
+	Plan.Compute(vObsPoi.data(), AmOfMainElem, vField.data());
 
-		ExternFieldArray[StrNo] += MainTransPtrArray[StrNo]->TrVectField_inv(Field.H);
-	}
+	for(int StrNo=0; StrNo<AmOfMainElem; StrNo++) ExternFieldArray[StrNo] += MainTransPtrArray[StrNo]->TrVectField_inv(vField[StrNo].H);
 }
 
 //-------------------------------------------------------------------------
@@ -1120,6 +1268,11 @@ void radTInteraction::DumpBin(CAuxBinStrVect& oStr, vector<int>& vElemKeysOut, m
 
 	//short MemAllocTotAtOnce;
 	oStr << MemAllocTotAtOnce;
+
+	//std::vector<int> vElemOrder;
+	int size_vElemOrder = (int)vElemOrder.size();
+	oStr << size_vElemOrder;
+	for(int k=0; k<size_vElemOrder; k++) oStr << vElemOrder[k];
 }
 
 //-------------------------------------------------------------------------
@@ -1447,6 +1600,12 @@ radTInteraction::radTInteraction(CAuxBinStrVect& inStr, map<int, int>& mKeysOldN
 
 	//short MemAllocTotAtOnce;
 	inStr >> MemAllocTotAtOnce;
+
+	//std::vector<int> vElemOrder;
+	int size_vElemOrder = 0;
+	inStr >> size_vElemOrder;
+	vElemOrder.resize(size_vElemOrder);
+	for(int k=0; k<size_vElemOrder; k++) inStr >> vElemOrder[k];
 }
 
 //-------------------------------------------------------------------------
@@ -1498,26 +1657,39 @@ int radTInteraction::SetupInteractMatrix_HMatrix()
 			}
 		}
 
-		// Phase 2-B: Adaptive parameter selection based on problem size
-		double optimized_eps;
-		int optimized_max_rank;
-		OptimizeHMatrixParameters(AmOfMainElem, optimized_eps, optimized_max_rank);
-
 		// Create H-matrix configuration
 		radTHMatrixSolverConfig config;
 
-		// Use user-specified parameters if set, otherwise use optimized values
+		// User-specified parameters, or tuning for a target error (RadSolverHMatrixAccuracy, or eps <= 0)
 		double user_eps = RadSolverGetHMatrixEps();
 		int user_max_rank = RadSolverGetHMatrixMaxRank();
-
-		config.eps = (user_eps > 0) ? user_eps : optimized_eps;
-		config.max_rank = (user_max_rank > 0) ? user_max_rank : optimized_max_rank;
-		config.min_cluster_size = 10;
+		double target_error = RadSolverGetHMatrixTargetError();
+		if((target_error <= 0.) && (user_eps <= 0.)) target_error = 1e-3;
+
+		if(user_eps > 0) config.eps = user_eps;
+		if(user_max_rank > 0) config.max_rank = user_max_rank;
+		if(target_error > 0.)
+		{// Start from the parameters tuned for the last relaxation, otherwise from eps = target
+			if(!RadSolverGetHMatrixTunedStart(target_error, config.eps, config.max_rank)) config.eps = target_error;
+		}
+		config.min_cluster_size = RadSolverGetHMatrixLeafSize();
+		config.eta = RadSolverGetHMatrixEta();
+		config.split_type = RadSolverGetHMatrixSplitType();
+		config.use_h2 = RadSolverGetHMatrixH2();
 		config.use_openmp = true;
 		config.num_threads = 0;  // Auto-detect
 
+		// Fast multipole operator: no tuning and no backend choice
+		config.use_fmm = RadSolverGetFMMEnabled();
+		config.fmm_order = RadSolverGetFMMOrder();
+		config.fmm_theta = RadSolverGetFMMTheta();
+		config.fmm_leaf_size = RadSolverGetFMMLeafSize();
+		if(config.use_fmm) target_error = 0.;
+
 		std::cout << "[Phase 2-B] H-matrix parameters: eps=" << config.eps
 		          << ", max_rank=" << config.max_rank
+		          << ", eta=" << config.eta
+		          << ", leaf_size=" << config.min_cluster_size
 		          << " (N=" << AmOfMainElem << ")" << std::endl;
 
 		// Create H-matrix interaction object (only if not exists)
@@ -1526,8 +1698,38 @@ int radTInteraction::SetupInteractMatrix_HMatrix()
 			hmat_interaction = new radTHMatrixInteraction(this, config);
 		}
 
+		// Cost-model choice between dense, H-matrix and H2-matrix (RadSolverAuto)
+		if(RadSolverGetAutoBackend() && !config.use_fmm && !hmat_interaction->is_built)
+		{
+			double memory_budget = RadSolverGetMemoryBudget()*1048576.;
+			if(memory_budget <= 0.) memory_budget = 0.5*radPhysicalMemory();
+
+			radTInteractionPlan plan;
+			radPlanInteraction(*hmat_interaction, memory_budget, RadSolverGetPlanIterations(), plan);
+			plan.Print();
+
+			double arPlan[radTInteractionPlan::ArraySize];
+			plan.GetArray(arPlan);
+			RadSolverSetPlan(arPlan, radTInteractionPlan::ArraySize);
+
+			if(plan.backend == radTInteractionPlan::Dense)
+			{
+				delete hmat_interaction;
+				hmat_interaction = nullptr;
+				use_hmatrix = false;
+				return SetupInteractMatrix();
+			}
+			hmat_interaction->config.use_h2 = (plan.backend == radTInteractionPlan::H2Matrix);
+		}
+
 		// Build H-matrix (BuildHMatrix has internal is_built check)
-		int result = hmat_interaction->BuildHMatrix();
+		int result = 0;
+		if((target_error > 0.) && !hmat_interaction->is_built)
+		{
+			result = hmat_interaction->BuildTuned(target_error);
+			if(result != 0) RadSolverSetHMatrixTuned(target_error, hmat_interaction->config.eps, hmat_interaction->config.max_rank, hmat_interaction->est_error);
+		}
+		else result = hmat_interaction->BuildHMatrix();
 
 		if(result != 0)
 		{
@@ -1579,38 +1781,38 @@ void radTInteraction::DefineFieldArray_HMatrix(const TVector3d* MagnArray, TVect
 	}
 }
 
-//-------------------------------------------------------------------------
-// Phase 2-B: Adaptive Parameter Selection
 //-------------------------------------------------------------------------
 
-static void OptimizeHMatrixParameters(int num_elements, double& eps, int& max_rank)
-{
-	// Automatically adjust H-matrix parameters based on problem size
-	// Trade-off: accuracy vs construction time
-
-	if(num_elements < 200)
-	{
-		// Don't use H-matrix (handled by threshold check)
-		eps = 1e-4;
-		max_rank = 30;
-	}
-	else if(num_elements < 500)
+void radTInteraction::MatVec(const TVector3d* MagnArray, TVector3d* FieldArray, bool Transposed)
+{// FieldArray = N * MagnArray (Transposed: N^T * MagnArray), external field not added;
+ // the same interaction matrix serves both products, no re-assembly with swapped roles
+	if(use_hmatrix && (hmat_interaction != nullptr))
 	{
-		// Medium problems: Balanced accuracy/speed
-		eps = 1e-4;
-		max_rank = 30;
+		hmat_interaction->MatVec(MagnArray, FieldArray, Transposed);
+		return;
 	}
-	else if(num_elements < 1000)
-	{
-		// Large problems: Slightly favor speed
-		eps = 2e-4;  // 2x relaxed tolerance
-		max_rank = 25;
-	}
-	else
+
+	#pragma omp parallel for schedule(static) if(AmOfMainElem > 100)
+	for(int StrNo=0; StrNo<AmOfMainElem; StrNo++)
 	{
-		// Very large problems: Aggressive compression
-		eps = 5e-4;  // 5x relaxed tolerance
-		max_rank = 20;
+		TVector3d H(0.,0.,0.);
+		if(Transposed)
+		{// blocks of N^T are (N_ji)^T
+			for(int ColNo=0; ColNo<AmOfMainElem; ColNo++)
+			{
+				const TMatrix3df& N = InteractMatrix[ColNo][StrNo];
+				const TVector3d& M = MagnArray[ColNo];
+				H.x += N.Str0.x*M.x + N.Str1.x*M.y + N.Str2.x*M.z;
+				H.y += N.Str0.y*M.x + N.Str1.y*M.y + N.Str2.y*M.z;
+				H.z += N.Str0.z*M.x + N.Str1.z*M.y + N.Str2.z*M.z;
+			}
+		}
+		else
+		{
+			TMatrix3df *pLineInteractMatrix = InteractMatrix[StrNo];
+			for(int ColNo=0; ColNo<AmOfMainElem; ColNo++) H += pLineInteractMatrix[ColNo]*MagnArray[ColNo];
+		}
+		FieldArray[StrNo] = H;
 	}
 }
 
@@ -25,6 +25,7 @@
 
 #include <sstream>
 #include <vector>
+#include <memory>
 
 //-------------------------------------------------------------------------
 //-------------------------------------------------------------------------
@@ -132,6 +133,20 @@ struct iterator_traits <radTRelaxSubInterval*> {
 */
 #endif
 
+//-------------------------------------------------------------------------
+// Allocator leaving value-initialized elements unwritten, so that large
+// storage can be first touched by the threads that use it (NUMA placement)
+//-------------------------------------------------------------------------
+
+template<class T> struct radTFirstTouchAllocator : std::allocator<T> {
+	template<class U> struct rebind { typedef radTFirstTouchAllocator<U> other; };
+	radTFirstTouchAllocator() {}
+	template<class U> radTFirstTouchAllocator(const radTFirstTouchAllocator<U>&) {}
+
+	template<class U> void construct(U*) {}
+	template<class U, class... Args> void construct(U* p, Args&&... args) { ::new((void*)p) U(std::forward<Args>(args)...);}
+};
+
 //-------------------------------------------------------------------------
 
 class radTInteraction : public radTg {
@@ -146,7 +161,7 @@ class radTInteraction : public radTg {
 
 	std::vector<std::vector<TMatrix3df>> vInteractMatrix;
 	std::vector<TMatrix3df*> vInteractMatrixPtrs;
-	std::vector<TMatrix3df> vGenMatrStorage; // Storage for MemAllocTotAtOnce mode
+	std::vector<TMatrix3df, radTFirstTouchAllocator<TMatrix3df>> vGenMatrStorage; // Storage for MemAllocTotAtOnce mode
 	TMatrix3df** InteractMatrix; //OC250504
 	//TMatrix3d** InteractMatrix; //OC250504
 
@@ -171,6 +186,7 @@ class radTInteraction : public radTg {
 	radTVectRelaxSubInterval RelaxSubIntervConstrVect; // New
 	std::vector<radTrans*> vMainTransPtrArray;
 	radTrans** MainTransPtrArray;
+	std::vector<int> vElemOrder; // Input number of each relaxable element after ReorderRelaxElems (empty: input order)
 
 	radTCast Cast;
 	radTSend Send;
@@ -220,10 +236,14 @@ public:
 	double CalcQuadNewOldMagnDif();
 	int CountRelaxElemsWithSym();
 	int OutAmOfRelaxObjs() { return AmOfMainElem;}
+	void ReorderRelaxElems(int Curve); // Space-filling curve order of relaxable elements: 1 - Morton, 2 - Hilbert
+	bool ElemsReordered() { return !vElemOrder.empty();}
+	int InputElemNo(int i) { return vElemOrder.empty()? i : vElemOrder[i];}
 	void FindMaxModMandH(double& MaxModM, double& MaxModH);
 
 	// H-matrix support methods
 	void DefineFieldArray_HMatrix(const TVector3d* MagnArray, TVector3d* FieldArray);
+	void MatVec(const TVector3d* MagnArray, TVector3d* FieldArray, bool Transposed=false); // N*M or N^T*M (dense or H-matrix)
 	void EnableHMatrix(bool enable, double eps=1e-6, int max_rank=50);
 	size_t ComputeGeometryHash();  // Phase 2-B: Compute hash of geometry for cache validation
 
@@ -249,7 +269,8 @@ public:
 	int DumpBinParseSourceHandle(CAuxBinStrVect& inStr, map<int, int>& mKeysOldNew, radTmhg& gMapOfHandlers, bool do_g3dCast, bool do_g3dRelaxCast, radThg& out_hg);
 	void DumpBinParseVectOfPtrToListsOfTransPtr(CAuxBinStrVect& inStr, map<int, int>& mKeysOldNew, radTmhg& gMapOfHandlers, radVectPtr_lphgPtr& VectOfPtrToListsOfTransPtr);
 
-	int Type_g() { return 4;}
+	static const int TypeID_g = 4;
+	int Type_g() { return TypeID_g;}
 
 	inline void ResetM();
 	inline void ResetAuxParam();
@@ -281,7 +302,9 @@ public:
 	friend class radTRelaxationMethNo_a5;
 	friend class radTRelaxationMethNo_7;
 	friend class radTRelaxationMethNo_8;
+	friend class radTRelaxationMethNo_9;
 	friend class radTHMatrixInteraction;
+	friend class radTHMatrixLUSolver;
 };
 
 //-------------------------------------------------------------------------
@@ -528,6 +551,12 @@ inline void radTInteraction::ShowInteractVector(char Ch)
 		default :
 			Vect3dPtr = NewFieldArray; break;
 	}
+	if(!vElemOrder.empty())
+	{
+		std::vector<TVector3d> vInputOrder(AmOfMainElem);
+		for(int i=0; i<AmOfMainElem; i++) vInputOrder[vElemOrder[i]] = Vect3dPtr[i];
+		Send.ArrayOfVector3d(vInputOrder.data(), AmOfMainElem); return;
+	}
 	Send.ArrayOfVector3d(Vect3dPtr, AmOfMainElem);
 }
 
@@ -535,6 +564,15 @@ inline void radTInteraction::ShowInteractVector(char Ch)
 
 inline void radTInteraction::ShowInteractMatrix()
 {
+	if(!vElemOrder.empty())
+	{
+		std::vector<TMatrix3df> vInputOrder((size_t)AmOfMainElem*AmOfMainElem);
+		std::vector<TMatrix3df*> vRowPtrs(AmOfMainElem);
+		for(int i=0; i<AmOfMainElem; i++) vRowPtrs[i] = &vInputOrder[(size_t)i*AmOfMainElem];
+		for(int i=0; i<AmOfMainElem; i++)
+			for(int j=0; j<AmOfMainElem; j++) vRowPtrs[vElemOrder[i]][vElemOrder[j]] = InteractMatrix[i][j];
+		Send.MatrixOfMatrix3d(vRowPtrs.data(), AmOfMainElem, AmOfMainElem); return;
+	}
 	Send.MatrixOfMatrix3d(InteractMatrix, AmOfMainElem, AmOfMainElem);
 }
 
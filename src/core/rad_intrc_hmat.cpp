@@ -16,19 +16,57 @@
 *-------------------------------------------------------------------------*/
 
 #include "rad_intrc_hmat.h"
+#include "rad_hmatrix.h"
+#include "radentry.h"
+#include "radentry_hmat.h"
 #include "rad_geometry_3d.h"
 #include "rad_group.h"
 #include "rad_transform_def.h"
+#include "rad_material_def.h"
 #include <cmath>
 #include <cstring>
 #include <iostream>
 #include <chrono>
 #include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <exception>
+#include <random>
 
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
+//-------------------------------------------------------------------------
+// H-matrices of the last relaxation, kept for incremental updates
+//-------------------------------------------------------------------------
+
+struct radTHMatrixUpdateCache
+{
+	radTHMatrixSolverConfig config;
+	std::vector<radTg3dRelax*> elem_ptrs;
+	std::vector<double> elem_signature;
+	std::unique_ptr<hacapk::HMatrix> hmat[9];
+
+	void Clear()
+	{
+		elem_ptrs.clear();
+		elem_signature.clear();
+		for(int idx = 0; idx < 9; idx++) hmat[idx].reset();
+	}
+};
+
+static radTHMatrixUpdateCache& UpdateCache()
+{// Never destroyed: interactions still held by the application are deleted during static destruction
+	static radTHMatrixUpdateCache* cache = new radTHMatrixUpdateCache();
+	return *cache;
+}
+
+void radTHMatrixInteraction::ReleaseUpdateCache()
+{
+	UpdateCache().Clear();
+}
+
 //-------------------------------------------------------------------------
 // Constructor
 //-------------------------------------------------------------------------
@@ -40,6 +78,9 @@ radTHMatrixInteraction::radTHMatrixInteraction(radTInteraction* intrct, const ra
 	elem_coords = nullptr;
 	elem_ptrs = nullptr;
 	is_built = false;
+	est_error = -1.;
+	sym_order = 1;
+	num_updated_elem = -1;
 	memory_used = 0;
 	compression_ratio = 0.0;
 	construction_time = 0.0;
@@ -54,6 +95,17 @@ radTHMatrixInteraction::radTHMatrixInteraction(radTInteraction* intrct, const ra
 
 radTHMatrixInteraction::~radTHMatrixInteraction()
 {
+	// Keep the H-matrices for an incremental update in the next relaxation
+	if(is_built && !config.use_h2 && ((int)elem_signature.size() == n_elem*ElemSignatureSize))
+	{
+		radTHMatrixUpdateCache& cache = UpdateCache();
+		cache.Clear();
+		cache.config = config;
+		cache.elem_ptrs.assign(elem_ptrs, elem_ptrs + n_elem);
+		cache.elem_signature.swap(elem_signature);
+		for(int idx = 0; idx < 9; idx++) cache.hmat[idx] = std::move(hmat[idx]);
+	}
+
 	// Clean up allocated memory
 	if(elem_coords != nullptr)
 	{
@@ -67,8 +119,13 @@ radTHMatrixInteraction::~radTHMatrixInteraction()
 		elem_ptrs = nullptr;
 	}
 
-	// Note: H-matrix data structures will be cleaned up here
-	// when HACApK integration is complete
+	// Release cached symmetry transformations (owned by this object)
+	for(size_t j = 0; j < cached_trans_vect.size(); j++)
+	{
+		if(cached_trans_vect[j].empty()) continue;
+		intrct_ptr->TransPtrVect.swap(cached_trans_vect[j]);
+		intrct_ptr->EmptyTransPtrVect();
+	}
 }
 
 //-------------------------------------------------------------------------
@@ -124,8 +181,11 @@ void radTHMatrixInteraction::ExtractElementData()
 	// Initialize HACApK parameters
 	hacapk_params.eps_aca = config.eps;
 	hacapk_params.leaf_size = config.min_cluster_size;
-	hacapk_params.eta = 1.5;  // Admissibility parameter (Phase 1: was 0.8 → 1.5 for better compression)
+	hacapk_params.eta = config.eta;  // Admissibility parameter
+	hacapk_params.split_type = config.split_type;
 	hacapk_params.aca_type = 2;  // Use ACA+ (improved version)
+	hacapk_params.max_rank = config.max_rank;  // Block-cluster tree (H2-matrix construction)
+	hacapk_params.collect_stats = RadHMatrixReportStatsEnabled();  // Block statistics of the report
 	hacapk_params.nthr = config.num_threads;
 	if(hacapk_params.nthr <= 0)
 	{
@@ -144,10 +204,70 @@ void radTHMatrixInteraction::ExtractElementData()
 	for(int j = 0; j < n_elem; j++)
 	{
 		intrct_ptr->FillInTransPtrVectForElem(j, 'I');
-		cached_trans_vect[j] = intrct_ptr->TransPtrVect;  // Copy the vector
-		intrct_ptr->EmptyTransPtrVect();
+		cached_trans_vect[j].swap(intrct_ptr->TransPtrVect);  // Take ownership (released in destructor)
 	}
 	std::cout << "Cached " << n_elem << " transformation lists" << std::endl;
+
+	CollectSymmetryImages();
+}
+
+//-------------------------------------------------------------------------
+
+void radTHMatrixInteraction::CollectSymmetryImages()
+{
+	hacapk_params.target_images.clear();
+	sym_order = 1;
+
+	double size = 0.;
+	for(int i = 0; i < 3*n_elem; i++) size = std::max(size, fabs(elem_coords[i]));
+	const double tol = 1e-9;
+	const double tol_b = tol*((size > 0.) ? size : 1.);
+
+	const TVector3d Basis[] = {TVector3d(0., 0., 0.), TVector3d(1., 0., 0.), TVector3d(0., 1., 0.), TVector3d(0., 0., 1.)};
+	for(int j = 0; j < n_elem; j++)
+	{
+		const std::vector<radTrans*>& trans_vect = cached_trans_vect[j];
+		sym_order = std::max(sym_order, (int)trans_vect.size());
+		radTrans* main_trans = intrct_ptr->MainTransPtrArray[j];
+
+		for(size_t k = 0; k < trans_vect.size(); k++)
+		{
+			// Affine map from the element centre (main transformation) to the centre of image k
+			TVector3d P[4];
+			for(int c = 0; c < 4; c++)
+			{
+				TVector3d x = (main_trans != nullptr) ? main_trans->TrPoint_inv(Basis[c]) : Basis[c];
+				P[c] = trans_vect[k]->TrPoint(x);
+			}
+			std::array<double, 12> map;
+			for(int c = 0; c < 3; c++)
+			{
+				TVector3d col = P[c + 1] - P[0];
+				map[c] = col.x; map[3 + c] = col.y; map[6 + c] = col.z;
+			}
+			map[9] = P[0].x; map[10] = P[0].y; map[11] = P[0].z;
+
+			auto same = [&](const std::array<double, 12>& a, const std::array<double, 12>& b)
+			{
+				for(int m = 0; m < 9; m++) if(fabs(a[m] - b[m]) > tol) return false;
+				for(int m = 9; m < 12; m++) if(fabs(a[m] - b[m]) > tol_b) return false;
+				return true;
+			};
+			const std::array<double, 12> identity = {1., 0., 0., 0., 1., 0., 0., 0., 1., 0., 0., 0.};
+			if(same(map, identity)) continue;
+
+			bool found = false;
+			for(const std::array<double, 12>& image : hacapk_params.target_images)
+				if(same(map, image)) { found = true; break;}
+			if(!found) hacapk_params.target_images.push_back(map);
+		}
+	}
+
+	if(sym_order > 1)
+	{
+		std::cout << "Symmetry: up to " << sym_order << " images per element, "
+		          << hacapk_params.target_images.size() << " image maps in the block admissibility" << std::endl;
+	}
 }
 
 //-------------------------------------------------------------------------
@@ -166,6 +286,21 @@ int radTHMatrixInteraction::BuildHMatrix()
 
 	auto t_start = std::chrono::high_resolution_clock::now();
 
+	if(config.use_fmm)
+	{
+		try
+		{
+			if(BuildFMM()) return 1;
+		}
+		catch(const std::exception& e)
+		{
+			std::cerr << "FMM construction failed: " << e.what() << std::endl;
+		}
+		std::cout << "FMM not applicable, building H-matrices" << std::endl;
+		config.use_fmm = false;
+		fmm.reset();
+	}
+
 	try
 	{
 		std::cout << "\n========================================" << std::endl;
@@ -175,83 +310,118 @@ int radTHMatrixInteraction::BuildHMatrix()
 		std::cout << "ACA tolerance: " << hacapk_params.eps_aca << std::endl;
 		std::cout << "Admissibility param: " << hacapk_params.eta << std::endl;
 		std::cout << "Min cluster size: " << hacapk_params.leaf_size << std::endl;
+		std::cout << "Cluster splitting: " << hacapk_params.split_type << std::endl;
+		std::cout << "Storage: " << (config.use_h2 ? "H2-matrix (nested cluster bases)" : "H-matrix") << std::endl;
 		std::cout << "OpenMP threads: " << hacapk_params.nthr << std::endl;
 
-		// Build 9 H-matrices for the 3x3 tensor interaction matrix
-		// Each H-matrix corresponds to one tensor component M[row][col]
-		std::cout << "\nBuilding 9 H-matrices (3x3 tensor components)";
-		if(config.use_openmp && n_elem > 100)
-		{
-			std::cout << " in parallel..." << std::endl;
-		}
-		else
-		{
-			std::cout << " sequentially..." << std::endl;
-		}
-
 		// Thread-safe memory accumulation (each component stores its own memory usage)
 		std::vector<size_t> memory_per_component(9);
 		memory_used = 0;
 
-		// Parallel construction of 9 H-matrices
-		// Use dynamic scheduling for load balancing (different components may have different ranks)
-		// Only parallelize for large problems (n_elem > 100) to avoid OpenMP overhead
-		#pragma omp parallel for schedule(dynamic) if(config.use_openmp && n_elem > 100)
-		for(int idx = 0; idx < 9; idx++)
-		{
-			int row = idx / 3;
-			int col = idx % 3;
+		// Moved/changed elements only: update the H-matrices of the last relaxation
+		if(!config.use_h2) ComputeElementSignatures();
+		bool updated = !config.use_h2 && UpdateFromCache(memory_per_component);
+		UpdateCache().Clear();
 
-			// Thread-safe output (critical section)
-			#pragma omp critical
+		if(!updated)
+		{
+			// Build 9 H-matrices for the 3x3 tensor interaction matrix
+			// Each H-matrix corresponds to one tensor component M[row][col]
+			std::cout << "\nBuilding 9 H-matrices (3x3 tensor components)";
+			if(config.use_openmp && n_elem > 100)
+			{
+				std::cout << " in parallel..." << std::endl;
+			}
+			else
 			{
-				std::cout << "  Component [" << row << "][" << col << "]... " << std::flush;
+				std::cout << " sequentially..." << std::endl;
 			}
 
-			// Prepare kernel data
-			KernelData kdata;
-			kdata.hmat_ptr = this;
-			kdata.tensor_row = row;
-			kdata.tensor_col = col;
-
-			// Build H-matrix for this tensor component
-			// Each thread builds its own H-matrix independently
-			hmat[idx] = hacapk::build_hmatrix(
-				points,             // Source points
-				points,             // Target points (same for self-interaction)
-				KernelFunction,     // Kernel function callback
-				&kdata,             // User data
-				hacapk_params       // Control parameters
-			);
-
-			if(!hmat[idx])
+			// Parallel construction of 9 H-matrices
+			// Use dynamic scheduling for load balancing (different components may have different ranks)
+			// Only parallelize for large problems (n_elem > 100) to avoid OpenMP overhead
+			#pragma omp parallel for schedule(dynamic) if(config.use_openmp && n_elem > 100)
+			for(int idx = 0; idx < 9; idx++)
 			{
+				int row = idx / 3;
+				int col = idx % 3;
+
+				// Thread-safe output (critical section)
 				#pragma omp critical
 				{
-					std::cerr << "Failed to build H-matrix for component ["
-					          << row << "][" << col << "]" << std::endl;
+					std::cout << "  Component [" << row << "][" << col << "]... " << std::flush;
 				}
-				throw std::runtime_error("Failed to build H-matrix for component ["
-				                         + std::to_string(row) + "][" + std::to_string(col) + "]");
-			}
 
-			// Store memory usage (thread-safe: each thread writes to different index)
-			memory_per_component[idx] = hmat[idx]->memory_usage();
+				// Prepare kernel data
+				KernelData kdata;
+				kdata.hmat_ptr = this;
+				kdata.tensor_row = row;
+				kdata.tensor_col = col;
 
-			// Thread-safe output (critical section)
-			#pragma omp critical
-			{
-				std::cout << "rank=" << hmat[idx]->ktmax
-				          << ", blocks=" << hmat[idx]->nlf
-				          << ", memory=" << (hmat[idx]->memory_usage() / 1024) << " KB" << std::endl;
+				// H2-matrix: block-cluster tree recompressed into nested cluster bases
+				if(config.use_h2)
+				{
+					h2mat[idx] = hacapk::build_h2matrix(points, KernelFunction, &kdata, hacapk_params);
+
+					memory_per_component[idx] = h2mat[idx]->memory_usage();
+
+					#pragma omp critical
+					{
+						std::cout << "rank=" << h2mat[idx]->ktmax
+						          << ", far blocks=" << h2mat[idx]->far.size()
+						          << ", memory=" << (h2mat[idx]->memory_usage() / 1024) << " KB" << std::endl;
+					}
+					continue;
+				}
+
+				// Build H-matrix for this tensor component
+				// Each thread builds its own H-matrix independently
+				hmat[idx] = hacapk::build_hmatrix(
+					points,             // Source points
+					points,             // Target points (same for self-interaction)
+					KernelFunction,     // Kernel function callback
+					&kdata,             // User data
+					hacapk_params       // Control parameters
+				);
+
+				if(!hmat[idx])
+				{
+					#pragma omp critical
+					{
+						std::cerr << "Failed to build H-matrix for component ["
+						          << row << "][" << col << "]" << std::endl;
+					}
+					throw std::runtime_error("Failed to build H-matrix for component ["
+					                         + std::to_string(row) + "][" + std::to_string(col) + "]");
+				}
+
+				// Store memory usage (thread-safe: each thread writes to different index)
+				memory_per_component[idx] = hmat[idx]->memory_usage();
+
+				// Thread-safe output (critical section)
+				#pragma omp critical
+				{
+					std::cout << "rank=" << hmat[idx]->ktmax
+					          << ", blocks=" << hmat[idx]->nlf
+					          << ", memory=" << (hmat[idx]->memory_usage() / 1024) << " KB" << std::endl;
+				}
 			}
 		}
 
+		// Re-allocate the block factors by the threads applying them in hmatrix_matvec (RadSolverNUMA)
+		if(RadSolverGetNUMAFirstTouch())
+		{
+			for(int idx = 0; idx < 9; idx++) if(hmat[idx]) hacapk::hmatrix_first_touch(*hmat[idx]);
+		}
+
 		// Sum up memory usage from all components (after parallel region)
+		RadHMatrixReportReset(0);
 		for(int idx = 0; idx < 9; idx++)
 		{
 			memory_used += memory_per_component[idx];
+			if(hmat[idx]) radHMatrixReportBlocks(0, idx, *hmat[idx]);
 		}
+		RadHMatrixReportUpdatedElem(num_updated_elem);
 
 		is_built = true;
 
@@ -281,6 +451,491 @@ int radTHMatrixInteraction::BuildHMatrix()
 	}
 }
 
+//-------------------------------------------------------------------------
+// Fast multipole operator
+//-------------------------------------------------------------------------
+
+static TMatrix3d LinearMapOfVectField(radTrans* TransPtr, bool Inverse)
+{// Matrix of TrVectField (TrVectField_inv) with columns the images of the unit vectors
+	TVector3d E[] = {TVector3d(1., 0., 0.), TVector3d(0., 1., 0.), TVector3d(0., 0., 1.)}, C[3];
+	for(int c = 0; c < 3; c++)
+	{
+		if(TransPtr == nullptr) C[c] = E[c];
+		else C[c] = Inverse? TransPtr->TrVectField_inv(E[c]) : TransPtr->TrVectField(E[c]);
+	}
+	return TMatrix3d(TVector3d(C[0].x, C[1].x, C[2].x), TVector3d(C[0].y, C[1].y, C[2].y), TVector3d(C[0].z, C[1].z, C[2].z));
+}
+
+static inline TVector3d MulTransposed(const TMatrix3d& M, const TVector3d& V)
+{
+	return V.x*M.Str0 + V.y*M.Str1 + V.z*M.Str2;
+}
+
+//-------------------------------------------------------------------------
+
+bool radTHMatrixInteraction::BuildFMM()
+{
+	// Consecutive elements sharing one source object (subdivided blocks relaxed together) have order-dependent B_comp state
+	for(int j = 1; j < n_elem; j++) if(elem_ptrs[j] == elem_ptrs[j - 1]) return false;
+
+	auto t_start = std::chrono::high_resolution_clock::now();
+
+	std::cout << "\n========================================" << std::endl;
+	std::cout << "Building FMM Operator for Relaxation Solver" << std::endl;
+	std::cout << "========================================" << std::endl;
+	std::cout << "Number of elements: " << n_elem << std::endl;
+	std::cout << "Expansion order: " << config.fmm_order << ", theta: " << config.fmm_theta << ", leaf size: " << config.fmm_leaf_size << std::endl;
+
+	fmm.reset(new radTFMM(config.fmm_order, config.fmm_theta, config.fmm_leaf_size));
+
+	// Targets: element centres; sources: element images
+	fmm_trg_map.resize(n_elem);
+	for(int i = 0; i < n_elem; i++)
+	{
+		fmm->Targets.AddPoint(TVector3d(elem_coords[3*i], elem_coords[3*i + 1], elem_coords[3*i + 2]));
+		fmm_trg_map[i] = LinearMapOfVectField(intrct_ptr->MainTransPtrArray[i], true);
+	}
+	fmm_src_start.assign(1, 0);
+	fmm_src_map.clear();
+	std::vector<std::vector<radTrans*> > images;
+	for(int j = 0; j < n_elem; j++)
+	{
+		const std::vector<radTrans*>& trans_vect = cached_trans_vect[j];
+		images.assign(trans_vect.size(), std::vector<radTrans*>(1));
+		for(size_t k = 0; k < trans_vect.size(); k++)
+		{
+			images[k][0] = trans_vect[k];
+			fmm_src_map.push_back(LinearMapOfVectField(trans_vect[k], false));
+		}
+		fmm->Sources.AddElement(elem_ptrs[j], images);
+		fmm_src_start.push_back(fmm->Sources.Size());
+	}
+	fmm->Build();
+
+	// Near targets of each source
+	int n_src = fmm->Sources.Size();
+	std::vector<int> src_near_start(n_src + 1, 0), src_near(fmm->NearSource.size());
+	for(int s : fmm->NearSource) src_near_start[s + 1]++;
+	std::partial_sum(src_near_start.begin(), src_near_start.end(), src_near_start.begin());
+	{
+		std::vector<int> pos(src_near_start.begin(), src_near_start.end() - 1);
+		for(int i = 0; i < n_elem; i++)
+			for(int k = fmm->NearStart[i]; k < fmm->NearStart[i + 1]; k++) src_near[pos[fmm->NearSource[k]]++] = i;
+	}
+
+	// Exact near blocks, column by column (sum over the near images of element j)
+	int AmOfElemWithSym = intrct_ptr->CountRelaxElemsWithSym();
+	std::vector<std::vector<int> > col_rows(n_elem);
+	std::vector<std::vector<TMatrix3df> > col_blocks(n_elem);
+	std::exception_ptr pExcept = nullptr;
+
+	#pragma omp parallel if(config.use_openmp && n_elem > 100)
+	{
+		std::vector<TVector3d> obs;
+		std::vector<int> obs_row, obs_img;
+		std::vector<TMatrix3d> sub, block;
+		std::vector<int> slot(n_elem, -1);
+
+		#pragma omp for schedule(dynamic)
+		for(int j = 0; j < n_elem; j++)
+		{
+			try
+			{
+				const std::vector<radTrans*>& trans_vect = cached_trans_vect[j];
+				obs.clear(); obs_row.clear(); obs_img.clear();
+				for(int s = fmm_src_start[j]; s < fmm_src_start[j + 1]; s++)
+				{
+					int k = s - fmm_src_start[j];
+					for(int e = src_near_start[s]; e < src_near_start[s + 1]; e++)
+					{
+						int i = src_near[e];
+						obs.push_back(trans_vect[k]->TrPoint_inv(TVector3d(elem_coords[3*i], elem_coords[3*i + 1], elem_coords[3*i + 2])));
+						obs_row.push_back(i);
+						obs_img.push_back(k);
+					}
+				}
+				if(obs.empty()) continue;
+
+				sub.resize(obs.size());
+				elem_ptrs[j]->B_compIntrctBatch(obs.data(), (int)obs.size(), intrct_ptr->CompCriterium, AmOfElemWithSym, sub.data());
+
+				std::vector<int>& rows = col_rows[j];
+				TVector3d ZeroVect(0., 0., 0.);
+				block.clear();
+				for(size_t p = 0; p < obs.size(); p++)
+				{
+					int i = obs_row[p];
+					if(slot[i] < 0)
+					{
+						slot[i] = (int)rows.size();
+						rows.push_back(i);
+						block.push_back(TMatrix3d(ZeroVect, ZeroVect, ZeroVect));
+					}
+					trans_vect[obs_img[p]]->TrMatrix(sub[p]);
+					block[slot[i]] += sub[p];
+				}
+				col_blocks[j].resize(rows.size());
+				for(size_t r = 0; r < rows.size(); r++)
+				{
+					intrct_ptr->MainTransPtrArray[rows[r]]->TrMatrix_inv(block[r]);
+					col_blocks[j][r] = block[r];
+					slot[rows[r]] = -1;
+				}
+			}
+			catch(...)
+			{
+				#pragma omp critical
+				{
+					if(!pExcept) pExcept = std::current_exception();
+				}
+			}
+		}
+	}
+	if(pExcept) std::rethrow_exception(pExcept);
+
+	// Row-major storage with a column index
+	near_row_start.assign(n_elem + 1, 0);
+	for(int j = 0; j < n_elem; j++) for(int i : col_rows[j]) near_row_start[i + 1]++;
+	std::partial_sum(near_row_start.begin(), near_row_start.end(), near_row_start.begin());
+	int n_near = near_row_start[n_elem];
+	near_row.resize(n_near); near_col.resize(n_near); near_block.resize(n_near);
+	near_col_start.assign(1, 0); near_col_entry.clear();
+	near_col_entry.reserve(n_near);
+	{
+		std::vector<int> pos(near_row_start.begin(), near_row_start.end() - 1);
+		for(int j = 0; j < n_elem; j++)
+		{
+			for(size_t r = 0; r < col_rows[j].size(); r++)
+			{
+				int e = pos[col_rows[j][r]]++;
+				near_row[e] = col_rows[j][r];
+				near_col[e] = j;
+				near_block[e] = col_blocks[j][r];
+				near_col_entry.push_back(e);
+			}
+			near_col_start.push_back((int)near_col_entry.size());
+			std::vector<int>().swap(col_rows[j]);
+			std::vector<TMatrix3df>().swap(col_blocks[j]);
+		}
+	}
+
+	memory_used = (size_t)fmm->Memory() + (size_t)fmm->ExpansionMemory()
+		+ (size_t)n_near*(sizeof(TMatrix3df) + 3*sizeof(int)) + fmm_src_map.size()*sizeof(TMatrix3d) + fmm_trg_map.size()*sizeof(TMatrix3d);
+	size_t dense_memory = (size_t)n_elem * (size_t)n_elem * 9 * sizeof(double);
+	compression_ratio = (double)memory_used / (double)dense_memory;
+	is_built = true;
+
+	auto t_end = std::chrono::high_resolution_clock::now();
+	construction_time = std::chrono::duration<double>(t_end - t_start).count();
+
+	std::cout << "Sources (element images): " << n_src << std::endl;
+	std::cout << "M2L cluster pairs: " << fmm->NumM2L << ", near blocks: " << n_near
+	          << " (" << (double)n_near/n_elem << " per element)" << std::endl;
+	std::cout << "Construction time: " << construction_time << " s (trees and lists " << fmm->BuildTime << " s)" << std::endl;
+	std::cout << "Total memory used: " << (memory_used / 1024) << " KB" << std::endl;
+	std::cout << "========================================\n" << std::endl;
+	return true;
+}
+
+//-------------------------------------------------------------------------
+
+void radTHMatrixInteraction::MatVecFMM(const TVector3d* M_in, TVector3d* H_out, bool trans)
+{
+	int n_src = fmm->Sources.Size();
+	if(!trans)
+	{
+		std::vector<TVector3d> dip(n_src), h_far(n_elem);
+		for(int j = 0; j < n_elem; j++)
+			for(int s = fmm_src_start[j]; s < fmm_src_start[j + 1]; s++) dip[s] = fmm_src_map[s]*M_in[j];
+		fmm->FarField(dip.data(), h_far.data());
+
+		#pragma omp parallel for schedule(static) if(n_elem > 100)
+		for(int i = 0; i < n_elem; i++)
+		{
+			TVector3d H = fmm_trg_map[i]*h_far[i];
+			for(int e = near_row_start[i]; e < near_row_start[i + 1]; e++) H += near_block[e]*M_in[near_col[e]];
+			H_out[i] = H;
+		}
+		return;
+	}
+
+	// Transposed: dipoles (P_i)^T x_i at the element centres, fields integrated over the images
+	std::vector<TVector3d> dip(n_elem), g_far(n_src);
+	for(int i = 0; i < n_elem; i++) dip[i] = MulTransposed(fmm_trg_map[i], M_in[i]);
+	fmm->FarField(dip.data(), g_far.data(), true);
+
+	#pragma omp parallel for schedule(static) if(n_elem > 100)
+	for(int j = 0; j < n_elem; j++)
+	{
+		TVector3d H(0., 0., 0.);
+		for(int s = fmm_src_start[j]; s < fmm_src_start[j + 1]; s++) H += MulTransposed(fmm_src_map[s], g_far[s]);
+		for(int k = near_col_start[j]; k < near_col_start[j + 1]; k++)
+		{
+			int e = near_col_entry[k];
+			const TMatrix3df& N = near_block[e];
+			const TVector3d& M = M_in[near_row[e]];
+			H.x += N.Str0.x*M.x + N.Str1.x*M.y + N.Str2.x*M.z;
+			H.y += N.Str0.y*M.x + N.Str1.y*M.y + N.Str2.y*M.z;
+			H.z += N.Str0.z*M.x + N.Str1.z*M.y + N.Str2.z*M.z;
+		}
+		H_out[j] = H;
+	}
+}
+
+//-------------------------------------------------------------------------
+// Element signatures for the detection of moved or changed elements
+//-------------------------------------------------------------------------
+
+void radTHMatrixInteraction::ComputeElementSignatures()
+{
+	elem_signature.assign((size_t)n_elem*ElemSignatureSize, 0.);
+
+	for(int i = 0; i < n_elem; i++)
+	{
+		double* sig = &elem_signature[(size_t)i*ElemSignatureSize];
+		radTg3dRelax* elem = elem_ptrs[i];
+		radTrans* trans = intrct_ptr->MainTransPtrArray[i];
+
+		// Placement: transformed center and axes
+		TVector3d center = elem->ReturnCentrPoint();
+		TVector3d c = trans->TrPoint(center);
+		TVector3d ax = trans->TrPoint(center + TVector3d(1., 0., 0.)) - c;
+		TVector3d ay = trans->TrPoint(center + TVector3d(0., 1., 0.)) - c;
+		sig[0] = c.x; sig[1] = c.y; sig[2] = c.z;
+		sig[3] = ax.x; sig[4] = ax.y; sig[5] = ax.z;
+		sig[6] = ay.x; sig[7] = ay.y; sig[8] = ay.z;
+
+		// Shape: self-interaction tensor, column by column (unit magnetization along col)
+		TVector3d originalMagn = elem->Magn;
+		for(int col = 0; col < 3; col++)
+		{
+			elem->Magn = TVector3d(col == 0 ? 1. : 0., col == 1 ? 1. : 0., col == 2 ? 1. : 0.);
+			TMatrix3df kernel;
+			ComputeInteractionKernel(i, i, kernel);
+			TVector3d N_col(kernel.Str0.x, kernel.Str1.x, kernel.Str2.x);
+			if(col == 1) N_col = TVector3d(kernel.Str0.y, kernel.Str1.y, kernel.Str2.y);
+			else if(col == 2) N_col = TVector3d(kernel.Str0.z, kernel.Str1.z, kernel.Str2.z);
+			sig[9 + 3*col] = N_col.x; sig[10 + 3*col] = N_col.y; sig[11 + 3*col] = N_col.z;
+		}
+		elem->Magn = originalMagn;
+
+		sig[18] = (double)cached_trans_vect[i].size();
+	}
+}
+
+//-------------------------------------------------------------------------
+// Incremental update of the H-matrices of the last relaxation
+//-------------------------------------------------------------------------
+
+bool radTHMatrixInteraction::UpdateFromCache(std::vector<size_t>& memory_per_component)
+{
+	radTHMatrixUpdateCache& cache = UpdateCache();
+	if(!cache.hmat[0] || ((int)cache.elem_ptrs.size() != n_elem) || !cache.config.SameApproximation(config)) return false;
+
+	// Elements replaced, moved or changed since the last relaxation
+	std::vector<int> changed;
+	for(int i = 0; i < n_elem; i++)
+	{
+		const double* sig = &elem_signature[(size_t)i*ElemSignatureSize];
+		const double* sig_old = &cache.elem_signature[(size_t)i*ElemSignatureSize];
+		if((cache.elem_ptrs[i] != elem_ptrs[i]) || !std::equal(sig, sig + ElemSignatureSize, sig_old)) changed.push_back(i);
+	}
+	if((double)changed.size() > config.update_fraction*n_elem) return false;
+
+	std::cout << "\nUpdating H-matrices of the last relaxation: " << changed.size() << " of " << n_elem
+	          << " elements moved or changed" << std::endl;
+
+	std::vector<int> num_blocks(9, 0);
+	for(int idx = 0; idx < 9; idx++) hmat[idx] = std::move(cache.hmat[idx]);
+
+	#pragma omp parallel for schedule(dynamic) if(config.use_openmp && n_elem > 100)
+	for(int idx = 0; idx < 9; idx++)
+	{
+		KernelData kdata;
+		kdata.hmat_ptr = this;
+		kdata.tensor_row = idx / 3;
+		kdata.tensor_col = idx % 3;
+
+		num_blocks[idx] = hacapk::update_hmatrix(*hmat[idx], points, points, changed, changed, KernelFunction, &kdata, hacapk_params);
+		memory_per_component[idx] = hmat[idx]->memory_usage();
+	}
+
+	for(int idx = 0; idx < 9; idx++)
+	{
+		std::cout << "  Component [" << idx / 3 << "][" << idx % 3 << "]... recomputed " << num_blocks[idx]
+		          << " of " << hmat[idx]->blocks.size() << " blocks, rank=" << hmat[idx]->ktmax << std::endl;
+	}
+
+	num_updated_elem = (int)changed.size();
+	return true;
+}
+
+//-------------------------------------------------------------------------
+// Build with eps / max_rank tuned for a target relative error
+//-------------------------------------------------------------------------
+
+int radTHMatrixInteraction::BuildTuned(double target_error)
+{
+	const int MaxTrials = 6;
+
+	radTHMatrixAccuracySample sample;
+	SampleExactProducts(sample);
+
+	// Best trial: least storage among those meeting the target, otherwise smallest error
+	std::unique_ptr<hacapk::HMatrix> best_hmat[9];
+	std::unique_ptr<hacapk::H2Matrix> best_h2mat[9];
+	radTHMatrixSolverConfig best_config = config;
+	size_t best_memory = 0;
+	double best_error = -1., total_time = 0.;
+	bool best_passed = false, failed = false, loosened = false;
+
+	for(int trial = 0; trial < MaxTrials; trial++)
+	{
+		hacapk_params.eps_aca = config.eps;
+		hacapk_params.max_rank = config.max_rank;
+		is_built = false;
+		if(!BuildHMatrix()) return 0;
+		total_time += construction_time;
+
+		double err = EstimateRelativeError(sample);
+		int rank = 0;
+		for(int idx = 0; idx < 9; idx++)
+		{
+			if(hmat[idx]) rank = std::max(rank, hmat[idx]->ktmax);
+			if(h2mat[idx]) rank = std::max(rank, h2mat[idx]->ktmax);
+		}
+		bool passed = (err <= target_error);
+		std::cout << "[Auto-tune] eps=" << config.eps << ", max_rank=" << config.max_rank
+		          << ": rank=" << rank << ", memory=" << (memory_used / 1024) << " KB, estimated error=" << err
+		          << (passed ? " <= " : " > ") << "target " << target_error << std::endl;
+
+		if((best_error < 0.) || (passed && (!best_passed || (memory_used < best_memory))) || (!passed && !best_passed && (err < best_error)))
+		{
+			for(int idx = 0; idx < 9; idx++)
+			{
+				best_hmat[idx] = std::move(hmat[idx]);
+				best_h2mat[idx] = std::move(h2mat[idx]);
+			}
+			best_config = config;
+			best_memory = memory_used;
+			best_error = err;
+			best_passed = passed;
+		}
+
+		// The error is about proportional to eps: tighten it while the target is missed (doubling a
+		// saturated max_rank), loosen it once if the target is met by a wide margin at the first try
+		if(passed)
+		{
+			if(failed || loosened || (err > 0.25*target_error)) break;
+			config.eps = std::min(0.1, config.eps*((err > 0.) ? std::min(8., 0.5*target_error/err) : 8.));
+			loosened = true;
+		}
+		else
+		{
+			if(best_passed) break;
+			failed = true;
+			if(rank >= config.max_rank) config.max_rank = std::min(2*config.max_rank, n_elem);
+			config.eps *= std::max(0.01, std::min(0.5, 0.5*target_error/err));
+		}
+	}
+
+	for(int idx = 0; idx < 9; idx++)
+	{
+		hmat[idx] = std::move(best_hmat[idx]);
+		h2mat[idx] = std::move(best_h2mat[idx]);
+	}
+	config = best_config;
+	hacapk_params.eps_aca = config.eps;
+	hacapk_params.max_rank = config.max_rank;
+	memory_used = best_memory;
+	compression_ratio = (double)memory_used / ((double)n_elem * (double)n_elem * 9 * sizeof(double));
+	construction_time = total_time;
+	est_error = best_error;
+	is_built = true;
+
+	RadHMatrixReportReset(0);
+	for(int idx = 0; idx < 9; idx++) if(hmat[idx]) radHMatrixReportBlocks(0, idx, *hmat[idx]);
+
+	if(!best_passed)
+	{
+		std::cout << "[Auto-tune] Warning: target error " << target_error << " not reached, using the most accurate trial" << std::endl;
+	}
+	std::cout << "[Auto-tune] Selected eps=" << config.eps << ", max_rank=" << config.max_rank
+	          << " (estimated error " << est_error << ")" << std::endl;
+	return 1;
+}
+
+//-------------------------------------------------------------------------
+// Randomised a-posteriori accuracy estimate
+//-------------------------------------------------------------------------
+
+void radTHMatrixInteraction::SampleExactProducts(radTHMatrixAccuracySample& sample, int nsample, int nvec, unsigned seed)
+{
+	std::mt19937 gen(seed);
+	int ns = std::min(n_elem, std::max(nsample, 1));
+	std::vector<int> perm(n_elem);
+	std::iota(perm.begin(), perm.end(), 0);
+	for(int s = 0; s < ns; s++)
+	{
+		std::uniform_int_distribution<int> pick(s, n_elem - 1);
+		std::swap(perm[s], perm[pick(gen)]);
+	}
+	sample.rows.assign(perm.begin(), perm.begin() + ns);
+
+	sample.nvec = std::max(nvec, 1);
+	sample.x.resize((size_t)sample.nvec*n_elem);
+	for(TVector3d& xj : sample.x)
+	{
+		xj.x = (gen() & 1) ? 1. : -1.;
+		xj.y = (gen() & 1) ? 1. : -1.;
+		xj.z = (gen() & 1) ? 1. : -1.;
+	}
+
+	// Rows of 3x3 blocks as in the dense interaction matrix (ns * n_elem kernel evaluations)
+	sample.ref.assign((size_t)sample.nvec*ns, TVector3d(0., 0., 0.));
+	for(int s = 0; s < ns; s++)
+	{
+		for(int j = 0; j < n_elem; j++)
+		{
+			TMatrix3df N;
+			ComputeInteractionKernel(sample.rows[s], j, N);
+			for(int v = 0; v < sample.nvec; v++) sample.ref[(size_t)v*ns + s] += N*sample.x[(size_t)v*n_elem + j];
+		}
+	}
+}
+
+//-------------------------------------------------------------------------
+
+double radTHMatrixInteraction::EstimateRelativeError(const radTHMatrixAccuracySample& sample)
+{
+	int ns = (int)sample.rows.size();
+	std::vector<TVector3d> H(n_elem);
+	double err2 = 0., ref2 = 0.;
+	for(int v = 0; v < sample.nvec; v++)
+	{
+		MatVec(&sample.x[(size_t)v*n_elem], H.data());
+		for(int s = 0; s < ns; s++)
+		{
+			const TVector3d& ref = sample.ref[(size_t)v*ns + s];
+			TVector3d d = H[sample.rows[s]] - ref;
+			err2 += d.x*d.x + d.y*d.y + d.z*d.z;
+			ref2 += ref.x*ref.x + ref.y*ref.y + ref.z*ref.z;
+		}
+	}
+	return (ref2 > 0.) ? sqrt(err2/ref2) : sqrt(err2);
+}
+
+//-------------------------------------------------------------------------
+
+hacapk::HMatrixPlan radTHMatrixInteraction::PlanComponent(int idx, int nsample)
+{
+	KernelData kdata;
+	kdata.hmat_ptr = this;
+	kdata.tensor_row = idx / 3;
+	kdata.tensor_col = idx % 3;
+	return hacapk::plan_hmatrix(points, points, KernelFunction, &kdata, hacapk_params, nsample);
+}
+
 //-------------------------------------------------------------------------
 // Compute interaction kernel between elements i and j
 // Phase 2: Full implementation with symmetry handling
@@ -336,12 +991,17 @@ void radTHMatrixInteraction::ComputeInteractionKernel(int i, int j, TMatrix3df&
 // True H-matrix implementation with O(N log N) complexity
 //-------------------------------------------------------------------------
 
-void radTHMatrixInteraction::MatVec(const TVector3d* M_in, TVector3d* H_out)
+void radTHMatrixInteraction::MatVec(const TVector3d* M_in, TVector3d* H_out, bool trans)
 {
 	if(!is_built)
 	{
 		throw std::runtime_error("H-matrix solver: H-matrix not built yet");
 	}
+	if(fmm)
+	{
+		MatVecFMM(M_in, H_out, trans);
+		return;
+	}
 
 	// Convert input magnetization vectors to scalar arrays for HACApK
 	// M_in[i] = (Mx, My, Mz) -> M_x[i], M_y[i], M_z[i]
@@ -366,21 +1026,30 @@ void radTHMatrixInteraction::MatVec(const TVector3d* M_in, TVector3d* H_out)
 
 	// Perform 9 H-matrix-vector multiplications using HACApK
 	// InteractMatrix is 3x3 tensor: H[row] = sum_col (M[row][col] * M_in[col])
+	// Transposed: the 3x3 blocks of N^T are (N_ji)^T, i.e. H[row] = sum_col (M[col][row]^T * M_in[col])
 	for(int row = 0; row < 3; row++)
 	{
 		// H[row].x = M[row][0]*M_x + M[row][1]*M_y + M[row][2]*M_z
-		int idx_0 = row * 3 + 0;  // M[row][0]
-		int idx_1 = row * 3 + 1;  // M[row][1]
-		int idx_2 = row * 3 + 2;  // M[row][2]
+		int idx_0 = trans ? (0 * 3 + row) : (row * 3 + 0);  // M[row][0]
+		int idx_1 = trans ? (1 * 3 + row) : (row * 3 + 1);  // M[row][1]
+		int idx_2 = trans ? (2 * 3 + row) : (row * 3 + 2);  // M[row][2]
+
+		if(config.use_h2)
+		{
+			hacapk::h2matrix_matvec(*h2mat[idx_0], M_x, result[row][0], trans);
+			hacapk::h2matrix_matvec(*h2mat[idx_1], M_y, result[row][1], trans);
+			hacapk::h2matrix_matvec(*h2mat[idx_2], M_z, result[row][2], trans);
+			continue;
+		}
 
 		// result[row][0] = hmat[idx_0] * M_x
-		hacapk::hmatrix_matvec(*hmat[idx_0], M_x, result[row][0]);
+		hacapk::hmatrix_matvec(*hmat[idx_0], M_x, result[row][0], trans);
 
 		// result[row][1] = hmat[idx_1] * M_y
-		hacapk::hmatrix_matvec(*hmat[idx_1], M_y, result[row][1]);
+		hacapk::hmatrix_matvec(*hmat[idx_1], M_y, result[row][1], trans);
 
 		// result[row][2] = hmat[idx_2] * M_z
-		hacapk::hmatrix_matvec(*hmat[idx_2], M_z, result[row][2]);
+		hacapk::hmatrix_matvec(*hmat[idx_2], M_z, result[row][2], trans);
 	}
 
 	// Combine results into output field vectors
@@ -413,17 +1082,29 @@ void radTHMatrixInteraction::PrintStatistics()
 	std::cout << "H-Matrix Solver Statistics" << std::endl;
 	std::cout << "========================================" << std::endl;
 	std::cout << "Number of elements: " << n_elem << std::endl;
+	if(sym_order > 1) std::cout << "Symmetry images per element: " << sym_order << " (" << (long long)n_elem*sym_order << " elements in the expanded model)" << std::endl;
 	std::cout << "Construction time: " << construction_time << " s" << std::endl;
 
 	size_t dense_memory = (size_t)n_elem * (size_t)n_elem * 9 * sizeof(float);
 	std::cout << "Dense matrix memory: " << dense_memory / (1024*1024) << " MB" << std::endl;
-	std::cout << "H-matrix memory: " << memory_used / (1024*1024) << " MB" << std::endl;
+	std::cout << (fmm? "FMM memory: " : "H-matrix memory: ") << memory_used / (1024*1024) << " MB" << std::endl;
 	std::cout << "Compression ratio: " << compression_ratio * 100 << "%" << std::endl;
 
 	std::cout << "\nConfiguration:" << std::endl;
+	if(fmm)
+	{
+		std::cout << "  FMM order = " << config.fmm_order << ", theta = " << config.fmm_theta << ", leaf size = " << config.fmm_leaf_size << std::endl;
+		std::cout << "  M2L cluster pairs = " << fmm->NumM2L << ", near blocks = " << near_block.size() << std::endl;
+		std::cout << "========================================" << std::endl;
+		return;
+	}
 	std::cout << "  eps = " << config.eps << std::endl;
 	std::cout << "  max_rank = " << config.max_rank << std::endl;
 	std::cout << "  min_cluster_size = " << config.min_cluster_size << std::endl;
+	std::cout << "  eta = " << config.eta << std::endl;
+	std::cout << "  split_type = " << config.split_type << std::endl;
+	std::cout << "  use_h2 = " << (config.use_h2 ? "yes" : "no") << std::endl;
+	if(est_error >= 0.) std::cout << "  estimated error = " << est_error << std::endl;
 	std::cout << "  use_openmp = " << (config.use_openmp ? "yes" : "no") << std::endl;
 	std::cout << "  num_threads = " << config.num_threads << std::endl;
 	std::cout << "========================================" << std::endl;
@@ -530,3 +1211,162 @@ double radTHMatrixInteraction::KernelFunction(int i, int j, void* user_data)
 
 	return result;
 }
+
+//-------------------------------------------------------------------------
+// H-LU solver for the linearized relaxation system
+//-------------------------------------------------------------------------
+
+static inline double Matrix3dElem(const TMatrix3d& M, int r, int c)
+{
+	const TVector3d& Str = (r == 0)? M.Str0 : ((r == 1)? M.Str1 : M.Str2);
+	return (c == 0)? Str.x : ((c == 1)? Str.y : Str.z);
+}
+
+//-------------------------------------------------------------------------
+
+radTHMatrixLUSolver::radTHMatrixLUSolver(radTInteraction* intrct, double in_eps, int in_max_rank)
+	: intrct_ptr(intrct), eps(in_eps), max_rank(in_max_rank)
+{
+	if(intrct_ptr == nullptr)
+	{
+		throw std::runtime_error("H-LU solver: Invalid interaction pointer");
+	}
+
+	n_elem = intrct_ptr->AmOfMainElem;
+	num_factorizations = 0;
+	factorization_time = 0.0;
+
+	// Three degrees of freedom (Mx, My, Mz) per element, located at the element center
+	points.reserve(3 * n_elem);
+	for(int i = 0; i < n_elem; i++)
+	{
+		TVector3d center = intrct_ptr->g3dRelaxPtrVect[i]->ReturnCentrPoint();
+		radTrans* trans = intrct_ptr->MainTransPtrArray[i];
+		if(trans != nullptr) center = trans->TrPoint(center);
+
+		for(int k = 0; k < 3; k++) points.emplace_back(center.x, center.y, center.z);
+	}
+	ksi.resize(n_elem);
+}
+
+//-------------------------------------------------------------------------
+
+void radTHMatrixLUSolver::GetInteractionBlock(int i, int j, TMatrix3d& N) const
+{
+	if(intrct_ptr->use_hmatrix && (intrct_ptr->hmat_interaction != nullptr))
+	{
+		// Dense interaction matrix is not set up in H-matrix mode
+		TMatrix3df Nf;
+#ifdef _OPENMP
+		#pragma omp critical(kernel_magn_access)
+#endif
+		intrct_ptr->hmat_interaction->ComputeInteractionKernel(i, j, Nf);
+		N = TMatrix3d(TVector3d(Nf.Str0.x, Nf.Str0.y, Nf.Str0.z), TVector3d(Nf.Str1.x, Nf.Str1.y, Nf.Str1.z), TVector3d(Nf.Str2.x, Nf.Str2.y, Nf.Str2.z));
+	}
+	else
+	{
+		const TMatrix3df& Nf = intrct_ptr->InteractMatrix[i][j];
+		N = TMatrix3d(TVector3d(Nf.Str0.x, Nf.Str0.y, Nf.Str0.z), TVector3d(Nf.Str1.x, Nf.Str1.y, Nf.Str1.z), TVector3d(Nf.Str2.x, Nf.Str2.y, Nf.Str2.z));
+	}
+}
+
+//-------------------------------------------------------------------------
+
+double radTHMatrixLUSolver::KernelFunction(int a, int b, void* user_data)
+{
+	const radTHMatrixLUSolver* solver = static_cast<const radTHMatrixLUSolver*>(user_data);
+	int i = a / 3, j = b / 3;
+
+	// ACA requests rows / columns entry by entry: keep the last 3x3 block Ksi_i * N_ij per thread
+	struct BlockCache { const radTHMatrixLUSolver* owner; int fact_no, i, j; TMatrix3d KsiN; };
+	static thread_local BlockCache cache = { nullptr, -1, -1, -1, TMatrix3d() };
+
+	if((cache.owner != solver) || (cache.fact_no != solver->num_factorizations) || (cache.i != i) || (cache.j != j))
+	{
+		TMatrix3d N;
+		solver->GetInteractionBlock(i, j, N);
+		cache.KsiN = solver->ksi[i] * N;
+		cache.owner = solver; cache.fact_no = solver->num_factorizations; cache.i = i; cache.j = j;
+	}
+
+	double res = -Matrix3dElem(cache.KsiN, a % 3, b % 3);
+	if(a == b) res += 1.;
+	return res;
+}
+
+//-------------------------------------------------------------------------
+
+void radTHMatrixLUSolver::Factorize(const TVector3d* FieldArray, bool Secant)
+{
+	auto t_start = std::chrono::high_resolution_clock::now();
+
+	const TVector3d ZeroVect(0.,0.,0.);
+	TVector3d InstMr;
+	for(int i = 0; i < n_elem; i++)
+	{
+		radTg3dRelax* g3dRelaxPtr = intrct_ptr->g3dRelaxPtrVect[i];
+		radTMaterial* MaterPtr = (radTMaterial*)(g3dRelaxPtr->MaterHandle.rep);
+		TVector3d H = FieldArray[i];
+		double He2 = H.AmpE2();
+
+		if(Secant && (He2 > 0.))
+		{
+			double SecKsi = ((MaterPtr->M(H) - MaterPtr->M(ZeroVect))*H)/He2;
+			ksi[i] = TMatrix3d(TVector3d(SecKsi,0.,0.), TVector3d(0.,SecKsi,0.), TVector3d(0.,0.,SecKsi));
+		}
+		else
+		{
+			ksi[i] = TMatrix3d(ZeroVect, ZeroVect, ZeroVect);
+			MaterPtr->DefineInstantKsiTensor(H, ksi[i], InstMr);
+		}
+	}
+	num_factorizations++; // also invalidates kernel block caches
+
+	hacapk::ControlParams params;
+	params.eps_aca = eps;
+	params.max_rank = max_rank;
+	params.leaf_size = 96; // 32 elements: smaller blocks of I - Ksi*N are hardly compressible
+	params.eta = 1.0;
+	params.split_type = 3;
+	params.print_level = 0;
+#ifdef _OPENMP
+	params.nthr = omp_get_max_threads();
+#else
+	params.nthr = 1;
+#endif
+
+	hlu.reset();
+	std::unique_ptr<hacapk::HMatrixTree> tree = hacapk::build_hmatrix_tree(points, KernelFunction, this, params);
+	hacapk::hlu_factorize(*tree, eps, max_rank);
+	hlu = std::move(tree);
+
+	auto t_end = std::chrono::high_resolution_clock::now();
+	factorization_time = std::chrono::duration<double>(t_end - t_start).count();
+}
+
+//-------------------------------------------------------------------------
+
+void radTHMatrixLUSolver::Solve(const TVector3d* Rhs, TVector3d* Sol, bool Transposed) const
+{
+	if(hlu == nullptr)
+	{
+		throw std::runtime_error("H-LU solver: Matrix is not factorized");
+	}
+
+	std::vector<double> b(3 * n_elem);
+	for(int i = 0; i < n_elem; i++)
+	{
+		b[3*i + 0] = Rhs[i].x;
+		b[3*i + 1] = Rhs[i].y;
+		b[3*i + 2] = Rhs[i].z;
+	}
+
+	hacapk::hlu_solve(*hlu, b, Transposed);
+
+	for(int i = 0; i < n_elem; i++)
+	{
+		Sol[i].x = b[3*i + 0];
+		Sol[i].y = b[3*i + 1];
+		Sol[i].z = b[3*i + 2];
+	}
+}
@@ -22,6 +22,7 @@
 #include "rad_interaction.h"
 #include "rad_geometry_3d.h"
 #include "rad_group.h"
+#include "rad_fmm.h"
 #include "../ext/HACApK_LH-Cimplm/hacapk.hpp"  // HACApK library
 #include <vector>
 #include <memory>
@@ -40,9 +41,19 @@ struct radTHMatrixSolverConfig
 {
 	double eps;              // ACA tolerance (default: 1e-4, Phase 1 optimized)
 	int max_rank;            // Maximum rank for low-rank blocks (default: 30, Phase 1 optimized)
-	int min_cluster_size;    // Minimum cluster size (default: 10)
+	int min_cluster_size;    // Minimum cluster size = leaf size of the cluster tree (default: 10)
 	bool use_openmp;         // Enable OpenMP parallelization (default: true)
 	int num_threads;         // Number of OpenMP threads (0 = auto-detect)
+	double eta;              // Admissibility: dist >= eta * min(diam) (default: 1.0)
+	int split_type;          // Cluster splitting: 1=longest box edge at midpoint, 2=principal axis at midpoint,
+	                         // 3=principal axis at median (default: 3)
+	bool use_h2;             // Store as H2-matrix with nested cluster bases (default: false)
+	double update_fraction;  // Max. fraction of moved/changed elements for which the H-matrix of the
+	                         // previous relaxation is updated instead of rebuilt (default: 0.25, 0 = always rebuild)
+	bool use_fmm;            // Fast multipole method instead of H-matrices (default: false)
+	int fmm_order;           // FMM expansion order (default: 8)
+	double fmm_theta;        // FMM separation ratio: (r_t + r_s) < fmm_theta * distance (default: 0.5)
+	int fmm_leaf_size;       // FMM leaf size (default: 16)
 
 	radTHMatrixSolverConfig()
 	{
@@ -52,12 +63,43 @@ struct radTHMatrixSolverConfig
 		min_cluster_size = 10;
 		use_openmp = true;
 		num_threads = 0;  // Auto-detect
+		eta = 1.0;
+		split_type = 3;   // Balanced trees also for thin, elongated assemblies
+		use_h2 = false;
+		update_fraction = 0.25;
+		use_fmm = false;
+		fmm_order = 8;
+		fmm_theta = 0.5;
+		fmm_leaf_size = 16;
 	}
 
-	radTHMatrixSolverConfig(double e, int mr, int mcs, bool omp, int nt)
-		: eps(e), max_rank(mr), min_cluster_size(mcs), use_openmp(omp), num_threads(nt)
+	radTHMatrixSolverConfig(double e, int mr, int mcs, bool omp, int nt, double et = 1.0, int st = 3, bool h2 = false)
+		: eps(e), max_rank(mr), min_cluster_size(mcs), use_openmp(omp), num_threads(nt), eta(et), split_type(st), use_h2(h2), update_fraction(0.25),
+		  use_fmm(false), fmm_order(8), fmm_theta(0.5), fmm_leaf_size(16)
 	{
 	}
+
+	// Same cluster trees and block approximation (H-matrices can be updated instead of rebuilt)
+	bool SameApproximation(const radTHMatrixSolverConfig& c) const
+	{
+		return (eps == c.eps) && (max_rank == c.max_rank) && (min_cluster_size == c.min_cluster_size)
+			&& (eta == c.eta) && (split_type == c.split_type) && (use_h2 == c.use_h2);
+	}
+};
+
+//-------------------------------------------------------------------------
+// Exact products of the interaction matrix on sampled rows, for the
+// a-posteriori accuracy estimate of its H-matrix approximation
+//-------------------------------------------------------------------------
+
+struct radTHMatrixAccuracySample
+{
+	int nvec;                        // Number of random vectors
+	std::vector<int> rows;           // Sampled elements (rows of 3x3 blocks)
+	std::vector<TVector3d> x;        // Random +-1 magnetization vectors [nvec][n_elem]
+	std::vector<TVector3d> ref;      // Exact fields N * x on the sampled rows [nvec][rows.size()]
+
+	radTHMatrixAccuracySample() : nvec(0) {}
 };
 
 //-------------------------------------------------------------------------
@@ -65,11 +107,32 @@ struct radTHMatrixSolverConfig
 //
 // Purpose: Replaces dense NxN interaction matrix with H-matrix
 //          representation, providing O(N log N) operations instead of O(N^2)
+//          (O(N) storage and operations as H2-matrix, config.use_h2)
 //
 // Usage:
 //   1. Create: radTHMatrixInteraction hmat(interaction_ptr, config);
 //   2. Build: hmat.BuildHMatrix();
 //   3. Use: hmat.MatVec(M_in, H_out);
+//
+// With a target error (BuildTuned), eps and max_rank are chosen as the
+// cheapest (least storage) tried parameters whose error, estimated by
+// comparing H-matrix products with exact products on randomly sampled rows,
+// does not exceed the target.
+//
+// Symmetric models (TrfZerPara, TrfZerPerp, TrfMlt) are handled on the irreducible
+// elements only: an entry sums the contributions of all symmetry images of the
+// column element, and a block is approximated only if it is admissible for every
+// image. Storage and construction are those of the irreducible part.
+//
+// The H-matrices (not H2) are kept after destruction for the next relaxation:
+// if at most config.update_fraction of the elements moved or changed, only
+// the blocks whose row or column cluster contains such an element are
+// recomputed (hacapk::update_hmatrix), the cluster trees are kept.
+//
+// With config.use_fmm, the H-matrices are replaced by the fast multipole
+// method (radTFMM): the far field of all element images is evaluated from
+// the element moments in O(N) per product, only the exact 3x3 blocks of near
+// element pairs are stored.
 //-------------------------------------------------------------------------
 
 class radTHMatrixInteraction
@@ -90,11 +153,28 @@ public:
 	// H-matrix storage for 3x3 tensor interaction matrix
 	// We store 9 scalar H-matrices, one for each tensor component
 	std::unique_ptr<hacapk::HMatrix> hmat[9];  // [0]=M[0][0], [1]=M[0][1], ..., [8]=M[2][2]
+	std::unique_ptr<hacapk::H2Matrix> h2mat[9];  // Same with nested cluster bases (config.use_h2)
 
 	// Cached symmetry transformations for each element (for performance)
 	std::vector<std::vector<radTrans*>> cached_trans_vect;  // [j] = list of transformations for element j
+	int sym_order;                   // Largest number of symmetry images of an element (1: no symmetry)
+
+	// Per-element signatures [n_elem][ElemSignatureSize] to detect moved/changed elements
+	std::vector<double> elem_signature;
+	int num_updated_elem;            // Elements recomputed by the last incremental update (-1: full build)
+
+	// Fast multipole operator (config.use_fmm): one FMM source per element image, targets at the element centres
+	std::unique_ptr<radTFMM> fmm;
+	std::vector<int> fmm_src_start;         // Sources of element j: fmm_src_start[j] ... fmm_src_start[j+1]-1
+	std::vector<TMatrix3d> fmm_src_map;     // Magnetization of the element -> dipole density of the image (global frame)
+	std::vector<TMatrix3d> fmm_trg_map;     // Global field -> field in the frame of element i
+	std::vector<int> near_row_start;        // Exact near blocks of row i: near_row_start[i] ... near_row_start[i+1]-1
+	std::vector<int> near_row, near_col;
+	std::vector<TMatrix3df> near_block;
+	std::vector<int> near_col_start, near_col_entry;  // Near blocks of column j (indices of the entries above)
 
 	bool is_built;                   // H-matrix built flag
+	double est_error;                // Estimated relative error of N * M (-1: not estimated)
 
 	// Statistics
 	size_t memory_used;              // Estimated memory usage (bytes)
@@ -105,27 +185,58 @@ public:
 	radTHMatrixInteraction(radTInteraction* intrct, const radTHMatrixSolverConfig& cfg);
 	~radTHMatrixInteraction();
 
-	// Build H-matrix from interaction data
+	// Build H-matrix from interaction data (fast multipole operator if config.use_fmm and applicable)
 	int BuildHMatrix();
 
+	// Build H-matrices with the cheapest tried eps / max_rank (starting from config)
+	// whose estimated relative error does not exceed target_error
+	int BuildTuned(double target_error);
+
+	// Exact products N * x on nsample random rows for nvec random vectors x
+	void SampleExactProducts(radTHMatrixAccuracySample& sample, int nsample = 32, int nvec = 2, unsigned seed = 1);
+
+	// Relative error of the H-matrix products on the sampled rows
+	double EstimateRelativeError(const radTHMatrixAccuracySample& sample);
+
+	// Block structure, sampled ACA rank and kernel timing of tensor component idx (row*3 + col), without building it
+	hacapk::HMatrixPlan PlanComponent(int idx, int nsample = 8);
+
 	// H-matrix-vector multiplication
-	// Computes: H_field = InteractMatrix * M_vector
+	// Computes: H_field = InteractMatrix * M_vector (trans: InteractMatrix^T * M_vector)
 	// Input: M_in[n_elem] - magnetization vectors
 	// Output: H_out[n_elem] - field vectors (without external field)
-	void MatVec(const TVector3d* M_in, TVector3d* H_out);
+	void MatVec(const TVector3d* M_in, TVector3d* H_out, bool trans = false);
 
 	// Memory and statistics
 	void PrintStatistics();
 	size_t EstimateMemoryUsage() const;
 	double GetCompressionRatio() const;
 
+	// Kernel function for interaction matrix computation
+	// Computes the 3x3 interaction matrix between elements i and j
+	void ComputeInteractionKernel(int i, int j, TMatrix3df& result);
+
+	// Release the H-matrices kept from the last relaxation
+	static void ReleaseUpdateCache();
+
 private:
 	// Extract element coordinates from radTInteraction
 	void ExtractElementData();
 
-	// Kernel function for interaction matrix computation
-	// Computes the 3x3 interaction matrix between elements i and j
-	void ComputeInteractionKernel(int i, int j, TMatrix3df& result);
+	// Symmetry image maps of the element centres (hacapk_params.target_images), so that blocks are
+	// low-rank only if all images of their column elements are far from the row elements
+	void CollectSymmetryImages();
+
+	// Element signature: transformed center, transformed axes, self-interaction tensor, number of symmetry images
+	static const int ElemSignatureSize = 19;
+	void ComputeElementSignatures();
+
+	// Update the H-matrices kept from the last relaxation; false if not applicable (then a full build is needed)
+	bool UpdateFromCache(std::vector<size_t>& memory_per_component);
+
+	// Fast multipole operator with exact near blocks; false if not applicable (several elements relaxed together)
+	bool BuildFMM();
+	void MatVecFMM(const TVector3d* M_in, TVector3d* H_out, bool trans);
 
 	// Kernel function wrapper data (for HACApK callback)
 	struct KernelData
@@ -139,4 +250,59 @@ private:
 	static double KernelFunction(int i, int j, void* user_data);
 };
 
+//-------------------------------------------------------------------------
+// H-LU factorization of the linearized relaxation system
+//
+// Purpose: Approximate direct solver / preconditioner for
+//            (I - Ksi_i * N_ij) dM_j = r_i
+//          where Ksi_i is the differential (Newton) or secant (Picard)
+//          susceptibility tensor of element i at field H_i and N_ij the 3x3 blocks of the
+//          interaction matrix. The 3N x 3N matrix is stored as a
+//          block-cluster tree H-matrix and factorized by H-LU.
+//
+// Usage:
+//   1. Create: radTHMatrixLUSolver lu(interaction_ptr, eps, max_rank);
+//   2. Factorize: lu.Factorize(H_array, secant);
+//   3. Solve: lu.Solve(r_array, dM_array);
+//-------------------------------------------------------------------------
+
+class radTHMatrixLUSolver
+{
+public:
+	radTInteraction* intrct_ptr;     // Parent interaction object
+	double eps;                      // H-matrix / H-LU truncation accuracy
+	int max_rank;                    // Maximum rank of low-rank blocks
+
+	int n_elem;                      // Number of relaxation elements
+	std::vector<hacapk::Point3D> points;  // Degree-of-freedom positions (3 per element)
+	std::vector<TMatrix3d> ksi;      // Instantaneous susceptibility tensors [n_elem]
+
+	std::unique_ptr<hacapk::HMatrixTree> hlu;  // Factorized system matrix
+
+	// Statistics
+	int num_factorizations;          // Number of (re)factorizations
+	double factorization_time;       // Time of last assembly + factorization (seconds)
+
+public:
+	radTHMatrixLUSolver(radTInteraction* intrct, double in_eps, int in_max_rank);
+
+	// Assemble and factorize I - Ksi(H) * N at the given element fields;
+	// Secant: Ksi = (M(H) - M(0))*H / |H|^2 (isotropic), otherwise dM/dH
+	// Throws std::runtime_error on factorization breakdown
+	void Factorize(const TVector3d* FieldArray, bool Secant = false);
+
+	// Solve (I - Ksi * N) Sol = Rhs with the current factorization
+	// (Transposed: (I - Ksi * N)^T Sol = Rhs, e.g. for adjoint sensitivities)
+	void Solve(const TVector3d* Rhs, TVector3d* Sol, bool Transposed = false) const;
+
+	bool IsFactorized() const { return hlu != nullptr;}
+
+private:
+	// 3x3 interaction block N_ij (dense matrix or H-matrix kernel)
+	void GetInteractionBlock(int i, int j, TMatrix3d& N) const;
+
+	// Scalar entry of I - Ksi * N for HACApK (degrees of freedom a, b)
+	static double KernelFunction(int a, int b, void* user_data);
+};
+
 #endif
@@ -0,0 +1,188 @@
+/*-------------------------------------------------------------------------
+*
+* File name:      rad_intrc_plan.cpp
+*
+* Project:        RADIA
+*
+* Description:    Cost-model choice of the relaxation interaction backend
+*                 (dense matrix, H-matrix, H2-matrix)
+*
+* Author(s):      Radia Development Team
+*
+* First release:  2026
+*
+*------------------------------------------------------------------------*/
+
+#include "rad_intrc_plan.h"
+#include "rad_intrc_hmat.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+//-------------------------------------------------------------------------
+// Machine characteristics
+//-------------------------------------------------------------------------
+
+double radPhysicalMemory()
+{
+#if defined(_WIN32)
+	MEMORYSTATUSEX status;
+	status.dwLength = sizeof(status);
+	if(GlobalMemoryStatusEx(&status)) return (double)status.ullTotalPhys;
+	return 0.;
+#elif defined(_SC_PHYS_PAGES) && defined(_SC_PAGESIZE)
+	long pages = sysconf(_SC_PHYS_PAGES), page_size = sysconf(_SC_PAGESIZE);
+	if((pages > 0) && (page_size > 0)) return (double)pages*(double)page_size;
+	return 0.;
+#else
+	return 0.;
+#endif
+}
+
+//-------------------------------------------------------------------------
+
+static double MeasureStreamRate()
+{// Bytes of a 16 MB matrix (larger than usual caches) streamed per second by one dense product
+	static double rate = 0.;
+	if(rate > 0.) return rate;
+
+	const int m = 1024, n = 2048, reps = 3;
+	std::vector<double> A((size_t)m*n, 1e-3), x(n, 1.), y(m, 0.);
+	hacapk::dense_gemv(false, m, n, 1., A.data(), x.data(), y.data()); // pages touched before timing
+	auto t_start = std::chrono::steady_clock::now();
+	for(int r = 0; r < reps; r++) hacapk::dense_gemv(false, m, n, 1., A.data(), x.data(), y.data());
+	double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+	rate = (t > 0.)? reps*(double)A.size()*sizeof(double)/t : 1e10;
+	return rate;
+}
+
+//-------------------------------------------------------------------------
+// Plan
+//-------------------------------------------------------------------------
+
+radTInteractionPlan::radTInteractionPlan()
+{
+	backend = Dense;
+	n_elem = 0;
+	kernel_time = stream_rate = mean_rank = memory_budget = 0.;
+	num_threads = 1;
+	iterations = 0;
+	for(int b = 0; b < NumBackends; b++) build_time[b] = iter_time[b] = memory[b] = 0.;
+}
+
+//-------------------------------------------------------------------------
+
+void radTInteractionPlan::Choose()
+{
+	int best = -1, least_memory = Dense;
+	for(int b = 0; b < NumBackends; b++)
+	{
+		if(memory[b] < memory[least_memory]) least_memory = b;
+		if((memory_budget > 0.) && (memory[b] > memory_budget)) continue;
+		if((best < 0) || (TotalTime(b) < TotalTime(best))) best = b;
+	}
+	backend = (best >= 0)? best : least_memory;
+}
+
+//-------------------------------------------------------------------------
+
+void radTInteractionPlan::Print() const
+{
+	const char* names[] = {"dense", "H-matrix", "H2-matrix"};
+	std::cout << "\n[Planner] N=" << n_elem << ", kernel " << kernel_time*1e6 << " us per block, sampled rank " << mean_rank
+	          << ", " << num_threads << " threads, " << iterations << " iterations, memory budget "
+	          << memory_budget/1048576. << " MB" << std::endl;
+	for(int b = 0; b < NumBackends; b++)
+	{
+		std::cout << "[Planner]   " << names[b] << ": build " << build_time[b] << " s, iteration " << iter_time[b]*1e3
+		          << " ms, total " << TotalTime(b) << " s, memory " << memory[b]/1048576. << " MB"
+		          << (((memory_budget > 0.) && (memory[b] > memory_budget))? " (over budget)" : "") << std::endl;
+	}
+	std::cout << "[Planner] Selected " << names[backend];
+	if((memory_budget > 0.) && (memory[backend] > memory_budget)) std::cout << " (no backend fits into the memory budget, least memory)";
+	std::cout << std::endl;
+}
+
+//-------------------------------------------------------------------------
+
+void radTInteractionPlan::GetArray(double* arData) const
+{
+	if(arData == 0) return;
+	arData[0] = backend;
+	arData[1] = kernel_time;
+	arData[2] = stream_rate;
+	for(int b = 0; b < NumBackends; b++)
+	{
+		arData[3 + b] = build_time[b];
+		arData[6 + b] = iter_time[b];
+		arData[9 + b] = memory[b];
+	}
+	arData[12] = memory_budget;
+	arData[13] = iterations;
+	arData[14] = mean_rank;
+}
+
+//-------------------------------------------------------------------------
+
+void radPlanInteraction(radTHMatrixInteraction& hmat, double memory_budget, int iterations, radTInteractionPlan& plan)
+{
+	double N = hmat.n_elem;
+	plan.n_elem = hmat.n_elem;
+	plan.memory_budget = memory_budget;
+	plan.iterations = iterations;
+#ifdef _OPENMP
+	plan.num_threads = omp_get_max_threads();
+#endif
+	double nthr = plan.num_threads;
+
+	// Structure of one tensor component (the same for all 9), sampled ranks and kernel timing;
+	// the kernel of a component evaluates the whole 3x3 block
+	hacapk::HMatrixPlan hplan = hmat.PlanComponent(8);
+	plan.kernel_time = hplan.kernel_time;
+	plan.mean_rank = hplan.mean_rank;
+	plan.stream_rate = MeasureStreamRate();
+	double rate = plan.stream_rate*nthr;
+
+	// Dense: N^2 float 3x3 blocks, assembled in parallel, rows streamed in parallel
+	double dense_bytes = N*N*sizeof(TMatrix3df);
+	double near = (double)hplan.near_entries;
+	plan.build_time[radTInteractionPlan::Dense] = (near*hplan.near_kernel_time + (N*N - near)*hplan.kernel_time)/nthr;
+	plan.iter_time[radTInteractionPlan::Dense] = dense_bytes/rate;
+	plan.memory[radTInteractionPlan::Dense] = dense_bytes;
+
+	// H-matrix: 9 components; kernel calls are serialized (element magnetization is set per call)
+	double h_entries = hplan.stored_entries();
+	double h_bytes = 9*h_entries*sizeof(double);
+	plan.build_time[radTInteractionPlan::HMatrix] = 9*hplan.build_time;
+	plan.iter_time[radTInteractionPlan::HMatrix] = h_bytes/rate;
+	plan.memory[radTInteractionPlan::HMatrix] = h_bytes;
+
+	// H2-matrix: recompressed from the H-matrix blocks into cluster bases (about 2 N k entries)
+	// and k x k coupling matrices; the recompression is costed as k^3 flops per block at the product rate
+	double k = std::max(1., hplan.mean_rank);
+	double h2_entries = hplan.near_entries + hplan.far_blocks*k*k + 2*N*k;
+	double h2_bytes = 9*h2_entries*sizeof(double);
+	double recompress_flops = 9*4*(hplan.far_blocks*k*k*k + N*k*k);
+	plan.build_time[radTInteractionPlan::H2Matrix] = plan.build_time[radTInteractionPlan::HMatrix] + recompress_flops/(rate/4.);
+	plan.iter_time[radTInteractionPlan::H2Matrix] = h2_bytes/rate;
+	plan.memory[radTInteractionPlan::H2Matrix] = h_bytes + h2_bytes;
+
+	plan.Choose();
+}
@@ -0,0 +1,72 @@
+/*-------------------------------------------------------------------------
+*
+* File name:      rad_intrc_plan.h
+*
+* Project:        RADIA
+*
+* Description:    Cost-model choice of the relaxation interaction backend
+*                 (dense matrix, H-matrix, H2-matrix)
+*
+* Author(s):      Radia Development Team
+*
+* First release:  2026
+*
+*------------------------------------------------------------------------*/
+
+#ifndef __RADINTRC_PLAN_H
+#define __RADINTRC_PLAN_H
+
+class radTHMatrixInteraction;
+
+//-------------------------------------------------------------------------
+// Estimated costs of the interaction backends and the chosen one
+//
+// Build time, time per relaxation iteration (one interaction matrix-vector
+// product) and peak memory are modelled from
+//   - the block structure of the H-matrix (cluster trees and admissibility,
+//     exact) and the ACA ranks of a few sampled low-rank blocks,
+//   - the measured wall time of the interaction kernel on sampled blocks,
+//   - the measured rate of streaming matrix data in a matrix-vector product.
+// The backend with the least build time + iterations * iteration time whose
+// memory fits into the budget is chosen.
+//-------------------------------------------------------------------------
+
+struct radTInteractionPlan
+{
+	enum { Dense = 0, HMatrix = 1, H2Matrix = 2, NumBackends = 3 };
+
+	int backend;                     // Chosen backend
+	int n_elem;                      // Number of relaxation elements
+	double kernel_time;              // Wall time of one 3x3 interaction block of a random element pair [s]
+	double stream_rate;              // Matrix data streamed per second in a matrix-vector product (one thread) [bytes/s]
+	int num_threads;                 // OpenMP threads
+	double mean_rank;                // Sampled ACA rank of low-rank blocks
+	double memory_budget;            // [bytes]
+	int iterations;                  // Expected number of relaxation iterations
+	double build_time[NumBackends];  // [s]
+	double iter_time[NumBackends];   // [s]
+	double memory[NumBackends];      // Peak memory of the construction [bytes]
+
+	radTInteractionPlan();
+
+	double TotalTime(int b) const { return build_time[b] + iterations*iter_time[b];}
+
+	// Cheapest backend within the memory budget (least memory if none fits)
+	void Choose();
+	void Print() const;
+
+	// Flat record: [backend, kernel_time, stream_rate, build_time[3], iter_time[3], memory[3], memory_budget, iterations, mean_rank]
+	static const int ArraySize = 15;
+	void GetArray(double* arData) const;
+};
+
+//-------------------------------------------------------------------------
+
+// Estimates the costs of all backends for the relaxation elements of hmat (element centres,
+// interaction kernel and cluster parameters of the relaxation H-matrix) and chooses one
+void radPlanInteraction(radTHMatrixInteraction& hmat, double memory_budget, int iterations, radTInteractionPlan& plan);
+
+// Physical memory of the machine [bytes] (0 if unknown)
+double radPhysicalMemory();
+
+#endif
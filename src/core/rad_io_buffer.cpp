@@ -19,7 +19,7 @@
 
 //-------------------------------------------------------------------------
 
-int radTIOBuffer::AmOfErrors = 139; //modify this when adding new error !!!
+int radTIOBuffer::AmOfErrors = 140; //modify this when adding new error !!!
 string radTIOBuffer::err_ar[] = {
 
 	"Radia::ErrorXXX::::Wrong Error Number.\0",
@@ -148,6 +148,9 @@ string radTIOBuffer::err_ar[] = {
 	"Radia::Error123::::Multiple extruded polygon can not be generated from this input: incorrect definition of transformations at extrusion step(s).\0",
 	"Radia::Error124::::Multiple extruded polygon can not be generated from this input: an extrusion step can not consist of a single homothety without any other transformations.\0",
 	"Radia::Error125::::Failed to generate 3D object from the given input.\0",
+	"Radia::Error126::::H-LU factorization of the relaxation matrix failed (zero pivot). Try a smaller H-LU tolerance or another relaxation method.\0",
+	"Radia::Error127::::Incorrect input: the magnetization array should contain 3 components for each relaxable element of the interaction object.\0",
+	"Radia::Error128::::Relaxation sub-intervals can not be set for an interaction object whose elements were reordered (see SolverElemOrder).\0",
 	"Radia::Error200::::Step size is too small in automatic Runge-Kutta integration routine.\0",
 	"Radia::Error201::::Maximum number of steps exceeded in automatic Runge-Kutta integration routine.\0",
 	"Radia::Error202::::Failed to instantiate object(s).\0",
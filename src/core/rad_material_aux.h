@@ -80,8 +80,10 @@ public:
 		gdMdH_Par = gdMdH_Perp = 0;
 	}
 
-	int Type_Material() { return 4;}
-	virtual int Type_NonlinearAnisotropMaterial() { return 0;}
+	static const int TypeID_Material = 4;
+	int Type_Material() { return TypeID_Material;}
+	static const int TypeID_NonlinearAnisotropMaterial = 0;
+	virtual int Type_NonlinearAnisotropMaterial() { return TypeID_NonlinearAnisotropMaterial;}
 
 	inline TVector3d M(const TVector3d& H);
 	inline void DefineInstantKsiTensor(const TVector3d&, TMatrix3d&, TVector3d&);
@@ -677,7 +679,8 @@ public:
 	//int Type_Material() { return 4;} //same as radTNonlinearAnisotropMaterial
 	//double ScalarInstantKsiAsForIsotropic(double, char); //to correct in radTNonlinearAnisotropMaterial
 	//double ScalarInstantKsi(double, char, TVector3d&); //don't need
-	int Type_NonlinearAnisotropMaterial() { return 1;}
+	static const int TypeID_NonlinearAnisotropMaterial = 1;
+	int Type_NonlinearAnisotropMaterial() { return TypeID_NonlinearAnisotropMaterial;}
 
 	//void FindNewH(TVector3d& H, const TMatrix3d& Matr, const TVector3d& H_Ext, double, radTg3dRelax* pMag, void* pvAuxRelax) //OC140103
 	void FindNewH(TVector3d& H, const TMatrix3d& Matr, const TVector3d& H_Ext, double)
@@ -45,8 +45,10 @@ public:
 	}
 	radTMaterial() { EasyAxisDefined = 0;}
 
-	int Type_g() { return 3;}
-	virtual int Type_Material() { return 0;}
+	static const int TypeID_g = 3;
+	int Type_g() { return TypeID_g;}
+	static const int TypeID_Material = 0;
+	virtual int Type_Material() { return TypeID_Material;}
 
 	virtual TVector3d M(const TVector3d& H) { return 0.*H;}
 	virtual void DefineInstantKsiTensor(const TVector3d&, TMatrix3d&, TVector3d&) {}
@@ -144,7 +146,8 @@ public:
 
 	radTLinearAnisotropMaterial() {}
 
-	int Type_Material() { return 1;}
+	static const int TypeID_Material = 1;
+	int Type_Material() { return TypeID_Material;}
 	
 	inline void SetupKsiTensor();
 	TVector3d M(const TVector3d& H) { return KsiTensor*H + RemMagn;}  // Should we add RemMagn here?
@@ -277,7 +280,8 @@ public:
 
 	radTLinearIsotropMaterial() {}
 
-	int Type_Material() { return 2;}
+	static const int TypeID_Material = 2;
+	int Type_Material() { return TypeID_Material;}
 
 	TVector3d M(const TVector3d& H) { return Ksi * H + RemMagn;} // Should not we add RemMagn here?
 	void DefineInstantKsiTensor(const TVector3d&, TMatrix3d&, TVector3d&);
@@ -431,7 +435,8 @@ public:
 	radTNonlinearIsotropMaterial() { gArrayHM = 0; gLenArrayHM = 0; gdMdH = 0; gMaxKsi = 0;}
 	~radTNonlinearIsotropMaterial() { DeallocateArrays();}
 
-	int Type_Material() { return 3;}
+	static const int TypeID_Material = 3;
+	int Type_Material() { return TypeID_Material;}
 
 	TVector3d M(const TVector3d& H);
 	void DefineInstantKsiTensor(const TVector3d&, TMatrix3d&, TVector3d&);
@@ -739,7 +744,8 @@ public:
 
 	radTPermanentMagnet() {}
 
-	int Type_Material() { return 101;}  // New type ID for permanent magnet
+	static const int TypeID_Material = 101;
+	int Type_Material() { return TypeID_Material;}  // New type ID for permanent magnet
 
 	TVector3d M(const TVector3d& H)
 	{
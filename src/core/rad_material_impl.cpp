@@ -26,7 +26,9 @@
 
 #include <math.h>
 #include <string.h>
+#include <exception>
 
+extern radTYield radYield;
 
 //-------------------------------------------------------------------------
 //-------------------------------------------------------------------------
@@ -772,27 +774,6 @@ int radTApplication::DumpElemParse(const unsigned char *bstr, int bstrLen)
 		char cType1, cType2, cType3, cType4, cType5;
 		map<int, int> mKeysOldNew;
 		vector<int> vElemKeys;
-		
-		radTg3d g3d;
-		radTArcCur arcCur;
-		radTFlmLinCur flmCur;
-		radTBackgroundFieldSource bkgFldSrc;
-		radTGroup grp;
-		radTg3dRelax g3dRelax;
-		radTRecMag recMag;
-		radTSubdividedRecMag sbdRecMag;
-		radTExtrPolygon extPgn;
-		radTSubdividedExtrPolygon sbdExtPgn;
-		radTPolyhedron polyhdr;
-		radTSubdividedPolyhedron sbdPolyhdr;
-		radTrans tr;
-		radTMaterial mat;
-		radTLinearAnisotropMaterial matLinAniso;
-		radTLinearIsotropMaterial matLinIso;
-		radTNonlinearIsotropMaterial matNonLinIso;
-		radTNonlinearAnisotropMaterial matNonLinAniso;
-		radTNonlinearLaminatedMaterial matNonLinLam;
-		radTInteraction intrc;
 
 		for(int i=0; i<nElemTot; i++)
 		{
@@ -806,86 +787,86 @@ int radTApplication::DumpElemParse(const unsigned char *bstr, int bstrLen)
 
 			radThg hg;
 
-			if(cType1 == g3d.Type_g())
+			if(cType1 == radTg3d::TypeID_g)
 			{
-				if(cType2 == g3dRelax.Type_g3d())
+				if(cType2 == radTg3dRelax::TypeID_g3d)
 				{
-					if(cType3 == recMag.Type_g3dRelax())
+					if(cType3 == radTRecMag::TypeID_g3dRelax)
 					{//Instantiate RecMag
 						hg = radThg(new radTRecMag(inStr, mKeysOldNew, GlobalMapOfHandlers));
 					}
-					else if(cType3 == extPgn.Type_g3dRelax())
+					else if(cType3 == radTExtrPolygon::TypeID_g3dRelax)
 					{//Instantiate ExtrPolygon
 						hg = radThg(new radTExtrPolygon(inStr, mKeysOldNew, GlobalMapOfHandlers));
 					}
-					else if(cType3 == polyhdr.Type_g3dRelax())
+					else if(cType3 == radTPolyhedron::TypeID_g3dRelax)
 					{//Instantiate Polyhedron
 						hg = radThg(new radTPolyhedron(inStr, mKeysOldNew, GlobalMapOfHandlers));
 					}
 				}
-				else if(cType2 == grp.Type_g3d())
+				else if(cType2 == radTGroup::TypeID_g3d)
 				{//Instantiate Group
-					if(cType3 == grp.Type_Group())
+					if(cType3 == radTGroup::TypeID_Group)
 					{//Instantiate Group
 						hg = radThg(new radTGroup(inStr, mKeysOldNew, GlobalMapOfHandlers));
 					}
-					else if(cType3 == sbdRecMag.Type_Group())
+					else if(cType3 == radTSubdividedRecMag::TypeID_Group)
 					{
 						hg = radThg(static_cast<radTGroup*>(new radTSubdividedRecMag(inStr, mKeysOldNew, GlobalMapOfHandlers)));
 					}
-					else if(cType3 == sbdExtPgn.Type_Group())
+					else if(cType3 == radTSubdividedExtrPolygon::TypeID_Group)
 					{//Instantiate Subdivided ExtrPolygon
 						hg = radThg(static_cast<radTGroup*>(new radTSubdividedExtrPolygon(inStr, mKeysOldNew, GlobalMapOfHandlers)));
 					}
-					else if(cType3 == sbdPolyhdr.Type_Group())
+					else if(cType3 == radTSubdividedPolyhedron::TypeID_Group)
 					{//Instantiate Subdivided Polyhedron
 						hg = radThg(static_cast<radTGroup*>(new radTSubdividedPolyhedron(inStr, mKeysOldNew, GlobalMapOfHandlers)));
 					}
 				}
-				else if(cType2 == arcCur.Type_g3d())
+				else if(cType2 == radTArcCur::TypeID_g3d)
 				{//Instantiate ArcCur
 					hg = radThg(new radTArcCur(inStr, mKeysOldNew, GlobalMapOfHandlers));
 				}
-				else if(cType2 == flmCur.Type_g3d())
+				else if(cType2 == radTFlmLinCur::TypeID_g3d)
 				{//Instantiate FlmLinCur
 					hg = radThg(new radTFlmLinCur(inStr, mKeysOldNew, GlobalMapOfHandlers));
 				}
-				else if(cType2 == bkgFldSrc.Type_g3d())
+				else if(cType2 == radTBackgroundFieldSource::TypeID_g3d)
 				{//Instantiate BackgroundFieldSource
 					hg = radThg(new radTBackgroundFieldSource(inStr, mKeysOldNew, GlobalMapOfHandlers));
 				}
 			}
-			else if(cType1 == tr.Type_g())
+			else if(cType1 == radTrans::TypeID_g)
 			{//Instantiate Transformation
 				hg = radThg(new radTrans(inStr));
 			}
-			else if(cType1 == mat.Type_g())
+			else if(cType1 == radTMaterial::TypeID_g)
 			{
-				if(cType2 == matLinIso.Type_Material())
+				if(cType2 == radTLinearIsotropMaterial::TypeID_Material)
 				{//Instantiate Linear Isotropic Material
 					hg = radThg(new radTLinearIsotropMaterial(inStr));
 				}
-				else if(cType2 == matLinAniso.Type_Material())
+				else if(cType2 == radTLinearAnisotropMaterial::TypeID_Material)
 				{//Instantiate Linear Anisotropic Material
 					hg = radThg(new radTLinearAnisotropMaterial(inStr));
 				}
-				else if(cType2 == matNonLinIso.Type_Material())
+				else if(cType2 == radTNonlinearIsotropMaterial::TypeID_Material)
 				{//Instantiate Non-Linear Isotropic Material
 					hg = radThg(new radTNonlinearIsotropMaterial(inStr));
 				}
-				else if(cType2 == matNonLinAniso.Type_Material())
+				else if(cType2 == radTNonlinearAnisotropMaterial::TypeID_Material)
 				{//Instantiate Non-Linear Anisotropic Material
-					if(cType3 == matNonLinAniso.Type_NonlinearAnisotropMaterial())
+					if(cType3 == radTNonlinearAnisotropMaterial::TypeID_NonlinearAnisotropMaterial)
 					{
 						hg = radThg(new radTNonlinearAnisotropMaterial(inStr));
 					}
-					else if(cType3 == matNonLinLam.Type_NonlinearAnisotropMaterial())
+					else if(cType3 == radTNonlinearLaminatedMaterial::TypeID_NonlinearAnisotropMaterial)
 					{
 						hg = radThg(new radTNonlinearLaminatedMaterial(inStr));
 					}
 				}
 			}
-			else if(cType1 == intrc.Type_g())
+			else if(cType1 == radTInteraction::TypeID_g)
 			{//Instantiate Interaction Matrix
 				hg = radThg(new radTInteraction(inStr, mKeysOldNew, GlobalMapOfHandlers));
 			}
@@ -1206,8 +1187,7 @@ void radTApplication::GraphicsForAll_g3d(int InShowSymmetryChilds)
 			iter != GlobalMapOfHandlers.end(); ++iter)
 		{
 			radTg* gPtr = ((*iter).second).rep;
-			radTg3d g3d;
-			if(gPtr->Type_g() == g3d.Type_g())
+			if(gPtr->Type_g() == radTg3d::TypeID_g)
 				if(!static_cast<radTg3d*>(gPtr)->IsGroupMember)
 				{
 					g3dPtrPtr[g3dPresElemCount] = static_cast<radTg3d*>(gPtr);
@@ -1301,6 +1281,7 @@ int radTApplication::SetRelaxSubInterval(int InteractElemKey, int StartNo, int F
 		if(!ValidateElemKey(InteractElemKey, hg)) return 0;
 		radTInteraction* InteractPtr = Cast.InteractCast(hg.rep);
 		if(InteractPtr==0) { Send.ErrorMessage("Radia::Error017"); return 0;}
+		if(InteractPtr->ElemsReordered()) { Send.ErrorMessage("Radia::Error128"); return 0;}
 
 		TRelaxSubIntervalID SubIntervalID = (RelaxTogether != 0) ?
 			TRelaxSubIntervalID::RelaxTogether : TRelaxSubIntervalID::RelaxApart;
@@ -1408,6 +1389,7 @@ int radTApplication::MakeManualRelax(int InteractElemKey, int MethNo, int IterNu
 		double RelaxStatusParamArray[3];
 		InteractPtr->OutRelaxStatusParam(RelaxStatusParamArray);
 
+		radYield.ThrowIfCancelled();
 		if(SendingIsRequired) Send.DoubleList(RelaxStatusParamArray, lenRelaxStatusParamArray);
 		return InteractElemKey;
 	}
@@ -1493,7 +1475,18 @@ int radTApplication::MakeAutoRelax(int InteractElemKey, double PrecOnMagnetiz, i
 				ActualIterNum = RelaxMethNo_8.AutoRelax(PrecOnMagnetiz, MaxIterNumber, MagnResetIsNotNeeded);
 			}
 			break;
+			case 9:
+			{
+				try
+				{
+					radTRelaxationMethNo_9 RelaxMethNo_9(InteractPtr);
+					ActualIterNum = RelaxMethNo_9.AutoRelax(PrecOnMagnetiz, MaxIterNumber, MagnResetIsNotNeeded);
+				}
+				catch(const std::exception&) { Send.ErrorMessage("Radia::Error126"); return 0;}
 			}
+			break;
+			}
+			radYield.ThrowIfCancelled();
 
 			InteractPtr->OutRelaxStatusParam(RelaxStatusParamArray);
 		}
@@ -1534,6 +1527,36 @@ int radTApplication::UpdateSourcesForRelax(int InteractElemKey)
 
 //-------------------------------------------------------------------------
 
+void radTApplication::InteractMatrixProduct(int InteractElemKey, double* pM, int nM, int Transposed)
+{
+	try
+	{
+		radThg hg;
+		if(!ValidateElemKey(InteractElemKey, hg)) return;
+		radTInteraction* InteractPtr = Cast.InteractCast(hg.rep); 
+		if(InteractPtr==0) { Send.ErrorMessage("Radia::Error017"); return;}
+
+		int AmOfElem = InteractPtr->OutAmOfRelaxObjs();
+		if((pM == 0) || (nM != 3*AmOfElem)) { Send.ErrorMessage("Radia::Error127"); return;}
+
+		std::vector<TVector3d> vM(AmOfElem), vH(AmOfElem), vHout(AmOfElem);
+		for(int i=0; i<AmOfElem; i++)
+		{//arrays in input order of the elements
+			int k = InteractPtr->InputElemNo(i);
+			vM[i] = TVector3d(pM[3*k], pM[3*k + 1], pM[3*k + 2]);
+		}
+
+		InteractPtr->MatVec(vM.data(), vH.data(), (Transposed != 0));
+
+		for(int i=0; i<AmOfElem; i++) vHout[InteractPtr->InputElemNo(i)] = vH[i];
+		Send.ArrayOfVector3d(vHout.data(), AmOfElem);
+	}
+	catch(...)
+	{
+		Initialize(); return;
+	}
+}
+
 int radTApplication::SolveGen(int ObjKey, double PrecOnMagnetiz, int MaxIterNumber, int MethNo)
 {
 	long ActualIterNum = 0;
@@ -1560,6 +1583,7 @@ int radTApplication::SolveGen(int ObjKey, double PrecOnMagnetiz, int MaxIterNumb
 				radTRelaxationMethNo_7 SolveMethNo_7(hg, CompCriterium);
 				ActualIterNum = SolveMethNo_7.AutoRelax(PrecOnMagnetiz, MaxIterNumber, RelaxStatusParamArray);
 			}
+			radYield.ThrowIfCancelled();
 
 			if(ActualIterNum >= MaxIterNumber) 
 			{ 
@@ -2042,6 +2066,7 @@ int radTApplication::SetCompPrecisions(const char** ValNames, double* Values, in
 			else if(!strcmp(*BufString, OptionNames.Energy)) CompCriterium.AbsPrecEnergy = *Ptr;
 			else if(!strcmp(*BufString, OptionNames.Coord)) CompCriterium.AbsPrecTrjCoord = *Ptr;
 			else if(!strcmp(*BufString, OptionNames.Angle)) CompCriterium.AbsPrecTrjAngle = *Ptr;
+			else if(!strcmp(*BufString, OptionNames.Far)) CompCriterium.FarRelPrec = *Ptr;
 			else { Send.ErrorMessage("Radia::Error057"); return 0;}
 			BufString++; Ptr++;
 		}
@@ -24,7 +24,7 @@
 //-------------------------------------------------------------------------
 
 struct radTOptionNames {
-	char B[25], A[25], BInt[25], Force[25], Torque[25], Energy[25], Coord[25], Angle[25]; // Precisions
+	char B[25], A[25], BInt[25], Force[25], Torque[25], Energy[25], Coord[25], Angle[25], Far[25]; // Precisions
 
 	char Frame[25], FrameValues[3][25];
 	char SubdParamCode[25], SubdParamBorderCode[25], SubdParamCodeValues[2][25];
@@ -56,6 +56,7 @@ struct radTOptionNames {
 		strncpy(Energy, "PrcEnergy", 24); Energy[24] = '\0';
 		strncpy(Coord, "PrcCoord", 24); Coord[24] = '\0';
 		strncpy(Angle, "PrcAngle", 24); Angle[24] = '\0';
+		strncpy(Far, "PrcFar", 24); Far[24] = '\0';
 
 		strncpy(Frame, "Frame", 24); Frame[24] = '\0';
 		strncpy(FrameValues[0], "Loc", 24); FrameValues[0][24] = '\0';
@@ -132,6 +133,7 @@ struct radTOptionNames {
 		mOptData[Energy] = vRealVal;
 		mOptData[Coord] = vRealVal;
 		mOptData[Angle] = vRealVal;
+		mOptData[Far] = vRealVal;
 		mOptData[TriAngMin] = vRealVal;
 		mOptData[TriAreaMax] = vRealVal;
 
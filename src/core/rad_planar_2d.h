@@ -52,7 +52,8 @@ public:
 	}
 	radTRectangle() {}
 
-	int Type_g3d() { return 5;}
+	static const int TypeID_g3d = 5;
+	int Type_g3d() { return TypeID_g3d;}
 
 	void IntOverShape(radTField* FieldPtr) 
 	{
@@ -258,7 +259,8 @@ public:
 	radTPolygon(CAuxBinStrVect& inStr);
 	radTPolygon() { CoordZ =0.; SomethingIsWrong = 0;}
 
-	virtual int Type_g3d() { return 6;}
+	static const int TypeID_g3d = 6;
+	virtual int Type_g3d() { return TypeID_g3d;}
 
 	int DuplicateItself(radThg& hg, radTApplication*, char) 
 	{
@@ -280,7 +282,8 @@ public:
 	void CheckAndRearrangeEdgePoints(TVector2d*, int);
 	void CheckAndRearrangeEdgePoints(radTVect2dVect&);
 
-	void B_comp(radTField*);
+	void B_comp(radTField* FieldPtr) { B_compWithMagn(FieldPtr, Magn);}
+	void B_compWithMagn(radTField*, const TVector3d&) const;
 	void B_intComp(radTField*);
 	void B_intCompSpecCases(radTField*, const TSpecCaseID&);
 
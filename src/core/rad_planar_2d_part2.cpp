@@ -26,11 +26,13 @@ extern radTYield radYield;
 //-------------------------------------------------------------------------
 //-------------------------------------------------------------------------
 
-void radTPolygon::B_comp(radTField* FieldPtr)
+void radTPolygon::B_compWithMagn(radTField* FieldPtr, const TVector3d& InMagn) const
 {
 // Orientation: The Polygon normal parallel to vertical ort !!!
 // NOTE: This function uses the analytical formula from radpoly_analytical.cpp
 //       for improved performance and simplicity.
+// Magnetization (in the polygon frame) is an argument and only *FieldPtr is written,
+// so one polygon may be evaluated from several threads.
 
 	const double PI = 3.14159265358979;
 	const double ConstForH = 1./4./PI;
@@ -39,7 +41,7 @@ void radTPolygon::B_comp(radTField* FieldPtr)
 	if(radYield.Check()==0) return;
 
 	// Get observation point
-	TVector3d& ObsPo = FieldPtr->P;
+	const TVector3d& ObsPo = FieldPtr->P;
 
 	// Check which field components are needed
 	short A_CompNeeded = FieldPtr->FieldKey.A_;
@@ -49,46 +51,28 @@ void radTPolygon::B_comp(radTField* FieldPtr)
 
 	// Handle singularity: if observation point is on polygon plane
 	double z = CoordZ - ObsPo.z;
-	TVector3d ObsPoOriginal = ObsPo;  // Save original
 	if(z == 0.)
 	{
-		// Shift observation point slightly
+		// Shift observation point slightly (locally)
 		double AbsRandZ = radCR.AbsRandMagnitude(CoordZ);
 		if(AbsRandZ == 0.) AbsRandZ = 1.e-15;
 		z = AbsRandZ;
-		ObsPo.z -= AbsRandZ;
 	}
+	// Point on the inner side of the face (normal is outward); a polyhedron adds M where all faces report this
+	FieldPtr->PointIsInsideFrame = (z > 0.)? 1 : 0;
 
 	// ========================================================================
 	// Use analytical formula for field calculation
 	// ========================================================================
 
-	// Setup local coordinate system (polygon is in XY plane at z=CoordZ)
-	TVector3d AA(1, 0, 0);  // Local X-axis
-	TVector3d BB(0, 1, 0);  // Local Y-axis
-	TVector3d CC(0, 0, 1);  // Normal (Z-axis)
-	TVector3d YY(0, 0, CoordZ);  // Reference point on polygon plane
-
-	// Prepare observation point in single-element vector
-	std::vector<TVector3d> obs_points(1, ObsPo);
-	std::vector<TVector3d> field_result(1, TVector3d(0, 0, 0));
-
-	// Magnetic charge density (from Magn.z)
-	double W = ConstForH * Magn.z;
-
-	// Call analytical formula
-	RadAnalyticalFieldFromPolygonCharge(
-		AA, BB, CC, YY,
-		EdgePointsVector,  // Polygon vertices in 2D
-		obs_points,
-		field_result,
-		W,
-		1,  // Element index (for error reporting)
-		AmOfEdgePoints
-	);
-
-	// Extract result
-	TVector3d& H_field = field_result[0];
+	// Polygon is in the XY plane at z=CoordZ; single point, no temporary arrays
+	double X = ObsPo.x, Y = ObsPo.y, Z = -z;
+	TVector3d H_field(0, 0, 0);
+
+	// Magnetic charge density (from InMagn.z); unit charge for the interaction matrix
+	double W = FieldPtr->FieldKey.PreRelax_? ConstForH : ConstForH * InMagn.z;
+
+	RadAnalyticalFieldFromPolygonChargeBatch(EdgePointsVector.data(), AmOfEdgePoints, W, &X, &Y, &Z, 1, &H_field.x, &H_field.y, &H_field.z);
 
 	// ========================================================================
 	// Apply results to FieldPtr
@@ -98,10 +82,10 @@ void radTPolygon::B_comp(radTField* FieldPtr)
 	{
 		if(FieldPtr->FieldKey.PreRelax_)
 		{
-			// Special handling for relaxation
-			TVector3d St0(0., 0., -H_field.x);
-			TVector3d St1(0., 0., -H_field.y);
-			TVector3d St2(0., 0., -H_field.z);
+			// Special handling for relaxation: H = Q*Magn, only Magn.z makes charge
+			TVector3d St0(0., 0., H_field.x);
+			TVector3d St1(0., 0., H_field.y);
+			TVector3d St2(0., 0., H_field.z);
 			FieldPtr->B += St0;
 			FieldPtr->H += St1;
 			FieldPtr->A += St2;
@@ -116,14 +100,11 @@ void radTPolygon::B_comp(radTField* FieldPtr)
 	if(A_CompNeeded)
 	{
 		// Vector potential calculation
-		// A = -z * H_z in the direction perpendicular to Magn
+		// A = -z * H_z in the direction perpendicular to InMagn
 		double AS = -z * H_field.z;
-		TVector3d BufA(-Magn.y, Magn.x, 0.);
+		TVector3d BufA(-InMagn.y, InMagn.x, 0.);
 		FieldPtr->A += AS * BufA;
 	}
-
-	// Restore original observation point
-	ObsPo = ObsPoOriginal;
 }
 
 //-------------------------------------------------------------------------
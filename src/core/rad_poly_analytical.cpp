@@ -15,12 +15,18 @@
 #include "rad_poly_analytical.h"
 #include <cmath>
 #include <algorithm>
-#include <iostream>
 
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#define RAD_PRAGMA(x) _Pragma(#x)
+#define RAD_SIMD RAD_PRAGMA(omp simd)
+#else
+#define RAD_SIMD
+#endif
+
 //-------------------------------------------------------------------------
 // Helper functions
 //-------------------------------------------------------------------------
@@ -37,168 +43,223 @@ inline double SQ2(double x, double y)
 
 //-------------------------------------------------------------------------
 /**
- * Compute field from polygon magnetic charge using analytical formula
+ * Field from polygon magnetic charge at many points, in the frame of the polygon
  *
- * @param AA Local coordinate system X-axis (unit vector)
- * @param BB Local coordinate system Y-axis (unit vector)
- * @param CC Local coordinate system Z-axis (normal vector)
- * @param YY Reference point on polygon (3D)
- * @param XY Polygon vertices in local 2D coordinates (KAdo points)
- * @param XX Observation points in global 3D coordinates (MXX points)
- * @param FGH Output: magnetic field at each observation point (3 x MXX)
- * @param W Magnetic charge density (weight)
- * @param MXX Number of observation points
- * @param NII Element index (for error reporting)
- * @param KAdo Number of polygon vertices (3 or 4)
+ * Points are processed in tiles on stack buffers; for each edge (and each
+ * triangle of the fan from vertex 0) the loops over the points of a tile are
+ * vectorizable, the log / atan2 calls are made in separate loops.
  *
- * @note This function uses the analytical formula:
- *       H = (1/4pi) * integral sigma * dOmega
- *       where dOmega is the solid angle subtended by each edge
+ * In-plane components: line integrals of 1/R along the edges,
+ *   H_in = -W * sum_J n_J * log((R_J + R_J+1 - DS_J)/(R_J + R_J+1 + DS_J))
+ *   (n_J: outward in-plane normal of edge J).
+ * Normal component: W times the solid angle of the polygon, summed over the
+ * triangles (0, k, k+1) by the Van Oosterom - Strackee formula
+ *   tan(Omega/2) = Z*C_k / (r0*rk*rk1 + (v0.vk)*rk1 + (v0.vk1)*rk + (vk.vk1)*r0)
+ *   (C_k: twice the signed area of the triangle, v: vertex to point vectors).
  */
-void RadAnalyticalFieldFromPolygonCharge(
-	const TVector3d& AA,
-	const TVector3d& BB,
-	const TVector3d& CC,
-	const TVector3d& YY,
-	const std::vector<TVector2d>& XY,  // Polygon vertices in 2D local coords
-	const std::vector<TVector3d>& XX,  // Observation points in 3D
-	std::vector<TVector3d>& FGH,       // Output: field at each point
-	double W,                           // Magnetic charge density
-	int NII,                            // Element index
-	int KAdo)                           // Number of vertices (3 or 4)
+void RadAnalyticalFieldFromPolygonChargeBatch(
+	const TVector2d* XY,
+	int KAdo,
+	double W,
+	const double* ArrX,
+	const double* ArrY,
+	const double* ArrZ,
+	int AmOfPoints,
+	double* ArrHx,
+	double* ArrHy,
+	double* ArrHz)
 {
-	const double ONE = 1.0;
-	const double ZER = 0.0;
 	const double EPS = 1.0e-20;
-	const double BIG = 1.0e20;
+	const int TileSize = 64;
 
-	int MXX = static_cast<int>(XX.size());
-	if(MXX == 0) return;
-
-	// Ensure output array is sized correctly
-	if(FGH.size() != static_cast<size_t>(MXX)) {
-		FGH.resize(MXX, TVector3d(0, 0, 0));
-	}
-
-	// Compute edge properties
-	std::vector<double> DS(4);   // Edge lengths
-	std::vector<double> AM(4);   // Slopes (dy/dx)
-	std::vector<double> SM(4);   // sqrt(1 + slope^2)
-	std::vector<double> XD(4);   // Edge direction X
-	std::vector<double> YD(4);   // Edge direction Y
+	if((KAdo < 3) || (AmOfPoints <= 0)) return;
 
 	double EPSG = 0.0;
-	double ZONE = (KAdo == 3) ? ZER : ONE;
-
-	// Compute edge parameters
 	for(int J = 0; J < KAdo; J++) {
-		int L = (J + 1) % KAdo;  // Next vertex
-
-		double XS1 = XY[L].x - XY[J].x;
-		double XS2 = XY[L].y - XY[J].y;
-
-		if(std::abs(XS1) < EPS) {
-			// Vertical edge - handle specially
-			std::cerr << "[Warning] RadAnalyticalFieldFromPolygonCharge: vertical edge in element "
-			          << NII << std::endl;
-			XS1 = EPS;
-		}
-
-		DS[J] = SQ2(XS2, XS1);
-		AM[J] = XS2 / XS1;
-		SM[J] = std::sqrt(AM[J]*AM[J] + ONE);
-		XD[J] = -XS1 / DS[J];
-		YD[J] =  XS2 / DS[J];
-
-		EPSG = std::max(EPSG, DS[J]);
+		int L = (J + 1) % KAdo;
+		EPSG = std::max(EPSG, SQ2(XY[L].x - XY[J].x, XY[L].y - XY[J].y));
 	}
-
 	EPSG = EPSG * 1.0e-12;  // Tolerance for z=0 check
 
-	// For triangle, set 4th edge to dummy values
-	if(KAdo == 3) {
-		DS[3] = ONE;
-		AM[3] = ZER;
-		SM[3] = BIG;
-		XD[3] = ZER;
-		YD[3] = ZER;
-	}
-
-	// Main loop over observation points (can be parallelized)
-	#pragma omp parallel for if(MXX > 100)
-	for(int I = 0; I < MXX; I++) {
-		// Transform observation point to local coordinates
-		TVector3d DD = XX[I] - YY;
-
-		double EE1 = DD.x*AA.x + DD.y*AA.y + DD.z*AA.z;  // X in local frame
-		double EE2 = DD.x*BB.x + DD.y*BB.y + DD.z*BB.z;  // Y in local frame
-		double EE3 = DD.x*CC.x + DD.y*CC.y + DD.z*CC.z;  // Z in local frame (height)
-
-		// Compute distances from observation point to vertices
-		std::vector<double> X(4), Y(4), H(4), E(4), R(4);
-
-		for(int J = 0; J < 4; J++) {
-			X[J] = EE1 - XY[J].x;
-			Y[J] = EE2 - XY[J].y;
-			H[J] = Y[J] * X[J];
+	double DX0[TileSize], DY0[TileSize], R0[TileSize];  // Point relative to vertex 0
+	double DX1[TileSize], DY1[TileSize], R1[TileSize];  // Point relative to the other vertices (two buffers used in turn)
+	double DX2[TileSize], DY2[TileSize], R2[TileSize];
+	double Buf[TileSize], Buf2[TileSize];
+	double HH1[TileSize], HH2[TileSize], HH3[TileSize];
+
+	for(int Start = 0; Start < AmOfPoints; Start += TileSize) {
+		int n = std::min(TileSize, AmOfPoints - Start);
+		const double *X = ArrX + Start, *Y = ArrY + Start, *Z = ArrZ + Start;
+
+		const double X0 = XY[0].x, Y0 = XY[0].y;
+		RAD_SIMD
+		for(int i = 0; i < n; i++) {
+			DX0[i] = X[i] - X0;
+			DY0[i] = Y[i] - Y0;
+			R0[i] = SQR3(DX0[i], DY0[i], Z[i]);
 		}
 
-		double Z = EE3;
-		double Z2 = Z * Z;
-
-		for(int J = 0; J < 4; J++) {
-			E[J] = Z2 + X[J]*X[J];
-			R[J] = SQR3(X[J], Y[J], Z);
-		}
-
-		// Compute edge contributions
-		std::vector<double> RM(4), RP(4), RR(4), AL(4);
+		// Point relative to the first (a) and second (b) vertex of the current edge; buffers are
+		// swapped rather than copied from edge to edge (copy loops become slow rep movs for small tiles)
+		double *DXa = DX0, *DYa = DY0, *Ra = R0;
+		double *DXb = DX1, *DYb = DY1, *Rb = R1;
+
+		for(int J = 0; J < KAdo; J++) {
+			int L = (J + 1 < KAdo)? J + 1 : 0;
+			const double XL = XY[L].x, YL = XY[L].y;
+			const double XS1 = XL - XY[J].x, XS2 = YL - XY[J].y;
+			const double DS = SQ2(XS1, XS2);
+			const double TX = (DS > 0.)? XS1/DS : 0., TY = (DS > 0.)? XS2/DS : 0.;
+
+			if(L == 0) { DXb = DX0; DYb = DY0; Rb = R0;}  // Closing edge ends at vertex 0
+			else {
+				RAD_SIMD
+				for(int i = 0; i < n; i++) {
+					DXb[i] = X[i] - XL;
+					DYb[i] = Y[i] - YL;
+					Rb[i] = SQR3(DXb[i], DYb[i], Z[i]);
+				}
+			}
+			RAD_SIMD
+			for(int i = 0; i < n; i++) {
+				double RaPlRb = Ra[i] + Rb[i];
+				Buf[i] = std::max((RaPlRb - DS)/(RaPlRb + DS), EPS);
+			}
+			for(int i = 0; i < n; i++) Buf[i] = std::log(Buf[i]);
+
+			if(J == 0) {
+				RAD_SIMD
+				for(int i = 0; i < n; i++) {
+					HH1[i] = -TY*Buf[i];
+					HH2[i] = TX*Buf[i];
+				}
+			}
+			else {
+				RAD_SIMD
+				for(int i = 0; i < n; i++) {
+					HH1[i] -= TY*Buf[i];
+					HH2[i] += TX*Buf[i];
+				}
+			}
 
-		for(int J = 0; J < 4; J++) {
-			int JP1 = (J + 1) % 4;
+			// Triangle (0, J, J+1) of the fan
+			if((J >= 1) && (J <= KAdo - 2)) {
+				const double C = (XY[0].x - XY[J].x)*(XY[0].y - YL) - (XY[0].y - XY[J].y)*(XY[0].x - XL);
+				RAD_SIMD
+				for(int i = 0; i < n; i++) {
+					double Z2 = Z[i]*Z[i];
+					double V0Va = DX0[i]*DXa[i] + DY0[i]*DYa[i] + Z2;
+					double V0Vb = DX0[i]*DXb[i] + DY0[i]*DYb[i] + Z2;
+					double VaVb = DXa[i]*DXb[i] + DYa[i]*DYb[i] + Z2;
+					Buf[i] = Z[i]*C;
+					Buf2[i] = R0[i]*Ra[i]*Rb[i] + V0Va*Rb[i] + V0Vb*Ra[i] + VaVb*R0[i];
+				}
+				if(J == 1) for(int i = 0; i < n; i++) HH3[i] = 2.*std::atan2(Buf[i], Buf2[i]);
+				else for(int i = 0; i < n; i++) HH3[i] += 2.*std::atan2(Buf[i], Buf2[i]);
+			}
 
-			RM[J] = R[J] + R[JP1] - DS[J];
-			RP[J] = R[J] + R[JP1] + DS[J];
-			RR[J] = std::max(RM[J] / RP[J], EPS);
-			AL[J] = std::log(RR[J]);
+			double *DXc = (DXa == DX0)? DX2 : DXa, *DYc = (DYa == DY0)? DY2 : DYa, *Rc = (Ra == R0)? R2 : Ra;
+			DXa = DXb; DYa = DYb; Ra = Rb;
+			DXb = DXc; DYb = DYc; Rb = Rc;
 		}
 
-		// Compute field components in local frame
-		double HH1 = W * (-YD[0]*AL[0] - YD[1]*AL[1] - YD[2]*AL[2] - YD[3]*AL[3]);
-		double HH2 = W * (-XD[0]*AL[0] - XD[1]*AL[1] - XD[2]*AL[2] - XD[3]*AL[3]);
-		double HH3 = ZER;
-
-		// Z-component (solid angle contribution)
-		if(std::abs(Z) > EPSG) {
-			std::vector<double> ZR(4), AT(4), BT(4);
+		double *Hx = ArrHx + Start, *Hy = ArrHy + Start, *Hz = ArrHz + Start;
+		RAD_SIMD
+		for(int i = 0; i < n; i++) {
+			Hx[i] += W*HH1[i];
+			Hy[i] += W*HH2[i];
+			Hz[i] += (std::abs(Z[i]) > EPSG)? W*HH3[i] : 0.;  // No normal component in the plane of the polygon
+		}
+	}
+}
 
-			for(int J = 0; J < 4; J++) {
-				ZR[J] = Z * R[J];
-			}
+//-------------------------------------------------------------------------
+// Field of a polygon given by a vertex array at points in global coordinates
+//-------------------------------------------------------------------------
 
-			// Compute arctan terms
-			for(int J = 0; J < 4; J++) {
-				int JP1 = (J + 1) % 4;
+static void RadFieldFromPolygonChargeInFrame(
+	const TVector3d& AA,
+	const TVector3d& BB,
+	const TVector3d& CC,
+	const TVector3d& YY,
+	const TVector2d* XY,
+	int KAdo,
+	const std::vector<TVector3d>& XX,
+	std::vector<TVector3d>& FGH,
+	double W)
+{
+	const int TileSize = 64;
 
-				AT[J] = (AM[J]*E[J] - H[J]) / ZR[J];
-				BT[J] = (AM[J]*E[JP1] - H[JP1]) / ZR[JP1];
-			}
+	int MXX = static_cast<int>(XX.size());
+	if(MXX == 0) return;
 
-			// Special handling for triangle (4th term)
-			AT[3] = AT[3] * ZONE;
-			BT[3] = BT[3] * ZONE;
+	// Ensure output array is sized correctly
+	if(FGH.size() != static_cast<size_t>(MXX)) {
+		FGH.resize(MXX, TVector3d(0, 0, 0));
+	}
+	int AmOfTiles = (MXX + TileSize - 1) / TileSize;
 
-			HH3 = W * (-std::atan(AT[0]) - std::atan(AT[1]) - std::atan(AT[2]) - std::atan(AT[3])
-			          + std::atan(BT[0]) + std::atan(BT[1]) + std::atan(BT[2]) + std::atan(BT[3]));
+	// Tiles of points transformed to the local frame, on stack buffers
+	#pragma omp parallel for if(MXX > 100)
+	for(int T = 0; T < AmOfTiles; T++) {
+		double EE1[TileSize], EE2[TileSize], EE3[TileSize], HH1[TileSize], HH2[TileSize], HH3[TileSize];
+		int Start = T * TileSize;
+		int n = std::min(TileSize, MXX - Start);
+		for(int i = 0; i < n; i++) {
+			TVector3d DD = XX[Start + i] - YY;
+			EE1[i] = DD.x*AA.x + DD.y*AA.y + DD.z*AA.z;  // X in local frame
+			EE2[i] = DD.x*BB.x + DD.y*BB.y + DD.z*BB.z;  // Y in local frame
+			EE3[i] = DD.x*CC.x + DD.y*CC.y + DD.z*CC.z;  // Z in local frame (height)
+			HH1[i] = HH2[i] = HH3[i] = 0.;
 		}
 
+		RadAnalyticalFieldFromPolygonChargeBatch(XY, KAdo, W, EE1, EE2, EE3, n, HH1, HH2, HH3);
+
 		// Transform field back to global coordinates
-		FGH[I].x += HH1*AA.x + HH2*BB.x + HH3*CC.x;
-		FGH[I].y += HH1*AA.y + HH2*BB.y + HH3*CC.y;
-		FGH[I].z += HH1*AA.z + HH2*BB.z + HH3*CC.z;
+		for(int i = 0; i < n; i++) {
+			TVector3d& F = FGH[Start + i];
+			F.x += HH1[i]*AA.x + HH2[i]*BB.x + HH3[i]*CC.x;
+			F.y += HH1[i]*AA.y + HH2[i]*BB.y + HH3[i]*CC.y;
+			F.z += HH1[i]*AA.z + HH2[i]*BB.z + HH3[i]*CC.z;
+		}
 	}
 }
 
+//-------------------------------------------------------------------------
+/**
+ * Compute field from polygon magnetic charge using analytical formula
+ *
+ * @param AA Local coordinate system X-axis (unit vector)
+ * @param BB Local coordinate system Y-axis (unit vector)
+ * @param CC Local coordinate system Z-axis (normal vector)
+ * @param YY Reference point on polygon (3D)
+ * @param XY Polygon vertices in local 2D coordinates (KAdo points)
+ * @param XX Observation points in global 3D coordinates (MXX points)
+ * @param FGH Output: magnetic field at each observation point (3 x MXX)
+ * @param W Magnetic charge density (weight)
+ * @param MXX Number of observation points
+ * @param NII Element index (not used)
+ * @param KAdo Number of polygon vertices (any number >= 3)
+ *
+ * @note This function uses the analytical formula:
+ *       H = (1/4pi) * integral sigma * dOmega
+ *       where dOmega is the solid angle subtended by each edge
+ */
+void RadAnalyticalFieldFromPolygonCharge(
+	const TVector3d& AA,
+	const TVector3d& BB,
+	const TVector3d& CC,
+	const TVector3d& YY,
+	const std::vector<TVector2d>& XY,  // Polygon vertices in 2D local coords
+	const std::vector<TVector3d>& XX,  // Observation points in 3D
+	std::vector<TVector3d>& FGH,       // Output: field at each point
+	double W,                           // Magnetic charge density
+	int NII,                            // Element index
+	int KAdo)                           // Number of vertices
+{
+	RadFieldFromPolygonChargeInFrame(AA, BB, CC, YY, XY.data(), std::min(KAdo, static_cast<int>(XY.size())), XX, FGH, W);
+}
+
 //-------------------------------------------------------------------------
 /**
  * Compute field from triangular magnetic charge
@@ -218,8 +279,8 @@ void RadAnalyticalFieldFromTriangleCharge(
 	double W,
 	int NII)
 {
-	std::vector<TVector2d> XY = {V1, V2, V3};
-	RadAnalyticalFieldFromPolygonCharge(AA, BB, CC, YY, XY, XX, FGH, W, NII, 3);
+	TVector2d XY[] = {V1, V2, V3};
+	RadFieldFromPolygonChargeInFrame(AA, BB, CC, YY, XY, 3, XX, FGH, W);
 }
 
 //-------------------------------------------------------------------------
@@ -242,6 +303,6 @@ void RadAnalyticalFieldFromQuadCharge(
 	double W,
 	int NII)
 {
-	std::vector<TVector2d> XY = {V1, V2, V3, V4};
-	RadAnalyticalFieldFromPolygonCharge(AA, BB, CC, YY, XY, XX, FGH, W, NII, 4);
+	TVector2d XY[] = {V1, V2, V3, V4};
+	RadFieldFromPolygonChargeInFrame(AA, BB, CC, YY, XY, 4, XX, FGH, W);
 }
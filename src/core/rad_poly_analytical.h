@@ -39,8 +39,8 @@
  * @param XX Observation points in global 3D coordinates
  * @param FGH Output: accumulated magnetic field at each observation point
  * @param W Magnetic charge density (weight)
- * @param NII Element index (for error reporting)
- * @param KAdo Number of polygon vertices (3 for triangle, 4 for quad)
+ * @param NII Element index (not used)
+ * @param KAdo Number of polygon vertices (any number >= 3)
  */
 void RadAnalyticalFieldFromPolygonCharge(
 	const TVector3d& AA,
@@ -54,6 +54,29 @@ void RadAnalyticalFieldFromPolygonCharge(
 	int NII,
 	int KAdo);
 
+/**
+ * Compute field from polygon magnetic charge at many points (no heap allocation)
+ *
+ * The polygon lies in the plane z = 0 of the frame of the points, vertices
+ * counter-clockwise. Points are given as separate coordinate arrays; the field
+ * is added to ArrHx, ArrHy, ArrHz. Loops over the points are vectorizable.
+ *
+ * @param XY Polygon vertices (KAdo points)
+ * @param KAdo Number of polygon vertices (any number >= 3)
+ * @param W Magnetic charge density (weight)
+ */
+void RadAnalyticalFieldFromPolygonChargeBatch(
+	const TVector2d* XY,
+	int KAdo,
+	double W,
+	const double* ArrX,
+	const double* ArrY,
+	const double* ArrZ,
+	int AmOfPoints,
+	double* ArrHx,
+	double* ArrHy,
+	double* ArrHz);
+
 /**
  * Compute field from triangular magnetic charge
  */
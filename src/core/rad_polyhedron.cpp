@@ -23,6 +23,11 @@
 #include "rad_geometry_3d_aux.h"
 #include "rad_application.h"
 #include "auxparse.h"
+#include "rad_poly_analytical.h"
+
+//-------------------------------------------------------------------------
+
+extern radTYield radYield;
 
 //-------------------------------------------------------------------------
 //-------------------------------------------------------------------------
@@ -432,9 +437,165 @@ int radTPolyhedron::FillInTransAndFacesInLocFrames(TVector3d* ArrayOfPoints, int
 
 //-------------------------------------------------------------------------
 
-void radTPolyhedron::B_comp_frM(radTField* FieldPtr)
+void radTPolyhedron::SetupFaceTable()
+{// Face frames and vertices copied to flat arrays; face transforms are rotations about the origin (see FillInTransAndFacesInLocFrames)
+	FaceTable.clear(); FaceVertices.clear();
+	int AmOfFacesLoc = (int)VectHandlePgnAndTrans.size();
+	if(AmOfFacesLoc != AmOfFaces) return;
+
+	TVector3d Zero(0.,0.,0.), E[] = {TVector3d(1.,0.,0.), TVector3d(0.,1.,0.), TVector3d(0.,0.,1.)};
+	int AmOfVertices = 0;
+	for(int i=0; i<AmOfFaces; i++)
+	{
+		radTPolygon* PgnPtr = VectHandlePgnAndTrans[i].PgnHndl.rep;
+		radTrans* TransPtr = VectHandlePgnAndTrans[i].TransHndl.rep;
+		if((PgnPtr == 0) || (TransPtr == 0) || (PgnPtr->AmOfEdgePoints < 3)) { FaceTable.clear(); return;}
+		if(TransPtr->TrPoint_inv(Zero) != Zero) { FaceTable.clear(); return;}
+		AmOfVertices += PgnPtr->AmOfEdgePoints;
+	}
+	FaceTable.resize(AmOfFaces);
+	FaceVertices.reserve(AmOfVertices);
+
+	for(int i=0; i<AmOfFaces; i++)
+	{
+		radTPolygon* PgnPtr = VectHandlePgnAndTrans[i].PgnHndl.rep;
+		radTrans* TransPtr = VectHandlePgnAndTrans[i].TransHndl.rep;
+		radTPolyhedronFace& Face = FaceTable[i];
+
+		TVector3d InvCol[3];
+		for(int k=0; k<3; k++)
+		{
+			InvCol[k] = TransPtr->TrBiPoint_inv(E[k]);
+			Face.Col[k] = TransPtr->TrVectField(E[k]);
+		}
+		Face.Row[0] = TVector3d(InvCol[0].x, InvCol[1].x, InvCol[2].x);
+		Face.Row[1] = TVector3d(InvCol[0].y, InvCol[1].y, InvCol[2].y);
+		Face.Row[2] = TVector3d(InvCol[0].z, InvCol[1].z, InvCol[2].z);
+
+		Face.CoordZ = PgnPtr->CoordZ;
+		Face.FirstVertex = (int)FaceVertices.size();
+		Face.AmOfVertices = PgnPtr->AmOfEdgePoints;
+		FaceVertices.insert(FaceVertices.end(), PgnPtr->EdgePointsVector.begin(), PgnPtr->EdgePointsVector.begin() + PgnPtr->AmOfEdgePoints);
+	}
+}
+
+//-------------------------------------------------------------------------
+
+void radTPolyhedron::B_comp_frM_Faces(radTField* FieldPtr, const TVector3d& InMagn) const
+{// Same as B_comp_frM with radTPolygon::B_comp of each face, on the flat face table
+	const double ConstForH = 1./4./3.14159265358979;
+
+	radTFieldKey& FldKey = FieldPtr->FieldKey;
+	const TVector3d& P = FieldPtr->P;
+	if(!FldKey.PreRelax_)
+	{// Accumulated in place by the lean kernel (same order of additions as the field record)
+		short PointIsInside = 0;
+		if(FldKey.A_)
+		{
+			radTLeanField<true, true, true> Acc;
+			Acc.B = FieldPtr->B; Acc.H = FieldPtr->H; Acc.A = FieldPtr->A;
+			PointIsInside = B_compLean(P, InMagn, Acc);
+			if(FldKey.B_) FieldPtr->B = Acc.B;
+			if(FldKey.H_) FieldPtr->H = Acc.H;
+			FieldPtr->A = Acc.A;
+		}
+		else
+		{
+			radTFieldBH Acc;
+			Acc.B = FieldPtr->B; Acc.H = FieldPtr->H;
+			PointIsInside = B_compLean(P, InMagn, Acc);
+			if(FldKey.B_) FieldPtr->B = Acc.B;
+			if(FldKey.H_) FieldPtr->H = Acc.H;
+		}
+		if(FldKey.M_) if(PointIsInside) FieldPtr->M += InMagn;
+		return;
+	}
+
+	if(radYield.Check()==0) return;
+
+	TMatrix3d SumQ(TVector3d(0.,0.,0.), TVector3d(0.,0.,0.), TVector3d(0.,0.,0.));
+	for(int i=0; i<AmOfFaces; i++)
+	{// Field of unit charge; the face contributes H*(n.M)
+		const radTPolyhedronFace& Face = FaceTable[i];
+		double X = Face.Row[0]*P, Y = Face.Row[1]*P, Z = Face.Row[2]*P - Face.CoordZ;
+		if(Z == 0.)
+		{// Point on the face plane: shifted slightly, as in radTPolygon::B_comp
+			double AbsRandZ = radCR.AbsRandMagnitude(Face.CoordZ);
+			if(AbsRandZ == 0.) AbsRandZ = 1.e-15;
+			Z = -AbsRandZ;
+		}
+
+		double Hx = 0., Hy = 0., Hz = 0.;
+		RadAnalyticalFieldFromPolygonChargeBatch(&FaceVertices[Face.FirstVertex], Face.AmOfVertices, ConstForH, &X, &Y, &Z, 1, &Hx, &Hy, &Hz);
+		TVector3d H = Hx*Face.Col[0] + Hy*Face.Col[1] + Hz*Face.Col[2];
+		const TVector3d& N = Face.Row[2];
+		SumQ.Str0 += H.x*N; SumQ.Str1 += H.y*N; SumQ.Str2 += H.z*N;
+	}
+	FieldPtr->B += SumQ.Str0;
+	FieldPtr->H += SumQ.Str1;
+	FieldPtr->A += SumQ.Str2;
+}
+
+//-------------------------------------------------------------------------
+
+template<class TLean> short radTPolyhedron::B_compLean(const TVector3d& P, const TVector3d& InMagn, TLean& Out) const
+{// Field of the magnetized polyhedron (face table, J = 0) at P, added to a lean accumulator; returns 1 if P is inside.
+ // H is needed for any quantity (B = H + M inside, A from Hz of the faces).
+	const double ConstForH = 1./4./3.14159265358979;
+
+	if(radYield.Check()==0) return 0;
+
+	TVector3d SumH(0.,0.,0.), SumA(0.,0.,0.);
+	short PointIsInside = 1;
+
+	for(int i=0; i<AmOfFaces; i++)
+	{
+		const radTPolyhedronFace& Face = FaceTable[i];
+		double X = Face.Row[0]*P, Y = Face.Row[1]*P, Z = Face.Row[2]*P - Face.CoordZ;
+
+		double z = -Z;
+		if(z == 0.)
+		{// Point on the face plane: shifted slightly, as in radTPolygon::B_comp
+			double AbsRandZ = radCR.AbsRandMagnitude(Face.CoordZ);
+			if(AbsRandZ == 0.) AbsRandZ = 1.e-15;
+			z = AbsRandZ; Z = -AbsRandZ;
+		}
+		if(z <= 0.) PointIsInside = 0;
+
+		TVector3d LocMagn(Face.Row[0]*InMagn, Face.Row[1]*InMagn, Face.Row[2]*InMagn);
+		double Hx = 0., Hy = 0., Hz = 0.;
+		RadAnalyticalFieldFromPolygonChargeBatch(&FaceVertices[Face.FirstVertex], Face.AmOfVertices, ConstForH*LocMagn.z, &X, &Y, &Z, 1, &Hx, &Hy, &Hz);
+		SumH += Hx*Face.Col[0] + Hy*Face.Col[1] + Hz*Face.Col[2];
+		if(TLean::A_)
+		{
+			double AS = -z*Hz;
+			SumA += (AS*(-LocMagn.y))*Face.Col[0] + (AS*LocMagn.x)*Face.Col[1];
+		}
+	}
+
+	Out.H += SumH;
+	if(TLean::B_)
+	{
+		Out.B += SumH;
+		if(PointIsInside) Out.B += InMagn;
+	}
+	Out.A += SumA;
+	return PointIsInside;
+}
+
+template short radTPolyhedron::B_compLean(const TVector3d&, const TVector3d&, radTFieldB&) const;
+template short radTPolyhedron::B_compLean(const TVector3d&, const TVector3d&, radTFieldH&) const;
+template short radTPolyhedron::B_compLean(const TVector3d&, const TVector3d&, radTFieldBH&) const;
+template short radTPolyhedron::B_compLean(const TVector3d&, const TVector3d&, radTFieldA&) const;
+template short radTPolyhedron::B_compLean(const TVector3d&, const TVector3d&, radTLeanField<true, true, true>&) const;
+
+//-------------------------------------------------------------------------
+
+void radTPolyhedron::B_comp_frM(radTField* FieldPtr, const TVector3d& InMagn) const
 //void radTPolyhedron::B_comp(radTField* FieldPtr)
-{
+{// Magnetization is an argument and only *FieldPtr is written (no face data or handle counts touched): safe for parallel evaluation
+	if((AmOfFaces > 0) && ((int)FaceTable.size() == AmOfFaces)) { B_comp_frM_Faces(FieldPtr, InMagn); return;}
+
 	TVector3d Zero(0.,0.,0.);
 	short PointIsInside = 1;
 
@@ -447,22 +608,15 @@ void radTPolyhedron::B_comp_frM(radTField* FieldPtr)
 
 	for(int i=0; i<AmOfFaces; i++)
 	{
-		radTHandlePgnAndTrans HandlePgnAndTrans = VectHandlePgnAndTrans[i];
+		const radTHandlePgnAndTrans& HandlePgnAndTrans = VectHandlePgnAndTrans[i];
 
-		radTPolygon* PgnPtr = HandlePgnAndTrans.PgnHndl.rep;
+		const radTPolygon* PgnPtr = HandlePgnAndTrans.PgnHndl.rep;
 		radTrans* TransPtr = HandlePgnAndTrans.TransHndl.rep;
 
 		radTField LocField(LocFieldKey, SumLocField.CompCriterium, Zero, Zero, Zero, Zero, Zero, Zero);
 		LocField.P = TransPtr->TrPoint_inv(SumLocField.P);
-		TVector3d PrevP = LocField.P;
 
-		if(!LocFieldKey.PreRelax_) PgnPtr->Magn = TransPtr->TrVectField_inv(Magn);
-		PgnPtr->B_comp(&LocField); //OC040504 test
-
-		if(LocField.P != PrevP)
-		{
-			SumLocField.P = TransPtr->TrPoint(LocField.P); //OC040504 test
-		}
+		PgnPtr->B_compWithMagn(&LocField, LocFieldKey.PreRelax_? Zero : TransPtr->TrVectField_inv(InMagn));
 
 		if(!LocField.PointIsInsideFrame) PointIsInside = 0;
 
@@ -489,11 +643,11 @@ void radTPolyhedron::B_comp_frM(radTField* FieldPtr)
 		return;
 	}
 	if(FldKey.H_) FieldPtr->H += SumLocField.H;
-	if(FldKey.M_) if(PointIsInside) FieldPtr->M += Magn;
+	if(FldKey.M_) if(PointIsInside) FieldPtr->M += InMagn;
 	if(FldKey.B_)
 	{
 		FieldPtr->B += SumLocField.H;
-		if(PointIsInside) FieldPtr->B += Magn;
+		if(PointIsInside) FieldPtr->B += InMagn;
 	}
 	if(FldKey.A_) FieldPtr->A += SumLocField.A;
 }
@@ -520,7 +674,7 @@ void radTPolyhedron::B_comp_frJ(radTField* pField)
 
 	for(int i=0; i<AmOfFaces; i++)
 	{
-		radTHandlePgnAndTrans hPgnAndTrans = VectHandlePgnAndTrans[i];
+		const radTHandlePgnAndTrans& hPgnAndTrans = VectHandlePgnAndTrans[i];
 		radTPolygon* pPgn = hPgnAndTrans.PgnHndl.rep;
 		radTrans* pTrans = hPgnAndTrans.TransHndl.rep;
 
@@ -772,7 +926,7 @@ void radTPolyhedron::B_intComp_frM(radTField* FieldPtr)
 	TVector3d Zero(0.,0.,0.);
 	for(int i=0; i<AmOfFaces; i++)
 	{
-		radTHandlePgnAndTrans HandlePgnAndTrans = VectHandlePgnAndTrans[i];
+		const radTHandlePgnAndTrans& HandlePgnAndTrans = VectHandlePgnAndTrans[i];
 
 		radTPolygon* PgnPtr = HandlePgnAndTrans.PgnHndl.rep;
 		radTrans* TransPtr = HandlePgnAndTrans.TransHndl.rep;
@@ -871,7 +1025,7 @@ void radTPolyhedron::B_intComp_frJ(radTField* pField)
 
 	for(int i=0; i<AmOfFaces; i++)
 	{
-		radTHandlePgnAndTrans hPgnAndTrans = VectHandlePgnAndTrans[i];
+		const radTHandlePgnAndTrans& hPgnAndTrans = VectHandlePgnAndTrans[i];
 		radTPolygon* pPgn = hPgnAndTrans.PgnHndl.rep;
 		radTrans* pTrans = hPgnAndTrans.TransHndl.rep;
 		TrProduct(&trIntAxis2Ez, pTrans, trFace2Int);
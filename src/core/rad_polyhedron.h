@@ -57,6 +57,15 @@ inline int operator ==(const radTHandlePgnAndTrans& h1, const radTHandlePgnAndTr
 
 //-------------------------------------------------------------------------
 
+struct radTPolyhedronFace { // Face of a polyhedron in flat form, for field computation
+	TVector3d Row[3]; // Rows of the face rotation inverse: polyhedron frame -> face frame (Row[2] is the outward normal)
+	TVector3d Col[3]; // Columns of the face rotation: face frame -> polyhedron frame
+	double CoordZ; // Face plane in the face frame
+	int FirstVertex, AmOfVertices; // 2D vertices in radTPolyhedron::FaceVertices
+};
+
+//-------------------------------------------------------------------------
+
 #ifdef __GNUC__
 using radTVectHandlePgnAndTrans = vector<radTHandlePgnAndTrans>;
 using radTVectOfPtrToVect3d = vector<std::array<TVector3d, 2>>;
@@ -109,6 +118,8 @@ class radTPolyhedron : public radTg3dRelax {
 public:
 	radTVectHandlePgnAndTrans VectHandlePgnAndTrans;
 	int AmOfFaces;
+	vector<radTPolyhedronFace> FaceTable; // Set up from VectHandlePgnAndTrans after construction
+	vector<TVector2d> FaceVertices;
 
 	TVector3d J; //to move to base?
 	bool J_IsNotZero;
@@ -129,6 +140,7 @@ public:
 		FillInVectHandlePgnAndTrans(ArrayOfPoints, lenArrayOfPoints, ArrayOfFaces, ArrayOfLengths);
 		if(SomethingIsWrong) return;
 		DefineCentrPoint(ArrayOfPoints, lenArrayOfPoints);
+		SetupFaceTable();
 	}
 	radTPolyhedron(TVector3d* ArrayOfPoints, int lenArrayOfPoints, int** ArrayOfFaces, int* ArrayOfLengths, int lenArrayOfFaces, 
 		const TVector3d& InMagn, TMatrix3d& InM_LinCoef, TVector3d& InJ, TMatrix3d& InJ_LinCoef, char LinTreat) 
@@ -140,6 +152,7 @@ public:
 		FillInVectHandlePgnAndTrans(ArrayOfPoints, lenArrayOfPoints, ArrayOfFaces, ArrayOfLengths);
 		if(SomethingIsWrong) return;
 		DefineCentrPoint(ArrayOfPoints, lenArrayOfPoints);
+		SetupFaceTable();
 
 		J = InJ;
 		bool J_LinCoefIsNotZero = !InJ_LinCoef.isZero();
@@ -167,6 +180,7 @@ public:
 		if(SomethingIsWrong) { DeleteInputArrays(OutArrayOfPoints, OutArrayOfFaces); return;}
 		DefineCentrPoint(OutArrayOfPoints, lenArrayOfPoints);
 		DeleteInputArrays(OutArrayOfPoints, OutArrayOfFaces);
+		SetupFaceTable();
 	}
 	radTPolyhedron(const radTVectHandlePgnAndTrans& InVectHandlePgnAndTrans, 
 		const TVector3d* pInMagn, TMatrix3d* pInM_LinCoef, const radThg& InMatHandle, 
@@ -182,6 +196,7 @@ public:
 		for(int i=0; i<AmOfFaces; i++) VectHandlePgnAndTrans.push_back(InVectHandlePgnAndTrans[i]);
 		SomethingIsWrong = 0;
 		DefineCentrPoint();
+		SetupFaceTable();
 
 		J_IsNotZero = false;
 		J.Zero();
@@ -223,6 +238,7 @@ public:
 
 		AttemptToCreateConvexPolyhedronFromTwoBaseFaces(inHandleBasePgnAndTrf1, inHandleBasePgnAndTrf2);
 		if(SomethingIsWrong) return;
+		SetupFaceTable();
 		if(avgCur != 0)
 		{
 			SetCurrentDensityForConstCurrent(avgCur, 0, 1); //may set J and pJ_LinCoef
@@ -244,6 +260,7 @@ public:
 		DumpBinParse_g3d(inStr, mKeysOldNew, gMapOfHandlers);
 		DumpBinParse_g3dRelax(inStr, mKeysOldNew, gMapOfHandlers);
 		DumpBinParse_Polyhedron(inStr);
+		SetupFaceTable();
 	}
 	radTPolyhedron() : radTg3dRelax()
 	{ 
@@ -256,7 +273,8 @@ public:
 		if(pJ_LinCoef != 0) delete pJ_LinCoef;
 	}
 
-	int Type_g3dRelax() { return 5;}
+	static const int TypeID_g3dRelax = 5;
+	int Type_g3dRelax() { return TypeID_g3dRelax;}
 	int NumberOfDegOfFreedom() { return 3;}
 
 	void FillInVectHandlePgnAndTrans(TVector3d*, int, int**, int*);
@@ -268,7 +286,11 @@ public:
 	//void B_comp(radTField*);
 	//void B_intComp(radTField*);
 
-	void B_comp_frM(radTField*);
+	void SetupFaceTable();
+	void B_comp_frM(radTField*, const TVector3d& InMagn) const;
+	void B_comp_frM_Faces(radTField*, const TVector3d& InMagn) const;
+	template<class TLean> short B_compLean(const TVector3d& P, const TVector3d& InMagn, TLean& Out) const;
+	bool LeanFieldIsAvailable() const { return !J_IsNotZero && (AmOfFaces > 0) && ((int)FaceTable.size() == AmOfFaces);}
 	void B_comp_frJ(radTField*);
 	void B_intComp_frM(radTField*);
 	void B_intComp_frJ(radTField*);
@@ -327,7 +349,7 @@ public:
 	void B_comp(radTField* pField)
 	{
 		bool M_IsNotZero = !Magn.isZero();
-		if(M_IsNotZero || (pField->FieldKey.PreRelax_)) B_comp_frM(pField);
+		if(M_IsNotZero || (pField->FieldKey.PreRelax_)) B_comp_frM(pField, Magn);
 		if(J_IsNotZero) B_comp_frJ(pField);
 	}
 	void B_intComp(radTField* pField)
@@ -347,6 +369,7 @@ public:
 		int BufSize = sizeof(radTrans);
 		GenSize += AmOfFaces*BufSize;
 		for(int i=0; i<AmOfFaces; i++) GenSize += (VectHandlePgnAndTrans[i].PgnHndl.rep)->SizeOfThis();
+		GenSize += (int)(FaceTable.size()*sizeof(radTPolyhedronFace) + FaceVertices.size()*sizeof(TVector2d));
 		return GenSize;
 	}
 	void DefineCentrPoint(TVector3d* ArrayOfPoints, int AmOfPoints)
@@ -38,6 +38,13 @@
 #include <sstream>
 //#endif
 
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#define RAD_PRAGMA(x) _Pragma(#x)
+#define RAD_SIMD RAD_PRAGMA(omp simd)
+#else
+#define RAD_SIMD
+#endif
+
 //-------------------------------------------------------------------------
 
 extern radTYield radYield;
@@ -315,6 +322,298 @@ void radTRecMag::B_comp(radTField* FieldPtr)
 
 //-------------------------------------------------------------------------
 
+void radTRecMag::B_compIntrctBatch(const TVector3d* ArrObsPoi, int AmOfObsPoi, const radTCompCriterium& CompCrit, int AmOfIntrctElemWithSym, TMatrix3d* ArrSubMatr)
+{// Interaction sub-matrices at many observation points; same kernel as PreRelax branch of B_comp, with per-source setup done once
+	const double Pi = 3.141592653589793238;
+	const double dConst2 = 1./4./Pi;
+
+	if(radYield.Check()==0) return;
+
+	bool J_is_Zero = ((J.x==0.) && (J.y==0.) && (J.z==0.));
+	const double* MltThr = CompCrit.MltplThresh;
+	double MaxMltThr = MltThr[0];
+	for(int k=1; k<4; k++) if(MaxMltThr < MltThr[k]) MaxMltThr = MltThr[k];
+
+	TVector3d HalfDim = 0.5*Dimensions;
+	double AbsRandHalfDimX = radCR.AbsRandMagnitude(HalfDim.x);
+	double AbsRandHalfDimY = radCR.AbsRandMagnitude(HalfDim.y);
+	double AbsRandHalfDimZ = radCR.AbsRandMagnitude(HalfDim.z);
+	double SumDimE2 = Dimensions.x*Dimensions.x + Dimensions.y*Dimensions.y + Dimensions.z*Dimensions.z;
+
+	radTFieldKey FieldKeyInteract; FieldKeyInteract.B_=FieldKeyInteract.H_=FieldKeyInteract.PreRelax_=1;
+	TVector3d ZeroVect(0.,0.,0.);
+	TMatrix3d ZeroMatr(ZeroVect, ZeroVect, ZeroVect);
+
+	for(int iPt=0; iPt<AmOfObsPoi; iPt++)
+	{
+		TVector3d P_min_CenPo = ArrObsPoi[iPt] - CentrPoint;
+		TMatrix3d& SubMatr = ArrSubMatr[iPt];
+
+		double PxE2 = P_min_CenPo.x*P_min_CenPo.x, PyE2 = P_min_CenPo.y*P_min_CenPo.y, PzE2 = P_min_CenPo.z*P_min_CenPo.z;
+		double SquaredMltpolCritRatio = SumDimE2/(PxE2 + PyE2 + PzE2);
+		if(J_is_Zero && (SquaredMltpolCritRatio < MaxMltThr))
+		{
+			if(SquaredMltpolCritRatio < MltThr[0]) { SubMatr = ZeroMatr; continue;}
+
+			double AlreadyComputedStuff[] = { P_min_CenPo.x, P_min_CenPo.y, P_min_CenPo.z, PxE2, PyE2, PzE2,
+				Dimensions.x*Dimensions.x, Dimensions.y*Dimensions.y, Dimensions.z*Dimensions.z, SquaredMltpolCritRatio };
+			radTField Field(FieldKeyInteract, CompCrit, ArrObsPoi[iPt], ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.);
+			Field.AmOfIntrctElemWithSym = AmOfIntrctElemWithSym;
+			B_compMultipole(&Field, AlreadyComputedStuff);
+			SubMatr.Str0 = Field.B; SubMatr.Str1 = Field.H; SubMatr.Str2 = Field.A;
+			continue;
+		}
+
+		double x0 = -P_min_CenPo.x - HalfDim.x, x1 = -P_min_CenPo.x + HalfDim.x;
+		double y0 = -P_min_CenPo.y - HalfDim.y, y1 = -P_min_CenPo.y + HalfDim.y;
+		double z0 = -P_min_CenPo.z - HalfDim.z, z1 = -P_min_CenPo.z + HalfDim.z;
+		if(x0==0.) x0 = AbsRandHalfDimX;
+		if(x1==0.) x1 = AbsRandHalfDimX;
+		if(y0==0.) y0 = AbsRandHalfDimY;
+		if(y1==0.) y1 = AbsRandHalfDimY;
+		if(z0==0.) z0 = AbsRandHalfDimZ;
+		if(z1==0.) z1 = AbsRandHalfDimZ;
+
+		double x0e2 = x0*x0, x1e2 = x1*x1;
+		double y0e2 = y0*y0, y1e2 = y1*y1;
+		double z0e2 = z0*z0, z1e2 = z1*z1;
+
+		double D000 = sqrt(x0e2+y0e2+z0e2);
+		double D100 = sqrt(x1e2+y0e2+z0e2);
+		double D010 = sqrt(x0e2+y1e2+z0e2);
+		double D110 = sqrt(x1e2+y1e2+z0e2);
+		double D001 = sqrt(x0e2+y0e2+z1e2);
+		double D101 = sqrt(x1e2+y0e2+z1e2);
+		double D011 = sqrt(x0e2+y1e2+z1e2);
+		double D111 = sqrt(x1e2+y1e2+z1e2);
+
+		double PiMult1 = 0., PiMult2 = 0., PiMult3 = 0.;
+		TVector3d T;
+		T.x = atan(TransAtans(TransAtans(y0*z0/(x0*D000), -y0*z1/(x0*D001), PiMult1), 
+							  TransAtans(-y1*z0/(x0*D010), y1*z1/(x0*D011), PiMult2), PiMult3))+Pi*(PiMult1+PiMult2+PiMult3);
+		T.x += atan(TransAtans(TransAtans(-y0*z0/(x1*D100), y0*z1/(x1*D101), PiMult1), 
+							   TransAtans(y1*z0/(x1*D110), -y1*z1/(x1*D111), PiMult2), PiMult3))+Pi*(PiMult1+PiMult2+PiMult3);
+		T.y = atan(TransAtans(TransAtans(x0*z0/(y0*D000), -x0*z1/(y0*D001), PiMult1), 
+							  TransAtans(-x1*z0/(y0*D100), x1*z1/(y0*D101), PiMult2), PiMult3))+Pi*(PiMult1+PiMult2+PiMult3);
+		T.y += atan(TransAtans(TransAtans(-x0*z0/(y1*D010), x0*z1/(y1*D011), PiMult1), 
+							   TransAtans(x1*z0/(y1*D110), -x1*z1/(y1*D111), PiMult2), PiMult3))+Pi*(PiMult1+PiMult2+PiMult3);
+		T.z = atan(TransAtans(TransAtans(x0*y0/(z0*D000), -x1*y0/(z0*D100), PiMult1), 
+							  TransAtans(-x0*y1/(z0*D010), x1*y1/(z0*D110), PiMult2), PiMult3))+Pi*(PiMult1+PiMult2+PiMult3);
+		T.z += atan(TransAtans(TransAtans(-x0*y0/(z1*D001), x1*y0/(z1*D101), PiMult1), 
+							   TransAtans(x0*y1/(z1*D011), -x1*y1/(z1*D111), PiMult2), PiMult3))+Pi*(PiMult1+PiMult2+PiMult3);
+
+		double AbsRandD000 = 10.*radCR.AbsRandMagnitude(D000);
+		double AbsRandD010 = 10.*radCR.AbsRandMagnitude(D010);
+		double AbsRandD001 = 10.*radCR.AbsRandMagnitude(D001);
+		double AbsRandD011 = 10.*radCR.AbsRandMagnitude(D011);
+		double AbsRandD100 = 10.*radCR.AbsRandMagnitude(D100);
+		double AbsRandD110 = 10.*radCR.AbsRandMagnitude(D110);
+		double AbsRandD101 = 10.*radCR.AbsRandMagnitude(D101);
+		double AbsRandD111 = 10.*radCR.AbsRandMagnitude(D111);
+
+		double z0plD100 = z0+D100; if(z0plD100 < AbsRandD100) z0plD100 = 0.5*(x1e2 + y0e2)/Abs(z0);
+		double z1plD101 = z1+D101; if(z1plD101 < AbsRandD101) z1plD101 = 0.5*(x1e2 + y0e2)/Abs(z1);
+		double z1plD001 = z1+D001; if(z1plD001 < AbsRandD001) z1plD001 = 0.5*(x0e2 + y0e2)/Abs(z1);
+		double z0plD000 = z0+D000; if(z0plD000 < AbsRandD000) z0plD000 = 0.5*(x0e2 + y0e2)/Abs(z0);
+		double z0plD010 = z0+D010; if(z0plD010 < AbsRandD010) z0plD010 = 0.5*(x0e2 + y1e2)/Abs(z0);
+		double z1plD011 = z1+D011; if(z1plD011 < AbsRandD011) z1plD011 = 0.5*(x0e2 + y1e2)/Abs(z1);
+		double z1plD111 = z1+D111; if(z1plD111 < AbsRandD111) z1plD111 = 0.5*(x1e2 + y1e2)/Abs(z1);
+		double z0plD110 = z0+D110; if(z0plD110 < AbsRandD110) z0plD110 = 0.5*(x1e2 + y1e2)/Abs(z0);
+
+		double y0plD100 = y0+D100; if(y0plD100 < AbsRandD100) y0plD100 = 0.5*(x1e2 + z0e2)/Abs(y0);
+		double y1plD110 = y1+D110; if(y1plD110 < AbsRandD110) y1plD110 = 0.5*(x1e2 + z0e2)/Abs(y1);
+		double y1plD010 = y1+D010; if(y1plD010 < AbsRandD010) y1plD010 = 0.5*(x0e2 + z0e2)/Abs(y1);
+		double y0plD000 = y0+D000; if(y0plD000 < AbsRandD000) y0plD000 = 0.5*(x0e2 + z0e2)/Abs(y0);
+		double y0plD001 = y0+D001; if(y0plD001 < AbsRandD001) y0plD001 = 0.5*(x0e2 + z1e2)/Abs(y0);
+		double y1plD011 = y1+D011; if(y1plD011 < AbsRandD011) y1plD011 = 0.5*(x0e2 + z1e2)/Abs(y1);
+		double y1plD111 = y1+D111; if(y1plD111 < AbsRandD111) y1plD111 = 0.5*(x1e2 + z1e2)/Abs(y1);
+		double y0plD101 = y0+D101; if(y0plD101 < AbsRandD101) y0plD101 = 0.5*(x1e2 + z1e2)/Abs(y0);
+
+		double x0plD010 = x0+D010; if(x0plD010 < AbsRandD010) x0plD010 = 0.5*(y1e2 + z0e2)/Abs(x0);
+		double x1plD110 = x1+D110; if(x1plD110 < AbsRandD110) x1plD110 = 0.5*(y1e2 + z0e2)/Abs(x1);
+		double x1plD100 = x1+D100; if(x1plD100 < AbsRandD100) x1plD100 = 0.5*(y0e2 + z0e2)/Abs(x1);
+		double x0plD000 = x0+D000; if(x0plD000 < AbsRandD000) x0plD000 = 0.5*(y0e2 + z0e2)/Abs(x0);
+		double x0plD001 = x0+D001; if(x0plD001 < AbsRandD001) x0plD001 = 0.5*(y0e2 + z1e2)/Abs(x0);
+		double x1plD101 = x1+D101; if(x1plD101 < AbsRandD101) x1plD101 = 0.5*(y0e2 + z1e2)/Abs(x1);
+		double x1plD111 = x1+D111; if(x1plD111 < AbsRandD111) x1plD111 = 0.5*(y1e2 + z1e2)/Abs(x1);
+		double x0plD011 = x0+D011; if(x0plD011 < AbsRandD011) x0plD011 = 0.5*(y1e2 + z1e2)/Abs(x0);
+
+		double Sx = -log((x0plD010/x1plD110)*(x1plD100/x0plD000)*(x0plD001/x1plD101)*(x1plD111/x0plD011));
+		double Sy = -log((y0plD100/y1plD110)*(y1plD010/y0plD000)*(y0plD001/y1plD011)*(y1plD111/y0plD101));
+		double Sz = -log((z0plD100/z1plD101)*(z1plD001/z0plD000)*(z0plD010/z1plD011)*(z1plD111/z0plD110));
+
+		T = dConst2*T; Sx *= dConst2; Sy *= dConst2; Sz *= dConst2;
+		SubMatr.Str0.x = T.x; SubMatr.Str0.y = -Sz; SubMatr.Str0.z = -Sy;
+		SubMatr.Str1.x = -Sz; SubMatr.Str1.y = T.y; SubMatr.Str1.z = -Sx;
+		SubMatr.Str2.x = -Sy; SubMatr.Str2.y = -Sx; SubMatr.Str2.z = T.z;
+	}
+}
+
+//-------------------------------------------------------------------------
+
+void radTRecMag::B_compBatch(const double* ArrX, const double* ArrY, const double* ArrZ, int AmOfPoints, double* ArrHx, double* ArrHy, double* ArrHz, double* ArrBx, double* ArrBy, double* ArrBz)
+{// H (if ArrHx != 0) and B (if ArrBx != 0) of the magnetized block (J = 0) at many points of its frame, added to the output arrays;
+ // expressions of B_comp without multipole approximation, on structure-of-arrays data. Per tile of points, the tangents
+ // and log arguments are computed in a vectorizable loop (the two atan sums of each T component are merged into one atan),
+ // then the atan / log calls are made, then H (and B) are assembled in another vectorizable loop.
+	const double Pi = 3.141592653589793238;
+	const double dConst2 = 1./4./Pi;
+	const int TileSize = 64;
+
+	if(radYield.Check()==0) return;
+
+	const double Cx = CentrPoint.x, Cy = CentrPoint.y, Cz = CentrPoint.z;
+	const double Mx = Magn.x, My = Magn.y, Mz = Magn.z;
+	const double HalfDimX = 0.5*Dimensions.x, HalfDimY = 0.5*Dimensions.y, HalfDimZ = 0.5*Dimensions.z;
+	const double AbsRandHalfDimX = radCR.AbsRandMagnitude(HalfDimX);
+	const double AbsRandHalfDimY = radCR.AbsRandMagnitude(HalfDimY);
+	const double AbsRandHalfDimZ = radCR.AbsRandMagnitude(HalfDimZ);
+
+	// radCR.AbsRandMagnitude of the (non-zero) distances to the corners, times 10
+	const double RandAct = radCR.ActOnDoubles? 10. : 0.;
+	const double RelRand = radCR.RelRand, AbsRand = radCR.AbsRand;
+
+	double TanX[TileSize], TanY[TileSize], TanZ[TileSize], PiX[TileSize], PiY[TileSize], PiZ[TileSize];
+	double LogArgX[TileSize], LogArgY[TileSize], LogArgZ[TileSize], InsideBuf[TileSize];
+
+	for(int Start=0; Start<AmOfPoints; Start+=TileSize)
+	{
+		int n = AmOfPoints - Start; if(n > TileSize) n = TileSize;
+		const double *X = ArrX + Start, *Y = ArrY + Start, *Z = ArrZ + Start;
+
+		RAD_SIMD
+		for(int i=0; i<n; i++)
+		{
+			double Px = X[i] - Cx, Py = Y[i] - Cy, Pz = Z[i] - Cz;
+			double x0 = -Px - HalfDimX, x1 = -Px + HalfDimX;
+			double y0 = -Py - HalfDimY, y1 = -Py + HalfDimY;
+			double z0 = -Pz - HalfDimZ, z1 = -Pz + HalfDimZ;
+			x0 = (x0==0.)? AbsRandHalfDimX : x0; x1 = (x1==0.)? AbsRandHalfDimX : x1;
+			y0 = (y0==0.)? AbsRandHalfDimY : y0; y1 = (y1==0.)? AbsRandHalfDimY : y1;
+			z0 = (z0==0.)? AbsRandHalfDimZ : z0; z1 = (z1==0.)? AbsRandHalfDimZ : z1;
+			InsideBuf[i] = ((x0*x1<0) & (y0*y1<0) & (z0*z1<0))? 1. : 0.;
+
+			double x0e2 = x0*x0, x1e2 = x1*x1;
+			double y0e2 = y0*y0, y1e2 = y1*y1;
+			double z0e2 = z0*z0, z1e2 = z1*z1;
+
+			double D000 = sqrt(x0e2+y0e2+z0e2);
+			double D100 = sqrt(x1e2+y0e2+z0e2);
+			double D010 = sqrt(x0e2+y1e2+z0e2);
+			double D110 = sqrt(x1e2+y1e2+z0e2);
+			double D001 = sqrt(x0e2+y0e2+z1e2);
+			double D101 = sqrt(x1e2+y0e2+z1e2);
+			double D011 = sqrt(x0e2+y1e2+z1e2);
+			double D111 = sqrt(x1e2+y1e2+z1e2);
+
+			double PiMult1, PiMult2, PiMult3, PiMult4, PiMult5, PiMult6, PiMult7;
+			double A1, A2, A3, A4, A5, A6;
+			A1 = TransAtans(y0*z0/(x0*D000), -y0*z1/(x0*D001), PiMult1);
+			A2 = TransAtans(-y1*z0/(x0*D010), y1*z1/(x0*D011), PiMult2);
+			A5 = TransAtans(A1, A2, PiMult3);
+			A3 = TransAtans(-y0*z0/(x1*D100), y0*z1/(x1*D101), PiMult4);
+			A4 = TransAtans(y1*z0/(x1*D110), -y1*z1/(x1*D111), PiMult5);
+			A6 = TransAtans(A3, A4, PiMult6);
+			TanX[i] = TransAtans(A5, A6, PiMult7);
+			PiX[i] = PiMult1 + PiMult2 + PiMult3 + PiMult4 + PiMult5 + PiMult6 + PiMult7;
+
+			A1 = TransAtans(x0*z0/(y0*D000), -x0*z1/(y0*D001), PiMult1);
+			A2 = TransAtans(-x1*z0/(y0*D100), x1*z1/(y0*D101), PiMult2);
+			A5 = TransAtans(A1, A2, PiMult3);
+			A3 = TransAtans(-x0*z0/(y1*D010), x0*z1/(y1*D011), PiMult4);
+			A4 = TransAtans(x1*z0/(y1*D110), -x1*z1/(y1*D111), PiMult5);
+			A6 = TransAtans(A3, A4, PiMult6);
+			TanY[i] = TransAtans(A5, A6, PiMult7);
+			PiY[i] = PiMult1 + PiMult2 + PiMult3 + PiMult4 + PiMult5 + PiMult6 + PiMult7;
+
+			A1 = TransAtans(x0*y0/(z0*D000), -x1*y0/(z0*D100), PiMult1);
+			A2 = TransAtans(-x0*y1/(z0*D010), x1*y1/(z0*D110), PiMult2);
+			A5 = TransAtans(A1, A2, PiMult3);
+			A3 = TransAtans(-x0*y0/(z1*D001), x1*y0/(z1*D101), PiMult4);
+			A4 = TransAtans(x0*y1/(z1*D011), -x1*y1/(z1*D111), PiMult5);
+			A6 = TransAtans(A3, A4, PiMult6);
+			TanZ[i] = TransAtans(A5, A6, PiMult7);
+			PiZ[i] = PiMult1 + PiMult2 + PiMult3 + PiMult4 + PiMult5 + PiMult6 + PiMult7;
+
+			double AbsRandD000 = RandAct*((RelRand*D000 < AbsRand)? AbsRand : RelRand*D000);
+			double AbsRandD010 = RandAct*((RelRand*D010 < AbsRand)? AbsRand : RelRand*D010);
+			double AbsRandD001 = RandAct*((RelRand*D001 < AbsRand)? AbsRand : RelRand*D001);
+			double AbsRandD011 = RandAct*((RelRand*D011 < AbsRand)? AbsRand : RelRand*D011);
+			double AbsRandD100 = RandAct*((RelRand*D100 < AbsRand)? AbsRand : RelRand*D100);
+			double AbsRandD110 = RandAct*((RelRand*D110 < AbsRand)? AbsRand : RelRand*D110);
+			double AbsRandD101 = RandAct*((RelRand*D101 < AbsRand)? AbsRand : RelRand*D101);
+			double AbsRandD111 = RandAct*((RelRand*D111 < AbsRand)? AbsRand : RelRand*D111);
+
+			double z0plD100 = z0+D100; z0plD100 = (z0plD100 < AbsRandD100)? 0.5*(x1e2 + y0e2)/Abs(z0) : z0plD100;
+			double z1plD101 = z1+D101; z1plD101 = (z1plD101 < AbsRandD101)? 0.5*(x1e2 + y0e2)/Abs(z1) : z1plD101;
+			double z1plD001 = z1+D001; z1plD001 = (z1plD001 < AbsRandD001)? 0.5*(x0e2 + y0e2)/Abs(z1) : z1plD001;
+			double z0plD000 = z0+D000; z0plD000 = (z0plD000 < AbsRandD000)? 0.5*(x0e2 + y0e2)/Abs(z0) : z0plD000;
+			double z0plD010 = z0+D010; z0plD010 = (z0plD010 < AbsRandD010)? 0.5*(x0e2 + y1e2)/Abs(z0) : z0plD010;
+			double z1plD011 = z1+D011; z1plD011 = (z1plD011 < AbsRandD011)? 0.5*(x0e2 + y1e2)/Abs(z1) : z1plD011;
+			double z1plD111 = z1+D111; z1plD111 = (z1plD111 < AbsRandD111)? 0.5*(x1e2 + y1e2)/Abs(z1) : z1plD111;
+			double z0plD110 = z0+D110; z0plD110 = (z0plD110 < AbsRandD110)? 0.5*(x1e2 + y1e2)/Abs(z0) : z0plD110;
+
+			double y0plD100 = y0+D100; y0plD100 = (y0plD100 < AbsRandD100)? 0.5*(x1e2 + z0e2)/Abs(y0) : y0plD100;
+			double y1plD110 = y1+D110; y1plD110 = (y1plD110 < AbsRandD110)? 0.5*(x1e2 + z0e2)/Abs(y1) : y1plD110;
+			double y1plD010 = y1+D010; y1plD010 = (y1plD010 < AbsRandD010)? 0.5*(x0e2 + z0e2)/Abs(y1) : y1plD010;
+			double y0plD000 = y0+D000; y0plD000 = (y0plD000 < AbsRandD000)? 0.5*(x0e2 + z0e2)/Abs(y0) : y0plD000;
+			double y0plD001 = y0+D001; y0plD001 = (y0plD001 < AbsRandD001)? 0.5*(x0e2 + z1e2)/Abs(y0) : y0plD001;
+			double y1plD011 = y1+D011; y1plD011 = (y1plD011 < AbsRandD011)? 0.5*(x0e2 + z1e2)/Abs(y1) : y1plD011;
+			double y1plD111 = y1+D111; y1plD111 = (y1plD111 < AbsRandD111)? 0.5*(x1e2 + z1e2)/Abs(y1) : y1plD111;
+			double y0plD101 = y0+D101; y0plD101 = (y0plD101 < AbsRandD101)? 0.5*(x1e2 + z1e2)/Abs(y0) : y0plD101;
+
+			double x0plD010 = x0+D010; x0plD010 = (x0plD010 < AbsRandD010)? 0.5*(y1e2 + z0e2)/Abs(x0) : x0plD010;
+			double x1plD110 = x1+D110; x1plD110 = (x1plD110 < AbsRandD110)? 0.5*(y1e2 + z0e2)/Abs(x1) : x1plD110;
+			double x1plD100 = x1+D100; x1plD100 = (x1plD100 < AbsRandD100)? 0.5*(y0e2 + z0e2)/Abs(x1) : x1plD100;
+			double x0plD000 = x0+D000; x0plD000 = (x0plD000 < AbsRandD000)? 0.5*(y0e2 + z0e2)/Abs(x0) : x0plD000;
+			double x0plD001 = x0+D001; x0plD001 = (x0plD001 < AbsRandD001)? 0.5*(y0e2 + z1e2)/Abs(x0) : x0plD001;
+			double x1plD101 = x1+D101; x1plD101 = (x1plD101 < AbsRandD101)? 0.5*(y0e2 + z1e2)/Abs(x1) : x1plD101;
+			double x1plD111 = x1+D111; x1plD111 = (x1plD111 < AbsRandD111)? 0.5*(y1e2 + z1e2)/Abs(x1) : x1plD111;
+			double x0plD011 = x0+D011; x0plD011 = (x0plD011 < AbsRandD011)? 0.5*(y1e2 + z1e2)/Abs(x0) : x0plD011;
+
+			LogArgX[i] = (x0plD010/x1plD110)*(x1plD100/x0plD000)*(x0plD001/x1plD101)*(x1plD111/x0plD011);
+			LogArgY[i] = (y0plD100/y1plD110)*(y1plD010/y0plD000)*(y0plD001/y1plD011)*(y1plD111/y0plD101);
+			LogArgZ[i] = (z0plD100/z1plD101)*(z1plD001/z0plD000)*(z0plD010/z1plD011)*(z1plD111/z0plD110);
+		}
+		for(int i=0; i<n; i++)
+		{
+			TanX[i] = atan(TanX[i]); TanY[i] = atan(TanY[i]); TanZ[i] = atan(TanZ[i]);
+			LogArgX[i] = log(LogArgX[i]); LogArgY[i] = log(LogArgY[i]); LogArgZ[i] = log(LogArgZ[i]);
+		}
+
+		RAD_SIMD
+		for(int i=0; i<n; i++)
+		{
+			double Tx = dConst2*(TanX[i] + Pi*PiX[i]), Ty = dConst2*(TanY[i] + Pi*PiY[i]), Tz = dConst2*(TanZ[i] + Pi*PiZ[i]);
+			double Sx = -dConst2*LogArgX[i], Sy = -dConst2*LogArgY[i], Sz = -dConst2*LogArgZ[i];
+			TanX[i] = Tx*Mx + (-Sz)*My + (-Sy)*Mz;
+			TanY[i] = (-Sz)*Mx + Ty*My + (-Sx)*Mz;
+			TanZ[i] = (-Sy)*Mx + (-Sx)*My + Tz*Mz;
+		}
+		if(ArrHx != 0)
+		{
+			double *Hx = ArrHx + Start, *Hy = ArrHy + Start, *Hz = ArrHz + Start;
+			RAD_SIMD
+			for(int i=0; i<n; i++)
+			{
+				Hx[i] += TanX[i]; Hy[i] += TanY[i]; Hz[i] += TanZ[i];
+			}
+		}
+		if(ArrBx != 0)
+		{
+			double *Bx = ArrBx + Start, *By = ArrBy + Start, *Bz = ArrBz + Start;
+			RAD_SIMD
+			for(int i=0; i<n; i++)
+			{
+				Bx[i] += TanX[i] + InsideBuf[i]*Mx; By[i] += TanY[i] + InsideBuf[i]*My; Bz[i] += TanZ[i] + InsideBuf[i]*Mz;
+			}
+		}
+	}
+	#undef RAD_TRANS_ATANS
+}
+
+//-------------------------------------------------------------------------
+
 void radTRecMag::B_compMultipole(radTField* FieldPtr, double* AlreadyComputedStuff)
 {
 	double* MltThr = FieldPtr->CompCriterium.MltplThresh;
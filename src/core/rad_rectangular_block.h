@@ -86,11 +86,15 @@ public:
 		InternalFacesAfterCut = 0;
 	}
 
-	int Type_g3dRelax() { return 1;}
-	virtual int Type_RecMag() { return 0;}
+	static const int TypeID_g3dRelax = 1;
+	int Type_g3dRelax() { return TypeID_g3dRelax;}
+	static const int TypeID_RecMag = 0;
+	virtual int Type_RecMag() { return TypeID_RecMag;}
 
 	void B_comp(radTField*);
 	void B_compMultipole(radTField*, double*);
+	void B_compIntrctBatch(const TVector3d* ArrObsPoi, int AmOfObsPoi, const radTCompCriterium& CompCrit, int AmOfIntrctElemWithSym, TMatrix3d* ArrSubMatr); // virtual in radTg3dRelax
+	void B_compBatch(const double* ArrX, const double* ArrY, const double* ArrZ, int AmOfPoints, double* ArrHx, double* ArrHy, double* ArrHz, double* ArrBx, double* ArrBy, double* ArrBz);
 	void B_intComp(radTField*);
 	void B_intUtilSpecCaseZeroVxVy(const TVector3d&, const TVector3d&, short, TMatrix3d&, TVector3d&);
 
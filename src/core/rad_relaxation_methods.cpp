@@ -15,9 +15,12 @@
 -------------------------------------------------------------------------*/
 
 #include "rad_relaxation_methods.h"
+#include "rad_intrc_hmat.h"
 #include "rad_yield.h"
+#include "radentry.h" // For RadRlxTelemetryPush()
 
 #include <time.h>
+#include <chrono>
 
 //-------------------------------------------------------------------------
 
@@ -77,6 +80,38 @@ void radTIterativeRelaxMeth::ComputeRelaxStatusParam(const TVector3d* NewMagnArr
 
 //-------------------------------------------------------------------------
 
+double radTIterativeRelaxMeth::TelemetryClock()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//-------------------------------------------------------------------------
+
+void radTIterativeRelaxMeth::StartTelemetry(double PrecOnMagnetiz, int MaxIterNumber)
+{
+	mChangedElemTolE2 = PrecOnMagnetiz*PrecOnMagnetiz;
+	ResetSweepTelemetry();
+	RadRlxTelemetryReset();
+	radYield.ProgressStart(MaxIterNumber);
+}
+
+//-------------------------------------------------------------------------
+
+bool radTIterativeRelaxMeth::ReportIteration(int IterNo, double MisfitM, double SweepStartTime)
+{// Returns false if the monitor callback or a cancellation request (radTYield) terminates the relaxation
+	radYield.ProgressAdd(1);
+	RadRelaxIterInfo Info;
+	Info.iter = IterNo;
+	Info.misfit = MisfitM;
+	Info.sweep_time = TelemetryClock() - SweepStartTime;
+	Info.matvec_time = mMatVecTime;
+	Info.num_changed = mAmOfChangedElem;
+	Info.num_elem = IntrctPtr->AmOfMainElem;
+	return RadRlxTelemetryPush(Info) && !radYield.CancelIsRequested();
+}
+
+//-------------------------------------------------------------------------
+
 void radTIterativeRelaxMeth::MakeN_iter(int IterNum)
 {
 	for(int i=0; i<(IterNum-1); i++)
@@ -113,7 +148,8 @@ void radTSimpleRelaxation::DefineNewMagnetizations()
 	}
 	else
 	{
-		// Dense matrix-vector multiplication (original code)
+		// Dense matrix-vector multiplication (original code); rows as first touched (RadSolverNUMA)
+		#pragma omp parallel for schedule(static) if(LocAmOfMainElem > 100)
 		for(int StrNo=0; StrNo<LocAmOfMainElem; StrNo++)
 		{
 			TVector3d H_atElemStrNo(0.,0.,0.);
@@ -234,11 +270,14 @@ void radTRelaxationMethNo_3::DefineNewMagnetizations()
 
 	TMatrix3df** IntrcMat = IntrctPtr->InteractMatrix; //OC250504
 	int AmOfMainElem_mi_One = LocAmOfMainElem - 1;
+	ResetSweepTelemetry();
 	for(int StrNo=0; StrNo<LocAmOfMainElem; StrNo++)
 	{
 		TVector3d QuasiExtFieldAtElemStrNo(0.,0.,0.);
+		double MatVecStartTime = TelemetryClock();
 		for(int ColNo=0; ColNo<LocAmOfMainElem; ColNo++)
 			if(ColNo!=StrNo) QuasiExtFieldAtElemStrNo += IntrcMat[StrNo][ColNo] * MagnAr[ColNo];
+		mMatVecTime += TelemetryClock() - MatVecStartTime;
 		QuasiExtFieldAtElemStrNo += ExternFieldAr[StrNo];
 
 		g3dRelaxPtr = IntrctPtr->g3dRelaxPtrVect[StrNo];
@@ -253,8 +292,10 @@ void radTRelaxationMethNo_3::DefineNewMagnetizations()
 		MagnAr[StrNo] = MaterPtr->M(NewFieldAr[StrNo]);
 
 		Mnew_mi_MoldVect = MagnAr[StrNo] - g3dRelaxPtr->Magn;
-		BufMisfitM += Mnew_mi_MoldVect.x*Mnew_mi_MoldVect.x + Mnew_mi_MoldVect.y*Mnew_mi_MoldVect.y 
+		double NewDifMe2 = Mnew_mi_MoldVect.x*Mnew_mi_MoldVect.x + Mnew_mi_MoldVect.y*Mnew_mi_MoldVect.y 
 					+ Mnew_mi_MoldVect.z*Mnew_mi_MoldVect.z;
+		BufMisfitM += NewDifMe2;
+		CountChangedElem(NewDifMe2);
 
 		g3dRelaxPtr->Magn = MagnAr[StrNo];
 	}
@@ -270,11 +311,15 @@ int radTRelaxationMethNo_3::AutoRelax(double PrecOnMagnetiz, int MaxIterNumber,
 		IntrctPtr->ResetM(); // Consider removing
 	}
 
+	StartTelemetry(PrecOnMagnetiz, MaxIterNumber);
+
 	int IterCount = 0;
 	while(InstMisfitM > PrecOnMagnetiz)
 	{
 		if(++IterCount > MaxIterNumber) break;
+		double SweepStartTime = TelemetryClock();
 		DefineNewMagnetizations();
+		if(!ReportIteration(IterCount, InstMisfitM, SweepStartTime)) break; // terminated by monitor callback
 
 		if(radYield.Check()==0) return 0; // To allow multitasking on Mac: consider better places for this
 	}
@@ -368,6 +413,8 @@ void radTRelaxationMethNo_a5::DefineNewMagnetizations()
 	radTMaterial* MaterPtr = nullptr;
 
 	double BufMisfitM=0.;
+	double MatVecStartTime = 0.;
+	ResetSweepTelemetry();
 
 	int StrNo = 0;
 	int RelaxTogetherCount = -1;
@@ -383,10 +430,12 @@ void radTRelaxationMethNo_a5::DefineNewMagnetizations()
 			{
 				TVector3d QuasiExtFieldAtElemStrNo(0.,0.,0.);
 				int ColNo=0;
+				MatVecStartTime = TelemetryClock();
 				for(ColNo = 0; ColNo < CurrentSubInterv.StartNo; ColNo++)
 					QuasiExtFieldAtElemStrNo += IntrcMat[StrNo][ColNo] * MagnAr[ColNo];
 				for(ColNo = CurrentSubInterv.FinNo+1; ColNo < LocAmOfMainElem; ColNo++)
 					QuasiExtFieldAtElemStrNo += IntrcMat[StrNo][ColNo] * MagnAr[ColNo];
+				mMatVecTime += TelemetryClock() - MatVecStartTime;
 				QuasiExtFieldAtElemStrNo += ExternFieldAr[StrNo];
 
 				int AuxMatrStrNo = 3*(StrNo - CurrentSubInterv.StartNo);
@@ -456,8 +505,10 @@ void radTRelaxationMethNo_a5::DefineNewMagnetizations()
 
 				MagnAr[StrNo] = MaterPtr->M(NewFieldAr[StrNo]);
 				Mnew_mi_MoldVect = MagnAr[StrNo] - g3dRelaxPtr->Magn;
-				BufMisfitM += Mnew_mi_MoldVect.x*Mnew_mi_MoldVect.x + Mnew_mi_MoldVect.y*Mnew_mi_MoldVect.y 
+				double NewDifMe2 = Mnew_mi_MoldVect.x*Mnew_mi_MoldVect.x + Mnew_mi_MoldVect.y*Mnew_mi_MoldVect.y 
 							+ Mnew_mi_MoldVect.z*Mnew_mi_MoldVect.z;
+				BufMisfitM += NewDifMe2;
+				CountChangedElem(NewDifMe2);
 				g3dRelaxPtr->Magn = MagnAr[StrNo];
 			}
 		}
@@ -467,8 +518,10 @@ void radTRelaxationMethNo_a5::DefineNewMagnetizations()
 			for(StrNo = CurrentSubInterv.StartNo; StrNo <= CurrentSubInterv.FinNo; StrNo++)
 			{
 				TVector3d QuasiExtFieldAtElemStrNo(0.,0.,0.);
+				MatVecStartTime = TelemetryClock();
 				for(int ColNo=0; ColNo<LocAmOfMainElem; ColNo++)
 					if(ColNo!=StrNo) QuasiExtFieldAtElemStrNo += IntrcMat[StrNo][ColNo] * MagnAr[ColNo];
+				mMatVecTime += TelemetryClock() - MatVecStartTime;
 				QuasiExtFieldAtElemStrNo += ExternFieldAr[StrNo];
 
 				g3dRelaxPtr = IntrctPtr->g3dRelaxPtrVect[StrNo];
@@ -482,8 +535,10 @@ void radTRelaxationMethNo_a5::DefineNewMagnetizations()
 				MagnAr[StrNo] = MaterPtr->M(NewFieldAr[StrNo]);
 
 				Mnew_mi_MoldVect = MagnAr[StrNo] - g3dRelaxPtr->Magn;
-				BufMisfitM += Mnew_mi_MoldVect.x*Mnew_mi_MoldVect.x + Mnew_mi_MoldVect.y*Mnew_mi_MoldVect.y 
+				double NewDifMe2 = Mnew_mi_MoldVect.x*Mnew_mi_MoldVect.x + Mnew_mi_MoldVect.y*Mnew_mi_MoldVect.y 
 							+ Mnew_mi_MoldVect.z*Mnew_mi_MoldVect.z;
+				BufMisfitM += NewDifMe2;
+				CountChangedElem(NewDifMe2);
 				g3dRelaxPtr->Magn = MagnAr[StrNo];
 			}
 		}
@@ -501,11 +556,15 @@ int radTRelaxationMethNo_a5::AutoRelax(double PrecOnMagnetiz, int MaxIterNumber,
 		IntrctPtr->ResetM();  // Consider removing
 	}
 
+	StartTelemetry(PrecOnMagnetiz, MaxIterNumber);
+
 	int IterCount = 0;
 	while(InstMisfitM > PrecOnMagnetiz)
 	{
 		if(++IterCount > MaxIterNumber) break;
+		double SweepStartTime = TelemetryClock();
 		DefineNewMagnetizations();
+		if(!ReportIteration(IterCount, InstMisfitM, SweepStartTime)) break; // terminated by monitor callback
 
 		if(radYield.Check()==0) return 0; // To allow multitasking on Mac: consider better places for this
 	}
@@ -549,6 +608,7 @@ void radTRelaxationMethNo_4::DefineNewMagnetizations()
 	if(LocPrecMagnE2 < BestPrecMagnE2) LocPrecMagnE2 = BestPrecMagnE2;
 	radTRelaxAuxData *tRelaxAuxData = mpRelaxAuxData; //OC06112003
 	const int MaxConseqBadPasses = 1; //OC06112003
+	ResetSweepTelemetry();
 
 	for(int StrNo=0; StrNo<LocAmOfMainElem; StrNo++)
 	{
@@ -556,10 +616,12 @@ void radTRelaxationMethNo_4::DefineNewMagnetizations()
 		TMatrix3df* MatrArrayPtr = IntrcMat[StrNo]; //OC250504
 		//TMatrix3d* MatrArrayPtr = IntrcMat[StrNo]; //OC250504
 
+		double MatVecStartTime = TelemetryClock();
 		for(int ColNo=0; ColNo<LocAmOfMainElem; ColNo++)
 		{
 			if(ColNo!=StrNo) QuasiExtFieldAtElemStrNo += MatrArrayPtr[ColNo] * MagnAr[ColNo];
 		}
+		mMatVecTime += TelemetryClock() - MatVecStartTime;
 		QuasiExtFieldAtElemStrNo += ExternFieldAr[StrNo];
 
 		g3dRelaxPtr = IntrctPtr->g3dRelaxPtrVect[StrNo];
@@ -585,6 +647,7 @@ void radTRelaxationMethNo_4::DefineNewMagnetizations()
 		Mnew_mi_MoldVect = PureNewM - g3dRelaxPtr->Magn;
 		double NewDifMe2 = Mnew_mi_MoldVect.AmpE2(); //OC06112003
 		BufMisfitM += NewDifMe2;
+		CountChangedElem(NewDifMe2);
 
 		//tRelaxAuxData->Update(NewDifMe2, MaxConseqBadPasses, mRelaxParModFact, mRelaxParMin); //OC06112003
 		//OC: commented out 150304
@@ -818,11 +881,15 @@ int radTRelaxationMethNo_4::AutoRelax(double PrecOnMagnetiz, int MaxIterNumber,
 	mKeepPrevOldValues = false;
 	mBadConverg = false;
 
+	StartTelemetry(PrecOnMagnetiz, MaxIterNumber);
+
 	double MinInstMisfitMe2 = 1.e+30;
 	while(InstMisfitMe2 > DesiredPrecOnMagnetizE2)
 	{
 		if(++mIterCount > MaxIterNumber) break;
+		double SweepStartTime = TelemetryClock();
 		DefineNewMagnetizations();
+		if(!ReportIteration(mIterCount, sqrt(InstMisfitMe2), SweepStartTime)) break; // terminated by monitor callback
 
 		//if(MinInstMisfitMe2 > InstMisfitMe2) 
 		//{
@@ -1114,12 +1181,16 @@ int radTRelaxationMethNo_8::AutoRelax(double PrecOnMagnetiz, int MaxIterNumber,
 		IntrctPtr->ResetAuxParam();
 	}
 
+	StartTelemetry(PrecOnMagnetiz, MaxIterNumber);
+
 	double MinInstMisfitMe2 = 1.e+30;
 	int ItCnt=0;
 	for(ItCnt=0; ItCnt<MaxIterNumber; ItCnt++)
 	{
 		if(ItCnt > MaxIterNumber) break;
+		double SweepStartTime = TelemetryClock();
 		DefineNewMagnetizations();
+		if(!ReportIteration(ItCnt + 1, sqrt(mInstMisfitMe2), SweepStartTime)) { ItCnt++; break;} // terminated by monitor callback
 
 		if(radYield.Check()==0) return 0; // To allow multitasking on Mac: consider better places for this
 	}
@@ -1191,16 +1262,19 @@ void radTRelaxationMethNo_8::DefineNewMagnetizations()
 	int LocAmOfMainElem = IntrctPtr->AmOfMainElem;
 	double NormFact = 1./double(LocAmOfMainElem);
 	double BufMisfitM=0.;
+	ResetSweepTelemetry();
 
 	for(int StrNo=0; StrNo<LocAmOfMainElem; StrNo++)
 	{
 		TVector3d QuasiExtFieldAtElemStrNo(0.,0.,0.);
 		TMatrix3df* MatrArrayPtr = IntrcMat[StrNo];
 
+		double MatVecStartTime = TelemetryClock();
 		for(int ColNo=0; ColNo<LocAmOfMainElem; ColNo++)
 		{
 			if(ColNo!=StrNo) QuasiExtFieldAtElemStrNo += MatrArrayPtr[ColNo] * MagnAr[ColNo];
 		}
+		mMatVecTime += TelemetryClock() - MatVecStartTime;
 		QuasiExtFieldAtElemStrNo += ExternFieldAr[StrNo];
 
 		g3dRelaxPtr = IntrctPtr->g3dRelaxPtrVect[StrNo];
@@ -1224,6 +1298,7 @@ void radTRelaxationMethNo_8::DefineNewMagnetizations()
 		Mnew_mi_MoldVect = InstantM - g3dRelaxPtr->Magn;
 		double NewDifMe2 = Mnew_mi_MoldVect.AmpE2();
 		BufMisfitM += NewDifMe2;
+		CountChangedElem(NewDifMe2);
 
 		g3dRelaxPtr->Magn = InstantM; 
 	}
@@ -1233,6 +1308,168 @@ void radTRelaxationMethNo_8::DefineNewMagnetizations()
 //-------------------------------------------------------------------------
 //-------------------------------------------------------------------------
 
+radTRelaxationMethNo_9::radTRelaxationMethNo_9(radTInteraction* InInteractionPtr) : radTIterativeRelaxMeth(InInteractionPtr)
+{
+	InstMisfitM = 1.E+23;
+	mResNorm = mNewtonSwitchResNorm = 0.;
+	mRefactorIsNeeded = true; mNewtonIsOn = false;
+	mpLU.reset(new radTHMatrixLUSolver(InInteractionPtr, RadSolverGetHLUEps(), RadSolverGetHLUMaxRank()));
+}
+
+//-------------------------------------------------------------------------
+
+radTRelaxationMethNo_9::~radTRelaxationMethNo_9()
+{
+}
+
+//-------------------------------------------------------------------------
+
+void radTRelaxationMethNo_9::DefineFieldArray(const TVector3d* MagnArray, TVector3d* FieldArray)
+{
+	double MatVecStartTime = TelemetryClock();
+
+	if(IntrctPtr->use_hmatrix && IntrctPtr->hmat_interaction)
+	{
+		IntrctPtr->DefineFieldArray_HMatrix(MagnArray, FieldArray);
+	}
+	else
+	{
+		int LocAmOfMainElem = IntrctPtr->AmOfMainElem;
+		TMatrix3df** IntrcMat = IntrctPtr->InteractMatrix;
+		TVector3d* ExternFieldAr = IntrctPtr->ExternFieldArray;
+
+		#pragma omp parallel for schedule(static) if(LocAmOfMainElem > 100)
+		for(int StrNo=0; StrNo<LocAmOfMainElem; StrNo++)
+		{
+			TVector3d H_atElemStrNo(0.,0.,0.);
+			TMatrix3df* MatrArrayPtr = IntrcMat[StrNo];
+			for(int ColNo=0; ColNo<LocAmOfMainElem; ColNo++) H_atElemStrNo += MatrArrayPtr[ColNo]*MagnArray[ColNo];
+			FieldArray[StrNo] = H_atElemStrNo + ExternFieldAr[StrNo];
+		}
+	}
+	mMatVecTime += TelemetryClock() - MatVecStartTime;
+}
+
+//-------------------------------------------------------------------------
+
+double radTRelaxationMethNo_9::DefineResidual(const TVector3d* MagnArray, const TVector3d* FieldArray, TVector3d* ResArray)
+{// Residual of the relaxation equations r = M(H) - M; returns its rms value over the elements
+	int LocAmOfMainElem = IntrctPtr->AmOfMainElem;
+	double SumResE2 = 0.;
+	for(int i=0; i<LocAmOfMainElem; i++)
+	{
+		radTMaterial* MaterPtr = (radTMaterial*)(IntrctPtr->g3dRelaxPtrVect[i]->MaterHandle.rep);
+		ResArray[i] = MaterPtr->M(FieldArray[i]) - MagnArray[i];
+		SumResE2 += ResArray[i].AmpE2();
+	}
+	return sqrt(SumResE2/LocAmOfMainElem);
+}
+
+//-------------------------------------------------------------------------
+
+void radTRelaxationMethNo_9::DefineNewMagnetizations()
+{
+	int LocAmOfMainElem = IntrctPtr->AmOfMainElem;
+	TVector3d* MagnAr = IntrctPtr->NewMagnArray;
+	TVector3d* NewFieldAr = IntrctPtr->NewFieldArray;
+	ResetSweepTelemetry();
+
+	if(!mNewtonIsOn && (mResNorm < mNewtonSwitchResNorm))
+	{
+		mNewtonIsOn = true; mRefactorIsNeeded = true;
+	}
+	if(mRefactorIsNeeded || !mpLU->IsFactorized())
+	{
+		mpLU->Factorize(NewFieldAr, !mNewtonIsOn);
+		mRefactorIsNeeded = false;
+	}
+
+	// (I - Ksi*N) dM = M(H) - M
+	mpLU->Solve(vmRes.data(), vmDeltaM.data());
+
+	// Halve the Newton step until the residual decreases (overshoot near saturation)
+	const int MaxAmOfStepReductions = mNewtonIsOn? 8 : 0;
+	double StepFact = 1., TrialResNorm = 0.;
+	for(int k=0; k<=MaxAmOfStepReductions; k++)
+	{
+		for(int i=0; i<LocAmOfMainElem; i++) vmTrialM[i] = MagnAr[i] + StepFact*vmDeltaM[i];
+		DefineFieldArray(vmTrialM.data(), vmTrialH.data());
+		TrialResNorm = DefineResidual(vmTrialM.data(), vmTrialH.data(), vmTrialRes.data());
+		if(TrialResNorm <= mResNorm) break;
+		StepFact *= 0.5;
+	}
+
+	// Slow convergence: the linearization is outdated, refactorize at the new state
+	if(TrialResNorm > 0.5*mResNorm) mRefactorIsNeeded = true;
+	// Newton does not make progress: fall back to secant steps
+	if(mNewtonIsOn && (TrialResNorm > mResNorm))
+	{
+		mNewtonIsOn = false; mNewtonSwitchResNorm *= 0.1;
+	}
+
+	double BufMisfitM = 0.;
+	for(int i=0; i<LocAmOfMainElem; i++)
+	{
+		TVector3d Mnew_mi_MoldVect = vmTrialM[i] - MagnAr[i];
+		double NewDifMe2 = Mnew_mi_MoldVect.AmpE2();
+		BufMisfitM += NewDifMe2;
+		CountChangedElem(NewDifMe2);
+
+		MagnAr[i] = vmTrialM[i];
+		NewFieldAr[i] = vmTrialH[i];
+		IntrctPtr->g3dRelaxPtrVect[i]->Magn = MagnAr[i];
+	}
+	vmRes.swap(vmTrialRes);
+	mResNorm = TrialResNorm;
+	InstMisfitM = sqrt(BufMisfitM/LocAmOfMainElem);
+}
+
+//-------------------------------------------------------------------------
+
+int radTRelaxationMethNo_9::AutoRelax(double PrecOnMagnetiz, int MaxIterNumber, char MagnResetIsNotNeeded)
+{
+	if(IntrctPtr == 0) return 0;
+
+	int LocAmOfMainElem = IntrctPtr->AmOfMainElem;
+	TVector3d* MagnAr = IntrctPtr->NewMagnArray;
+	TVector3d* NewFieldAr = IntrctPtr->NewFieldArray;
+	if(!MagnResetIsNotNeeded) IntrctPtr->ResetM();
+	else
+	{
+		for(int i=0; i<LocAmOfMainElem; i++) MagnAr[i] = IntrctPtr->g3dRelaxPtrVect[i]->Magn;
+	}
+
+	StartTelemetry(PrecOnMagnetiz, MaxIterNumber);
+
+	vmRes.resize(LocAmOfMainElem); vmDeltaM.resize(LocAmOfMainElem);
+	vmTrialM.resize(LocAmOfMainElem); vmTrialH.resize(LocAmOfMainElem); vmTrialRes.resize(LocAmOfMainElem);
+
+	DefineFieldArray(MagnAr, NewFieldAr);
+	mResNorm = DefineResidual(MagnAr, NewFieldAr, vmRes.data());
+	mRefactorIsNeeded = true; mNewtonIsOn = false;
+	mNewtonSwitchResNorm = 0.01*mResNorm; // Newton only within its convergence region
+
+	int ItCnt = 0;
+	while((InstMisfitM > PrecOnMagnetiz) && (ItCnt < MaxIterNumber))
+	{
+		ItCnt++;
+		double SweepStartTime = TelemetryClock();
+		DefineNewMagnetizations();
+		if(!ReportIteration(ItCnt, InstMisfitM, SweepStartTime)) break; // terminated by monitor callback
+
+		if(radYield.Check()==0) return 0; // To allow multitasking on Mac: consider better places for this
+	}
+
+	IntrctPtr->RelaxStatusParam.MisfitM = -1.;
+	ComputeRelaxStatusParam(MagnAr, nullptr, NewFieldAr);
+	IntrctPtr->RelaxStatusParam.MisfitM = InstMisfitM;
+
+	return ItCnt;
+}
+
+//-------------------------------------------------------------------------
+//-------------------------------------------------------------------------
+
 void radTRelaxationMethNo_6::SetupInteractionMatrices(const radThg& hg, const radTCompCriterium& CompCrit)
 {
 	mAmOfParts = 0;
@@ -20,6 +20,10 @@
 #include "rad_interaction.h"
 #include "rad_math_methods.h"
 
+#include <memory>
+
+class radTHMatrixLUSolver;
+
 //-------------------------------------------------------------------------
 //-------------------------------------------------------------------------
 
@@ -27,9 +31,20 @@ class radTIterativeRelaxMeth {
 protected:
 	radTInteraction* IntrctPtr;
 
+	// Per-iteration telemetry (reported via RadRlxMonitor / RadRlxTelemetry)
+	double mMatVecTime; // time spent on interaction matrix - magnetization products in current sweep [s]
+	int mAmOfChangedElem; // number of elements whose magnetization changed by more than the tolerance in current sweep
+	double mChangedElemTolE2;
+
+	static double TelemetryClock();
+	void StartTelemetry(double PrecOnMagnetiz, int MaxIterNumber);
+	void ResetSweepTelemetry() { mMatVecTime = 0.; mAmOfChangedElem = 0;}
+	void CountChangedElem(double MagnDifE2) { if(MagnDifE2 > mChangedElemTolE2) mAmOfChangedElem++;}
+	bool ReportIteration(int IterNo, double MisfitM, double SweepStartTime);
+
 public:
-	radTIterativeRelaxMeth(radTInteraction* InIntrctPtr) { IntrctPtr = InIntrctPtr;}
-	radTIterativeRelaxMeth() { IntrctPtr = 0;}
+	radTIterativeRelaxMeth(radTInteraction* InIntrctPtr) { IntrctPtr = InIntrctPtr; mChangedElemTolE2 = 0.; ResetSweepTelemetry();}
+	radTIterativeRelaxMeth() { IntrctPtr = 0; mChangedElemTolE2 = 0.; ResetSweepTelemetry();}
 
 	virtual void DefineNewMagnetizations() {}
 	
@@ -434,6 +449,31 @@ public:
 //-------------------------------------------------------------------------
 //-------------------------------------------------------------------------
 
+class radTRelaxationMethNo_9 : public radTIterativeRelaxMeth {
+// Quasi-Newton iteration for M(H(M)) - M = 0: the linearized matrix I - Ksi*N is factorized
+// by H-LU and reused as long as the residual decreases fast enough. Ksi is the secant
+// susceptibility (globally convergent Picard steps) until the residual has dropped, then
+// the differential one (Newton).
+	double InstMisfitM, mResNorm, mNewtonSwitchResNorm;
+	std::unique_ptr<radTHMatrixLUSolver> mpLU;
+	bool mRefactorIsNeeded, mNewtonIsOn;
+
+	std::vector<TVector3d> vmRes, vmDeltaM, vmTrialM, vmTrialH, vmTrialRes;
+
+	void DefineFieldArray(const TVector3d* MagnArray, TVector3d* FieldArray);
+	double DefineResidual(const TVector3d* MagnArray, const TVector3d* FieldArray, TVector3d* ResArray);
+
+public:
+	radTRelaxationMethNo_9(radTInteraction* InInteractionPtr);
+	~radTRelaxationMethNo_9();
+
+	void DefineNewMagnetizations();
+	int AutoRelax(double PrecOnMagnetiz, int MaxIterNumber, char MagnResetIsNotNeeded=0);
+};
+
+//-------------------------------------------------------------------------
+//-------------------------------------------------------------------------
+
 class radTRelaxationMethNo_a5 : public radTIterativeRelaxMeth {
 	double InstMisfitM;
 	std::vector<std::vector<double>> vAuxMatr1Storage, vAuxMatr2Storage;
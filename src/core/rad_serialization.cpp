@@ -206,6 +206,15 @@ void radTSend::Vector3d(const TVector3df* VectorPtr)
 
 void radTSend::ArrayOfVector3d(const TVector3d* ArrayOfVector3d, int lenArray)
 {
+#if defined ALPHA__DLL__ || defined ALPHA__LIB__
+	std::vector<double> TotOutArray(3*lenArray);
+	for(int i=0; i<lenArray; i++)
+	{
+		TotOutArray[3*i] = ArrayOfVector3d[i].x; TotOutArray[3*i + 1] = ArrayOfVector3d[i].y; TotOutArray[3*i + 2] = ArrayOfVector3d[i].z;
+	}
+	int Dims[] = {3, lenArray};
+	MultiDimArrayOfDouble(TotOutArray.data(), Dims, 2);
+#endif
 }
 
 //-------------------------------------------------------------------------
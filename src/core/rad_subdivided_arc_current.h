@@ -50,7 +50,8 @@ public:
 	}
 	radTSubdividedArcCur() {}
 
-	int Type_Group() { return 4;}
+	static const int TypeID_Group = 4;
+	int Type_Group() { return TypeID_Group;}
 
 	void B_comp(radTField* FieldPtr) { radTGroup::B_comp(FieldPtr);}
 	void B_intComp(radTField* FieldPtr) { radTGroup::B_intComp(FieldPtr);}
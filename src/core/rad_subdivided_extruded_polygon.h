@@ -81,8 +81,10 @@ public:
 	radTSubdividedExtrPolygon(CAuxBinStrVect& inStr, map<int, int>& mKeysOldNew, radTmhg& gMapOfHandlers);
 	radTSubdividedExtrPolygon() { AlgsBasedOnKsQsMayNotWork = true;};
 
-	int Type_Group() { return 2;}
-	int Type_g3dRelax() { return 4;}
+	static const int TypeID_Group = 2;
+	int Type_Group() { return TypeID_Group;}
+	static const int TypeID_g3dRelax = 4;
+	int Type_g3dRelax() { return TypeID_g3dRelax;}
 
 	radTg3dGraphPresent* CreateGraphPresent();
 
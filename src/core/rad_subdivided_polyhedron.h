@@ -76,8 +76,10 @@ public:
 
 	radTSubdividedPolyhedron() {};
 
-	int Type_Group() { return 3;}
-	int Type_g3dRelax() { return 6;}
+	static const int TypeID_Group = 3;
+	int Type_Group() { return TypeID_Group;}
+	static const int TypeID_g3dRelax = 6;
+	int Type_g3dRelax() { return TypeID_g3dRelax;}
 
 	radTg3dGraphPresent* CreateGraphPresent();
 
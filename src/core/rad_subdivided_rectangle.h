@@ -62,8 +62,10 @@ public:
 	radTSubdividedRecMag(CAuxBinStrVect& inStr, map<int, int>& mKeysOldNew, radTmhg& gMapOfHandlers);
 	radTSubdividedRecMag();
 
-	int Type_Group() { return 1;}
-	int Type_g3dRelax() { return 3;}
+	static const int TypeID_Group = 1;
+	int Type_Group() { return TypeID_Group;}
+	static const int TypeID_g3dRelax = 3;
+	int Type_g3dRelax() { return TypeID_g3dRelax;}
 
 	int SetupFldCmpData(short, int);
 	inline TVector3d& ReturnCentrPoint(); // virtual in radTg3dRelax
@@ -73,6 +75,10 @@ public:
 
 	void B_comp(radTField*);
 	void B_compPolynomial(radTField* FieldPtr);
+	void B_compIntrctBatch(const TVector3d* ArrObsPoi, int AmOfObsPoi, const radTCompCriterium& CompCrit, int AmOfIntrctElemWithSym, TMatrix3d* ArrSubMatr)
+	{// B_comp of this class is order-dependent in the interaction matrix mode: keep the point-by-point version
+		radTg3dRelax::B_compIntrctBatch(ArrObsPoi, AmOfObsPoi, CompCrit, AmOfIntrctElemWithSym, ArrSubMatr);
+	}
 
 	radTg3dGraphPresent* CreateGraphPresent();
 
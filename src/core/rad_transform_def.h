@@ -45,8 +45,10 @@ public:
 	}
 	radTrans() : gmTrans() {}
 
-	int Type_g() { return 2;}
-	virtual int Type_Trans() { return 0;}
+	static const int TypeID_g = 2;
+	int Type_g() { return TypeID_g;}
+	static const int TypeID_Trans = 0;
+	virtual int Type_Trans() { return TypeID_Trans;}
 
 	void Dump(std::ostream& o, int ShortSign) // Porting
 	{
@@ -260,7 +262,8 @@ public:
 	void TrMatrix(TMatrix3d& Matrix) {}
 	void TrMatrix_inv(TMatrix3d& Matrix) {}
 
-	int Type_Trans() { return 1;}
+	static const int TypeID_Trans = 1;
+	int Type_Trans() { return TypeID_Trans;}
 	int SizeOfThis() { return sizeof(radIdentTrans);}
 
 	friend void TrProduct(radTrans* Tr2Ptr, radTrans* Tr1Ptr, radTrans& ResTrPtr);
@@ -270,8 +273,7 @@ public:
 
 inline void TrProduct(radTrans* Tr2Ptr, radTrans* Tr1Ptr, radTrans& ResTr)
 {
-	radIdentTrans IdentTr;
-	int IdentTrID = IdentTr.Type_Trans();
+	const int IdentTrID = radIdentTrans::TypeID_Trans;
 	int Tr1ID = Tr1Ptr->Type_Trans();
 	int Tr2ID = Tr2Ptr->Type_Trans();
 
@@ -18,6 +18,10 @@
 #include "rad_particle_trajectory.h"
 #include "rad_geometry_3d_aux.h"
 #include "rad_operation_names.h"
+#include "rad_field_batch.h"
+#include "rad_fmm.h"
+#include "rad_intrc_hmat.h"
+#include "rad_yield.h"
 
 #include <math.h>
 #include <string.h>
@@ -27,6 +31,7 @@
 #include <omp.h>
 #endif
 
+extern radTYield radYield;
 
 //-------------------------------------------------------------------------
 //-------------------------------------------------------------------------
@@ -58,7 +63,8 @@ void radTApplication::ComputeField(int ElemKey, char* FieldChar, double* StObsPo
 		TVector3d ObsPoiVect = StObsPoiVect;
 
 		radTField Field(FieldKey, CompCriterium, ObsPoiVect, ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.);
-		g3dPtr->B_genComp(&Field);
+		radYield.ProgressStart((Np > 1)? Np : 1);
+		if((Np <= 1) && !ComputeFieldBatch(g3dPtr, FieldKey, &ObsPoiVect, 1, &Field)) g3dPtr->B_genComp(&Field);
 
 		std::vector<radTField> vFieldArray;
 		std::vector<double> vArgArray;
@@ -72,25 +78,31 @@ void radTApplication::ComputeField(int ElemKey, char* FieldChar, double* StObsPo
 				ArgArray = vArgArray.data();
 			}
 
-			FieldArray[0] = Field;
 			TVector3d TranslVect = (1./double(Np-1))*(FiObsPoiVect-StObsPoiVect);
-			double StepArg;
+			double StepArg = 0.;
 			if(ArgumentNeeded) 
 			{
 				ArgArray[0] = StrtArg;
 				StepArg	= sqrt(TranslVect.x*TranslVect.x + TranslVect.y*TranslVect.y + TranslVect.z*TranslVect.z);
+				for(int i=1; i<Np; i++) ArgArray[i] = StrtArg + double(i) * StepArg;
 			}
 
-		#pragma omp parallel for if(Np > 100)
-			for(int i=1; i<Np; i++)
+			std::vector<TVector3d> vObsPoi(Np);
+			for(int i=0; i<Np; i++) vObsPoi[i] = StObsPoiVect + double(i) * TranslVect;
+			if(!ComputeFieldBatch(g3dPtr, FieldKey, vObsPoi.data(), Np, FieldArray))
 			{
-			TVector3d LocalObsPoiVect = StObsPoiVect + double(i) * TranslVect;
-				FieldArray[i] = radTField(FieldKey, CompCriterium, LocalObsPoiVect, ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.);
-				g3dPtr->B_genComp(&(FieldArray[i]));
-				if(ArgumentNeeded) ArgArray[i] = StrtArg + double(i) * StepArg;
+			#pragma omp parallel for if(Np > 100)
+				for(int i=0; i<Np; i++)
+				{
+					if(radYield.CancelIsRequested()) continue;
+					FieldArray[i] = radTField(FieldKey, CompCriterium, vObsPoi[i], ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.);
+					g3dPtr->B_genComp(&(FieldArray[i]));
+					radYield.ProgressAdd(1);
+				}
 			}
 		}
 		else FieldArray = &Field;
+		radYield.ThrowIfCancelled();
 
 		if(SendingIsRequired) Send.OutFieldCompRes(FieldChar, FieldArray, ArgArray, Np);
 		// RAII: vFieldArray and vArgArray cleaned up automatically
@@ -122,12 +134,19 @@ void radTApplication::ComputeField(int ElemKey, char* FieldChar, radTVectorOfVec
 		radTField* tField = FieldArray;
 
 		TVector3d ZeroVect(0.,0.,0.);
-		#pragma omp parallel for if(Np > 100)
-		for(long i=0; i<Np; i++)
+		radYield.ProgressStart(Np);
+		if(!ComputeFieldBatch(g3dPtr, FieldKey, VectorOfVector3d.data(), Np, FieldArray))
 		{
-			FieldArray[i] = radTField(FieldKey, CompCriterium, VectorOfVector3d[i], ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.);
-			g3dPtr->B_genComp(&(FieldArray[i]));
+		#pragma omp parallel for if(Np > 100)
+			for(long i=0; i<Np; i++)
+			{
+				if(radYield.CancelIsRequested()) continue;
+				FieldArray[i] = radTField(FieldKey, CompCriterium, VectorOfVector3d[i], ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.);
+				g3dPtr->B_genComp(&(FieldArray[i]));
+				radYield.ProgressAdd(1);
+			}
 		}
+		radYield.ThrowIfCancelled();
 
 		if(SendingIsRequired) OutFieldCompRes(FieldChar, FieldArray, Np, VectInputCell);
 		// RAII: vFieldArray cleaned up automatically
@@ -162,16 +181,21 @@ void radTApplication::ComputeField(int ElemKey, char* FieldChar, double** Points
 			radTField* tField = FieldArray;
 
 			TVector3d ZeroVect(0.,0.,0.), v;
-			double **tPoints = Points;
-			#pragma omp parallel for if(Np > 100)
-			for(long i=0; i<Np; i++)
+			std::vector<TVector3d> vObsPoi(Np);
+			for(long i=0; i<Np; i++) vObsPoi[i] = TVector3d(Points[i][0], Points[i][1], Points[i][2]);
+			radYield.ProgressStart(Np);
+			if(!ComputeFieldBatch(g3dPtr, FieldKey, vObsPoi.data(), Np, FieldArray))
 			{
-				double *t = Points[i];
-				TVector3d v; v.x = *(t++); v.y = *(t++); v.z = *t;
-
-				FieldArray[i] = radTField(FieldKey, CompCriterium, v, ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.);
-				g3dPtr->B_genComp(&(FieldArray[i]));
+			#pragma omp parallel for if(Np > 100)
+				for(long i=0; i<Np; i++)
+				{
+					if(radYield.CancelIsRequested()) continue;
+					FieldArray[i] = radTField(FieldKey, CompCriterium, vObsPoi[i], ZeroVect, ZeroVect, ZeroVect, ZeroVect, 0.);
+					g3dPtr->B_genComp(&(FieldArray[i]));
+					radYield.ProgressAdd(1);
+				}
 			}
+			radYield.ThrowIfCancelled();
 			if(SendingIsRequired) OutFieldCompRes(FieldChar, FieldArray, Np);
 			// RAII: vFieldArray cleaned up automatically
 		}
@@ -187,6 +211,40 @@ void radTApplication::ComputeField(int ElemKey, char* FieldChar, double** Points
 
 //-------------------------------------------------------------------------
 
+bool radTApplication::ComputeFieldBatch(radTg3d* g3dPtr, const radTFieldKey& FieldKey, const TVector3d* Points, long Np, radTField* FieldArray)
+{// B and H of groups by the treecode (option PrcFar); B, H, A and M by the flattened evaluation plan (radTFieldPlan); false if not applicable
+	bool OnlyBH = (FieldKey.B_ || FieldKey.H_) && !(FieldKey.A_ || FieldKey.M_ || FieldKey.J_ || FieldKey.Phi_ || FieldKey.PreRelax_ || FieldKey.Ib_ || FieldKey.Ih_
+		|| FieldKey.FinInt_ || FieldKey.Force_ || FieldKey.ForceEnr_ || FieldKey.Torque_ || FieldKey.Energy_ || FieldKey.Q_);
+	bool TreeAllowed = OnlyBH && (Np >= 2) && (CompCriterium.FarRelPrec > 0.) && (Cast.GroupCast(g3dPtr) != 0);
+	for(int k=0; k<4; k++) if(CompCriterium.MltplThresh[k] > 0.) TreeAllowed = false;
+	if(TreeAllowed)
+	{
+		std::vector<TVector3d> vH(FieldKey.H_? Np : 0), vB(FieldKey.B_? Np : 0);
+		int Order; double Theta;
+		radTFMMFieldEvaluator::TreeParameters(CompCriterium.FarRelPrec, Order, Theta);
+		radTFMMFieldEvaluator Tree(Order, Theta, 16);
+		if(Tree.EvaluateFieldTree(g3dPtr, Points, Np, CompCriterium, FieldKey.B_? vB.data() : 0, FieldKey.H_? vH.data() : 0))
+		{
+			TVector3d ZeroVect(0.,0.,0.);
+			for(long i=0; i<Np; i++)
+			{
+				radTField& Field = FieldArray[i];
+				Field.FieldKey = FieldKey; Field.CompCriterium = CompCriterium; Field.P = Points[i];
+				Field.B = FieldKey.B_? vB[i] : ZeroVect;
+				Field.H = FieldKey.H_? vH[i] : ZeroVect;
+			}
+			return true;
+		}
+	}
+
+	radTFieldPlan Plan;
+	if(!Plan.Setup(g3dPtr, FieldKey, CompCriterium)) return false;
+	Plan.Compute(Points, Np, FieldArray);
+	return true;
+}
+
+//-------------------------------------------------------------------------
+
 void radTApplication::ComputeFieldInt(int ElemKey, char* FinOrInfChar, char* FieldIntChar, double* StPoi, long lenStPoi, double* FiPoi, long lenFiPoi)
 {
 	try
@@ -208,6 +266,7 @@ void radTApplication::ComputeFieldInt(int ElemKey, char* FinOrInfChar, char* Fie
 
 		g3dPtr->B_genComp(&Field);
 
+		radYield.ThrowIfCancelled();
 		if(SendingIsRequired) Send.OutFieldIntCompRes(FieldIntChar, &Field);
 	}
 	catch(...) 
@@ -266,6 +325,7 @@ void radTApplication::ComputeFieldForce(int SourceElemKey, int ShapeElemKey)
 
 		ShapePtr->B_genComp(&Field);
 
+		radYield.ThrowIfCancelled();
 		if(SendingIsRequired) Send.Vector3d(&LocForce);
 	}
 	catch(...) 
@@ -314,6 +374,7 @@ void radTApplication::ComputeFieldEnergy(int DestElemKey, int SourceElemKey, int
 		DestPtr->EnergyForceTorqueComp(&Field);
 
 		if(Field.HandleEnergyForceTorqueCompData.rep->SomethingIsWrong) return;
+		radYield.ThrowIfCancelled();
 		if(SendingIsRequired) Send.Double(Field.Energy);
 	}
 	catch(...)
@@ -365,6 +426,7 @@ void radTApplication::ComputeFieldForceThroughEnergy(int DestElemKey, int Source
 		DestPtr->EnergyForceTorqueComp(&Field);
 
 		if(Field.HandleEnergyForceTorqueCompData.rep->SomethingIsWrong) return;
+		radYield.ThrowIfCancelled();
 		if(SendingIsRequired) Send.OutFieldForceOrTorqueThroughEnergyCompRes(ForceComponID, Field.Force, 'f');
 	}
 	catch(...)
@@ -418,6 +480,7 @@ void radTApplication::ComputeFieldTorqueThroughEnergy(int DestElemKey, int Sourc
 		DestPtr->EnergyForceTorqueComp(&Field);
 
 		if(Field.HandleEnergyForceTorqueCompData.rep->SomethingIsWrong) return;
+		radYield.ThrowIfCancelled();
 		if(SendingIsRequired) Send.OutFieldForceOrTorqueThroughEnergyCompRes(TorqueComponID, Field.Torque, 't');
 	}
 	catch(...)
@@ -503,6 +566,7 @@ void radTApplication::ComputeParticleTrajectory(int ElemKey, double Energy, doub
 
 		int Depth = 2;
 		int Dims[] = { 5, Np };
+		radYield.ThrowIfCancelled();
 		if(SendingIsRequired) Send.ArbNestedArrays(TrjData, Dims, Depth);
 
 		// TrjData cleaned up automatically by RAII (std::vector)
@@ -533,6 +597,7 @@ void radTApplication::ComputeFocusPotent(int ElemKey, double* StPoi, long lenStP
 		radTPrtclTrj PrtclTrj(SourcePtr, CompCriterium);
 		double FocPot = PrtclTrj.FocusingPotential(StPoiVect, FiPoiVect, Np);
 
+		radYield.ThrowIfCancelled();
 		if(SendingIsRequired) Send.Double(FocPot);
 	}
 	catch(...) 
@@ -604,6 +669,7 @@ void radTApplication::ComputeFocusKickPer(int ElemKey, double* P1, double* Nlong
 		//radTPrtclTrj::ComposeStrReportSecondOrderKickPer(StrComment, per*nper, np1, np2, pCoordDir1, pCoordDir2, pKickData1, pKickData2, pBtE2Int, pStrReport, cKickUnit);
 		radTPrtclTrj::ComposeStrReportSecondOrderKickPer(StrComment, per*nper, np1, np2, pCoordDir1, pCoordDir2, pKickData1, pKickData2, pBtE2Int, pStrReport, cKickUnit, cOutFormat);
 
+		radYield.ThrowIfCancelled();
 		if(SendingIsRequired)
 		{
 			//long LenArr = 2*np1*np2 + np1 + np2 + 1;
@@ -719,6 +785,7 @@ void radTApplication::ComputeFocusKick(int ElemKey, double* P1, double* Nlong, d
 		char EmptyStr[] = "\0";
 		PrtclTrj.ComposeStrReportSecondOrderKick(StrComment, ArrLongDist, lenArrLongDist, np1, np2, pCoordDir1, pCoordDir2, pKickData1, pKickData2, pIBe2, pStrReport);
 
+		radYield.ThrowIfCancelled();
 		if(SendingIsRequired) 
 		{
 			Send.InitOutList(4);
@@ -855,6 +922,7 @@ void radTApplication::ComputeShimSignature(int ElemKey, char* FldID, double* Dis
 
 		SendingIsRequired = prevSendingIsRequired;
 
+		radYield.ThrowIfCancelled();
 		if(SendingIsRequired)
 		{
 			if(FieldKey.Ib_	|| FieldKey.Ih_)
@@ -1439,6 +1507,7 @@ int radTApplication::DeleteAllElements(int DeletionMethNo)
 		GlobalUniqueMapKey = 1;
 
 		MapOfDrawAttr.erase(MapOfDrawAttr.begin(), MapOfDrawAttr.end());
+		radTHMatrixInteraction::ReleaseUpdateCache(); // H-matrices kept for incremental updates refer to deleted elements
 
 		if(SendingIsRequired) Send.Int(0);
 		return 1;
@@ -36,6 +36,9 @@
 class radTInteraction;
 
 //-------------------------------------------------------------------------
+// The type of an object is compared with the static TypeID_... constant of
+// the target class (the value returned by its Type_...() function), so no
+// object of the target class is constructed.
 //-------------------------------------------------------------------------
 
 class radTCast {
@@ -67,8 +70,7 @@ public:
 
 inline radTg3d* radTCast::g3dCast(radTg* gPtr)
 {
-	radTg3d g3d;
-	if(gPtr->Type_g()==g3d.Type_g()) return (radTg3d*)gPtr;
+	if(gPtr->Type_g()==radTg3d::TypeID_g) return (radTg3d*)gPtr;
 	else return 0;
 }
 
@@ -76,8 +78,7 @@ inline radTg3d* radTCast::g3dCast(radTg* gPtr)
 
 inline radTGroup* radTCast::GroupCast(radTg3d* g3dPtr)
 {
-	radTGroup Group;
-	if(g3dPtr->Type_g3d()==Group.Type_g3d()) return (radTGroup*)g3dPtr;
+	if(g3dPtr->Type_g3d()==radTGroup::TypeID_g3d) return (radTGroup*)g3dPtr;
 	else return 0;
 }
 
@@ -85,8 +86,7 @@ inline radTGroup* radTCast::GroupCast(radTg3d* g3dPtr)
 
 inline radTg3dRelax* radTCast::g3dRelaxCast(radTg3d* g3dPtr)
 {
-	radTg3dRelax g3dRelax;
-	if(g3dPtr->Type_g3d()==g3dRelax.Type_g3d()) return (radTg3dRelax*)g3dPtr;
+	if(g3dPtr->Type_g3d()==radTg3dRelax::TypeID_g3d) return (radTg3dRelax*)g3dPtr;
 	else return 0;
 }
 
@@ -94,8 +94,7 @@ inline radTg3dRelax* radTCast::g3dRelaxCast(radTg3d* g3dPtr)
 
 inline radTRecMag* radTCast::RecMagCast(radTg3dRelax* g3dRelaxPtr)
 {
-	radTRecMag RecMag;
-	if(g3dRelaxPtr->Type_g3dRelax()==RecMag.Type_g3dRelax()) return (radTRecMag*)g3dRelaxPtr;
+	if(g3dRelaxPtr->Type_g3dRelax()==radTRecMag::TypeID_g3dRelax) return (radTRecMag*)g3dRelaxPtr;
 	else return 0;
 }
 
@@ -103,8 +102,7 @@ inline radTRecMag* radTCast::RecMagCast(radTg3dRelax* g3dRelaxPtr)
 
 inline radTSubdividedRecMag* radTCast::SubdividedRecMagCast(radTGroup* GroupPtr)
 {
-	radTSubdividedRecMag SubdividedRecMag;
-	if(GroupPtr->Type_Group()==SubdividedRecMag.Type_Group()) return (radTSubdividedRecMag*)GroupPtr;
+	if(GroupPtr->Type_Group()==radTSubdividedRecMag::TypeID_Group) return (radTSubdividedRecMag*)GroupPtr;
 	else return 0;
 }
 
@@ -112,8 +110,7 @@ inline radTSubdividedRecMag* radTCast::SubdividedRecMagCast(radTGroup* GroupPtr)
 
 inline radTSubdividedRecMag* radTCast::SubdividedRecMagCastFromRelax(radTg3dRelax* g3dRelaxPtr)
 {
-	radTSubdividedRecMag SubdividedRecMag;
-	if(g3dRelaxPtr->Type_g3dRelax()==SubdividedRecMag.Type_g3dRelax()) return (radTSubdividedRecMag*)g3dRelaxPtr;
+	if(g3dRelaxPtr->Type_g3dRelax()==radTSubdividedRecMag::TypeID_g3dRelax) return (radTSubdividedRecMag*)g3dRelaxPtr;
 	else return 0;
 }
 
@@ -121,8 +118,7 @@ inline radTSubdividedRecMag* radTCast::SubdividedRecMagCastFromRelax(radTg3dRela
 
 inline radTExtrPolygon* radTCast::ExtrPolygonCast(radTg3dRelax* g3dRelaxPtr)
 {
-	radTExtrPolygon ExtrPolygon;
-	if(g3dRelaxPtr->Type_g3dRelax()==ExtrPolygon.Type_g3dRelax()) return (radTExtrPolygon*)g3dRelaxPtr;
+	if(g3dRelaxPtr->Type_g3dRelax()==radTExtrPolygon::TypeID_g3dRelax) return (radTExtrPolygon*)g3dRelaxPtr;
 	else return 0;
 }
 
@@ -130,8 +126,7 @@ inline radTExtrPolygon* radTCast::ExtrPolygonCast(radTg3dRelax* g3dRelaxPtr)
 
 inline radTSubdividedExtrPolygon* radTCast::SubdExtrPolygonCastFromGroup(radTGroup* GroupPtr)
 {
-	radTSubdividedExtrPolygon SubdividedExtrPolygon;
-	if(GroupPtr->Type_Group()==SubdividedExtrPolygon.Type_Group()) return (radTSubdividedExtrPolygon*)GroupPtr;
+	if(GroupPtr->Type_Group()==radTSubdividedExtrPolygon::TypeID_Group) return (radTSubdividedExtrPolygon*)GroupPtr;
 	else return 0;
 }
 
@@ -139,8 +134,7 @@ inline radTSubdividedExtrPolygon* radTCast::SubdExtrPolygonCastFromGroup(radTGro
 
 inline radTSubdividedExtrPolygon* radTCast::SubdExtrPolygonCastFromRelax(radTg3dRelax* g3dRelaxPtr)
 {
-	radTSubdividedExtrPolygon SubdividedExtrPolygon;
-	if(g3dRelaxPtr->Type_g3dRelax()==SubdividedExtrPolygon.Type_g3dRelax()) return (radTSubdividedExtrPolygon*)g3dRelaxPtr;
+	if(g3dRelaxPtr->Type_g3dRelax()==radTSubdividedExtrPolygon::TypeID_g3dRelax) return (radTSubdividedExtrPolygon*)g3dRelaxPtr;
 	else return 0;
 }
 
@@ -148,8 +142,7 @@ inline radTSubdividedExtrPolygon* radTCast::SubdExtrPolygonCastFromRelax(radTg3d
 
 inline radTPolyhedron* radTCast::PolyhedronCast(radTg3dRelax* g3dRelaxPtr)
 {
-	radTPolyhedron Polyhedron;
-	if(g3dRelaxPtr->Type_g3dRelax()==Polyhedron.Type_g3dRelax()) return (radTPolyhedron*)g3dRelaxPtr;
+	if(g3dRelaxPtr->Type_g3dRelax()==radTPolyhedron::TypeID_g3dRelax) return (radTPolyhedron*)g3dRelaxPtr;
 	else return 0;
 }
 
@@ -157,8 +150,7 @@ inline radTPolyhedron* radTCast::PolyhedronCast(radTg3dRelax* g3dRelaxPtr)
 
 inline radTSubdividedPolyhedron* radTCast::SubdPolyhedronCastFromGroup(radTGroup* GroupPtr)
 {
-	radTSubdividedPolyhedron SubdividedPolyhedron;
-	if(GroupPtr->Type_Group()==SubdividedPolyhedron.Type_Group()) return (radTSubdividedPolyhedron*)GroupPtr;
+	if(GroupPtr->Type_Group()==radTSubdividedPolyhedron::TypeID_Group) return (radTSubdividedPolyhedron*)GroupPtr;
 	else return 0;
 }
 
@@ -166,8 +158,7 @@ inline radTSubdividedPolyhedron* radTCast::SubdPolyhedronCastFromGroup(radTGroup
 
 inline radTRectangle* radTCast::RectangleCast(radTg3d* g3dPtr)
 {
-	radTRectangle Rectangle;
-	if(g3dPtr->Type_g3d()==Rectangle.Type_g3d()) return (radTRectangle*)g3dPtr;
+	if(g3dPtr->Type_g3d()==radTRectangle::TypeID_g3d) return (radTRectangle*)g3dPtr;
 	else return 0;
 }
 
@@ -175,8 +166,7 @@ inline radTRectangle* radTCast::RectangleCast(radTg3d* g3dPtr)
 
 inline radTFlmLinCur* radTCast::FlmLinCurCast(radTg3d* g3dPtr)
 {
-	radTFlmLinCur FlmLinCur;
-	if(g3dPtr->Type_g3d()==FlmLinCur.Type_g3d()) return (radTFlmLinCur*)g3dPtr;
+	if(g3dPtr->Type_g3d()==radTFlmLinCur::TypeID_g3d) return (radTFlmLinCur*)g3dPtr;
 	else return 0;
 }
 
@@ -184,8 +174,7 @@ inline radTFlmLinCur* radTCast::FlmLinCurCast(radTg3d* g3dPtr)
 
 inline radTrans* radTCast::TransCast(radTg* gPtr)
 {
-	radTrans Trans;
-	if(gPtr->Type_g()==Trans.Type_g()) return (radTrans*)gPtr;
+	if(gPtr->Type_g()==radTrans::TypeID_g) return (radTrans*)gPtr;
 	else return 0;
 }
 
@@ -193,8 +182,7 @@ inline radTrans* radTCast::TransCast(radTg* gPtr)
 
 inline radTrans* radTCast::IdentTransCast(radTrans* TransPtr)
 {
-	radIdentTrans IdentTrans;
-	if(TransPtr->Type_Trans()==IdentTrans.Type_Trans()) return (radIdentTrans*)TransPtr;
+	if(TransPtr->Type_Trans()==radIdentTrans::TypeID_Trans) return (radIdentTrans*)TransPtr;
 	else return 0;
 }
 
@@ -202,8 +190,7 @@ inline radTrans* radTCast::IdentTransCast(radTrans* TransPtr)
 
 inline radTMaterial* radTCast::MaterCast(radTg* gPtr)
 {
-	radTMaterial Mater;
-	if(gPtr->Type_g()==Mater.Type_g()) return (radTMaterial*)gPtr;
+	if(gPtr->Type_g()==radTMaterial::TypeID_g) return (radTMaterial*)gPtr;
 	else return 0;
 }
 
@@ -211,8 +198,7 @@ inline radTMaterial* radTCast::MaterCast(radTg* gPtr)
 
 inline radTLinearAnisotropMaterial* radTCast::LinAnisoMaterCast(radTMaterial* MaterPtr)
 {
-	radTLinearAnisotropMaterial LinAnisoMater;
-	if(MaterPtr->Type_Material()==LinAnisoMater.Type_Material()) return (radTLinearAnisotropMaterial*)MaterPtr;
+	if(MaterPtr->Type_Material()==radTLinearAnisotropMaterial::TypeID_Material) return (radTLinearAnisotropMaterial*)MaterPtr;
 	else return 0;
 }
 
@@ -220,8 +206,7 @@ inline radTLinearAnisotropMaterial* radTCast::LinAnisoMaterCast(radTMaterial* Ma
 
 inline radTLinearIsotropMaterial* radTCast::LinIsoMaterCast(radTMaterial* MaterPtr)
 {
-	radTLinearIsotropMaterial LinIsoMater;
-	if(MaterPtr->Type_Material()==LinIsoMater.Type_Material()) return (radTLinearIsotropMaterial*)MaterPtr;
+	if(MaterPtr->Type_Material()==radTLinearIsotropMaterial::TypeID_Material) return (radTLinearIsotropMaterial*)MaterPtr;
 	else return 0;
 }
 
@@ -229,8 +214,7 @@ inline radTLinearIsotropMaterial* radTCast::LinIsoMaterCast(radTMaterial* MaterP
 
 inline radTNonlinearIsotropMaterial* radTCast::NonlinIsoMaterCast(radTMaterial* MaterPtr)
 {
-	radTNonlinearIsotropMaterial NonlinIsoMater;
-	if(MaterPtr->Type_Material()==NonlinIsoMater.Type_Material()) return (radTNonlinearIsotropMaterial*)MaterPtr;
+	if(MaterPtr->Type_Material()==radTNonlinearIsotropMaterial::TypeID_Material) return (radTNonlinearIsotropMaterial*)MaterPtr;
 	else return 0;
 }
 
@@ -0,0 +1,160 @@
+/*
+ * @file bench_hacapk_kernels.cpp
+ * @brief Microbenchmark of the dense block kernels (near-field and low-rank block application)
+ *
+ * Part of the HACApK C++ implementation (MIT License, see LICENSE).
+ *
+ * Compares, per block size:
+ * - scalar: plain double loops (the former hand-written block products)
+ * - builtin: dense_gemv_builtin() / dense_gemm_builtin() (OpenMP SIMD)
+ * - backend: dense_gemv() / dense_gemm() as compiled (BLAS with HACAPK_USE_BLAS)
+ *
+ * Usage: bench_hacapk_kernels [repetition scale, default 1]
+ */
+
+#include "hacapk.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <algorithm>
+
+using namespace hacapk;
+using namespace std;
+
+namespace {
+
+vector<double> make_data(size_t n, double seed) {
+	vector<double> v(n);
+	for (size_t i = 0; i < n; i++) v[i] = sin(seed + 0.37 * i) + 0.1 * cos(1.3 * i);
+	return v;
+}
+
+/**
+ * Mean wall time of one call in microseconds
+ */
+double time_us(int reps, const function<void()>& f) {
+	f();  // warm-up
+	auto t0 = chrono::steady_clock::now();
+	for (int r = 0; r < reps; r++) f();
+	auto t1 = chrono::steady_clock::now();
+	return chrono::duration<double, micro>(t1 - t0).count() / reps;
+}
+
+double max_difference(const vector<double>& a, const vector<double>& b) {
+	double d = 0.0;
+	for (size_t i = 0; i < a.size(); i++) d = max(d, std::abs(a[i] - b[i]));
+	return d;
+}
+
+void scalar_gemv(bool trans, int m, int n, const double* A, const double* x, double* y) {
+	for (int i = 0; i < m; i++)
+		for (int j = 0; j < n; j++) {
+			if (trans) y[j] += A[static_cast<size_t>(i) * n + j] * x[i];
+			else y[i] += A[static_cast<size_t>(i) * n + j] * x[j];
+		}
+}
+
+void print_row(const string& name, double t_scalar, double t_builtin, double t_backend, double diff) {
+	cout << "  " << left << setw(28) << name << right << fixed << setprecision(2)
+		<< setw(11) << t_scalar << setw(11) << t_builtin << setw(11) << t_backend
+		<< setw(9) << t_scalar / t_backend << "x" << scientific << setprecision(1) << setw(10) << diff << endl;
+}
+
+void print_header(const string& title) {
+	cout << "\n" << title << endl;
+	cout << "  " << left << setw(28) << "block" << right << setw(11) << "scalar" << setw(11) << "builtin"
+		<< setw(11) << "backend" << setw(10) << "speedup" << setw(10) << "max diff" << endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	double scale = (argc > 1) ? atof(argv[1]) : 1.0;
+
+	cout << string(70, '=') << endl;
+	cout << "HACApK Dense Block Kernel Microbenchmark" << endl;
+	cout << string(70, '=') << endl;
+	cout << "Backend: " << dense_kernel_backend() << " (times in microseconds per call)" << endl;
+
+	// Dense near-field blocks: y += A x and y += A^T x
+	print_header("Full blocks (gemv)");
+	for (int n : {16, 64, 256, 1024}) {
+		for (int trans = 0; trans < 2; trans++) {
+			vector<double> A = make_data(static_cast<size_t>(n) * n, 0.1), x = make_data(n, 0.7);
+			vector<double> y0(n, 0.0), y1(n, 0.0), y2(n, 0.0);
+			int reps = max(1, static_cast<int>(scale * 2.0e7 / (static_cast<double>(n) * n)));
+
+			double ts = time_us(reps, [&]() { scalar_gemv(trans != 0, n, n, A.data(), x.data(), y0.data()); });
+			double tb = time_us(reps, [&]() { dense_gemv_builtin(trans != 0, n, n, 1.0, A.data(), x.data(), y1.data()); });
+			double tk = time_us(reps, [&]() { dense_gemv(trans != 0, n, n, 1.0, A.data(), x.data(), y2.data()); });
+
+			double diff = max(max_difference(y0, y1), max_difference(y0, y2)) / (reps + 1);
+			print_row(to_string(n) + " x " + to_string(n) + (trans ? " (trans)" : ""), ts, tb, tk, diff);
+		}
+	}
+
+	// Low-rank far-field blocks: y += U (V^T x)
+	print_header("Low-rank blocks U*V^T (2 x gemv)");
+	for (int n : {64, 256, 1024}) {
+		for (int k : {4, 16, 48}) {
+			vector<double> U = make_data(static_cast<size_t>(n) * k, 0.2), V = make_data(static_cast<size_t>(n) * k, 0.9);
+			vector<double> x = make_data(n, 0.3), t(k);
+			vector<double> y0(n, 0.0), y1(n, 0.0), y2(n, 0.0);
+			int reps = max(1, static_cast<int>(scale * 1.0e7 / (static_cast<double>(n) * k)));
+
+			double ts = time_us(reps, [&]() {
+				fill(t.begin(), t.end(), 0.0);
+				scalar_gemv(true, n, k, V.data(), x.data(), t.data());
+				scalar_gemv(false, n, k, U.data(), t.data(), y0.data());
+			});
+			double tb = time_us(reps, [&]() {
+				fill(t.begin(), t.end(), 0.0);
+				dense_gemv_builtin(true, n, k, 1.0, V.data(), x.data(), t.data());
+				dense_gemv_builtin(false, n, k, 1.0, U.data(), t.data(), y1.data());
+			});
+			double tk = time_us(reps, [&]() {
+				fill(t.begin(), t.end(), 0.0);
+				dense_gemv(true, n, k, 1.0, V.data(), x.data(), t.data());
+				dense_gemv(false, n, k, 1.0, U.data(), t.data(), y2.data());
+			});
+
+			double diff = max(max_difference(y0, y1), max_difference(y0, y2)) / (reps + 1);
+			print_row(to_string(n) + " x " + to_string(n) + ", k = " + to_string(k), ts, tb, tk, diff);
+		}
+	}
+
+	// Dense products of H-arithmetic: C += A B (full x full) and C += U V^T (low-rank to dense)
+	print_header("Block products (gemm)");
+	for (int n : {32, 128, 256}) {
+		for (int transb = 0; transb < 2; transb++) {
+			int l = transb ? 16 : n;
+			vector<double> A = make_data(static_cast<size_t>(n) * l, 0.4), B = make_data(static_cast<size_t>(l) * n, 0.8);
+			vector<double> C0(static_cast<size_t>(n) * n, 0.0), C1 = C0, C2 = C0;
+			int reps = max(1, static_cast<int>(scale * 2.0e8 / (static_cast<double>(n) * n * l)));
+
+			double ts = time_us(reps, [&]() {
+				for (int i = 0; i < n; i++)
+					for (int j = 0; j < n; j++) {
+						double sum = 0.0;
+						for (int p = 0; p < l; p++)
+							sum += A[static_cast<size_t>(i) * l + p] * (transb ? B[static_cast<size_t>(j) * l + p] : B[static_cast<size_t>(p) * n + j]);
+						C0[static_cast<size_t>(i) * n + j] += sum;
+					}
+			});
+			double tb = time_us(reps, [&]() { dense_gemm_builtin(false, transb != 0, n, n, l, 1.0, A.data(), B.data(), C1.data()); });
+			double tk = time_us(reps, [&]() { dense_gemm(false, transb != 0, n, n, l, 1.0, A.data(), B.data(), C2.data()); });
+
+			double diff = max(max_difference(C0, C1), max_difference(C0, C2)) / (reps + 1);
+			string name = transb ? to_string(n) + " x " + to_string(l) + " * (" + to_string(n) + " x " + to_string(l) + ")^T"
+				: to_string(n) + " x " + to_string(n) + " * " + to_string(n) + " x " + to_string(n);
+			print_row(name, ts, tb, tk, diff);
+		}
+	}
+
+	cout << "\nspeedup = scalar / backend; max diff = largest deviation per accumulated call" << endl;
+	return 0;
+}
@@ -31,8 +31,11 @@
 
 #include "hacapk.hpp"
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <limits>
+#include <numeric>
+#include <random>
 #include <stdexcept>
 #include <iostream>
 
@@ -94,6 +97,66 @@ Cluster::Cluster(int ndim_)
 {
 }
 
+void principal_axis(
+	const std::vector<Point3D>& points,
+	const std::vector<int>& indices,
+	int start,
+	int size,
+	double axis[3]
+) {
+	// Centroid and covariance matrix
+	double c[3] = {0.0, 0.0, 0.0};
+	for (int i = 0; i < size; i++) {
+		const Point3D& p = points[indices[start + i]];
+		c[0] += p.x; c[1] += p.y; c[2] += p.z;
+	}
+	for (int k = 0; k < 3; k++) c[k] /= size;
+
+	double a[3][3] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+	for (int i = 0; i < size; i++) {
+		const Point3D& p = points[indices[start + i]];
+		double d[3] = {p.x - c[0], p.y - c[1], p.z - c[2]};
+		for (int k = 0; k < 3; k++)
+			for (int l = 0; l < 3; l++) a[k][l] += d[k] * d[l];
+	}
+
+	// Cyclic Jacobi eigenvalue iteration: a -> diag, columns of v = eigenvectors
+	double v[3][3] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+	for (int sweep = 0; sweep < 50; sweep++) {
+		double off = std::abs(a[0][1]) + std::abs(a[0][2]) + std::abs(a[1][2]);
+		double diag = std::abs(a[0][0]) + std::abs(a[1][1]) + std::abs(a[2][2]);
+		if (off <= 1e-15 * diag || off == 0.0) break;
+
+		for (int p = 0; p < 2; p++)
+			for (int q = p + 1; q < 3; q++) {
+				if (a[p][q] == 0.0) continue;
+				double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+				double t = ((theta >= 0.0) ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+				double cs = 1.0 / std::sqrt(t * t + 1.0), sn = t * cs;
+				for (int k = 0; k < 3; k++) {
+					double akp = a[k][p], akq = a[k][q];
+					a[k][p] = cs * akp - sn * akq;
+					a[k][q] = sn * akp + cs * akq;
+				}
+				for (int k = 0; k < 3; k++) {
+					double apk = a[p][k], aqk = a[q][k];
+					a[p][k] = cs * apk - sn * aqk;
+					a[q][k] = sn * apk + cs * aqk;
+				}
+				for (int k = 0; k < 3; k++) {
+					double vkp = v[k][p], vkq = v[k][q];
+					v[k][p] = cs * vkp - sn * vkq;
+					v[k][q] = sn * vkp + cs * vkq;
+				}
+			}
+	}
+
+	int imax = 0;
+	for (int k = 1; k < 3; k++)
+		if (a[k][k] > a[imax][imax]) imax = k;
+	for (int k = 0; k < 3; k++) axis[k] = v[k][imax];
+}
+
 void compute_bounding_box(
 	Cluster& cluster,
 	const std::vector<Point3D>& points,
@@ -136,6 +199,33 @@ bool is_admissible(
 	return (dist >= eta * min_diam);
 }
 
+bool is_admissible(
+	const BoundingBox& box1,
+	const BoundingBox& box2,
+	const ControlParams& params
+) {
+	if (!is_admissible(box1, box2, params.eta)) return false;
+
+	BoundingBox image(3);
+	for (const std::array<double, 12>& map : params.target_images) {
+		// Box of the 8 mapped corners
+		for (int d = 0; d < 3; d++) {
+			image.min[d] = std::numeric_limits<double>::max();
+			image.max[d] = -std::numeric_limits<double>::max();
+		}
+		for (int c = 0; c < 8; c++) {
+			double x[3] = {(c & 1) ? box2.max[0] : box2.min[0], (c & 2) ? box2.max[1] : box2.min[1], (c & 4) ? box2.max[2] : box2.min[2]};
+			for (int d = 0; d < 3; d++) {
+				double y = map[3 * d] * x[0] + map[3 * d + 1] * x[1] + map[3 * d + 2] * x[2] + map[9 + d];
+				image.min[d] = std::min(image.min[d], y);
+				image.max[d] = std::max(image.max[d], y);
+			}
+		}
+		if (!is_admissible(box1, image, params.eta)) return false;
+	}
+	return true;
+}
+
 // ============================================================================
 // Cluster Tree Generation
 // ============================================================================
@@ -161,43 +251,62 @@ std::shared_ptr<Cluster> generate_cluster(
 		return cluster;
 	}
 
-	// Find longest dimension
-	double dx = cluster->bbox.max[0] - cluster->bbox.min[0];
-	double dy = cluster->bbox.max[1] - cluster->bbox.min[1];
-	double dz = cluster->bbox.max[2] - cluster->bbox.min[2];
-
-	int split_dim = 0;
-	if (dy > dx && dy > dz) split_dim = 1;
-	else if (dz > dx && dz > dy) split_dim = 2;
-
-	// Find split point (median)
-	double split_val = (cluster->bbox.min[split_dim] + cluster->bbox.max[split_dim]) / 2.0;
+	// Splitting direction: longest bounding-box edge or principal axis
+	double axis[3] = {0.0, 0.0, 0.0};
+	if (params.split_type == 2 || params.split_type == 3) {
+		principal_axis(points, indices, start, size, axis);
+	} else {
+		double dx = cluster->bbox.max[0] - cluster->bbox.min[0];
+		double dy = cluster->bbox.max[1] - cluster->bbox.min[1];
+		double dz = cluster->bbox.max[2] - cluster->bbox.min[2];
+
+		int split_dim = 0;
+		if (dy > dx && dy > dz) split_dim = 1;
+		else if (dz > dx && dz > dy) split_dim = 2;
+		axis[split_dim] = 1.0;
+	}
+	auto coord = [&points, &axis](int idx) {
+		const Point3D& p = points[idx];
+		return axis[0] * p.x + axis[1] * p.y + axis[2] * p.z;
+	};
 
-	// Partition indices around split
-	int left = start;
-	int right = start + size - 1;
+	int left_size = 0;
+	if (params.split_type == 3) {
+		// Cardinality-balanced: split at the median along the axis
+		left_size = size / 2;
+		std::nth_element(
+			indices.begin() + start, indices.begin() + start + left_size, indices.begin() + start + size,
+			[&coord](int a, int b) { return coord(a) < coord(b); }
+		);
+	} else {
+		// Split at the midpoint of the extent along the axis
+		double cmin = coord(indices[start]), cmax = cmin;
+		for (int i = 1; i < size; i++) {
+			double c = coord(indices[start + i]);
+			cmin = std::min(cmin, c);
+			cmax = std::max(cmax, c);
+		}
+		double split_val = (cmin + cmax) / 2.0;
 
-	while (left <= right) {
-		const Point3D& p = points[indices[left]];
-		double val = (split_dim == 0) ? p.x : (split_dim == 1) ? p.y : p.z;
+		// Partition indices around split
+		int left = start;
+		int right = start + size - 1;
 
-		if (val < split_val) {
-			left++;
-		} else {
-			std::swap(indices[left], indices[right]);
-			right--;
+		while (left <= right) {
+			if (coord(indices[left]) < split_val) {
+				left++;
+			} else {
+				std::swap(indices[left], indices[right]);
+				right--;
+			}
 		}
+		left_size = left - start;
 	}
 
-	int left_size = left - start;
-	int right_size = size - left_size;
-
 	// Ensure both children have at least one element
-	if (left_size == 0 || right_size == 0) {
-		left_size = size / 2;
-		right_size = size - left_size;
-		left = start + left_size;
-	}
+	if (left_size == 0 || left_size == size) left_size = size / 2;
+	int right_size = size - left_size;
+	int left = start + left_size;
 
 	// Recursively create children (binary tree)
 	cluster->nnson = 2;
@@ -249,13 +358,17 @@ ControlParams::ControlParams()
 	, print_level(1)
 	, leaf_size(15)
 	, max_leaf_size_ratio(1.0)
+	, split_type(1)
 	, eta(2.0)
 	, eps_aca(1e-6)
 	, aca_type(2)
+	, max_rank(50)
+	, collect_stats(false)
 {
 	param[1] = 1.0;    // Print level
 	param[21] = 15.0;  // Leaf size
 	param[22] = 1.0;   // Max leaf size ratio
+	param[23] = 1.0;   // Split type
 	param[51] = 2.0;   // Eta parameter
 	param[60] = 2.0;   // ACA type (2=ACA+)
 	param[63] = 1e-6;  // ACA tolerance
@@ -450,6 +563,38 @@ void aca_approximation(
 	}
 }
 
+double estimate_block_error(
+	const LowRankBlock& block,
+	KernelFunction kernel,
+	void* kernel_data,
+	int nsample,
+	double* norm
+) {
+	if (norm) *norm = 0.0;
+	if (!block.is_lowrank() || !kernel) return 0.0;
+
+	int m = block.ndl;
+	int n = block.ndt;
+	int k = block.kt;
+	int ns = std::min(m, std::max(nsample, 1));
+
+	double err2 = 0.0, ref2 = 0.0;
+	for (int s = 0; s < ns; s++) {
+		int i = (s * m) / ns;
+		for (int j = 0; j < n; j++) {
+			double a = kernel(block.nstrtl + i, block.nstrtt + j, kernel_data);
+			double r = a;
+			for (int l = 0; l < k; l++) {
+				r -= block.a1[i * k + l] * block.a2[j * k + l];
+			}
+			err2 += r * r;
+			ref2 += a * a;
+		}
+	}
+	if (norm) *norm = std::sqrt(ref2 * m / ns);
+	return (ref2 > 0.0) ? std::sqrt(err2 / ref2) : std::sqrt(err2);
+}
+
 void aca_plus_approximation(
 	LowRankBlock& block,
 	KernelFunction kernel,
@@ -465,6 +610,62 @@ void aca_plus_approximation(
 // H-Matrix Construction
 // ============================================================================
 
+namespace {
+
+/**
+ * Fill a leaf block (cluster-order indices set) by ACA or as a full matrix; returns its statistics
+ */
+BlockStats fill_leaf_block(
+	LowRankBlock& block,
+	bool admissible,
+	KernelFunction kernel,
+	void* kernel_data,
+	const ControlParams& params
+) {
+	// Count kernel evaluations of this block only when requested: the wrapper adds a call per entry
+	BlockStats stats;
+	KernelFunction counted = kernel;
+	if (params.collect_stats) {
+		counted = [&kernel, &stats](int i, int j, void* data) {
+			stats.kernel_calls++;
+			return kernel(i, j, data);
+		};
+	}
+	auto t_start = std::chrono::steady_clock::now();
+
+	block.a1.clear();
+	block.a2.clear();
+	if (admissible) {
+		// Use ACA for low-rank approximation
+		if (params.aca_type == 2) {
+			aca_plus_approximation(block, counted, kernel_data, params.eps_aca);
+		} else {
+			aca_approximation(block, counted, kernel_data, params.eps_aca);
+		}
+	} else {
+		// Store as full matrix
+		block.ltmtx = 2;
+		block.kt = 0;
+		int m = block.ndl;
+		int n = block.ndt;
+		block.a1.resize(m * n);
+
+		// Compute full matrix using kernel function
+		// Use same indexing as ACA
+		for (int i = 0; i < m; i++) {
+			for (int j = 0; j < n; j++) {
+				block.a1[i * n + j] = counted(block.nstrtl + i, block.nstrtt + j, kernel_data);
+			}
+		}
+	}
+
+	stats.build_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+	if (params.collect_stats) stats.est_error = estimate_block_error(block, kernel, kernel_data, 4, &stats.est_norm);
+	return stats;
+}
+
+} // namespace
+
 void generate_leaf_blocks(
 	HMatrix& hmat,
 	const std::shared_ptr<Cluster>& source_cluster,
@@ -474,7 +675,7 @@ void generate_leaf_blocks(
 	const ControlParams& params
 ) {
 	// Check admissibility
-	bool admissible = is_admissible(source_cluster->bbox, target_cluster->bbox, params.eta);
+	bool admissible = is_admissible(source_cluster->bbox, target_cluster->bbox, params);
 
 	// Both are leaves
 	if (source_cluster->is_leaf() && target_cluster->is_leaf()) {
@@ -484,31 +685,10 @@ void generate_leaf_blocks(
 		block.nstrtt = target_cluster->nstrt;
 		block.ndt = target_cluster->nsize;
 
-		if (admissible) {
-			// Use ACA for low-rank approximation
-			if (params.aca_type == 2) {
-				aca_plus_approximation(block, kernel, kernel_data, params.eps_aca);
-			} else {
-				aca_approximation(block, kernel, kernel_data, params.eps_aca);
-			}
-		} else {
-			// Store as full matrix
-			block.ltmtx = 2;
-			block.kt = 0;
-			int m = block.ndl;
-			int n = block.ndt;
-			block.a1.resize(m * n);
-
-			// Compute full matrix using kernel function
-			// Use same indexing as ACA
-			for (int i = 0; i < m; i++) {
-				for (int j = 0; j < n; j++) {
-					block.a1[i * n + j] = kernel(block.nstrtl + i, block.nstrtt + j, kernel_data);
-				}
-			}
-		}
+		BlockStats stats = fill_leaf_block(block, admissible, kernel, kernel_data, params);
 
 		hmat.blocks.push_back(block);
+		hmat.stats.push_back(stats);
 		hmat.nlf++;
 		if (block.is_lowrank()) {
 			hmat.nlfkt++;
@@ -557,12 +737,181 @@ std::unique_ptr<HMatrix> build_hmatrix(
 	auto source_tree = generate_cluster(source_points, source_indices, 0, source_points.size(), 0, params);
 	auto target_tree = generate_cluster(target_points, target_indices, 0, target_points.size(), 0, params);
 
+	// Blocks are generated in cluster order; the kernel expects original indices
+	hmat->lodl = source_indices;
+	hmat->lodt = target_indices;
+	KernelFunction permuted_kernel = [&kernel, &source_indices, &target_indices](int i, int j, void* data) {
+		return kernel(source_indices[i], target_indices[j], data);
+	};
+
 	// Generate leaf blocks
-	generate_leaf_blocks(*hmat, source_tree, target_tree, kernel, kernel_data, params);
+	generate_leaf_blocks(*hmat, source_tree, target_tree, permuted_kernel, kernel_data, params);
 
 	return hmat;
 }
 
+HMatrixPlan plan_hmatrix(
+	const std::vector<Point3D>& source_points,
+	const std::vector<Point3D>& target_points,
+	KernelFunction kernel,
+	void* kernel_data,
+	const ControlParams& params,
+	int nsample,
+	unsigned seed
+) {
+	HMatrixPlan plan;
+	int m = static_cast<int>(source_points.size());
+	int n = static_cast<int>(target_points.size());
+	if (m == 0 || n == 0) return plan;
+
+	std::vector<int> source_indices(m), target_indices(n);
+	std::iota(source_indices.begin(), source_indices.end(), 0);
+	std::iota(target_indices.begin(), target_indices.end(), 0);
+	auto source_tree = generate_cluster(source_points, source_indices, 0, m, 0, params);
+	auto target_tree = generate_cluster(target_points, target_indices, 0, n, 0, params);
+
+	// Leaf blocks as in generate_leaf_blocks(), without filling them
+	std::vector<LowRankBlock> far, near;
+	std::function<void(const Cluster&, const Cluster&)> traverse = [&](const Cluster& src, const Cluster& tgt) {
+		if (src.is_leaf() && tgt.is_leaf()) {
+			if (is_admissible(src.bbox, tgt.bbox, params)) {
+				LowRankBlock block;
+				block.nstrtl = src.nstrt;
+				block.ndl = src.nsize;
+				block.nstrtt = tgt.nstrt;
+				block.ndt = tgt.nsize;
+				far.push_back(block);
+				plan.far_dims += src.nsize + tgt.nsize;
+			} else {
+				LowRankBlock block;
+				block.nstrtl = src.nstrt;
+				block.ndl = src.nsize;
+				block.nstrtt = tgt.nstrt;
+				block.ndt = tgt.nsize;
+				near.push_back(block);
+				plan.near_entries += static_cast<long long>(src.nsize) * tgt.nsize;
+			}
+			return;
+		}
+		if (!src.is_leaf() && !tgt.is_leaf()) {
+			for (const auto& s : src.sons) for (const auto& t : tgt.sons) traverse(*s, *t);
+		} else if (!src.is_leaf()) {
+			for (const auto& s : src.sons) traverse(*s, tgt);
+		} else {
+			for (const auto& t : tgt.sons) traverse(src, *t);
+		}
+	};
+	traverse(*source_tree, *target_tree);
+	plan.far_blocks = static_cast<long long>(far.size());
+
+	// Kernel timing on random entries and on random full blocks, ACA ranks and timing of random low-rank blocks
+	KernelFunction counted = [&kernel, &plan, &source_indices, &target_indices](int i, int j, void* data) {
+		plan.sample_kernel_calls++;
+		return kernel(source_indices[i], target_indices[j], data);
+	};
+	std::mt19937 gen(seed);
+	int nentries = 32 * std::max(nsample, 1);
+	auto t_start = std::chrono::steady_clock::now();
+	for (int s = 0; s < nentries; s++) counted(static_cast<int>(gen() % m), static_cast<int>(gen() % n), kernel_data);
+	plan.kernel_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count() / nentries;
+
+	plan.near_kernel_time = plan.kernel_time;
+	if (!near.empty()) {
+		long long calls = plan.sample_kernel_calls;
+		t_start = std::chrono::steady_clock::now();
+		for (int s = 0; s < std::max(nsample, 1); s++) {
+			const LowRankBlock& block = near[gen() % near.size()];
+			for (int i = 0; i < block.ndl; i++)
+				for (int j = 0; j < block.ndt; j++) counted(block.nstrtl + i, block.nstrtt + j, kernel_data);
+		}
+		plan.near_kernel_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count()
+			/ static_cast<double>(plan.sample_kernel_calls - calls);
+	}
+
+	int ns = std::min(static_cast<int>(far.size()), std::max(nsample, 0));
+	for (int s = 0; s < ns; s++) {
+		std::uniform_int_distribution<int> pick(s, static_cast<int>(far.size()) - 1);
+		std::swap(far[s], far[pick(gen)]);
+	}
+	double rank_dims = 0.0, dims = 0.0;
+	t_start = std::chrono::steady_clock::now();
+	for (int s = 0; s < ns; s++) {
+		LowRankBlock& block = far[s];
+		fill_leaf_block(block, true, counted, kernel_data, params);
+		rank_dims += static_cast<double>(block.kt) * (block.ndl + block.ndt);
+		dims += block.ndl + block.ndt;
+	}
+	double far_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count();
+	plan.build_time = plan.near_entries * plan.near_kernel_time;
+	if (dims > 0.0) plan.build_time += far_time * plan.far_dims / dims;
+	if (dims > 0.0) plan.mean_rank = rank_dims / dims;
+	return plan;
+}
+
+int update_hmatrix(
+	HMatrix& hmat,
+	const std::vector<Point3D>& source_points,
+	const std::vector<Point3D>& target_points,
+	const std::vector<int>& changed_source,
+	const std::vector<int>& changed_target,
+	KernelFunction kernel,
+	void* kernel_data,
+	const ControlParams& params
+) {
+	if (hmat.lodl.size() != source_points.size() || hmat.lodt.size() != target_points.size())
+		throw std::invalid_argument("hacapk: update_hmatrix() point sets do not match the H-matrix");
+
+	// Changed points in cluster order, as prefix counts for range queries
+	auto prefix_count = [](const std::vector<int>& lod, const std::vector<int>& changed) {
+		std::vector<int> flag(lod.size(), 0), inv(lod.size());
+		for (size_t k = 0; k < lod.size(); k++) inv[lod[k]] = static_cast<int>(k);
+		for (int idx : changed) flag[inv[idx]] = 1;
+		std::vector<int> cnt(lod.size() + 1, 0);
+		for (size_t k = 0; k < lod.size(); k++) cnt[k + 1] = cnt[k] + flag[k];
+		return cnt;
+	};
+	std::vector<int> cnt_l = prefix_count(hmat.lodl, changed_source);
+	std::vector<int> cnt_t = prefix_count(hmat.lodt, changed_target);
+
+	std::vector<int> affected;
+	for (size_t b = 0; b < hmat.blocks.size(); b++) {
+		const LowRankBlock& block = hmat.blocks[b];
+		bool row_changed = cnt_l[block.nstrtl + block.ndl] > cnt_l[block.nstrtl];
+		bool col_changed = cnt_t[block.nstrtt + block.ndt] > cnt_t[block.nstrtt];
+		if (row_changed || col_changed) affected.push_back(static_cast<int>(b));
+	}
+
+	const std::vector<int>& lodl = hmat.lodl;
+	const std::vector<int>& lodt = hmat.lodt;
+	KernelFunction permuted_kernel = [&kernel, &lodl, &lodt](int i, int j, void* data) {
+		return kernel(lodl[i], lodt[j], data);
+	};
+
+	// The cluster trees are kept; admissibility is re-checked with the current points
+	int naffected = static_cast<int>(affected.size());
+	#pragma omp parallel for schedule(dynamic)
+	for (int a = 0; a < naffected; a++) {
+		LowRankBlock& block = hmat.blocks[affected[a]];
+		Cluster rows(3), cols(3);
+		rows.nstrt = block.nstrtl; rows.nsize = block.ndl;
+		cols.nstrt = block.nstrtt; cols.nsize = block.ndt;
+		compute_bounding_box(rows, source_points, lodl);
+		compute_bounding_box(cols, target_points, lodt);
+
+		bool admissible = is_admissible(rows.bbox, cols.bbox, params);
+		hmat.stats[affected[a]] = fill_leaf_block(block, admissible, permuted_kernel, kernel_data, params);
+	}
+
+	hmat.nlfkt = 0;
+	hmat.ktmax = 0;
+	for (const LowRankBlock& block : hmat.blocks) {
+		if (!block.is_lowrank()) continue;
+		hmat.nlfkt++;
+		hmat.ktmax = std::max(hmat.ktmax, block.kt);
+	}
+	return naffected;
+}
+
 // ============================================================================
 // Matrix-Vector Multiplication
 // ============================================================================
@@ -570,84 +919,167 @@ std::unique_ptr<HMatrix> build_hmatrix(
 void lowrank_matvec(
 	const LowRankBlock& block,
 	const std::vector<double>& x,
-	std::vector<double>& y
+	std::vector<double>& y,
+	bool trans
 ) {
 	if (!block.is_lowrank()) return;
 
-	int m = block.ndl;
-	int n = block.ndt;
-	int k = block.kt;
+	int x_start = trans ? block.nstrtl : block.nstrtt;
+	int y_start = trans ? block.nstrtt : block.nstrtl;
+	block_gemv(block, trans, 1.0, x.data() + x_start, y.data() + y_start);
+}
 
-	// Compute temp = V^T * x
-	std::vector<double> temp(k, 0.0);
+void block_gemv(const LowRankBlock& block, bool trans, double alpha, const double* x, double* y)
+{
+	int m = block.ndl, n = block.ndt;
 
-	for (int r = 0; r < k; r++) {
-		for (int j = 0; j < n; j++) {
-			temp[r] += block.a2[j * k + r] * x[block.nstrtt + j];
-		}
-	}
+	if (block.is_lowrank()) {
+		int k = block.kt;
+		if (k == 0) return;
 
-	// Compute y += U * temp
-	for (int i = 0; i < m; i++) {
-		for (int r = 0; r < k; r++) {
-			y[block.nstrtl + i] += block.a1[i * k + r] * temp[r];
-		}
+		// The transpose U * V^T -> V * U^T swaps the roles of the factors
+		const std::vector<double>& a_in = trans ? block.a1 : block.a2;
+		const std::vector<double>& a_out = trans ? block.a2 : block.a1;
+		int nin = trans ? m : n, nout = trans ? n : m;
+
+		// temp = V^T * x, y += alpha * U * temp
+		std::vector<double> temp(k, 0.0);
+		dense_gemv(true, nin, k, 1.0, a_in.data(), x, temp.data());
+		dense_gemv(false, nout, k, alpha, a_out.data(), temp.data(), y);
+	}
+	else if (block.is_full() && !block.a1.empty()) {
+		// A[i,j] stored in row-major format
+		dense_gemv(trans, m, n, alpha, block.a1.data(), x, y);
 	}
 }
 
 void hmatrix_matvec(
 	const HMatrix& hmat,
 	const std::vector<double>& x,
-	std::vector<double>& y
+	std::vector<double>& y,
+	bool trans
 ) {
+	// Blocks act on vectors in cluster order; H^T maps the row space to the column space
+	const std::vector<int>& lod_x = trans ? hmat.lodl : hmat.lodt;
+	const std::vector<int>& lod_y = trans ? hmat.lodt : hmat.lodl;
+	std::vector<double> x_perm, y_perm;
+	if (!lod_x.empty()) {
+		x_perm.resize(lod_x.size());
+		for (size_t k = 0; k < lod_x.size(); k++) x_perm[k] = x[lod_x[k]];
+	}
+	const std::vector<double>& x_c = lod_x.empty() ? x : x_perm;
+	if (!lod_y.empty()) y_perm.assign(y.size(), 0.0);
+	std::vector<double>& y_c = lod_y.empty() ? y : y_perm;
+
 	// Initialize output
 	std::fill(y.begin(), y.end(), 0.0);
 
 	// OpenMP parallelized loop over blocks
 	int nblocks = hmat.blocks.size();
+	int nparts = static_cast<int>(hmat.thread_part.size()) - 1;
+
+	if (nparts > 0 && hmat.thread_part[nparts] == nblocks) {
+		// NUMA placement: thread t applies the blocks it first touched (hmatrix_first_touch);
+		// their row ranges are disjoint, so H x is accumulated without synchronisation
+		#pragma omp parallel num_threads(nparts)
+		{
+			int nthr = omp_get_num_threads();
+			for (int t = omp_get_thread_num(); t < nparts; t += nthr) {
+				for (int b = hmat.thread_part[t]; b < hmat.thread_part[t + 1]; b++) {
+					const LowRankBlock& block = hmat.blocks[b];
+					if (!block.is_lowrank() && !block.is_full()) continue;
+					if (!trans) {
+						block_gemv(block, false, 1.0, x_c.data() + block.nstrtt, y_c.data() + block.nstrtl);
+						continue;
+					}
+					std::vector<double> y_local(block.ndt, 0.0);
+					block_gemv(block, true, 1.0, x_c.data() + block.nstrtl, y_local.data());
+					#pragma omp critical
+					{
+						for (int i = 0; i < block.ndt; i++) y_c[block.nstrtt + i] += y_local[i];
+					}
+				}
+			}
+		}
+	} else {
+		#pragma omp parallel for schedule(dynamic)
+		for (int b = 0; b < nblocks; b++) {
+			const LowRankBlock& block = hmat.blocks[b];
+			if (!block.is_lowrank() && !block.is_full()) continue;
 
-	#pragma omp parallel for
-	for (int b = 0; b < nblocks; b++) {
-		const LowRankBlock& block = hmat.blocks[b];
+			int x_start = trans ? block.nstrtl : block.nstrtt;
+			int y_start = trans ? block.nstrtt : block.nstrtl;
+			int ny = trans ? block.ndt : block.ndl;
 
-		if (block.is_lowrank()) {
-			// Need temporary vector for thread safety
-			std::vector<double> y_local(y.size(), 0.0);
-			lowrank_matvec(block, x, y_local);
+			// Block-local result for thread safety
+			std::vector<double> y_local(ny, 0.0);
+			block_gemv(block, trans, 1.0, x_c.data() + x_start, y_local.data());
 
 			// Add to global y (critical section)
 			#pragma omp critical
 			{
-				for (size_t i = 0; i < y.size(); i++) {
-					y[i] += y_local[i];
-				}
+				for (int i = 0; i < ny; i++) y_c[y_start + i] += y_local[i];
 			}
 		}
-		else if (block.is_full()) {
-			// Full matrix multiplication: y = A * x
-			// A[i,j] stored in row-major format
-			int m = block.ndl;
-			int n = block.ndt;
-
-			std::vector<double> y_local(y.size(), 0.0);
-
-			for (int i = 0; i < m; i++) {
-				double sum = 0.0;
-				for (int j = 0; j < n; j++) {
-					sum += block.a1[i * n + j] * x[block.nstrtt + j];
-				}
-				y_local[block.nstrtl + i] = sum;
-			}
+	}
 
-			// Add to global y (critical section)
-			#pragma omp critical
-			{
-				for (size_t i = 0; i < y.size(); i++) {
-					y[i] += y_local[i];
-				}
-			}
+	if (!lod_y.empty()) {
+		for (size_t k = 0; k < lod_y.size(); k++) y[lod_y[k]] = y_perm[k];
+	}
+}
+
+double hmatrix_estimate_error(
+	const HMatrix& hmat,
+	KernelFunction kernel,
+	void* kernel_data,
+	int nsample,
+	int nvec,
+	unsigned seed
+) {
+	int m = 0, n = 0;
+	for (const LowRankBlock& block : hmat.blocks) {
+		m = std::max(m, block.nstrtl + block.ndl);
+		n = std::max(n, block.nstrtt + block.ndt);
+	}
+	if (m == 0 || n == 0 || !kernel) return 0.0;
+	nvec = std::max(nvec, 1);
+
+	// Random rows (without repetition) and random sign vectors
+	std::mt19937 gen(seed);
+	std::vector<int> rows(m);
+	std::iota(rows.begin(), rows.end(), 0);
+	int ns = std::min(m, std::max(nsample, 1));
+	for (int s = 0; s < ns; s++) {
+		std::uniform_int_distribution<int> pick(s, m - 1);
+		std::swap(rows[s], rows[pick(gen)]);
+	}
+	rows.resize(ns);
+	std::vector<std::vector<double>> x(nvec, std::vector<double>(n));
+	for (int v = 0; v < nvec; v++) {
+		for (int j = 0; j < n; j++) x[v][j] = (gen() & 1) ? 1.0 : -1.0;
+	}
+
+	// Exact products on the sampled rows
+	std::vector<double> ref(static_cast<size_t>(ns) * nvec, 0.0);
+	#pragma omp parallel for schedule(dynamic)
+	for (int s = 0; s < ns; s++) {
+		for (int j = 0; j < n; j++) {
+			double a = kernel(rows[s], j, kernel_data);
+			for (int v = 0; v < nvec; v++) ref[static_cast<size_t>(s) * nvec + v] += a * x[v][j];
+		}
+	}
+
+	double err2 = 0.0, ref2 = 0.0;
+	std::vector<double> y(m);
+	for (int v = 0; v < nvec; v++) {
+		hmatrix_matvec(hmat, x[v], y);
+		for (int s = 0; s < ns; s++) {
+			double r = ref[static_cast<size_t>(s) * nvec + v];
+			err2 += (y[rows[s]] - r) * (y[rows[s]] - r);
+			ref2 += r * r;
 		}
 	}
+	return (ref2 > 0.0) ? std::sqrt(err2 / ref2) : std::sqrt(err2);
 }
 
 } // namespace hacapk
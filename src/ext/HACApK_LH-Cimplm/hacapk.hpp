@@ -46,10 +46,12 @@
 #ifndef HACAPK_HPP
 #define HACAPK_HPP
 
+#include <array>
 #include <vector>
 #include <memory>
 #include <functional>
 #include <cstdint>
+#include <cmath>
 #include <omp.h>
 
 namespace hacapk {
@@ -133,6 +135,18 @@ struct LowRankBlock {
 	size_t memory_usage() const;
 };
 
+/**
+ * Construction statistics of one leaf block
+ */
+struct BlockStats {
+	long long kernel_calls;  // Kernel evaluations during construction (ControlParams::collect_stats)
+	double build_time;       // Construction wall time [s]
+	double est_error;        // Estimated relative Frobenius error, 0 for full blocks (ControlParams::collect_stats)
+	double est_norm;         // Estimated Frobenius norm of a low-rank block (ControlParams::collect_stats)
+
+	BlockStats() : kernel_calls(0), build_time(0.0), est_error(0.0), est_norm(0.0) {}
+};
+
 /**
  * H-matrix structure (leaf matrix parameters)
  */
@@ -143,7 +157,10 @@ public:
 	int nlfkt;          // Number of low-rank blocks
 	int ktmax;          // Maximum rank
 
-	std::vector<LowRankBlock> blocks;  // Leaf blocks
+	std::vector<LowRankBlock> blocks;  // Leaf blocks (indices in cluster order)
+	std::vector<BlockStats> stats;     // Construction statistics (parallel to blocks)
+	std::vector<int> lodl, lodt;       // Original index of row / column in cluster order (empty = identity)
+	std::vector<int> thread_part;      // Blocks [thread_part[t], thread_part[t+1]) of thread t (hmatrix_first_touch, empty = dynamic)
 
 	// Block structure
 	std::vector<int> lbstrtl, lbstrtt;  // Block start indices (row/col)
@@ -169,11 +186,20 @@ struct ControlParams {
 	// Clustering parameters
 	double leaf_size;           // Leaf size (param[21])
 	double max_leaf_size_ratio; // Max leaf size ratio (param[22])
+	int split_type;             // Cluster splitting: 1=longest box edge at midpoint,
+	                            // 2=principal axis (PCA) at midpoint, 3=principal axis at median
 
 	// H-matrix parameters
 	double eta;                 // Distance parameter (param[51])
 	double eps_aca;             // ACA tolerance (param[63])
 	int aca_type;               // ACA type: 1=ACA, 2=ACA+ (param[60])
+	int max_rank;               // Maximum rank of low-rank blocks in block-cluster trees
+	bool collect_stats;         // Count kernel calls and estimate block errors in HMatrix::stats (report only)
+
+	// Symmetry images of the column (target) points whose kernel contributions are summed
+	// in every entry: affine maps x -> A x + b, stored as A (row-major) followed by b.
+	// A block is admissible only if it is admissible for the direct and for every image box.
+	std::vector<std::array<double, 12>> target_images;
 
 	ControlParams();
 	~ControlParams() = default;
@@ -208,6 +234,18 @@ std::shared_ptr<Cluster> generate_cluster(
 	const ControlParams& params
 );
 
+/**
+ * Principal axis (unit eigenvector of the largest eigenvalue of the covariance matrix)
+ * of points indices[start..start+size)
+ */
+void principal_axis(
+	const std::vector<Point3D>& points,
+	const std::vector<int>& indices,
+	int start,
+	int size,
+	double axis[3]
+);
+
 /**
  * Compute bounding box for cluster
  */
@@ -226,6 +264,16 @@ bool is_admissible(
 	double eta
 );
 
+/**
+ * Admissibility of a row box and a column box with params.eta, required for
+ * the column box and all its images under params.target_images
+ */
+bool is_admissible(
+	const BoundingBox& box1,
+	const BoundingBox& box2,
+	const ControlParams& params
+);
+
 // ============================================================================
 // H-Matrix Construction
 // ============================================================================
@@ -241,6 +289,61 @@ std::unique_ptr<HMatrix> build_hmatrix(
 	const ControlParams& params
 );
 
+/**
+ * Incremental update of an H-matrix built by build_hmatrix() after some points moved
+ * or their kernel entries changed (changed_source / changed_target: original indices).
+ * Leaf blocks whose row or column cluster contains a changed point are recomputed, with
+ * admissibility re-checked for the current points; all other blocks are kept and the
+ * cluster trees are not rebuilt. Returns the number of recomputed blocks.
+ */
+int update_hmatrix(
+	HMatrix& hmat,
+	const std::vector<Point3D>& source_points,
+	const std::vector<Point3D>& target_points,
+	const std::vector<int>& changed_source,
+	const std::vector<int>& changed_target,
+	KernelFunction kernel,
+	void* kernel_data,
+	const ControlParams& params
+);
+
+/**
+ * Cost estimate of an H-matrix before it is built (plan_hmatrix)
+ */
+struct HMatrixPlan {
+	long long near_entries;         // Entries of full (inadmissible) leaf blocks
+	long long far_blocks;           // Number of low-rank leaf blocks
+	long long far_dims;             // Sum of rows + columns of the low-rank blocks
+	double mean_rank;               // ACA rank of the sampled low-rank blocks, weighted by rows + columns
+	long long sample_kernel_calls;  // Kernel evaluations of the sample
+	double kernel_time;             // Mean wall time of one kernel evaluation on random entries [s]
+	double near_kernel_time;        // Mean wall time of one kernel evaluation in full leaf blocks [s]
+	double build_time;              // Estimated serial construction time [s]
+
+	HMatrixPlan() : near_entries(0), far_blocks(0), far_dims(0), mean_rank(0.0), sample_kernel_calls(0),
+		kernel_time(0.0), near_kernel_time(0.0), build_time(0.0) {}
+
+	// Estimated entries stored, i.e. also kernel evaluations of the construction
+	double stored_entries() const { return near_entries + mean_rank * far_dims; }
+};
+
+/**
+ * Structure-only dry run of build_hmatrix(): cluster trees and admissibility
+ * give the near-field entries and the low-rank blocks exactly; their rank is
+ * estimated by ACA on up to nsample randomly chosen low-rank blocks. The kernel
+ * is timed on random entries and on entries of random full blocks, and the ACA
+ * of the sampled blocks is timed per row + column, giving build_time
+ */
+HMatrixPlan plan_hmatrix(
+	const std::vector<Point3D>& source_points,
+	const std::vector<Point3D>& target_points,
+	KernelFunction kernel,
+	void* kernel_data,
+	const ControlParams& params,
+	int nsample = 8,
+	unsigned seed = 1
+);
+
 /**
  * Generate leaf blocks recursively
  */
@@ -267,6 +370,19 @@ void aca_approximation(
 	double eps
 );
 
+/**
+ * Relative Frobenius error of a low-rank block, estimated on up to nsample
+ * evenly spaced rows against the kernel; the estimated Frobenius norm of the
+ * block is returned in norm (if not null)
+ */
+double estimate_block_error(
+	const LowRankBlock& block,
+	KernelFunction kernel,
+	void* kernel_data,
+	int nsample = 4,
+	double* norm = nullptr
+);
+
 /**
  * ACA+ algorithm (improved version)
  */
@@ -282,24 +398,343 @@ void aca_plus_approximation(
 // ============================================================================
 
 /**
- * H-matrix matrix-vector product: y = H * x
+ * H-matrix matrix-vector product: y = H * x, or y = H^T * x if trans
+ * (y has the size of the row space, or of the column space if trans)
  * OpenMP parallelized
  */
 void hmatrix_matvec(
 	const HMatrix& hmat,
 	const std::vector<double>& x,
-	std::vector<double>& y
+	std::vector<double>& y,
+	bool trans = false
 );
 
 /**
- * Low-rank block matrix-vector product: y += U * (V^T * x)
+ * Low-rank block matrix-vector product: y += U * (V^T * x), or y += V * (U^T * x) if trans
  */
 void lowrank_matvec(
 	const LowRankBlock& block,
 	const std::vector<double>& x,
-	std::vector<double>& y
+	std::vector<double>& y,
+	bool trans = false
 );
 
+/**
+ * Leaf block product on local vectors: y += alpha * M * x, or y += alpha * M^T * x if trans
+ * (x, y start at the block's column / row offsets, swapped if trans)
+ */
+void block_gemv(const LowRankBlock& block, bool trans, double alpha, const double* x, double* y);
+
+/**
+ * Randomised a-posteriori accuracy estimate of an H-matrix:
+ * relative error ||(H x - A x)_S|| / ||(A x)_S|| of the products with nvec
+ * random +-1 vectors x on nsample randomly chosen rows S, the exact rows of
+ * A being evaluated by the kernel (original indices). Costs nsample * n
+ * kernel calls and nvec H-matrix products.
+ */
+double hmatrix_estimate_error(
+	const HMatrix& hmat,
+	KernelFunction kernel,
+	void* kernel_data,
+	int nsample = 32,
+	int nvec = 2,
+	unsigned seed = 1
+);
+
+// ============================================================================
+// Block-Cluster Tree and H-Arithmetic
+// ============================================================================
+
+/**
+ * Node of a block-cluster tree: block (row cluster t) x (column cluster s)
+ *
+ * Admissible blocks and blocks of two leaf clusters are leaves holding a
+ * low-rank (ltmtx=1) or full (ltmtx=2) LowRankBlock. Other blocks are
+ * subdivided into an nsonl x nsont grid of sons(t) x sons(s); a leaf
+ * cluster counts as its own single son. Index ranges refer to the
+ * permuted (cluster) ordering of the owning HMatrixTree.
+ */
+struct HNode {
+	int nstrtl, ndl;    // Row start and size
+	int nstrtt, ndt;    // Column start and size
+	int nsonl, nsont;   // Son grid dimensions (0 for leaves)
+
+	LowRankBlock leaf;                         // Leaf data
+	std::vector<std::unique_ptr<HNode>> sons;  // Sons, row-major (nsonl x nsont)
+
+	HNode();
+	~HNode() = default;
+
+	bool is_leaf() const { return sons.empty(); }
+	HNode& son(int i, int j) { return *sons[i * nsont + j]; }
+	const HNode& son(int i, int j) const { return *sons[i * nsont + j]; }
+
+	size_t memory_usage() const;
+};
+
+/**
+ * H-matrix stored as a block-cluster tree
+ * Unlike the flat HMatrix it keeps the block hierarchy, which is required
+ * for H-arithmetic (addition, multiplication) and H-LU factorisation.
+ */
+class HMatrixTree {
+public:
+	int nd;                      // Total number of unknowns
+	std::vector<int> lod;        // Permutation: cluster position -> original index
+	std::shared_ptr<Cluster> tree;  // Cluster tree of rows and columns
+	std::unique_ptr<HNode> root; // Root block (whole matrix)
+	bool is_factored;            // Root holds L (unit lower) and U after hlu_factorize()
+
+	int nlf;            // Number of leaf blocks
+	int nlfkt;          // Number of low-rank blocks
+	int ktmax;          // Maximum rank
+
+	HMatrixTree();
+	~HMatrixTree() = default;
+
+	void update_statistics();
+	size_t memory_usage() const;
+	double compression_ratio() const;
+};
+
+/**
+ * Build block-cluster tree H-matrix of a square kernel matrix
+ * Kernel indices are the original point indices. Admissible blocks are
+ * approximated by partially pivoted ACA and recompressed to relative
+ * accuracy params.eps_aca with rank at most params.max_rank.
+ */
+std::unique_ptr<HMatrixTree> build_hmatrix_tree(
+	const std::vector<Point3D>& points,
+	KernelFunction kernel,
+	void* kernel_data,
+	const ControlParams& params
+);
+
+/**
+ * Block-cluster tree matrix-vector product: y = H * x, or y = H^T * x if trans (original ordering)
+ */
+void hmatrix_tree_matvec(
+	const HMatrixTree& hmat,
+	const std::vector<double>& x,
+	std::vector<double>& y,
+	bool trans = false
+);
+
+/**
+ * Block matrix-vector product: y += alpha * op(A) * x, op(A) = A or A^T
+ * x and y are local to the block (x[0] is the first column of op(A)).
+ */
+void hnode_gemv(const HNode& A, bool trans, double alpha, const double* x, double* y);
+
+/**
+ * Dense copy of a block (row-major ndl x ndt)
+ */
+void hnode_to_dense(const HNode& A, std::vector<double>& dense);
+
+/**
+ * H-matrix addition: C += alpha * A (blocks of equal size)
+ * eps: relative truncation accuracy, kmax: maximum rank of the result
+ */
+void hnode_add(HNode& C, double alpha, const HNode& A, double eps, int kmax);
+
+/**
+ * H-matrix multiplication: C += alpha * A * B
+ * eps: relative truncation accuracy, kmax: maximum rank of the result
+ */
+void hnode_mul_add(HNode& C, double alpha, const HNode& A, const HNode& B, double eps, int kmax);
+
+/**
+ * In-place H-LU factorisation of a diagonal block (no pivoting)
+ */
+void hnode_lu(HNode& A, double eps, int kmax);
+
+/**
+ * Triangular solves with a factorised diagonal block (in place, local vector)
+ * hnode_solve_lower: L x = b (unit lower), hnode_solve_upper: U x = b,
+ * hnode_solve_upper_trans: U^T x = b, hnode_solve_lower_trans: L^T x = b (unit lower)
+ */
+void hnode_solve_lower(const HNode& LU, double* x);
+void hnode_solve_upper(const HNode& LU, double* x);
+void hnode_solve_upper_trans(const HNode& LU, double* x);
+void hnode_solve_lower_trans(const HNode& LU, double* x);
+
+/**
+ * Approximate H-LU factorisation: H ~ L * U at accuracy eps
+ * Throws std::runtime_error on a zero pivot.
+ */
+void hlu_factorize(HMatrixTree& hmat, double eps, int kmax);
+
+/**
+ * Solve (L*U) x = b (trans: (L*U)^T x = b) with a factorised tree;
+ * b is overwritten by x (original ordering)
+ */
+void hlu_solve(const HMatrixTree& hmat, std::vector<double>& b, bool trans = false);
+
+// ============================================================================
+// H2-Matrices (Nested Cluster Bases)
+// ============================================================================
+
+/**
+ * Node of a nested cluster basis
+ * Leaf clusters store an orthonormal basis V (nsize x k); for the other
+ * clusters the basis is implicit: restricted to son t' it is V_t' * E_t',
+ * where the transfer matrix E_t' (k_t' x k_t) is stored in the son.
+ */
+struct ClusterBasis {
+	int nstrt, nsize;       // Index range (cluster order)
+	int k;                  // Rank
+	int father;             // Father id (-1 for the root)
+	std::vector<int> sons;  // Son ids (empty for leaves)
+
+	std::vector<double> V;  // Leaf basis (nsize x k, row-major)
+	std::vector<double> E;  // Transfer matrix to the father (k x k_father, row-major)
+
+	ClusterBasis() : nstrt(0), nsize(0), k(0), father(-1) {}
+
+	bool is_leaf() const { return sons.empty(); }
+};
+
+/**
+ * Admissible block of an H2-matrix: M = V_row * S * W_col^T
+ */
+struct H2Block {
+	int row, col;           // Row / column cluster basis ids
+	std::vector<double> S;  // Coupling matrix (k_row x k_col, row-major)
+};
+
+/**
+ * H2-matrix: admissible blocks share nested row and column cluster bases,
+ * inadmissible blocks are stored as full matrices.
+ * Storage and matrix-vector products are O(N k).
+ * Basis ids are in pre-order (sons have larger ids than their father).
+ */
+class H2Matrix {
+public:
+	int nd;                                 // Total number of unknowns
+	std::vector<int> lod;                   // Permutation: cluster position -> original index
+	std::vector<ClusterBasis> row_basis;    // Row cluster basis (id 0 = root)
+	std::vector<ClusterBasis> col_basis;    // Column cluster basis (id 0 = root)
+
+	std::vector<H2Block> far;               // Admissible blocks, sorted by row id
+	std::vector<int> far_ptr;               // far[far_ptr[t]..far_ptr[t+1]) have row id t
+	std::vector<LowRankBlock> near;         // Full blocks of leaf clusters, sorted by row id
+	std::vector<int> near_ptr;              // near[near_ptr[t]..near_ptr[t+1]) have row id t
+	std::vector<int> far_tr, far_tr_ptr;    // far[far_tr[f]], f in [far_tr_ptr[s], far_tr_ptr[s+1]), have column id s
+	std::vector<int> near_tr, near_tr_ptr;  // Same for near blocks (transposed products)
+
+	int ktmax;                              // Maximum basis rank
+
+	H2Matrix();
+	~H2Matrix() = default;
+
+	size_t memory_usage() const;
+	double compression_ratio() const;
+};
+
+/**
+ * Convert a block-cluster tree H-matrix into an H2-matrix
+ * The low-rank blocks are recompressed into nested cluster bases such that
+ * each block keeps relative accuracy of about eps; full blocks are copied.
+ * Throws std::logic_error for a factorised tree.
+ */
+std::unique_ptr<H2Matrix> convert_to_h2matrix(
+	const HMatrixTree& hmat,
+	double eps
+);
+
+/**
+ * Build H2-matrix of a square kernel matrix
+ * (build_hmatrix_tree followed by convert_to_h2matrix with params.eps_aca)
+ */
+std::unique_ptr<H2Matrix> build_h2matrix(
+	const std::vector<Point3D>& points,
+	KernelFunction kernel,
+	void* kernel_data,
+	const ControlParams& params
+);
+
+/**
+ * H2-matrix matrix-vector product: y = H * x, or y = H^T * x if trans (original ordering)
+ */
+void h2matrix_matvec(
+	const H2Matrix& hmat,
+	const std::vector<double>& x,
+	std::vector<double>& y,
+	bool trans = false
+);
+
+// ============================================================================
+// Dense Block Kernels
+// ============================================================================
+
+/**
+ * y += alpha * A * x, or y += alpha * A^T * x if trans (A: m x n, row-major)
+ * Calls the external BLAS (dgemv) when built with HACAPK_USE_BLAS,
+ * otherwise dense_gemv_builtin()
+ */
+void dense_gemv(bool trans, int m, int n, double alpha, const double* A, const double* x, double* y);
+
+/**
+ * C += alpha * op(A) * op(B) with C: m x n, op(A): m x l, op(B): l x n (all row-major)
+ * Calls the external BLAS (dgemm) when built with HACAPK_USE_BLAS,
+ * otherwise dense_gemm_builtin()
+ */
+void dense_gemm(bool transa, bool transb, int m, int n, int l, double alpha, const double* A, const double* B, double* C);
+
+/**
+ * Built-in (OpenMP SIMD vectorised) versions of dense_gemv() / dense_gemm()
+ */
+void dense_gemv_builtin(bool trans, int m, int n, double alpha, const double* A, const double* x, double* y);
+void dense_gemm_builtin(bool transa, bool transb, int m, int n, int l, double alpha, const double* A, const double* B, double* C);
+
+/**
+ * Backend of the dense block kernels: "blas" or "builtin"
+ */
+const char* dense_kernel_backend();
+
+// ============================================================================
+// Dense Factorisations
+// ============================================================================
+
+/**
+ * Thin QR by modified Gram-Schmidt with reorthogonalisation
+ * A (m x k, row-major) = Q (m x kq) * R (kq x k); linearly dependent columns are dropped
+ */
+void qr_mgs(int m, int k, const std::vector<double>& A, std::vector<double>& Q, std::vector<double>& R, int& kq);
+
+/**
+ * One-sided Jacobi SVD of M (p x q, row-major, p >= q): M = W * diag(S) * Z^T
+ * W (p x q), Z (q x q), singular values sorted in decreasing order
+ */
+void svd_jacobi(int p, int q, const std::vector<double>& M, std::vector<double>& W, std::vector<double>& S, std::vector<double>& Z);
+
+// ============================================================================
+// NUMA Placement
+// ============================================================================
+
+/**
+ * Distribute the blocks of a flat H-matrix over nthr threads (0 = all OpenMP threads):
+ * blocks are sorted by row cluster and split into row ranges of about equal storage;
+ * each thread then re-allocates its block factors, so that first touch places them
+ * in the memory of its NUMA node. hmatrix_matvec() uses the same partition, every
+ * thread reads only its own blocks and writes only its own rows.
+ */
+void hmatrix_first_touch(HMatrix& hmat, int nthr = 0);
+
+/**
+ * Bind the OpenMP threads to CPUs (Linux; elsewhere no-op returning 0)
+ * mode: 0 = release to the initial process affinity, 1 = close (fill NUMA nodes one after
+ * another), 2 = spread (round-robin over NUMA nodes)
+ * Thread t of later parallel regions of the same size runs on the same CPU.
+ * Returns the number of bound threads.
+ */
+int bind_threads(int mode);
+
+/**
+ * Number of NUMA nodes with CPUs available to the process (1 if unknown)
+ */
+int numa_node_count();
+
 // ============================================================================
 // Utility Functions
 // ============================================================================
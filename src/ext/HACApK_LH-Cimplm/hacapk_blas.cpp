@@ -0,0 +1,181 @@
+/*
+ * @file hacapk_blas.cpp
+ * @brief Dense block kernels (gemv / gemm) with an optional external BLAS backend
+ *
+ * Part of the HACApK C++ implementation (MIT License, see LICENSE).
+ *
+ * All matrices are row-major as in LowRankBlock. With HACAPK_USE_BLAS
+ * (CMake option of the same name) the kernels call the Fortran BLAS
+ * dgemv/dgemm (OpenBLAS, MKL, reference BLAS) on the column-major view of
+ * the row-major data, i.e. on the transposed matrices. Otherwise the
+ * built-in loops are used; their inner loops are contiguous and marked
+ * for OpenMP SIMD vectorisation.
+ */
+
+#include "hacapk.hpp"
+#include <vector>
+
+#if defined(_OPENMP) && (_OPENMP >= 201307)
+#define HACAPK_PRAGMA(x) _Pragma(#x)
+#define HACAPK_SIMD HACAPK_PRAGMA(omp simd)
+#define HACAPK_SIMD_SUM(...) HACAPK_PRAGMA(omp simd reduction(+:__VA_ARGS__))
+#else
+#define HACAPK_SIMD
+#define HACAPK_SIMD_SUM(...)
+#endif
+
+#ifdef HACAPK_USE_BLAS
+extern "C" {
+void dgemv_(const char* trans, const int* m, const int* n, const double* alpha, const double* a, const int* lda,
+	const double* x, const int* incx, const double* beta, double* y, const int* incy);
+void dgemm_(const char* transa, const char* transb, const int* m, const int* n, const int* k, const double* alpha,
+	const double* a, const int* lda, const double* b, const int* ldb, const double* beta, double* c, const int* ldc);
+}
+#endif
+
+namespace hacapk {
+
+namespace {
+
+/**
+ * Dot product of two contiguous vectors
+ */
+inline double dot_contiguous(int n, const double* a, const double* b)
+{
+	double sum = 0.0;
+	HACAPK_SIMD_SUM(sum)
+	for (int j = 0; j < n; j++) sum += a[j] * b[j];
+	return sum;
+}
+
+/**
+ * y += a * x for contiguous vectors
+ */
+inline void axpy_contiguous(int n, double a, const double* x, double* y)
+{
+	HACAPK_SIMD
+	for (int j = 0; j < n; j++) y[j] += a * x[j];
+}
+
+} // namespace
+
+// ============================================================================
+// Built-in Kernels
+// ============================================================================
+
+void dense_gemv_builtin(bool trans, int m, int n, double alpha, const double* A, const double* x, double* y)
+{
+	// Four rows per sweep share the loads of x (y if trans)
+	int i = 0;
+	if (trans) {
+		for (; i + 4 <= m; i += 4) {
+			const double* a0 = A + static_cast<size_t>(i) * n;
+			const double* a1 = a0 + n;
+			const double* a2 = a1 + n;
+			const double* a3 = a2 + n;
+			double x0 = alpha * x[i], x1 = alpha * x[i + 1], x2 = alpha * x[i + 2], x3 = alpha * x[i + 3];
+			HACAPK_SIMD
+			for (int j = 0; j < n; j++) y[j] += x0 * a0[j] + x1 * a1[j] + x2 * a2[j] + x3 * a3[j];
+		}
+		for (; i < m; i++) {
+			double xi = alpha * x[i];
+			if (xi == 0.0) continue;
+			axpy_contiguous(n, xi, A + static_cast<size_t>(i) * n, y);
+		}
+	} else {
+		for (; i + 4 <= m; i += 4) {
+			const double* a0 = A + static_cast<size_t>(i) * n;
+			const double* a1 = a0 + n;
+			const double* a2 = a1 + n;
+			const double* a3 = a2 + n;
+			double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+			HACAPK_SIMD_SUM(s0, s1, s2, s3)
+			for (int j = 0; j < n; j++) {
+				double xj = x[j];
+				s0 += a0[j] * xj;
+				s1 += a1[j] * xj;
+				s2 += a2[j] * xj;
+				s3 += a3[j] * xj;
+			}
+			y[i] += alpha * s0;
+			y[i + 1] += alpha * s1;
+			y[i + 2] += alpha * s2;
+			y[i + 3] += alpha * s3;
+		}
+		for (; i < m; i++) y[i] += alpha * dot_contiguous(n, A + static_cast<size_t>(i) * n, x);
+	}
+}
+
+void dense_gemm_builtin(bool transa, bool transb, int m, int n, int l, double alpha, const double* A, const double* B, double* C)
+{
+	if (!transb) {
+		// Rows of C accumulate rows of B
+		for (int i = 0; i < m; i++) {
+			double* c = C + static_cast<size_t>(i) * n;
+			for (int p = 0; p < l; p++) {
+				double a = alpha * (transa ? A[static_cast<size_t>(p) * m + i] : A[static_cast<size_t>(i) * l + p]);
+				if (a == 0.0) continue;
+				axpy_contiguous(n, a, B + static_cast<size_t>(p) * n, c);
+			}
+		}
+		return;
+	}
+
+	// Entries of C are dot products of rows of op(A) and rows of B
+	std::vector<double> col;
+	if (transa) col.resize(l);
+	for (int i = 0; i < m; i++) {
+		const double* a = A + static_cast<size_t>(i) * l;
+		if (transa) {
+			for (int p = 0; p < l; p++) col[p] = A[static_cast<size_t>(p) * m + i];
+			a = col.data();
+		}
+		double* c = C + static_cast<size_t>(i) * n;
+		for (int j = 0; j < n; j++) c[j] += alpha * dot_contiguous(l, a, B + static_cast<size_t>(j) * l);
+	}
+}
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+void dense_gemv(bool trans, int m, int n, double alpha, const double* A, const double* x, double* y)
+{
+	if (m <= 0 || n <= 0) return;
+#ifdef HACAPK_USE_BLAS
+	// Row-major A (m x n) is the column-major n x m matrix A^T
+	const char op = trans ? 'N' : 'T';
+	const int inc = 1;
+	const double one = 1.0;
+	dgemv_(&op, &n, &m, &alpha, A, &n, x, &inc, &one, y, &inc);
+#else
+	dense_gemv_builtin(trans, m, n, alpha, A, x, y);
+#endif
+}
+
+void dense_gemm(bool transa, bool transb, int m, int n, int l, double alpha, const double* A, const double* B, double* C)
+{
+	if (m <= 0 || n <= 0 || l <= 0) return;
+#ifdef HACAPK_USE_BLAS
+	// Column-major view: C^T (n x m) += op(B)^T * op(A)^T
+	const char opb = transb ? 'T' : 'N';
+	const char opa = transa ? 'T' : 'N';
+	const int ldb = transb ? l : n;
+	const int lda = transa ? m : l;
+	const double one = 1.0;
+	dgemm_(&opb, &opa, &n, &m, &l, &alpha, B, &ldb, A, &lda, &one, C, &n);
+#else
+	dense_gemm_builtin(transa, transb, m, n, l, alpha, A, B, C);
+#endif
+}
+
+const char* dense_kernel_backend()
+{
+#ifdef HACAPK_USE_BLAS
+	return "blas";
+#else
+	return "builtin";
+#endif
+}
+
+} // namespace hacapk
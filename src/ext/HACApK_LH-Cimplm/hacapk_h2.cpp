@@ -0,0 +1,643 @@
+/*
+ * @file hacapk_h2.cpp
+ * @brief H2-matrices with nested cluster bases
+ *
+ * Part of the HACApK C++ implementation (MIT License, see LICENSE).
+ *
+ * An H2-matrix is obtained by recompressing the low-rank blocks of a
+ * block-cluster tree H-matrix (HMatrixTree). Each admissible block t x s is
+ * stored as V_t * S_ts * W_s^T with row and column cluster bases shared by
+ * all blocks of a cluster. The bases are nested, so only leaf clusters keep
+ * explicit bases; storage and matrix-vector products are O(N k) instead of
+ * O(N k log N).
+ *
+ * Cluster basis construction (same for rows and columns):
+ * - a block U * V^T (V = Q R) contributes U * R^T / ||U V^T||_F to its row
+ *   cluster: its column space weighted by its singular values and scaled so
+ *   that every block is kept to relative accuracy eps
+ * - contributions of ancestors are inherited by the sons (restricted to the
+ *   son rows); they are compressed top-down by truncated SVDs
+ * - leaf bases are the dominant left singular vectors of the compressed
+ *   contributions, the transfer matrices of a father the dominant left
+ *   singular vectors of its contributions projected onto the son bases
+ */
+
+#include "hacapk.hpp"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+namespace hacapk {
+
+namespace {
+
+/**
+ * Truncated QR with column pivoting (modified Gram-Schmidt, reorthogonalised):
+ * A (n x c, row-major) * P ~ Q (n x kq) * R (kq x c), stopped when the
+ * Frobenius norm of the remaining columns drops below tol * ||A||_F.
+ * The columns of R are in the original order of A.
+ */
+void qr_pivoted(int n, int c, const std::vector<double>& A, double tol,
+	std::vector<double>& Q, std::vector<double>& R, int& kq)
+{
+	std::vector<double> W(static_cast<size_t>(c) * n);  // column-major work copy
+	for (int i = 0; i < n; i++)
+		for (int j = 0; j < c; j++) W[static_cast<size_t>(j) * n + i] = A[static_cast<size_t>(i) * c + j];
+
+	std::vector<double> nrm2(c, 0.0);
+	double total = 0.0;
+	for (int j = 0; j < c; j++) {
+		const double* w = &W[static_cast<size_t>(j) * n];
+		for (int i = 0; i < n; i++) nrm2[j] += w[i] * w[i];
+		total += nrm2[j];
+	}
+
+	std::vector<double> Qc;  // column-major n x kq
+	std::vector<double> Rr;  // row-major kq x c
+	kq = 0;
+	int kmax = std::min(n, c);
+	while (kq < kmax) {
+		double rest = 0.0;
+		int jp = 0;
+		for (int j = 0; j < c; j++) {
+			rest += nrm2[j];
+			if (nrm2[j] > nrm2[jp]) jp = j;
+		}
+		if (rest <= tol * tol * total || nrm2[jp] <= 0.0) break;
+
+		// New direction from the pivot column, reorthogonalised against Q
+		std::vector<double> q(W.begin() + static_cast<size_t>(jp) * n, W.begin() + static_cast<size_t>(jp + 1) * n);
+		for (int l = 0; l < kq; l++) {
+			const double* ql = &Qc[static_cast<size_t>(l) * n];
+			double d = 0.0;
+			for (int i = 0; i < n; i++) d += ql[i] * q[i];
+			for (int i = 0; i < n; i++) q[i] -= d * ql[i];
+		}
+		double nq = 0.0;
+		for (int i = 0; i < n; i++) nq += q[i] * q[i];
+		nq = std::sqrt(nq);
+		if (nq <= 1e-14 * std::sqrt(nrm2[jp])) break;
+		for (int i = 0; i < n; i++) q[i] /= nq;
+
+		Rr.resize(static_cast<size_t>(kq + 1) * c);
+		double* rrow = &Rr[static_cast<size_t>(kq) * c];
+		for (int j = 0; j < c; j++) {
+			double* w = &W[static_cast<size_t>(j) * n];
+			double d = 0.0;
+			for (int i = 0; i < n; i++) d += q[i] * w[i];
+			rrow[j] = d;
+			double s = 0.0;
+			for (int i = 0; i < n; i++) { w[i] -= d * q[i]; s += w[i] * w[i];}
+			nrm2[j] = s;
+		}
+		nrm2[jp] = 0.0;
+
+		Qc.insert(Qc.end(), q.begin(), q.end());
+		kq++;
+	}
+
+	Q.resize(static_cast<size_t>(n) * kq);
+	for (int i = 0; i < n; i++)
+		for (int l = 0; l < kq; l++) Q[static_cast<size_t>(i) * kq + l] = Qc[static_cast<size_t>(l) * n + i];
+	R.swap(Rr);
+}
+
+/**
+ * Truncated left singular vectors of A (n x c, row-major):
+ * A * A^T ~ W * diag(S)^2 * W^T, W (n x r), S[i] > eps * S[0]
+ */
+void left_singular(int n, int c, const std::vector<double>& A, double eps,
+	std::vector<double>& W, std::vector<double>& S, int& r)
+{
+	r = 0;
+	W.clear(); S.clear();
+	if (n == 0 || c == 0) return;
+
+	// A ~ Q * R: left singular vectors of A are Q times those of R (kq x c).
+	// The QR is truncated well below eps, so that the SVD only sees the numerical range of A
+	std::vector<double> Q, R;
+	int kq = 0;
+	qr_pivoted(n, c, A, 1e-2 * eps, Q, R, kq);
+	if (kq == 0) return;
+
+	// R^T = Q2 * R2  =>  R = R2^T * Q2^T, so only the small R2^T (kq x k2) is decomposed
+	std::vector<double> Rt(static_cast<size_t>(c) * kq), Q2, R2;
+	for (int a = 0; a < kq; a++)
+		for (int j = 0; j < c; j++) Rt[static_cast<size_t>(j) * kq + a] = R[static_cast<size_t>(a) * c + j];
+	int k2 = 0;
+	qr_mgs(c, kq, Rt, Q2, R2, k2);
+	if (k2 == 0) return;
+	std::vector<double> B(static_cast<size_t>(kq) * k2), Z, Sf, Y;
+	for (int a = 0; a < k2; a++)
+		for (int b = 0; b < kq; b++) B[static_cast<size_t>(b) * k2 + a] = R2[static_cast<size_t>(a) * kq + b];
+	svd_jacobi(kq, k2, B, Z, Sf, Y);  // R2^T = Z * diag(S) * Y^T, Z (kq x k2)
+
+	while (r < k2 && Sf[r] > 0.0 && Sf[r] > eps * Sf[0]) r++;
+	W.assign(static_cast<size_t>(n) * r, 0.0);
+	for (int i = 0; i < n; i++)
+		for (int b = 0; b < kq; b++) {
+			double qib = Q[static_cast<size_t>(i) * kq + b];
+			if (qib == 0.0) continue;
+			for (int a = 0; a < r; a++) W[static_cast<size_t>(i) * r + a] += qib * Z[static_cast<size_t>(b) * k2 + a];
+		}
+	S.assign(Sf.begin(), Sf.begin() + r);
+}
+
+/**
+ * Contribution of one block to a cluster basis (nsize x k, row-major)
+ */
+struct Contribution {
+	int k;
+	std::vector<double> C;
+};
+
+/**
+ * Builds a nested cluster basis from block contributions
+ */
+class BasisBuilder {
+public:
+	BasisBuilder(std::vector<ClusterBasis>& basis, std::vector<std::vector<Contribution>>& contrib, double eps)
+		: basis_(basis), contrib_(contrib), eps_(eps) {}
+
+	/**
+	 * Basis of cluster t; Zin (nsize x rin) are the compressed contributions of the ancestors
+	 */
+	void build(int t, const std::vector<double>& Zin, int rin)
+	{
+		ClusterBasis& cb = basis_[t];
+		int n = cb.nsize;
+
+		int c = rin;
+		for (const Contribution& ct : contrib_[t]) c += ct.k;
+
+		std::vector<double> A(static_cast<size_t>(n) * c);
+		for (int i = 0; i < n; i++) {
+			double* row = &A[static_cast<size_t>(i) * c];
+			int off = 0;
+			for (int a = 0; a < rin; a++) row[off++] = Zin[static_cast<size_t>(i) * rin + a];
+			for (const Contribution& ct : contrib_[t])
+				for (int a = 0; a < ct.k; a++) row[off++] = ct.C[static_cast<size_t>(i) * ct.k + a];
+		}
+		contrib_[t].clear();
+		contrib_[t].shrink_to_fit();
+
+		std::vector<double> W, S;
+		int r = 0;
+		left_singular(n, c, A, eps_, W, S, r);
+		A.clear();
+		A.shrink_to_fit();
+
+		if (cb.is_leaf()) {
+			cb.k = r;
+			cb.V.swap(W);
+			return;
+		}
+
+		// Compressed contributions Z = W * diag(S), handed down to the sons
+		std::vector<double> Z(W);
+		for (int i = 0; i < n; i++)
+			for (int a = 0; a < r; a++) Z[static_cast<size_t>(i) * r + a] *= S[a];
+
+		// Subtrees are independent
+		for (int s : cb.sons) {
+			#pragma omp task default(shared) firstprivate(s) if(n > 512)
+			{
+				const ClusterBasis& sb = basis_[s];
+				std::vector<double> Zs(Z.begin() + static_cast<size_t>(sb.nstrt - cb.nstrt) * r,
+					Z.begin() + static_cast<size_t>(sb.nstrt - cb.nstrt + sb.nsize) * r);
+				build(s, Zs, r);
+			}
+		}
+		#pragma omp taskwait
+
+		// Contributions projected onto the son bases, stacked: P (sum k_s x r)
+		int ksum = 0;
+		for (int s : cb.sons) ksum += basis_[s].k;
+		std::vector<double> P(static_cast<size_t>(ksum) * r);
+		int off = 0;
+		for (int s : cb.sons) {
+			const ClusterBasis& sb = basis_[s];
+			std::vector<double> Ps;
+			project(s, &Z[static_cast<size_t>(sb.nstrt - cb.nstrt) * r], r, Ps);
+			std::copy(Ps.begin(), Ps.end(), P.begin() + static_cast<size_t>(off) * r);
+			off += sb.k;
+		}
+
+		std::vector<double> Wp, Sp;
+		int kt = 0;
+		left_singular(ksum, r, P, eps_, Wp, Sp, kt);
+		cb.k = kt;
+
+		off = 0;
+		for (int s : cb.sons) {
+			ClusterBasis& sb = basis_[s];
+			sb.E.assign(Wp.begin() + static_cast<size_t>(off) * kt, Wp.begin() + static_cast<size_t>(off + sb.k) * kt);
+			off += sb.k;
+		}
+	}
+
+	/**
+	 * Out (k_t x c) = V_t^T * M, M (nsize x c, row-major)
+	 */
+	void project(int t, const double* M, int c, std::vector<double>& Out) const
+	{
+		const ClusterBasis& cb = basis_[t];
+		Out.assign(static_cast<size_t>(cb.k) * c, 0.0);
+		if (cb.k == 0) return;
+
+		if (cb.is_leaf()) {
+			for (int i = 0; i < cb.nsize; i++) {
+				const double* v = &cb.V[static_cast<size_t>(i) * cb.k];
+				const double* m = M + static_cast<size_t>(i) * c;
+				for (int a = 0; a < cb.k; a++) {
+					if (v[a] == 0.0) continue;
+					double* o = &Out[static_cast<size_t>(a) * c];
+					for (int j = 0; j < c; j++) o[j] += v[a] * m[j];
+				}
+			}
+			return;
+		}
+
+		for (int s : cb.sons) {
+			const ClusterBasis& sb = basis_[s];
+			if (sb.k == 0) continue;
+			std::vector<double> Ps;
+			project(s, M + static_cast<size_t>(sb.nstrt - cb.nstrt) * c, c, Ps);
+			// Out += E_s^T * Ps
+			for (int b = 0; b < sb.k; b++) {
+				const double* e = &sb.E[static_cast<size_t>(b) * cb.k];
+				const double* p = &Ps[static_cast<size_t>(b) * c];
+				for (int a = 0; a < cb.k; a++) {
+					double* o = &Out[static_cast<size_t>(a) * c];
+					for (int j = 0; j < c; j++) o[j] += e[a] * p[j];
+				}
+			}
+		}
+	}
+
+private:
+	std::vector<ClusterBasis>& basis_;
+	std::vector<std::vector<Contribution>>& contrib_;
+	double eps_;
+};
+
+/**
+ * Cluster tree in pre-order; ids of index ranges
+ */
+void enumerate_clusters(const Cluster& c, int father, std::vector<ClusterBasis>& basis,
+	std::map<std::pair<int, int>, int>& ids)
+{
+	int id = static_cast<int>(basis.size());
+	basis.emplace_back();
+	basis[id].nstrt = c.nstrt;
+	basis[id].nsize = c.nsize;
+	basis[id].father = father;
+	ids[std::make_pair(c.nstrt, c.nsize)] = id;
+
+	for (const auto& son : c.sons) {
+		int sid = static_cast<int>(basis.size());
+		basis[id].sons.push_back(sid);
+		enumerate_clusters(*son, id, basis, ids);
+	}
+}
+
+void collect_leaves(const HNode& A, std::vector<const HNode*>& lowrank, std::vector<const HNode*>& full)
+{
+	if (A.is_leaf()) {
+		if (A.leaf.is_lowrank()) { if (A.leaf.kt > 0) lowrank.push_back(&A); }
+		else if (A.leaf.is_full()) full.push_back(&A);
+		return;
+	}
+	for (const auto& son : A.sons) collect_leaves(*son, lowrank, full);
+}
+
+/**
+ * Low-rank block factor (m x k) times R^T (k x kq): (m x kq), row-major
+ */
+std::vector<double> times_rt(int m, int k, const std::vector<double>& U, int kq, const std::vector<double>& R)
+{
+	std::vector<double> C(static_cast<size_t>(m) * kq, 0.0);
+	for (int i = 0; i < m; i++)
+		for (int a = 0; a < kq; a++) {
+			double sum = 0.0;
+			for (int r = 0; r < k; r++) sum += U[static_cast<size_t>(i) * k + r] * R[static_cast<size_t>(a) * k + r];
+			C[static_cast<size_t>(i) * kq + a] = sum;
+		}
+	return C;
+}
+
+int basis_id(const std::map<std::pair<int, int>, int>& ids, int nstrt, int nsize)
+{
+	auto it = ids.find(std::make_pair(nstrt, nsize));
+	if (it == ids.end()) throw std::logic_error("hacapk: block does not match the cluster tree");
+	return it->second;
+}
+
+/**
+ * Counting sort of positions by key: idx[ptr[k]..ptr[k+1]) are the positions with key k
+ */
+void group_by_key(const std::vector<int>& key, int nkeys, std::vector<int>& idx, std::vector<int>& ptr)
+{
+	ptr.assign(nkeys + 1, 0);
+	for (int k : key) ptr[k + 1]++;
+	for (int k = 0; k < nkeys; k++) ptr[k + 1] += ptr[k];
+	idx.resize(key.size());
+	std::vector<int> pos(ptr.begin(), ptr.end() - 1);
+	for (size_t b = 0; b < key.size(); b++) idx[pos[key[b]]++] = static_cast<int>(b);
+}
+
+} // namespace
+
+// ============================================================================
+// H2Matrix Implementation
+// ============================================================================
+
+H2Matrix::H2Matrix()
+	: nd(0)
+	, ktmax(0)
+{
+}
+
+size_t H2Matrix::memory_usage() const {
+	size_t mem = 0;
+	for (const auto* basis : { &row_basis, &col_basis })
+		for (const ClusterBasis& cb : *basis) mem += (cb.V.size() + cb.E.size()) * sizeof(double);
+	for (const H2Block& b : far) mem += b.S.size() * sizeof(double);
+	for (const LowRankBlock& b : near) mem += b.memory_usage();
+	return mem;
+}
+
+double H2Matrix::compression_ratio() const {
+	size_t h2_mem = memory_usage();
+	if (nd == 0 || h2_mem == 0) return 0.0;
+
+	size_t full_mem = static_cast<size_t>(nd) * static_cast<size_t>(nd) * sizeof(double);
+	return static_cast<double>(full_mem) / static_cast<double>(h2_mem);
+}
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+std::unique_ptr<H2Matrix> convert_to_h2matrix(
+	const HMatrixTree& hmat,
+	double eps
+) {
+	if (hmat.is_factored) throw std::logic_error("hacapk: H2 conversion of a factorised H-matrix");
+
+	auto h2 = std::make_unique<H2Matrix>();
+	h2->nd = hmat.nd;
+	h2->lod = hmat.lod;
+	if (!hmat.root || !hmat.tree) return h2;
+
+	std::map<std::pair<int, int>, int> ids;
+	enumerate_clusters(*hmat.tree, -1, h2->row_basis, ids);
+	h2->col_basis = h2->row_basis;
+	int nclusters = static_cast<int>(h2->row_basis.size());
+
+	std::vector<const HNode*> lowrank, full;
+	collect_leaves(*hmat.root, lowrank, full);
+	int nlr = static_cast<int>(lowrank.size());
+
+	// Normalised block contributions to the row and column bases
+	std::vector<int> brow(nlr), bcol(nlr);
+	std::vector<Contribution> crow(nlr), ccol(nlr);
+
+	#pragma omp parallel for schedule(dynamic)
+	for (int b = 0; b < nlr; b++) {
+		const LowRankBlock& blk = lowrank[b]->leaf;
+		int m = blk.ndl, n = blk.ndt, k = blk.kt;
+
+		std::vector<double> QU, RU, QV, RV;
+		int ku = 0, kv = 0;
+		qr_mgs(m, k, blk.a1, QU, RU, ku);
+		qr_mgs(n, k, blk.a2, QV, RV, kv);
+
+		// ||U V^T||_F = ||RU * RV^T||_F
+		double nrm2 = 0.0;
+		for (int a = 0; a < ku; a++)
+			for (int c = 0; c < kv; c++) {
+				double sum = 0.0;
+				for (int r = 0; r < k; r++) sum += RU[static_cast<size_t>(a) * k + r] * RV[static_cast<size_t>(c) * k + r];
+				nrm2 += sum * sum;
+			}
+		if (nrm2 == 0.0) { crow[b].k = ccol[b].k = 0; continue; }
+		double inv = 1.0 / std::sqrt(nrm2);
+
+		crow[b].k = kv;
+		crow[b].C = times_rt(m, k, blk.a1, kv, RV);
+		for (double& v : crow[b].C) v *= inv;
+		ccol[b].k = ku;
+		ccol[b].C = times_rt(n, k, blk.a2, ku, RU);
+		for (double& v : ccol[b].C) v *= inv;
+	}
+
+	std::vector<std::vector<Contribution>> row_contrib(nclusters), col_contrib(nclusters);
+	for (int b = 0; b < nlr; b++) {
+		const HNode& A = *lowrank[b];
+		brow[b] = basis_id(ids, A.nstrtl, A.ndl);
+		bcol[b] = basis_id(ids, A.nstrtt, A.ndt);
+		if (crow[b].k == 0) continue;
+		row_contrib[brow[b]].push_back(std::move(crow[b]));
+		col_contrib[bcol[b]].push_back(std::move(ccol[b]));
+	}
+
+	BasisBuilder row_builder(h2->row_basis, row_contrib, eps);
+	BasisBuilder col_builder(h2->col_basis, col_contrib, eps);
+	#pragma omp parallel
+	#pragma omp single
+	{
+		#pragma omp task
+		row_builder.build(0, std::vector<double>(), 0);
+		#pragma omp task
+		col_builder.build(0, std::vector<double>(), 0);
+	}
+
+	for (const auto* basis : { &h2->row_basis, &h2->col_basis })
+		for (const ClusterBasis& cb : *basis) h2->ktmax = std::max(h2->ktmax, cb.k);
+
+	// Coupling matrices S = (V_t^T U) * (W_s^T V)^T
+	std::vector<H2Block> far(nlr);
+	std::vector<char> keep(nlr, 0);
+
+	#pragma omp parallel for schedule(dynamic)
+	for (int b = 0; b < nlr; b++) {
+		const LowRankBlock& blk = lowrank[b]->leaf;
+		int kt = h2->row_basis[brow[b]].k, ks = h2->col_basis[bcol[b]].k, k = blk.kt;
+		if (kt == 0 || ks == 0) continue;
+
+		std::vector<double> PU, PV;
+		row_builder.project(brow[b], blk.a1.data(), k, PU);
+		col_builder.project(bcol[b], blk.a2.data(), k, PV);
+
+		H2Block& fb = far[b];
+		fb.row = brow[b];
+		fb.col = bcol[b];
+		fb.S.assign(static_cast<size_t>(kt) * ks, 0.0);
+		for (int a = 0; a < kt; a++)
+			for (int c = 0; c < ks; c++) {
+				double sum = 0.0;
+				for (int r = 0; r < k; r++) sum += PU[static_cast<size_t>(a) * k + r] * PV[static_cast<size_t>(c) * k + r];
+				fb.S[static_cast<size_t>(a) * ks + c] = sum;
+			}
+		keep[b] = 1;
+	}
+
+	for (int b = 0; b < nlr; b++)
+		if (keep[b]) h2->far.push_back(std::move(far[b]));
+	std::stable_sort(h2->far.begin(), h2->far.end(), [](const H2Block& a, const H2Block& b) { return a.row < b.row; });
+
+	std::vector<int> nrow(full.size());
+	for (size_t b = 0; b < full.size(); b++) nrow[b] = basis_id(ids, full[b]->nstrtl, full[b]->ndl);
+	std::vector<size_t> order(full.size());
+	for (size_t b = 0; b < full.size(); b++) order[b] = b;
+	std::stable_sort(order.begin(), order.end(), [&nrow](size_t a, size_t b) { return nrow[a] < nrow[b]; });
+	h2->near.reserve(full.size());
+	for (size_t b : order) h2->near.push_back(full[b]->leaf);
+
+	h2->far_ptr.assign(nclusters + 1, 0);
+	h2->near_ptr.assign(nclusters + 1, 0);
+	for (const H2Block& b : h2->far) h2->far_ptr[b.row + 1]++;
+	for (size_t b = 0; b < full.size(); b++) h2->near_ptr[nrow[b] + 1]++;
+	for (int t = 0; t < nclusters; t++) {
+		h2->far_ptr[t + 1] += h2->far_ptr[t];
+		h2->near_ptr[t + 1] += h2->near_ptr[t];
+	}
+
+	// Blocks grouped by column id for transposed products
+	std::vector<int> far_col(h2->far.size()), near_col(h2->near.size());
+	for (size_t b = 0; b < h2->far.size(); b++) far_col[b] = h2->far[b].col;
+	for (size_t b = 0; b < h2->near.size(); b++) near_col[b] = basis_id(ids, h2->near[b].nstrtt, h2->near[b].ndt);
+	group_by_key(far_col, nclusters, h2->far_tr, h2->far_tr_ptr);
+	group_by_key(near_col, nclusters, h2->near_tr, h2->near_tr_ptr);
+
+	return h2;
+}
+
+std::unique_ptr<H2Matrix> build_h2matrix(
+	const std::vector<Point3D>& points,
+	KernelFunction kernel,
+	void* kernel_data,
+	const ControlParams& params
+) {
+	auto hmat = build_hmatrix_tree(points, kernel, kernel_data, params);
+	return convert_to_h2matrix(*hmat, params.eps_aca);
+}
+
+// ============================================================================
+// Matrix-Vector Multiplication
+// ============================================================================
+
+namespace {
+
+/**
+ * Forward transformation xhat_s = W_s^T x|s, sons before fathers
+ */
+void forward_transform(const std::vector<ClusterBasis>& basis, const std::vector<double>& xp, std::vector<std::vector<double>>& xhat)
+{
+	int nb = static_cast<int>(basis.size());
+	xhat.assign(nb, std::vector<double>());
+	for (int s = nb - 1; s >= 0; s--) {
+		const ClusterBasis& cb = basis[s];
+		std::vector<double>& xs = xhat[s];
+		xs.assign(cb.k, 0.0);
+		if (cb.k == 0) continue;
+		if (cb.is_leaf()) {
+			dense_gemv(true, cb.nsize, cb.k, 1.0, cb.V.data(), xp.data() + cb.nstrt, xs.data());
+		} else {
+			for (int son : cb.sons) {
+				const ClusterBasis& sb = basis[son];
+				dense_gemv(true, sb.k, cb.k, 1.0, sb.E.data(), xhat[son].data(), xs.data());
+			}
+		}
+	}
+}
+
+/**
+ * Backward transformation y|t += V_t yhat_t, fathers before sons (yhat is overwritten)
+ */
+void backward_transform(const std::vector<ClusterBasis>& basis, std::vector<std::vector<double>>& yhat, std::vector<double>& yp)
+{
+	int nb = static_cast<int>(basis.size());
+	for (int t = 0; t < nb; t++) {
+		const ClusterBasis& cb = basis[t];
+		if (cb.k == 0) continue;
+		const std::vector<double>& yt = yhat[t];
+		if (cb.is_leaf()) {
+			dense_gemv(false, cb.nsize, cb.k, 1.0, cb.V.data(), yt.data(), yp.data() + cb.nstrt);
+		} else {
+			for (int son : cb.sons) {
+				const ClusterBasis& sb = basis[son];
+				dense_gemv(false, sb.k, cb.k, 1.0, sb.E.data(), yt.data(), yhat[son].data());
+			}
+		}
+	}
+}
+
+} // namespace
+
+void h2matrix_matvec(
+	const H2Matrix& hmat,
+	const std::vector<double>& x,
+	std::vector<double>& y,
+	bool trans
+) {
+	int nd = hmat.nd;
+	y.assign(nd, 0.0);
+	if (hmat.row_basis.empty()) return;
+
+	// H^T = sum W_s S^T V_t^T + near^T: the bases swap roles
+	const std::vector<ClusterBasis>& in_basis = trans ? hmat.row_basis : hmat.col_basis;
+	const std::vector<ClusterBasis>& out_basis = trans ? hmat.col_basis : hmat.row_basis;
+	int nout = static_cast<int>(out_basis.size());
+
+	std::vector<double> xp(nd), yp(nd, 0.0);
+	for (int k = 0; k < nd; k++) xp[k] = x[hmat.lod[k]];
+
+	std::vector<std::vector<double>> xhat;
+	forward_transform(in_basis, xp, xhat);
+
+	// Coupling yhat_t = sum_s S_ts xhat_s (transposed: yhat_s = sum_t S_ts^T xhat_t)
+	std::vector<std::vector<double>> yhat(nout);
+	#pragma omp parallel for schedule(dynamic)
+	for (int t = 0; t < nout; t++) {
+		int kt = out_basis[t].k;
+		std::vector<double>& yt = yhat[t];
+		yt.assign(kt, 0.0);
+		if (!trans) {
+			for (int f = hmat.far_ptr[t]; f < hmat.far_ptr[t + 1]; f++) {
+				const H2Block& b = hmat.far[f];
+				const std::vector<double>& xs = xhat[b.col];
+				dense_gemv(false, kt, static_cast<int>(xs.size()), 1.0, b.S.data(), xs.data(), yt.data());
+			}
+		} else {
+			for (int f = hmat.far_tr_ptr[t]; f < hmat.far_tr_ptr[t + 1]; f++) {
+				const H2Block& b = hmat.far[hmat.far_tr[f]];
+				const std::vector<double>& xs = xhat[b.row];
+				dense_gemv(true, static_cast<int>(xs.size()), kt, 1.0, b.S.data(), xs.data(), yt.data());
+			}
+		}
+	}
+
+	backward_transform(out_basis, yhat, yp);
+
+	// Near field: full blocks, row (column) clusters are disjoint leaves
+	#pragma omp parallel for schedule(dynamic)
+	for (int t = 0; t < nout; t++) {
+		if (!trans) {
+			for (int f = hmat.near_ptr[t]; f < hmat.near_ptr[t + 1]; f++) {
+				const LowRankBlock& b = hmat.near[f];
+				block_gemv(b, false, 1.0, xp.data() + b.nstrtt, yp.data() + b.nstrtl);
+			}
+		} else {
+			for (int f = hmat.near_tr_ptr[t]; f < hmat.near_tr_ptr[t + 1]; f++) {
+				const LowRankBlock& b = hmat.near[hmat.near_tr[f]];
+				block_gemv(b, true, 1.0, xp.data() + b.nstrtl, yp.data() + b.nstrtt);
+			}
+		}
+	}
+
+	for (int k = 0; k < nd; k++) y[hmat.lod[k]] = yp[k];
+}
+
+} // namespace hacapk
@@ -0,0 +1,1034 @@
+/*
+ * @file hacapk_harith.cpp
+ * @brief Block-cluster tree H-matrices, H-arithmetic and H-LU factorisation
+ *
+ * Part of the HACApK C++ implementation (MIT License, see LICENSE).
+ *
+ * Storage conventions follow LowRankBlock:
+ * - low-rank block (ltmtx=1): M = U * V^T, U = a1[i*kt + r], V = a2[j*kt + r]
+ * - full block (ltmtx=2):     M[i][j] = a1[i*ndt + j]
+ *
+ * Low-rank sums and products are recompressed by QR of both factors
+ * followed by an SVD of the small core matrix; singular values below
+ * eps * (largest singular value) are dropped and the rank is capped by kmax.
+ */
+
+#include "hacapk.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace hacapk {
+
+// ============================================================================
+// Dense Factorisations
+// ============================================================================
+
+void qr_mgs(int m, int k, const std::vector<double>& A, std::vector<double>& Q, std::vector<double>& R, int& kq)
+{
+	std::vector<double> W(static_cast<size_t>(m) * k);  // column-major work copy
+	for (int i = 0; i < m; i++)
+		for (int c = 0; c < k; c++) W[static_cast<size_t>(c) * m + i] = A[static_cast<size_t>(i) * k + c];
+
+	std::vector<double> Qc;  // column-major m x kq
+	Qc.reserve(static_cast<size_t>(m) * std::min(m, k));
+	R.assign(static_cast<size_t>(k) * k, 0.0);
+	kq = 0;
+
+	for (int c = 0; c < k; c++) {
+		double* w = &W[static_cast<size_t>(c) * m];
+		double nrm0 = 0.0;
+		for (int i = 0; i < m; i++) nrm0 += w[i] * w[i];
+		nrm0 = std::sqrt(nrm0);
+		if (nrm0 == 0.0) continue;
+
+		for (int pass = 0; pass < 2; pass++) {
+			for (int q = 0; q < kq; q++) {
+				const double* qv = &Qc[static_cast<size_t>(q) * m];
+				double d = 0.0;
+				for (int i = 0; i < m; i++) d += qv[i] * w[i];
+				R[static_cast<size_t>(q) * k + c] += d;
+				for (int i = 0; i < m; i++) w[i] -= d * qv[i];
+			}
+		}
+
+		double nrm = 0.0;
+		for (int i = 0; i < m; i++) nrm += w[i] * w[i];
+		nrm = std::sqrt(nrm);
+		if (nrm <= 1e-14 * nrm0 || kq >= m) continue;
+
+		for (int i = 0; i < m; i++) Qc.push_back(w[i] / nrm);
+		R[static_cast<size_t>(kq) * k + c] = nrm;
+		kq++;
+	}
+
+	Q.resize(static_cast<size_t>(m) * kq);
+	for (int i = 0; i < m; i++)
+		for (int q = 0; q < kq; q++) Q[static_cast<size_t>(i) * kq + q] = Qc[static_cast<size_t>(q) * m + i];
+	R.resize(static_cast<size_t>(kq) * k);
+}
+
+void svd_jacobi(int p, int q, const std::vector<double>& M, std::vector<double>& W, std::vector<double>& S, std::vector<double>& Z)
+{
+	std::vector<double> A(static_cast<size_t>(p) * q);  // column-major
+	for (int i = 0; i < p; i++)
+		for (int j = 0; j < q; j++) A[static_cast<size_t>(j) * p + i] = M[static_cast<size_t>(i) * q + j];
+	std::vector<double> Zc(static_cast<size_t>(q) * q, 0.0);  // column-major
+	for (int j = 0; j < q; j++) Zc[static_cast<size_t>(j) * q + j] = 1.0;
+
+	for (int sweep = 0; sweep < 60; sweep++) {
+		bool rotated = false;
+		for (int i = 0; i < q - 1; i++) {
+			double* ai = &A[static_cast<size_t>(i) * p];
+			double* zi = &Zc[static_cast<size_t>(i) * q];
+			for (int j = i + 1; j < q; j++) {
+				double* aj = &A[static_cast<size_t>(j) * p];
+				double* zj = &Zc[static_cast<size_t>(j) * q];
+
+				double alpha = 0.0, beta = 0.0, gamma = 0.0;
+				for (int l = 0; l < p; l++) {
+					alpha += ai[l] * ai[l];
+					beta += aj[l] * aj[l];
+					gamma += ai[l] * aj[l];
+				}
+				if (std::abs(gamma) <= 1e-15 * std::sqrt(alpha * beta)) continue;
+				rotated = true;
+
+				double zeta = (beta - alpha) / (2.0 * gamma);
+				double t = ((zeta >= 0.0) ? 1.0 : -1.0) / (std::abs(zeta) + std::sqrt(1.0 + zeta * zeta));
+				double c = 1.0 / std::sqrt(1.0 + t * t);
+				double s = c * t;
+
+				for (int l = 0; l < p; l++) {
+					double x = ai[l], y = aj[l];
+					ai[l] = c * x - s * y;
+					aj[l] = s * x + c * y;
+				}
+				for (int l = 0; l < q; l++) {
+					double x = zi[l], y = zj[l];
+					zi[l] = c * x - s * y;
+					zj[l] = s * x + c * y;
+				}
+			}
+		}
+		if (!rotated) break;
+	}
+
+	std::vector<double> sv(q);
+	for (int j = 0; j < q; j++) {
+		double nrm = 0.0;
+		for (int l = 0; l < p; l++) nrm += A[static_cast<size_t>(j) * p + l] * A[static_cast<size_t>(j) * p + l];
+		sv[j] = std::sqrt(nrm);
+	}
+	std::vector<int> order(q);
+	for (int j = 0; j < q; j++) order[j] = j;
+	std::sort(order.begin(), order.end(), [&sv](int a, int b) { return sv[a] > sv[b]; });
+
+	W.assign(static_cast<size_t>(p) * q, 0.0);
+	Z.resize(static_cast<size_t>(q) * q);
+	S.resize(q);
+	for (int r = 0; r < q; r++) {
+		int j = order[r];
+		S[r] = sv[j];
+		double inv = (sv[j] > 0.0) ? 1.0 / sv[j] : 0.0;
+		for (int l = 0; l < p; l++) W[static_cast<size_t>(l) * q + r] = A[static_cast<size_t>(j) * p + l] * inv;
+		for (int l = 0; l < q; l++) Z[static_cast<size_t>(l) * q + r] = Zc[static_cast<size_t>(j) * q + l];
+	}
+}
+
+// ============================================================================
+// Low-Rank Factor Helpers
+// ============================================================================
+
+namespace {
+
+/**
+ * Low-rank factorisation M = U * V^T, U (m x k), V (n x k), row-major
+ */
+struct LRFactor {
+	int m, n, k;
+	std::vector<double> U, V;
+
+	LRFactor(int m_ = 0, int n_ = 0) : m(m_), n(n_), k(0) {}
+};
+
+/**
+ * Recompress F to relative accuracy eps and rank <= kmax
+ */
+void lr_truncate(LRFactor& F, double eps, int kmax)
+{
+	if (F.k == 0) return;
+
+	std::vector<double> QU, RU, QV, RV;
+	int ku = 0, kv = 0;
+	qr_mgs(F.m, F.k, F.U, QU, RU, ku);
+	qr_mgs(F.n, F.k, F.V, QV, RV, kv);
+	if (ku == 0 || kv == 0) {
+		F.k = 0; F.U.clear(); F.V.clear();
+		return;
+	}
+
+	// Core matrix C = RU * RV^T (ku x kv)
+	std::vector<double> C(static_cast<size_t>(ku) * kv, 0.0);
+	for (int a = 0; a < ku; a++)
+		for (int b = 0; b < kv; b++) {
+			double sum = 0.0;
+			for (int r = 0; r < F.k; r++) sum += RU[static_cast<size_t>(a) * F.k + r] * RV[static_cast<size_t>(b) * F.k + r];
+			C[static_cast<size_t>(a) * kv + b] = sum;
+		}
+
+	// C = W * diag(S) * Z^T, W (ku x q), Z (kv x q), q = min(ku, kv)
+	std::vector<double> W, S, Z;
+	int q = std::min(ku, kv);
+	if (ku >= kv) {
+		svd_jacobi(ku, kv, C, W, S, Z);
+	} else {
+		std::vector<double> Ct(static_cast<size_t>(kv) * ku);
+		for (int a = 0; a < ku; a++)
+			for (int b = 0; b < kv; b++) Ct[static_cast<size_t>(b) * ku + a] = C[static_cast<size_t>(a) * kv + b];
+		svd_jacobi(kv, ku, Ct, Z, S, W);
+	}
+
+	int r = 0;
+	while (r < q && S[r] > 0.0 && S[r] > eps * S[0]) r++;
+	if (kmax > 0 && r > kmax) r = kmax;
+
+	std::vector<double> U(static_cast<size_t>(F.m) * r, 0.0), V(static_cast<size_t>(F.n) * r, 0.0);
+	for (int i = 0; i < F.m; i++)
+		for (int c = 0; c < r; c++) {
+			double sum = 0.0;
+			for (int a = 0; a < ku; a++) sum += QU[static_cast<size_t>(i) * ku + a] * W[static_cast<size_t>(a) * q + c];
+			U[static_cast<size_t>(i) * r + c] = sum * S[c];
+		}
+	for (int j = 0; j < F.n; j++)
+		for (int c = 0; c < r; c++) {
+			double sum = 0.0;
+			for (int b = 0; b < kv; b++) sum += QV[static_cast<size_t>(j) * kv + b] * Z[static_cast<size_t>(b) * q + c];
+			V[static_cast<size_t>(j) * r + c] = sum;
+		}
+	F.k = r;
+	F.U.swap(U);
+	F.V.swap(V);
+}
+
+/**
+ * F += G (no recompression)
+ */
+void lr_append(LRFactor& F, const LRFactor& G)
+{
+	if (G.k == 0) return;
+	int k = F.k + G.k;
+	std::vector<double> U(static_cast<size_t>(F.m) * k), V(static_cast<size_t>(F.n) * k);
+	for (int i = 0; i < F.m; i++) {
+		std::copy(F.U.begin() + static_cast<size_t>(i) * F.k, F.U.begin() + static_cast<size_t>(i + 1) * F.k, U.begin() + static_cast<size_t>(i) * k);
+		std::copy(G.U.begin() + static_cast<size_t>(i) * G.k, G.U.begin() + static_cast<size_t>(i + 1) * G.k, U.begin() + static_cast<size_t>(i) * k + F.k);
+	}
+	for (int j = 0; j < F.n; j++) {
+		std::copy(F.V.begin() + static_cast<size_t>(j) * F.k, F.V.begin() + static_cast<size_t>(j + 1) * F.k, V.begin() + static_cast<size_t>(j) * k);
+		std::copy(G.V.begin() + static_cast<size_t>(j) * G.k, G.V.begin() + static_cast<size_t>(j + 1) * G.k, V.begin() + static_cast<size_t>(j) * k + F.k);
+	}
+	F.k = k;
+	F.U.swap(U);
+	F.V.swap(V);
+}
+
+/**
+ * Zero-padded embedding of F (F.m x F.n) at (r0, c0) into an m x n factor
+ */
+LRFactor lr_embed(const LRFactor& F, int m, int n, int r0, int c0)
+{
+	LRFactor E(m, n);
+	E.k = F.k;
+	E.U.assign(static_cast<size_t>(m) * F.k, 0.0);
+	E.V.assign(static_cast<size_t>(n) * F.k, 0.0);
+	std::copy(F.U.begin(), F.U.end(), E.U.begin() + static_cast<size_t>(r0) * F.k);
+	std::copy(F.V.begin(), F.V.end(), E.V.begin() + static_cast<size_t>(c0) * F.k);
+	return E;
+}
+
+/**
+ * Rows [r0, r0+m) and columns [c0, c0+n) of F
+ */
+LRFactor lr_restrict(const LRFactor& F, int r0, int m, int c0, int n)
+{
+	LRFactor R(m, n);
+	R.k = F.k;
+	R.U.assign(F.U.begin() + static_cast<size_t>(r0) * F.k, F.U.begin() + static_cast<size_t>(r0 + m) * F.k);
+	R.V.assign(F.V.begin() + static_cast<size_t>(c0) * F.k, F.V.begin() + static_cast<size_t>(c0 + n) * F.k);
+	return R;
+}
+
+/**
+ * Truncated low-rank factorisation of a dense row-major m x n matrix
+ */
+LRFactor lr_from_dense(int m, int n, const std::vector<double>& D, double eps, int kmax)
+{
+	LRFactor F(m, n);
+	if (n <= m) {
+		F.k = n;
+		F.U = D;
+		F.V.assign(static_cast<size_t>(n) * n, 0.0);
+		for (int j = 0; j < n; j++) F.V[static_cast<size_t>(j) * n + j] = 1.0;
+	} else {
+		F.k = m;
+		F.U.assign(static_cast<size_t>(m) * m, 0.0);
+		for (int i = 0; i < m; i++) F.U[static_cast<size_t>(i) * m + i] = 1.0;
+		F.V.resize(static_cast<size_t>(n) * m);
+		for (int i = 0; i < m; i++)
+			for (int j = 0; j < n; j++) F.V[static_cast<size_t>(j) * m + i] = D[static_cast<size_t>(i) * n + j];
+	}
+	lr_truncate(F, eps, kmax);
+	return F;
+}
+
+LRFactor lr_from_leaf(const LowRankBlock& b)
+{
+	LRFactor F(b.ndl, b.ndt);
+	F.k = b.kt;
+	F.U = b.a1;
+	F.V = b.a2;
+	return F;
+}
+
+void lr_to_leaf(LRFactor& F, LowRankBlock& b)
+{
+	b.ltmtx = 1;
+	b.kt = F.k;
+	b.a1.swap(F.U);
+	b.a2.swap(F.V);
+}
+
+/**
+ * Add U * V^T to a dense row-major m x n block
+ */
+void lr_add_to_dense(const LRFactor& F, double* D)
+{
+	dense_gemm(false, true, F.m, F.n, F.k, 1.0, F.U.data(), F.V.data(), D);
+}
+
+bool is_lowrank_leaf(const HNode& A) { return A.is_leaf() && A.leaf.is_lowrank(); }
+
+/**
+ * Son of A in grid position (i, j); a leaf acts as its own single son
+ */
+const HNode& grid_son(const HNode& A, int i, int j) { return A.is_leaf() ? A : A.son(i, j); }
+int grid_rows(const HNode& A) { return A.is_leaf() ? 1 : A.nsonl; }
+int grid_cols(const HNode& A) { return A.is_leaf() ? 1 : A.nsont; }
+
+/**
+ * C += F, F of the size of C
+ */
+void add_lowrank(HNode& C, const LRFactor& F, double eps, int kmax)
+{
+	if (F.k == 0) return;
+
+	if (C.is_leaf()) {
+		if (C.leaf.is_full()) {
+			lr_add_to_dense(F, C.leaf.a1.data());
+		} else {
+			LRFactor G = lr_from_leaf(C.leaf);
+			lr_append(G, F);
+			lr_truncate(G, eps, kmax);
+			lr_to_leaf(G, C.leaf);
+		}
+		return;
+	}
+
+	for (int i = 0; i < C.nsonl; i++)
+		for (int j = 0; j < C.nsont; j++) {
+			HNode& S = C.son(i, j);
+			add_lowrank(S, lr_restrict(F, S.nstrtl - C.nstrtl, S.ndl, S.nstrtt - C.nstrtt, S.ndt), eps, kmax);
+		}
+}
+
+/**
+ * Truncated low-rank approximation of a block
+ */
+LRFactor to_lowrank(const HNode& A, double eps, int kmax)
+{
+	if (A.is_leaf()) {
+		if (A.leaf.is_lowrank()) return lr_from_leaf(A.leaf);
+		return lr_from_dense(A.ndl, A.ndt, A.leaf.a1, eps, kmax);
+	}
+
+	LRFactor F(A.ndl, A.ndt);
+	for (int i = 0; i < A.nsonl; i++)
+		for (int j = 0; j < A.nsont; j++) {
+			const HNode& S = A.son(i, j);
+			lr_append(F, lr_embed(to_lowrank(S, eps, kmax), A.ndl, A.ndt, S.nstrtl - A.nstrtl, S.nstrtt - A.nstrtt));
+		}
+	lr_truncate(F, eps, kmax);
+	return F;
+}
+
+/**
+ * Low-rank approximation of alpha * A * B
+ */
+LRFactor product_lowrank(double alpha, const HNode& A, const HNode& B, double eps, int kmax)
+{
+	LRFactor F(A.ndl, B.ndt);
+
+	if (is_lowrank_leaf(A)) {
+		// U_A * (B^T V_A)^T
+		int k = A.leaf.kt;
+		F.k = k;
+		F.U = A.leaf.a1;
+		for (double& u : F.U) u *= alpha;
+		F.V.assign(static_cast<size_t>(B.ndt) * k, 0.0);
+		std::vector<double> v(B.ndl), w(B.ndt);
+		for (int r = 0; r < k; r++) {
+			for (int j = 0; j < B.ndl; j++) v[j] = A.leaf.a2[static_cast<size_t>(j) * k + r];
+			std::fill(w.begin(), w.end(), 0.0);
+			hnode_gemv(B, true, 1.0, v.data(), w.data());
+			for (int j = 0; j < B.ndt; j++) F.V[static_cast<size_t>(j) * k + r] = w[j];
+		}
+		return F;
+	}
+
+	if (is_lowrank_leaf(B)) {
+		// (A U_B) * V_B^T
+		int k = B.leaf.kt;
+		F.k = k;
+		F.V = B.leaf.a2;
+		F.U.assign(static_cast<size_t>(A.ndl) * k, 0.0);
+		std::vector<double> v(A.ndt), w(A.ndl);
+		for (int r = 0; r < k; r++) {
+			for (int j = 0; j < A.ndt; j++) v[j] = B.leaf.a1[static_cast<size_t>(j) * k + r];
+			std::fill(w.begin(), w.end(), 0.0);
+			hnode_gemv(A, false, alpha, v.data(), w.data());
+			for (int i = 0; i < A.ndl; i++) F.U[static_cast<size_t>(i) * k + r] = w[i];
+		}
+		return F;
+	}
+
+	if (A.is_leaf() && B.is_leaf()) {
+		// Both full
+		std::vector<double> D(static_cast<size_t>(A.ndl) * B.ndt, 0.0);
+		dense_gemm(false, false, A.ndl, B.ndt, A.ndt, alpha, A.leaf.a1.data(), B.leaf.a1.data(), D.data());
+		return lr_from_dense(A.ndl, B.ndt, D, eps, kmax);
+	}
+
+	int p = grid_rows(A), q = grid_cols(B), s = grid_cols(A);
+	if (grid_rows(B) != s) throw std::logic_error("hacapk: incompatible block structures in H-matrix product");
+	for (int i = 0; i < p; i++)
+		for (int j = 0; j < q; j++) {
+			const HNode& Ai0 = grid_son(A, i, 0);
+			const HNode& B0j = grid_son(B, 0, j);
+			LRFactor Fij(Ai0.ndl, B0j.ndt);
+			for (int l = 0; l < s; l++) {
+				lr_append(Fij, product_lowrank(alpha, grid_son(A, i, l), grid_son(B, l, j), eps, kmax));
+				lr_truncate(Fij, eps, kmax);
+			}
+			lr_append(F, lr_embed(Fij, A.ndl, B.ndt, Ai0.nstrtl - A.nstrtl, B0j.nstrtt - B.nstrtt));
+		}
+	lr_truncate(F, eps, kmax);
+	return F;
+}
+
+/**
+ * Partially pivoted ACA of a kernel block; returns U * V^T with
+ * ||u_k|| ||v_k|| <= eps ||S_k||_F on exit (or rank kmax)
+ */
+LRFactor aca_partial_pivot(
+	int m, int n, const std::function<double(int, int)>& entry, double eps, int kmax
+) {
+	LRFactor F(m, n);
+	int kcap = std::min(m, n);
+	if (kmax > 0) kcap = std::min(kcap, kmax);
+
+	std::vector<std::vector<double>> us, vs;
+	std::vector<char> used_rows(m, 0);
+	std::vector<double> row(n), col(m);
+	double norm2 = 0.0;
+	int i_piv = 0;
+
+	while (static_cast<int>(us.size()) < kcap) {
+		// Residual row
+		for (int j = 0; j < n; j++) {
+			double val = entry(i_piv, j);
+			for (size_t r = 0; r < us.size(); r++) val -= us[r][i_piv] * vs[r][j];
+			row[j] = val;
+		}
+		used_rows[i_piv] = 1;
+
+		int j_piv = 0;
+		for (int j = 1; j < n; j++)
+			if (std::abs(row[j]) > std::abs(row[j_piv])) j_piv = j;
+
+		if (row[j_piv] == 0.0) {
+			// Zero residual row: try the next unused row
+			int next = -1;
+			for (int i = 0; i < m; i++)
+				if (!used_rows[i]) { next = i; break; }
+			if (next < 0) break;
+			i_piv = next;
+			continue;
+		}
+
+		double inv_piv = 1.0 / row[j_piv];
+		for (int i = 0; i < m; i++) {
+			double val = entry(i, j_piv);
+			for (size_t r = 0; r < us.size(); r++) val -= us[r][i] * vs[r][j_piv];
+			col[i] = val;
+		}
+		for (int j = 0; j < n; j++) row[j] *= inv_piv;
+
+		double nu = 0.0, nv = 0.0;
+		for (int i = 0; i < m; i++) nu += col[i] * col[i];
+		for (int j = 0; j < n; j++) nv += row[j] * row[j];
+
+		double cross = 0.0;
+		for (size_t r = 0; r < us.size(); r++) {
+			double du = 0.0, dv = 0.0;
+			for (int i = 0; i < m; i++) du += us[r][i] * col[i];
+			for (int j = 0; j < n; j++) dv += vs[r][j] * row[j];
+			cross += du * dv;
+		}
+		norm2 += nu * nv + 2.0 * cross;
+
+		us.push_back(col);
+		vs.push_back(row);
+
+		if (nu * nv <= eps * eps * norm2) {
+			// Confirm on a few unused rows: the residual may vanish in the pivot
+			// columns only, e.g. for kernels with zero rows or columns
+			int miss = -1;
+			for (int smp = 1; smp <= 4 && miss < 0; smp++) {
+				int i = (smp * m) / 5;
+				while (i < m && used_rows[i]) i++;
+				if (i >= m) continue;
+				double r2 = 0.0;
+				for (int j = 0; j < n; j++) {
+					double val = entry(i, j);
+					for (size_t r = 0; r < us.size(); r++) val -= us[r][i] * vs[r][j];
+					r2 += val * val;
+				}
+				if (r2 * m > eps * eps * norm2) miss = i;
+				else used_rows[i] = 1;
+			}
+			if (miss < 0) break;
+			i_piv = miss;
+			continue;
+		}
+
+		// Next pivot row: largest entry of the new column among unused rows
+		int next = -1;
+		double best = -1.0;
+		for (int i = 0; i < m; i++)
+			if (!used_rows[i] && std::abs(col[i]) > best) { best = std::abs(col[i]); next = i; }
+		if (next < 0) break;
+		i_piv = next;
+	}
+
+	F.k = static_cast<int>(us.size());
+	F.U.resize(static_cast<size_t>(m) * F.k);
+	F.V.resize(static_cast<size_t>(n) * F.k);
+	for (int r = 0; r < F.k; r++) {
+		for (int i = 0; i < m; i++) F.U[static_cast<size_t>(i) * F.k + r] = us[r][i];
+		for (int j = 0; j < n; j++) F.V[static_cast<size_t>(j) * F.k + r] = vs[r][j];
+	}
+	return F;
+}
+
+/**
+ * Build the block-cluster tree below (t, s); leaves are collected for filling
+ * (leaf_pair: both clusters are leaves, so the block may be stored as full)
+ */
+std::unique_ptr<HNode> build_block_node(
+	const Cluster& t, const Cluster& s, const ControlParams& params,
+	std::vector<HNode*>& leaves, std::vector<char>& leaf_pair
+) {
+	auto node = std::make_unique<HNode>();
+	node->nstrtl = t.nstrt; node->ndl = t.nsize;
+	node->nstrtt = s.nstrt; node->ndt = s.nsize;
+
+	// Diagonal blocks must stay inadmissible for H-LU, also for clusters of coincident points
+	bool admissible = (&t != &s) && (bbox_distance(t.bbox, s.bbox) > 0.0)
+		&& is_admissible(t.bbox, s.bbox, params);
+
+	if (admissible || (t.is_leaf() && s.is_leaf())) {
+		node->leaf.ltmtx = admissible ? 1 : 2;
+		node->leaf.nstrtl = node->nstrtl; node->leaf.ndl = node->ndl;
+		node->leaf.nstrtt = node->nstrtt; node->leaf.ndt = node->ndt;
+		leaves.push_back(node.get());
+		leaf_pair.push_back(t.is_leaf() && s.is_leaf());
+		return node;
+	}
+
+	node->nsonl = t.is_leaf() ? 1 : static_cast<int>(t.sons.size());
+	node->nsont = s.is_leaf() ? 1 : static_cast<int>(s.sons.size());
+	for (int i = 0; i < node->nsonl; i++) {
+		const Cluster& ti = t.is_leaf() ? t : *t.sons[i];
+		for (int j = 0; j < node->nsont; j++) {
+			const Cluster& sj = s.is_leaf() ? s : *s.sons[j];
+			node->sons.push_back(build_block_node(ti, sj, params, leaves, leaf_pair));
+		}
+	}
+	return node;
+}
+
+void collect_statistics(const HNode& A, HMatrixTree& H)
+{
+	if (A.is_leaf()) {
+		H.nlf++;
+		if (A.leaf.is_lowrank()) {
+			H.nlfkt++;
+			H.ktmax = std::max(H.ktmax, A.leaf.kt);
+		}
+		return;
+	}
+	for (const auto& son : A.sons) collect_statistics(*son, H);
+}
+
+/**
+ * Local offset of son (i, i) inside diagonal block A
+ */
+int diag_offset(const HNode& A, int i) { return A.son(i, i).nstrtl - A.nstrtl; }
+
+/**
+ * B := L^{-1} B, L: factorised diagonal block (unit lower part), rows of B match L
+ */
+void trsm_lower_left(const HNode& L, HNode& B, double eps, int kmax)
+{
+	if (B.is_leaf()) {
+		if (B.leaf.is_lowrank()) {
+			int k = B.leaf.kt;
+			std::vector<double> v(B.ndl);
+			for (int r = 0; r < k; r++) {
+				for (int i = 0; i < B.ndl; i++) v[i] = B.leaf.a1[static_cast<size_t>(i) * k + r];
+				hnode_solve_lower(L, v.data());
+				for (int i = 0; i < B.ndl; i++) B.leaf.a1[static_cast<size_t>(i) * k + r] = v[i];
+			}
+		} else {
+			std::vector<double> v(B.ndl);
+			for (int j = 0; j < B.ndt; j++) {
+				for (int i = 0; i < B.ndl; i++) v[i] = B.leaf.a1[static_cast<size_t>(i) * B.ndt + j];
+				hnode_solve_lower(L, v.data());
+				for (int i = 0; i < B.ndl; i++) B.leaf.a1[static_cast<size_t>(i) * B.ndt + j] = v[i];
+			}
+		}
+		return;
+	}
+
+	if (L.is_leaf()) {
+		if (B.nsonl != 1) throw std::logic_error("hacapk: incompatible block structures in H-LU");
+		for (int j = 0; j < B.nsont; j++) trsm_lower_left(L, B.son(0, j), eps, kmax);
+		return;
+	}
+
+	int p = L.nsonl;
+	if (B.nsonl != p) throw std::logic_error("hacapk: incompatible block structures in H-LU");
+	for (int j = 0; j < B.nsont; j++)
+		for (int i = 0; i < p; i++) {
+			trsm_lower_left(L.son(i, i), B.son(i, j), eps, kmax);
+			for (int k = i + 1; k < p; k++) hnode_mul_add(B.son(k, j), -1.0, L.son(k, i), B.son(i, j), eps, kmax);
+		}
+}
+
+/**
+ * B := B U^{-1}, U: factorised diagonal block (upper part), columns of B match U
+ */
+void trsm_upper_right(const HNode& U, HNode& B, double eps, int kmax)
+{
+	if (B.is_leaf()) {
+		if (B.leaf.is_lowrank()) {
+			int k = B.leaf.kt;
+			std::vector<double> v(B.ndt);
+			for (int r = 0; r < k; r++) {
+				for (int j = 0; j < B.ndt; j++) v[j] = B.leaf.a2[static_cast<size_t>(j) * k + r];
+				hnode_solve_upper_trans(U, v.data());
+				for (int j = 0; j < B.ndt; j++) B.leaf.a2[static_cast<size_t>(j) * k + r] = v[j];
+			}
+		} else {
+			for (int i = 0; i < B.ndl; i++) hnode_solve_upper_trans(U, &B.leaf.a1[static_cast<size_t>(i) * B.ndt]);
+		}
+		return;
+	}
+
+	if (U.is_leaf()) {
+		if (B.nsont != 1) throw std::logic_error("hacapk: incompatible block structures in H-LU");
+		for (int i = 0; i < B.nsonl; i++) trsm_upper_right(U, B.son(i, 0), eps, kmax);
+		return;
+	}
+
+	int p = U.nsonl;
+	if (B.nsont != p) throw std::logic_error("hacapk: incompatible block structures in H-LU");
+	for (int i = 0; i < B.nsonl; i++)
+		for (int j = 0; j < p; j++) {
+			trsm_upper_right(U.son(j, j), B.son(i, j), eps, kmax);
+			for (int k = j + 1; k < p; k++) hnode_mul_add(B.son(i, k), -1.0, B.son(i, j), U.son(j, k), eps, kmax);
+		}
+}
+
+} // namespace
+
+// ============================================================================
+// HNode / HMatrixTree Implementation
+// ============================================================================
+
+HNode::HNode()
+	: nstrtl(0)
+	, ndl(0)
+	, nstrtt(0)
+	, ndt(0)
+	, nsonl(0)
+	, nsont(0)
+{
+}
+
+size_t HNode::memory_usage() const {
+	if (is_leaf()) return leaf.memory_usage();
+	size_t mem = 0;
+	for (const auto& son : sons) mem += son->memory_usage();
+	return mem;
+}
+
+HMatrixTree::HMatrixTree()
+	: nd(0)
+	, is_factored(false)
+	, nlf(0)
+	, nlfkt(0)
+	, ktmax(0)
+{
+}
+
+void HMatrixTree::update_statistics() {
+	nlf = nlfkt = ktmax = 0;
+	if (root) collect_statistics(*root, *this);
+}
+
+size_t HMatrixTree::memory_usage() const {
+	return root ? root->memory_usage() : 0;
+}
+
+double HMatrixTree::compression_ratio() const {
+	size_t hmatrix_mem = memory_usage();
+	if (nd == 0 || hmatrix_mem == 0) return 0.0;
+
+	size_t full_mem = static_cast<size_t>(nd) * static_cast<size_t>(nd) * sizeof(double);
+	return static_cast<double>(full_mem) / static_cast<double>(hmatrix_mem);
+}
+
+// ============================================================================
+// Block-Cluster Tree Construction
+// ============================================================================
+
+std::unique_ptr<HMatrixTree> build_hmatrix_tree(
+	const std::vector<Point3D>& points,
+	KernelFunction kernel,
+	void* kernel_data,
+	const ControlParams& params
+) {
+	auto hmat = std::make_unique<HMatrixTree>();
+	hmat->nd = static_cast<int>(points.size());
+	if (hmat->nd == 0) return hmat;
+
+	hmat->lod.resize(hmat->nd);
+	for (int i = 0; i < hmat->nd; i++) hmat->lod[i] = i;
+	hmat->tree = generate_cluster(points, hmat->lod, 0, hmat->nd, 0, params);
+
+	std::vector<HNode*> leaves;
+	std::vector<char> leaf_pair;
+	hmat->root = build_block_node(*hmat->tree, *hmat->tree, params, leaves, leaf_pair);
+
+	// Leaves are independent: fill them in parallel (kernel must be thread-safe)
+	const std::vector<int>& lod = hmat->lod;
+	int nleaves = static_cast<int>(leaves.size());
+
+	#pragma omp parallel for schedule(dynamic) num_threads(std::max(params.nthr, 1))
+	for (int b = 0; b < nleaves; b++) {
+		LowRankBlock& block = leaves[b]->leaf;
+		auto entry = [&](int i, int j) {
+			return kernel(lod[block.nstrtl + i], lod[block.nstrtt + j], kernel_data);
+		};
+
+		if (block.is_lowrank()) {
+			LRFactor F = aca_partial_pivot(block.ndl, block.ndt, entry, params.eps_aca, params.max_rank);
+			lr_truncate(F, params.eps_aca, params.max_rank);
+			if (!leaf_pair[b] || static_cast<size_t>(F.k) * (block.ndl + block.ndt) < static_cast<size_t>(block.ndl) * block.ndt) {
+				lr_to_leaf(F, block);
+				continue;
+			}
+			block.ltmtx = 2;  // Low-rank form would not save memory
+		}
+
+		block.a1.resize(static_cast<size_t>(block.ndl) * block.ndt);
+		for (int i = 0; i < block.ndl; i++)
+			for (int j = 0; j < block.ndt; j++) block.a1[static_cast<size_t>(i) * block.ndt + j] = entry(i, j);
+	}
+
+	hmat->update_statistics();
+	return hmat;
+}
+
+// ============================================================================
+// Block-Level Products
+// ============================================================================
+
+void hnode_gemv(const HNode& A, bool trans, double alpha, const double* x, double* y)
+{
+	if (!A.is_leaf()) {
+		for (const auto& son : A.sons) {
+			int r0 = son->nstrtl - A.nstrtl;
+			int c0 = son->nstrtt - A.nstrtt;
+			if (trans) hnode_gemv(*son, true, alpha, x + r0, y + c0);
+			else hnode_gemv(*son, false, alpha, x + c0, y + r0);
+		}
+		return;
+	}
+
+	block_gemv(A.leaf, trans, alpha, x, y);
+}
+
+void hmatrix_tree_matvec(
+	const HMatrixTree& hmat,
+	const std::vector<double>& x,
+	std::vector<double>& y,
+	bool trans
+) {
+	int nd = hmat.nd;
+	y.assign(nd, 0.0);
+	if (!hmat.root) return;
+	if (hmat.is_factored) throw std::logic_error("hacapk: matrix-vector product with a factorised H-matrix");
+
+	std::vector<double> xp(nd), yp(nd, 0.0);
+	for (int k = 0; k < nd; k++) xp[k] = x[hmat.lod[k]];
+	hnode_gemv(*hmat.root, trans, 1.0, xp.data(), yp.data());
+	for (int k = 0; k < nd; k++) y[hmat.lod[k]] = yp[k];
+}
+
+void hnode_to_dense(const HNode& A, std::vector<double>& dense)
+{
+	dense.assign(static_cast<size_t>(A.ndl) * A.ndt, 0.0);
+
+	if (A.is_leaf()) {
+		if (A.leaf.is_full()) {
+			if (!A.leaf.a1.empty()) dense = A.leaf.a1;
+		} else {
+			lr_add_to_dense(lr_from_leaf(A.leaf), dense.data());
+		}
+		return;
+	}
+
+	std::vector<double> sub;
+	for (const auto& son : A.sons) {
+		hnode_to_dense(*son, sub);
+		int r0 = son->nstrtl - A.nstrtl, c0 = son->nstrtt - A.nstrtt;
+		for (int i = 0; i < son->ndl; i++)
+			std::copy(sub.begin() + static_cast<size_t>(i) * son->ndt, sub.begin() + static_cast<size_t>(i + 1) * son->ndt,
+				dense.begin() + static_cast<size_t>(r0 + i) * A.ndt + c0);
+	}
+}
+
+// ============================================================================
+// H-Arithmetic
+// ============================================================================
+
+void hnode_add(HNode& C, double alpha, const HNode& A, double eps, int kmax)
+{
+	if (C.ndl != A.ndl || C.ndt != A.ndt) throw std::logic_error("hacapk: H-matrix addition of blocks of different size");
+
+	if (!C.is_leaf() && !A.is_leaf() && C.nsonl == A.nsonl && C.nsont == A.nsont) {
+		for (int i = 0; i < C.nsonl; i++)
+			for (int j = 0; j < C.nsont; j++) hnode_add(C.son(i, j), alpha, A.son(i, j), eps, kmax);
+		return;
+	}
+
+	if (C.is_leaf() && C.leaf.is_full()) {
+		std::vector<double> D;
+		hnode_to_dense(A, D);
+		for (size_t l = 0; l < D.size(); l++) C.leaf.a1[l] += alpha * D[l];
+		return;
+	}
+
+	LRFactor F = to_lowrank(A, eps, kmax);
+	for (double& u : F.U) u *= alpha;
+	add_lowrank(C, F, eps, kmax);
+}
+
+void hnode_mul_add(HNode& C, double alpha, const HNode& A, const HNode& B, double eps, int kmax)
+{
+	if (C.ndl != A.ndl || C.ndt != B.ndt || A.ndt != B.ndl) throw std::logic_error("hacapk: H-matrix product of blocks of incompatible size");
+
+	// A or B low-rank: the product is low-rank as well
+	if (is_lowrank_leaf(A) || is_lowrank_leaf(B)) {
+		add_lowrank(C, product_lowrank(alpha, A, B, eps, kmax), eps, kmax);
+		return;
+	}
+
+	if (C.is_leaf()) {
+		if (C.leaf.is_full()) {
+			// Dense result: multiply A by the columns of B
+			std::vector<double> DB, v(B.ndl), w(A.ndl);
+			hnode_to_dense(B, DB);
+			for (int j = 0; j < C.ndt; j++) {
+				for (int l = 0; l < B.ndl; l++) v[l] = DB[static_cast<size_t>(l) * B.ndt + j];
+				std::fill(w.begin(), w.end(), 0.0);
+				hnode_gemv(A, false, alpha, v.data(), w.data());
+				for (int i = 0; i < C.ndl; i++) C.leaf.a1[static_cast<size_t>(i) * C.ndt + j] += w[i];
+			}
+		} else {
+			add_lowrank(C, product_lowrank(alpha, A, B, eps, kmax), eps, kmax);
+		}
+		return;
+	}
+
+	// C subdivided: A and B are full leaves or subdivided blocks matching the grid of C
+	int p = C.nsonl, q = C.nsont, s = grid_cols(A);
+	if (grid_rows(A) != p || grid_cols(B) != q || grid_rows(B) != s)
+		throw std::logic_error("hacapk: incompatible block structures in H-matrix product");
+	for (int i = 0; i < p; i++)
+		for (int j = 0; j < q; j++)
+			for (int l = 0; l < s; l++) hnode_mul_add(C.son(i, j), alpha, grid_son(A, i, l), grid_son(B, l, j), eps, kmax);
+}
+
+// ============================================================================
+// H-LU Factorisation and Triangular Solves
+// ============================================================================
+
+void hnode_lu(HNode& A, double eps, int kmax)
+{
+	if (A.is_leaf()) {
+		if (!A.leaf.is_full()) throw std::logic_error("hacapk: H-LU diagonal block is not a full block");
+
+		int n = A.ndl;
+		double* a = A.leaf.a1.data();
+		double amax = 0.0;
+		for (size_t l = 0; l < A.leaf.a1.size(); l++) amax = std::max(amax, std::abs(a[l]));
+
+		for (int k = 0; k < n; k++) {
+			double piv = a[static_cast<size_t>(k) * n + k];
+			if (std::abs(piv) <= 1e-14 * amax || piv == 0.0) throw std::runtime_error("hacapk: zero pivot in H-LU factorisation");
+			for (int i = k + 1; i < n; i++) {
+				double lik = (a[static_cast<size_t>(i) * n + k] /= piv);
+				if (lik == 0.0) continue;
+				for (int j = k + 1; j < n; j++) a[static_cast<size_t>(i) * n + j] -= lik * a[static_cast<size_t>(k) * n + j];
+			}
+		}
+		return;
+	}
+
+	int p = A.nsonl;
+	if (A.nsont != p) throw std::logic_error("hacapk: H-LU of a non-square block structure");
+	for (int i = 0; i < p; i++) {
+		hnode_lu(A.son(i, i), eps, kmax);
+		for (int j = i + 1; j < p; j++) {
+			trsm_lower_left(A.son(i, i), A.son(i, j), eps, kmax);
+			trsm_upper_right(A.son(i, i), A.son(j, i), eps, kmax);
+		}
+		for (int j = i + 1; j < p; j++)
+			for (int k = i + 1; k < p; k++) hnode_mul_add(A.son(j, k), -1.0, A.son(j, i), A.son(i, k), eps, kmax);
+	}
+}
+
+void hnode_solve_lower(const HNode& LU, double* x)
+{
+	if (LU.is_leaf()) {
+		int n = LU.ndl;
+		const double* a = LU.leaf.a1.data();
+		for (int i = 1; i < n; i++) {
+			double sum = 0.0;
+			for (int j = 0; j < i; j++) sum += a[static_cast<size_t>(i) * n + j] * x[j];
+			x[i] -= sum;
+		}
+		return;
+	}
+
+	int p = LU.nsonl;
+	for (int i = 0; i < p; i++) {
+		double* xi = x + diag_offset(LU, i);
+		hnode_solve_lower(LU.son(i, i), xi);
+		for (int k = i + 1; k < p; k++) hnode_gemv(LU.son(k, i), false, -1.0, xi, x + diag_offset(LU, k));
+	}
+}
+
+void hnode_solve_upper(const HNode& LU, double* x)
+{
+	if (LU.is_leaf()) {
+		int n = LU.ndl;
+		const double* a = LU.leaf.a1.data();
+		for (int i = n - 1; i >= 0; i--) {
+			double sum = x[i];
+			for (int j = i + 1; j < n; j++) sum -= a[static_cast<size_t>(i) * n + j] * x[j];
+			x[i] = sum / a[static_cast<size_t>(i) * n + i];
+		}
+		return;
+	}
+
+	int p = LU.nsonl;
+	for (int i = p - 1; i >= 0; i--) {
+		double* xi = x + diag_offset(LU, i);
+		hnode_solve_upper(LU.son(i, i), xi);
+		for (int k = 0; k < i; k++) hnode_gemv(LU.son(k, i), false, -1.0, xi, x + diag_offset(LU, k));
+	}
+}
+
+void hnode_solve_upper_trans(const HNode& LU, double* x)
+{
+	if (LU.is_leaf()) {
+		int n = LU.ndl;
+		const double* a = LU.leaf.a1.data();
+		for (int i = 0; i < n; i++) {
+			double sum = x[i];
+			for (int j = 0; j < i; j++) sum -= a[static_cast<size_t>(j) * n + i] * x[j];
+			x[i] = sum / a[static_cast<size_t>(i) * n + i];
+		}
+		return;
+	}
+
+	int p = LU.nsonl;
+	for (int i = 0; i < p; i++) {
+		double* xi = x + diag_offset(LU, i);
+		hnode_solve_upper_trans(LU.son(i, i), xi);
+		for (int k = i + 1; k < p; k++) hnode_gemv(LU.son(i, k), true, -1.0, xi, x + diag_offset(LU, k));
+	}
+}
+
+void hnode_solve_lower_trans(const HNode& LU, double* x)
+{
+	if (LU.is_leaf()) {
+		int n = LU.ndl;
+		const double* a = LU.leaf.a1.data();
+		for (int i = n - 2; i >= 0; i--) {
+			double sum = 0.0;
+			for (int j = i + 1; j < n; j++) sum += a[static_cast<size_t>(j) * n + i] * x[j];
+			x[i] -= sum;
+		}
+		return;
+	}
+
+	int p = LU.nsonl;
+	for (int i = p - 1; i >= 0; i--) {
+		double* xi = x + diag_offset(LU, i);
+		hnode_solve_lower_trans(LU.son(i, i), xi);
+		for (int k = 0; k < i; k++) hnode_gemv(LU.son(i, k), true, -1.0, xi, x + diag_offset(LU, k));
+	}
+}
+
+void hlu_factorize(HMatrixTree& hmat, double eps, int kmax)
+{
+	if (!hmat.root || hmat.is_factored) return;
+	hnode_lu(*hmat.root, eps, kmax);
+	hmat.is_factored = true;
+	hmat.update_statistics();
+}
+
+void hlu_solve(const HMatrixTree& hmat, std::vector<double>& b, bool trans)
+{
+	if (!hmat.is_factored) throw std::logic_error("hacapk: hlu_solve() requires a factorised H-matrix");
+
+	int nd = hmat.nd;
+	std::vector<double> xp(nd);
+	for (int k = 0; k < nd; k++) xp[k] = b[hmat.lod[k]];
+	if (trans) {
+		// (L*U)^T = U^T * L^T
+		hnode_solve_upper_trans(*hmat.root, xp.data());
+		hnode_solve_lower_trans(*hmat.root, xp.data());
+	} else {
+		hnode_solve_lower(*hmat.root, xp.data());
+		hnode_solve_upper(*hmat.root, xp.data());
+	}
+	for (int k = 0; k < nd; k++) b[hmat.lod[k]] = xp[k];
+}
+
+} // namespace hacapk
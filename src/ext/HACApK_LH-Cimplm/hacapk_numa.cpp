@@ -0,0 +1,221 @@
+/*
+ * @file hacapk_numa.cpp
+ * @brief NUMA-aware placement of H-matrix blocks and OpenMP thread binding
+ *
+ * Part of the HACApK C++ implementation (MIT License, see LICENSE).
+ *
+ * Memory pages are placed on the NUMA node of the thread that writes them
+ * first (first-touch policy of Linux and Windows). Blocks built by one
+ * thread, or by dynamically scheduled threads, therefore end up scattered
+ * and the memory-bound matrix-vector product reads remote memory. Here the
+ * blocks are re-allocated by the thread that applies them in
+ * hmatrix_matvec(), and threads can be bound to CPUs so that this thread
+ * stays on the same node.
+ */
+
+#include "hacapk.hpp"
+#include <algorithm>
+#include <numeric>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#endif
+
+namespace hacapk {
+
+// ============================================================================
+// First-Touch Block Placement
+// ============================================================================
+
+void hmatrix_first_touch(HMatrix& hmat, int nthr)
+{
+	if (nthr <= 0) nthr = omp_get_max_threads();
+	int nblocks = static_cast<int>(hmat.blocks.size());
+	hmat.thread_part.clear();
+	if (nblocks == 0) return;
+
+	// Sort blocks by row cluster (statistics follow their blocks)
+	std::vector<int> order(nblocks);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&hmat](int a, int b) {
+		return hmat.blocks[a].nstrtl < hmat.blocks[b].nstrtl;
+	});
+	std::vector<LowRankBlock> blocks(nblocks);
+	for (int b = 0; b < nblocks; b++) blocks[b] = std::move(hmat.blocks[order[b]]);
+	hmat.blocks.swap(blocks);
+	if (static_cast<int>(hmat.stats.size()) == nblocks) {
+		std::vector<BlockStats> stats(nblocks);
+		for (int b = 0; b < nblocks; b++) stats[b] = hmat.stats[order[b]];
+		hmat.stats.swap(stats);
+	}
+
+	// Split into ranges of about equal storage, only where no block crosses the row boundary
+	std::vector<double> cost(nblocks + 1, 0.0);
+	for (int b = 0; b < nblocks; b++) cost[b + 1] = cost[b] + hmat.blocks[b].memory_usage() + 1.0;
+	hmat.thread_part.assign(1, 0);
+	int row_end = 0;
+	for (int b = 0; b < nblocks; b++) {
+		const LowRankBlock& block = hmat.blocks[b];
+		int t = static_cast<int>(hmat.thread_part.size());
+		if (b > 0 && block.nstrtl >= row_end && t < nthr && cost[b] >= cost[nblocks] * t / nthr) {
+			hmat.thread_part.push_back(b);
+		}
+		row_end = std::max(row_end, block.nstrtl + block.ndl);
+	}
+	hmat.thread_part.push_back(nblocks);
+	int nparts = static_cast<int>(hmat.thread_part.size()) - 1;
+
+	// Each thread copies the factors of its blocks, which places them in its memory
+	#pragma omp parallel num_threads(nparts)
+	{
+		int t = omp_get_thread_num();
+		int nthr_team = omp_get_num_threads();
+		for (int p = t; p < nparts; p += nthr_team) {
+			for (int b = hmat.thread_part[p]; b < hmat.thread_part[p + 1]; b++) {
+				LowRankBlock& block = hmat.blocks[b];
+				std::vector<double>(block.a1).swap(block.a1);
+				std::vector<double>(block.a2).swap(block.a2);
+			}
+		}
+	}
+}
+
+// ============================================================================
+// Thread Binding
+// ============================================================================
+
+#if defined(__linux__)
+
+namespace {
+
+/**
+ * Parse a Linux CPU list such as "0-7,16-23"
+ */
+std::vector<int> parse_cpu_list(const std::string& list)
+{
+	std::vector<int> cpus;
+	std::stringstream ss(list);
+	std::string range;
+	while (std::getline(ss, range, ',')) {
+		if (range.empty() || range[0] == '\n') continue;
+		size_t dash = range.find('-');
+		int first = std::stoi(range.substr(0, dash));
+		int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+		for (int c = first; c <= last; c++) cpus.push_back(c);
+	}
+	return cpus;
+}
+
+/**
+ * Affinity of the process before the first binding
+ */
+const cpu_set_t& initial_affinity()
+{
+	static cpu_set_t mask;
+	static bool init = false;
+	if (!init) {
+		CPU_ZERO(&mask);
+		sched_getaffinity(0, sizeof(mask), &mask);
+		init = true;
+	}
+	return mask;
+}
+
+/**
+ * Allowed CPUs grouped by NUMA node (one group if the topology is unknown)
+ */
+const std::vector<std::vector<int>>& numa_node_cpus()
+{
+	static std::vector<std::vector<int>> nodes;
+	if (!nodes.empty()) return nodes;
+
+	const cpu_set_t& allowed = initial_affinity();
+	for (int node = 0; node < 256; node++) {
+		// Node numbers may have gaps
+		std::ifstream f("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+		if (!f) continue;
+		std::string list;
+		std::getline(f, list);
+		std::vector<int> cpus;
+		for (int c : parse_cpu_list(list)) {
+			if (c < CPU_SETSIZE && CPU_ISSET(c, &allowed)) cpus.push_back(c);
+		}
+		if (!cpus.empty()) nodes.push_back(cpus);
+	}
+	if (nodes.empty()) {
+		nodes.resize(1);
+		for (int c = 0; c < CPU_SETSIZE; c++) {
+			if (CPU_ISSET(c, &allowed)) nodes[0].push_back(c);
+		}
+	}
+	return nodes;
+}
+
+} // namespace
+
+int bind_threads(int mode)
+{
+	static bool bound = false;
+	const cpu_set_t& allowed = initial_affinity();
+	int nbound = 0;
+
+	if (mode <= 0) {
+		if (!bound) return 0;
+		#pragma omp parallel
+		{
+			sched_setaffinity(0, sizeof(allowed), &allowed);
+		}
+		bound = false;
+		return 0;
+	}
+
+	// CPU of thread t: nodes one after another (close) or round-robin over nodes (spread)
+	const std::vector<std::vector<int>>& nodes = numa_node_cpus();
+	std::vector<int> cpus;
+	if (mode == 1) {
+		for (const std::vector<int>& node : nodes) cpus.insert(cpus.end(), node.begin(), node.end());
+	} else {
+		for (size_t k = 0; cpus.size() < CPU_SETSIZE; k++) {
+			bool any = false;
+			for (const std::vector<int>& node : nodes) {
+				if (k < node.size()) { cpus.push_back(node[k]); any = true; }
+			}
+			if (!any) break;
+		}
+	}
+	if (cpus.empty()) return 0;
+
+	#pragma omp parallel reduction(+:nbound)
+	{
+		cpu_set_t mask;
+		CPU_ZERO(&mask);
+		CPU_SET(cpus[omp_get_thread_num() % cpus.size()], &mask);
+		if (sched_setaffinity(0, sizeof(mask), &mask) == 0) nbound++;
+	}
+	bound = true;
+	return nbound;
+}
+
+int numa_node_count()
+{
+	return static_cast<int>(numa_node_cpus().size());
+}
+
+#else
+
+int bind_threads(int mode)
+{
+	return 0;
+}
+
+int numa_node_count()
+{
+	return 1;
+}
+
+#endif
+
+} // namespace hacapk
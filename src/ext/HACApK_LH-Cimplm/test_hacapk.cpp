@@ -214,9 +214,10 @@ bool test_aca() {
 	cout << "Test 4: ACA Low-Rank Approximation" << endl;
 	cout << string(70, '-') << endl;
 
+	// Well-separated index ranges: the block is numerically low-rank
 	LowRankBlock block;
 	block.nstrtl = 0;
-	block.nstrtt = 0;
+	block.nstrtt = 100;
 	block.ndl = 20;
 	block.ndt = 20;
 
@@ -244,7 +245,7 @@ bool test_aca() {
 		double max_error = 0.0;
 		for (int i = 0; i < block.ndl; i++) {
 			for (int j = 0; j < block.ndt; j++) {
-				double exact = kernel_1d(i, j, nullptr);
+				double exact = kernel_1d(block.nstrtl + i, block.nstrtt + j, nullptr);
 
 				double approx = 0.0;
 				for (int k = 0; k < block.kt; k++) {
@@ -275,7 +276,7 @@ bool test_hmatrix_construction() {
 	cout << string(70, '-') << endl;
 
 	// Create grid of points
-	int n = 64;
+	int n = 512;
 	vector<Point3D> points;
 
 	for (int i = 0; i < n; i++) {
@@ -289,8 +290,9 @@ bool test_hmatrix_construction() {
 
 	ControlParams params;
 	params.leaf_size = 16;
-	params.eta = 2.0;
+	params.eta = 0.5;
 	params.eps_aca = 1e-3;
+	params.collect_stats = true;
 
 	Laplace3DData kernel_data;
 	kernel_data.points = &points;
@@ -302,7 +304,39 @@ bool test_hmatrix_construction() {
 	auto t_end = chrono::high_resolution_clock::now();
 	double time_ms = chrono::duration<double, milli>(t_end - t_start).count();
 
-	bool success = (hmat != nullptr && hmat->nlf > 0);
+	bool success = (hmat != nullptr && hmat->nlf > 0 && hmat->stats.size() == hmat->blocks.size());
+
+	// Per-block statistics: full blocks evaluate every entry once, low-rank blocks meet the tolerance
+	long long kernel_calls = 0;
+	double max_error = 0.0;
+	for (size_t b = 0; success && b < hmat->blocks.size(); b++) {
+		const LowRankBlock& block = hmat->blocks[b];
+		const BlockStats& stats = hmat->stats[b];
+		kernel_calls += stats.kernel_calls;
+		max_error = max(max_error, stats.est_error);
+		if (block.is_full()) {
+			success = (stats.kernel_calls == static_cast<long long>(block.ndl) * block.ndt);
+			continue;
+		}
+
+		// Sampling all rows gives the exact relative error of the block
+		KernelFunction kernel = [&hmat](int i, int j, void* data) {
+			return kernel_laplace_3d(hmat->lodl[i], hmat->lodt[j], data);
+		};
+		double err2 = 0.0, ref2 = 0.0;
+		for (int i = 0; i < block.ndl; i++) {
+			for (int j = 0; j < block.ndt; j++) {
+				double a = kernel(block.nstrtl + i, block.nstrtt + j, &kernel_data);
+				double r = a;
+				for (int l = 0; l < block.kt; l++) r -= block.a1[i * block.kt + l] * block.a2[j * block.kt + l];
+				err2 += r * r;
+				ref2 += a * a;
+			}
+		}
+		double exact = estimate_block_error(block, kernel, &kernel_data, block.ndl);
+		success = (stats.kernel_calls > 0) && (stats.est_error > 0.0) && (stats.est_error < 0.1)
+			&& (std::abs(exact - sqrt(err2 / ref2)) < 1e-12);
+	}
 
 	if (success) {
 		cout << "  H-matrix created successfully" << endl;
@@ -312,6 +346,7 @@ bool test_hmatrix_construction() {
 		cout << "    Memory usage: " << hmat->memory_usage() / 1024.0 << " KB" << endl;
 		cout << "    Compression ratio: " << hmat->compression_ratio() << endl;
 		cout << "    Construction time: " << time_ms << " ms" << endl;
+		cout << "    Kernel calls: " << kernel_calls << ", max estimated block error: " << max_error << endl;
 	} else {
 		cout << "  [ERROR] H-matrix construction failed" << endl;
 	}
@@ -378,6 +413,733 @@ bool test_matvec() {
 	return success;
 }
 
+// ============================================================================
+// Tests 7-9: Block-Cluster Tree, H-Arithmetic, H-LU
+// ============================================================================
+
+/**
+ * Laplace kernel with shifted diagonal: K(i,i) = diag, K(i,j) = 1/||x_i - x_j||
+ * (symmetric positive definite for distinct points)
+ */
+struct ShiftedLaplaceData {
+	const vector<Point3D>* points;
+	double diag;
+};
+
+double kernel_shifted_laplace(int i, int j, void* data) {
+	auto* d = static_cast<ShiftedLaplaceData*>(data);
+	if (i == j) return d->diag;
+	return 1.0 / point_distance((*d->points)[i], (*d->points)[j]);
+}
+
+vector<Point3D> make_jittered_grid(int nx, int ny, int nz) {
+	vector<Point3D> points;
+	for (int k = 0; k < nz; k++) {
+		for (int j = 0; j < ny; j++) {
+			for (int i = 0; i < nx; i++) {
+				int s = (i * 7 + j * 13 + k * 29) % 17;
+				points.emplace_back(i + 0.02 * s, j - 0.015 * s, k + 0.01 * s);
+			}
+		}
+	}
+	return points;
+}
+
+double relative_difference(const vector<double>& a, const vector<double>& b) {
+	double num = 0.0, den = 0.0;
+	for (size_t i = 0; i < a.size(); i++) {
+		num += (a[i] - b[i]) * (a[i] - b[i]);
+		den += b[i] * b[i];
+	}
+	return sqrt(num / den);
+}
+
+/**
+ * Dense matrix of the kernel in cluster (permuted) ordering
+ */
+vector<double> dense_permuted(const HMatrixTree& hmat, double (*kernel)(int, int, void*), void* data) {
+	int n = hmat.nd;
+	vector<double> dense(static_cast<size_t>(n) * n);
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++) {
+			dense[static_cast<size_t>(i) * n + j] = kernel(hmat.lod[i], hmat.lod[j], data);
+		}
+	}
+	return dense;
+}
+
+bool test_hmatrix_tree() {
+	cout << "\n" << string(70, '-') << endl;
+	cout << "Test 7: Block-Cluster Tree H-Matrix" << endl;
+	cout << string(70, '-') << endl;
+
+	vector<Point3D> points = make_jittered_grid(20, 20, 5);
+	int n = points.size();
+
+	ControlParams params;
+	params.leaf_size = 16;
+	params.eta = 0.5;
+	params.eps_aca = 1e-6;
+
+	ShiftedLaplaceData kernel_data = {&points, 10.0};
+	auto hmat = build_hmatrix_tree(points, kernel_shifted_laplace, &kernel_data, params);
+
+	vector<double> x(n), y, y_ref(n, 0.0);
+	for (int i = 0; i < n; i++) x[i] = sin(0.1 * i) + 0.5;
+	hmatrix_tree_matvec(*hmat, x, y);
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++) {
+			y_ref[i] += kernel_shifted_laplace(i, j, &kernel_data) * x[j];
+		}
+	}
+	double err = relative_difference(y, y_ref);
+
+	cout << "  Number of points: " << n << endl;
+	cout << "  Leaf blocks: " << hmat->nlf << " (low-rank: " << hmat->nlfkt << ", max rank: " << hmat->ktmax << ")" << endl;
+	cout << "  Compression ratio: " << hmat->compression_ratio() << endl;
+	cout << "  Relative matvec error: " << err << endl;
+
+	return (hmat->nlfkt > 0) && (hmat->compression_ratio() > 1.0) && (err < 1e-5);
+}
+
+bool test_harith() {
+	cout << "\n" << string(70, '-') << endl;
+	cout << "Test 8: H-Matrix Addition and Multiplication" << endl;
+	cout << string(70, '-') << endl;
+
+	vector<Point3D> points = make_jittered_grid(8, 8, 4);
+	int n = points.size();
+
+	ControlParams params;
+	params.leaf_size = 16;
+	params.eta = 0.5;
+	params.eps_aca = 1e-8;
+
+	ShiftedLaplaceData kernel_data = {&points, 10.0};
+	auto A = build_hmatrix_tree(points, kernel_shifted_laplace, &kernel_data, params);
+	auto C = build_hmatrix_tree(points, kernel_shifted_laplace, &kernel_data, params);
+	vector<double> dA = dense_permuted(*A, kernel_shifted_laplace, &kernel_data);
+
+	// C = A + 0.5*A + A*A
+	hnode_add(*C->root, 0.5, *A->root, 1e-8, 0);
+	hnode_mul_add(*C->root, 1.0, *A->root, *A->root, 1e-8, 0);
+
+	vector<double> dC_ref(dA.size());
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++) {
+			double sum = 1.5 * dA[static_cast<size_t>(i) * n + j];
+			for (int l = 0; l < n; l++) sum += dA[static_cast<size_t>(i) * n + l] * dA[static_cast<size_t>(l) * n + j];
+			dC_ref[static_cast<size_t>(i) * n + j] = sum;
+		}
+	}
+	vector<double> dC;
+	hnode_to_dense(*C->root, dC);
+	double err = relative_difference(dC, dC_ref);
+
+	C->update_statistics();
+	cout << "  Number of points: " << n << endl;
+	cout << "  Max rank of result: " << C->ktmax << endl;
+	cout << "  Relative error of A + 0.5*A + A*A: " << err << endl;
+
+	return err < 1e-6;
+}
+
+bool test_hlu() {
+	cout << "\n" << string(70, '-') << endl;
+	cout << "Test 9: H-LU Factorisation and Solve" << endl;
+	cout << string(70, '-') << endl;
+
+	vector<Point3D> points = make_jittered_grid(10, 10, 5);
+	int n = points.size();
+
+	ControlParams params;
+	params.leaf_size = 16;
+	params.eta = 0.5;
+	params.eps_aca = 1e-8;
+
+	ShiftedLaplaceData kernel_data = {&points, 10.0};
+	auto hmat = build_hmatrix_tree(points, kernel_shifted_laplace, &kernel_data, params);
+
+	vector<double> x_ref(n), b(n, 0.0);
+	for (int i = 0; i < n; i++) x_ref[i] = cos(0.05 * i);
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++) {
+			b[i] += kernel_shifted_laplace(i, j, &kernel_data) * x_ref[j];
+		}
+	}
+
+	auto t_start = chrono::high_resolution_clock::now();
+	hlu_factorize(*hmat, 1e-8, 0);
+	auto t_end = chrono::high_resolution_clock::now();
+	double time_ms = chrono::duration<double, milli>(t_end - t_start).count();
+
+	vector<double> x = b;
+	hlu_solve(*hmat, x);
+	double err = relative_difference(x, x_ref);
+
+	cout << "  Number of unknowns: " << n << endl;
+	cout << "  Factor leaf blocks: " << hmat->nlf << " (max rank: " << hmat->ktmax << ")" << endl;
+	cout << "  Factor compression ratio: " << hmat->compression_ratio() << endl;
+	cout << "  Factorisation time: " << time_ms << " ms" << endl;
+	cout << "  Relative solution error: " << err << endl;
+
+	return hmat->is_factored && (err < 1e-6);
+}
+
+// ============================================================================
+// Test 10: Principal-Axis and Cardinality-Balanced Splitting
+// ============================================================================
+
+/**
+ * Leaf sizes and depth of a cluster tree
+ */
+void cluster_stats(const Cluster& c, int& max_leaf, int& min_leaf, int& max_depth) {
+	if (c.is_leaf()) {
+		max_leaf = max(max_leaf, c.nsize);
+		min_leaf = min(min_leaf, c.nsize);
+		max_depth = max(max_depth, c.ndpth);
+		return;
+	}
+	for (const auto& son : c.sons) cluster_stats(*son, max_leaf, min_leaf, max_depth);
+}
+
+bool test_cluster_splitting() {
+	cout << "\n" << string(70, '-') << endl;
+	cout << "Test 10: Principal-Axis and Balanced Splitting" << endl;
+	cout << string(70, '-') << endl;
+
+	// Thin girder along the oblique direction (1, 1, 0.2), 4x more points at one end
+	const double dir[3] = {1.0 / sqrt(2.04), 1.0 / sqrt(2.04), 0.2 / sqrt(2.04)};
+	vector<Point3D> points;
+	for (int i = 0; i < 1000; i++) {
+		double t = (i < 800) ? 0.25 * i : 200.0 + (i - 800);
+		double a = 0.5 * ((i * 7) % 5), b = 0.5 * ((i * 11) % 3);
+		points.emplace_back(t * dir[0] + a * 0.7071, t * dir[1] - a * 0.7071, t * dir[2] + b);
+	}
+	int n = points.size();
+	vector<int> indices(n);
+	for (int i = 0; i < n; i++) indices[i] = i;
+
+	double axis[3];
+	principal_axis(points, indices, 0, n, axis);
+	double cos_axis = std::abs(axis[0] * dir[0] + axis[1] * dir[1] + axis[2] * dir[2]);
+	cout << "  Principal axis: (" << axis[0] << ", " << axis[1] << ", " << axis[2] << "), |cos| to girder axis: " << cos_axis << endl;
+
+	ControlParams params;
+	params.leaf_size = 20;
+	bool success = (cos_axis > 0.999);
+
+	const char* names[] = {"longest box edge, midpoint", "principal axis, midpoint", "principal axis, median"};
+	int depth_mid = 0, depth_med = 0;
+	for (int type = 1; type <= 3; type++) {
+		params.split_type = type;
+		for (int i = 0; i < n; i++) indices[i] = i;
+		auto cluster = generate_cluster(points, indices, 0, n, 0, params);
+
+		int max_leaf = 0, min_leaf = n, max_depth = 0;
+		cluster_stats(*cluster, max_leaf, min_leaf, max_depth);
+		cout << "  " << names[type - 1] << ": depth " << max_depth << ", leaf sizes " << min_leaf << "-" << max_leaf << endl;
+
+		vector<int> sorted(indices);
+		sort(sorted.begin(), sorted.end());
+		for (int i = 0; i < n; i++) success = success && (sorted[i] == i);
+		success = success && (max_leaf <= params.leaf_size);
+
+		if (type == 2) depth_mid = max_depth;
+		if (type == 3) {
+			depth_med = max_depth;
+			// Root sons differ in size by at most one point, no leaf is less than half full
+			success = success && (std::abs(cluster->sons[0]->nsize - cluster->sons[1]->nsize) <= 1) && (min_leaf >= params.leaf_size / 2);
+		}
+	}
+	success = success && (depth_med < depth_mid);
+
+	// H-matrix accuracy is independent of the splitting
+	params.split_type = 3;
+	params.leaf_size = 16;
+	params.eta = 0.5;
+	params.eps_aca = 1e-6;
+	ShiftedLaplaceData kernel_data = {&points, 10.0};
+	auto hmat = build_hmatrix_tree(points, kernel_shifted_laplace, &kernel_data, params);
+
+	vector<double> x(n), y, y_ref(n, 0.0);
+	for (int i = 0; i < n; i++) x[i] = sin(0.1 * i) + 0.5;
+	hmatrix_tree_matvec(*hmat, x, y);
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++) {
+			y_ref[i] += kernel_shifted_laplace(i, j, &kernel_data) * x[j];
+		}
+	}
+	double err = relative_difference(y, y_ref);
+	cout << "  Balanced tree: compression ratio " << hmat->compression_ratio() << ", relative matvec error " << err << endl;
+
+	// Flat leaf list: blocks are assembled in cluster order and mapped back in the matvec
+	auto flat = build_hmatrix(points, points, kernel_shifted_laplace, &kernel_data, params);
+	vector<double> y_flat(n, 0.0);
+	hmatrix_matvec(*flat, x, y_flat);
+	double err_flat = relative_difference(y_flat, y_ref);
+	cout << "  Flat H-matrix: " << flat->nlfkt << " low-rank of " << flat->nlf << " blocks, relative matvec error " << err_flat << endl;
+
+	return success && (err < 1e-5) && (err_flat < 1e-4);
+}
+
+/**
+ * Non-symmetric dipole kernel: K(i,j) = (z_i - z_j) / |x_i - x_j|^3, diag on the diagonal
+ */
+double kernel_dipole_z(int i, int j, void* data) {
+	auto* d = static_cast<ShiftedLaplaceData*>(data);
+	if (i == j) return d->diag;
+	const Point3D& pi = (*d->points)[i];
+	const Point3D& pj = (*d->points)[j];
+	double r = point_distance(pi, pj);
+	return (pi.z - pj.z) / (r * r * r);
+}
+
+bool test_h2matrix() {
+	cout << "\n" << string(70, '-') << endl;
+	cout << "Test 11: H2-Matrix with Nested Cluster Bases" << endl;
+	cout << string(70, '-') << endl;
+
+	vector<Point3D> points = make_jittered_grid(24, 24, 4);
+	int n = points.size();
+
+	ControlParams params;
+	params.leaf_size = 32;
+	params.split_type = 3;
+	params.eta = 1.0;
+	params.eps_aca = 1e-6;
+	params.max_rank = 50;
+
+	ShiftedLaplaceData kernel_data = {&points, 10.0};
+	double (*kernels[])(int, int, void*) = {kernel_shifted_laplace, kernel_dipole_z};
+	const char* names[] = {"Laplace", "dipole (non-symmetric)"};
+
+	vector<double> x(n);
+	for (int i = 0; i < n; i++) x[i] = sin(0.1 * i) + 0.5;
+
+	bool success = true;
+	for (int kn = 0; kn < 2; kn++) {
+		auto hmat = build_hmatrix_tree(points, kernels[kn], &kernel_data, params);
+		auto h2 = convert_to_h2matrix(*hmat, params.eps_aca);
+
+		vector<double> y_h, y_h2, y_ref(n, 0.0);
+		hmatrix_tree_matvec(*hmat, x, y_h);
+		h2matrix_matvec(*h2, x, y_h2);
+		for (int i = 0; i < n; i++) {
+			for (int j = 0; j < n; j++) {
+				y_ref[i] += kernels[kn](i, j, &kernel_data) * x[j];
+			}
+		}
+		double err_h = relative_difference(y_h, y_ref);
+		double err_h2 = relative_difference(y_h2, y_ref);
+
+		// Far-field storage only: bases and coupling matrices vs low-rank factors
+		size_t near_mem = 0, h_far_mem = 0, h2_far_mem = h2->memory_usage();
+		for (const LowRankBlock& b : h2->near) near_mem += b.memory_usage();
+		h_far_mem = hmat->memory_usage() - near_mem;
+		h2_far_mem -= near_mem;
+
+		cout << "  " << names[kn] << ": N = " << n << ", far blocks " << h2->far.size()
+		     << ", max basis rank " << h2->ktmax << endl;
+		cout << "    far-field memory: H " << h_far_mem / 1024 << " KB, H2 " << h2_far_mem / 1024 << " KB"
+		     << " (compression ratio H " << hmat->compression_ratio() << ", H2 " << h2->compression_ratio() << ")" << endl;
+		cout << "    relative matvec error: H " << err_h << ", H2 " << err_h2 << endl;
+
+		success = success && (h2->far.size() == static_cast<size_t>(hmat->nlfkt))
+			&& (h2_far_mem < h_far_mem) && (err_h2 < 1e-5);
+	}
+
+	return success;
+}
+
+// ============================================================================
+// Test 12: Transposed Matrix-Vector Products
+// ============================================================================
+
+struct TwoGridData {
+	const vector<Point3D>* rows;
+	const vector<Point3D>* cols;
+};
+
+/**
+ * Non-symmetric kernel between two point sets (dipole field along z)
+ */
+double kernel_two_grid(int i, int j, void* data) {
+	auto* d = static_cast<TwoGridData*>(data);
+	const Point3D& p = (*d->rows)[i];
+	const Point3D& q = (*d->cols)[j];
+	double r = point_distance(p, q);
+	return (1.0 + (p.z - q.z) / r) / r;
+}
+
+double dot(const vector<double>& a, const vector<double>& b) {
+	double sum = 0.0;
+	for (size_t i = 0; i < a.size(); i++) sum += a[i] * b[i];
+	return sum;
+}
+
+bool test_transposed_matvec() {
+	cout << "\n" << string(70, '-') << endl;
+	cout << "Test 12: Transposed Matrix-Vector Products" << endl;
+	cout << string(70, '-') << endl;
+
+	ControlParams params;
+	params.leaf_size = 16;
+	params.split_type = 3;
+	params.eta = 1.0;
+	params.eps_aca = 1e-6;
+	params.max_rank = 50;
+
+	// Flat H-matrix of a rectangular kernel matrix
+	vector<Point3D> rows = make_jittered_grid(12, 12, 2);
+	vector<Point3D> cols = make_jittered_grid(10, 8, 3);
+	for (Point3D& q : cols) q.x += 4.5;
+	int m = rows.size(), n = cols.size();
+	TwoGridData two_grid = {&rows, &cols};
+	auto hmat = build_hmatrix(rows, cols, kernel_two_grid, &two_grid, params);
+
+	vector<double> x(n), xt(m), y(m), yt(n), yt_ref(n, 0.0);
+	for (int j = 0; j < n; j++) x[j] = sin(0.1 * j) + 0.5;
+	for (int i = 0; i < m; i++) xt[i] = cos(0.07 * i) - 0.2;
+	hmatrix_matvec(*hmat, x, y);
+	hmatrix_matvec(*hmat, xt, yt, true);
+	for (int i = 0; i < m; i++)
+		for (int j = 0; j < n; j++) yt_ref[j] += kernel_two_grid(i, j, &two_grid) * xt[i];
+
+	// <xt, H x> = <H^T xt, x> holds to round-off independently of the approximation
+	double adj_flat = std::abs(dot(xt, y) - dot(yt, x)) / std::abs(dot(xt, y));
+	double err_flat = relative_difference(yt, yt_ref);
+	cout << "  Flat H-matrix " << m << " x " << n << ": adjoint identity " << adj_flat << ", H^T x error " << err_flat << endl;
+	bool success = (adj_flat < 1e-12) && (err_flat < 1e-4);
+
+	// Block-cluster tree and H2-matrix of a square non-symmetric kernel matrix
+	vector<Point3D> points = make_jittered_grid(16, 16, 3);
+	int nd = points.size();
+	ShiftedLaplaceData kernel_data = {&points, 10.0};
+	auto tree = build_hmatrix_tree(points, kernel_dipole_z, &kernel_data, params);
+	auto h2 = convert_to_h2matrix(*tree, params.eps_aca);
+
+	vector<double> u(nd), v(nd), v_ref(nd, 0.0);
+	for (int i = 0; i < nd; i++) u[i] = sin(0.13 * i) + 0.3;
+	for (int i = 0; i < nd; i++)
+		for (int j = 0; j < nd; j++) v_ref[j] += kernel_dipole_z(i, j, &kernel_data) * u[i];
+
+	const char* names[] = {"Block-cluster tree", "H2-matrix"};
+	for (int kind = 0; kind < 2; kind++) {
+		vector<double> hx, htu;
+		if (kind == 0) {
+			hmatrix_tree_matvec(*tree, v_ref, hx);
+			hmatrix_tree_matvec(*tree, u, htu, true);
+		} else {
+			h2matrix_matvec(*h2, v_ref, hx);
+			h2matrix_matvec(*h2, u, htu, true);
+		}
+		double adj = std::abs(dot(u, hx) - dot(htu, v_ref)) / std::abs(dot(u, hx));
+		double err = relative_difference(htu, v_ref);
+		cout << "  " << names[kind] << " N = " << nd << ": adjoint identity " << adj << ", H^T x error " << err << endl;
+		success = success && (adj < 1e-12) && (err < 1e-5);
+	}
+
+	// Transposed H-LU solve: (L*U)^T x = K^T u recovers u
+	hlu_factorize(*tree, 1e-8, 0);
+	vector<double> x_sol = v_ref;
+	hlu_solve(*tree, x_sol, true);
+	double err_lu = relative_difference(x_sol, u);
+	cout << "  Transposed H-LU solve: relative solution error " << err_lu << endl;
+
+	return success && (err_lu < 1e-5);
+}
+
+// ============================================================================
+// Test 13: Dense Block Kernels
+// ============================================================================
+
+bool test_dense_kernels() {
+	cout << "\n" << string(70, '-') << endl;
+	cout << "Test 13: Dense Block Kernels" << endl;
+	cout << string(70, '-') << endl;
+	cout << "  Backend: " << dense_kernel_backend() << endl;
+
+	// Non-square operands; entries A[i][j] = sin(i + 2j)
+	int m = 37, n = 23, l = 11;
+	auto entry = [](int i, int j) { return sin(i + 2.0 * j); };
+	vector<double> A(m * n), At(n * m), x(max(m, n)), Bt(n * l);
+	for (int i = 0; i < m; i++)
+		for (int j = 0; j < n; j++) { A[i * n + j] = entry(i, j); At[j * m + i] = entry(i, j); }
+	for (int p = 0; p < l; p++)
+		for (int j = 0; j < n; j++) Bt[j * l + p] = cos(p - j);
+	for (size_t i = 0; i < x.size(); i++) x[i] = 0.5 + 0.1 * i;
+
+	double err = 0.0;
+	for (int trans = 0; trans < 2; trans++) {
+		int nout = trans ? n : m, nin = trans ? m : n;
+		vector<double> y_ref(nout, 1.0), y(nout, 1.0), y_b(nout, 1.0);
+		for (int i = 0; i < nout; i++)
+			for (int j = 0; j < nin; j++) y_ref[i] += -2.0 * (trans ? entry(j, i) : entry(i, j)) * x[j];
+		dense_gemv(trans != 0, m, n, -2.0, A.data(), x.data(), y.data());
+		dense_gemv_builtin(trans != 0, m, n, -2.0, A.data(), x.data(), y_b.data());
+		err = max(err, max(relative_difference(y, y_ref), relative_difference(y_b, y_ref)));
+	}
+
+	// C = 0.5 * A^T * A with both operands given in either storage layout
+	vector<double> C_ref(n * n, 0.0);
+	for (int i = 0; i < n; i++)
+		for (int j = 0; j < n; j++)
+			for (int p = 0; p < m; p++) C_ref[i * n + j] += 0.5 * entry(p, i) * entry(p, j);
+	for (int transa = 0; transa < 2; transa++)
+		for (int transb = 0; transb < 2; transb++) {
+			// op(A2) = A^T (n x m), op(B2) = A (m x n)
+			const double* A2 = transa ? A.data() : At.data();
+			const double* B2 = transb ? At.data() : A.data();
+			vector<double> C(n * n, 0.0), C_b(n * n, 0.0);
+			dense_gemm(transa != 0, transb != 0, n, n, m, 0.5, A2, B2, C.data());
+			dense_gemm_builtin(transa != 0, transb != 0, n, n, m, 0.5, A2, B2, C_b.data());
+			err = max(err, max(relative_difference(C, C_ref), relative_difference(C_b, C_ref)));
+		}
+
+	// Low-rank to dense update as in H-arithmetic: D += U * V^T
+	vector<double> D(m * n, 0.0), D_ref(m * n, 0.0);
+	for (int i = 0; i < m; i++)
+		for (int j = 0; j < n; j++)
+			for (int p = 0; p < l; p++) D_ref[i * n + j] += cos(i - p) * Bt[j * l + p];
+	vector<double> U(m * l);
+	for (int i = 0; i < m; i++)
+		for (int p = 0; p < l; p++) U[i * l + p] = cos(i - p);
+	dense_gemm(false, true, m, n, l, 1.0, U.data(), Bt.data(), D.data());
+	err = max(err, relative_difference(D, D_ref));
+
+	cout << "  Max relative error (gemv, gemm, all transpositions): " << err << endl;
+	return err < 1e-13;
+}
+
+// ============================================================================
+// Test 14: Incremental H-Matrix Update
+// ============================================================================
+
+bool test_incremental_update() {
+	cout << "\n" << string(70, '-') << endl;
+	cout << "Test 14: Incremental H-Matrix Update" << endl;
+	cout << string(70, '-') << endl;
+
+	ControlParams params;
+	params.leaf_size = 16;
+	params.split_type = 3;
+	params.eta = 1.0;
+	params.eps_aca = 1e-6;
+	params.max_rank = 50;
+
+	vector<Point3D> rows = make_jittered_grid(12, 12, 2);
+	vector<Point3D> cols = make_jittered_grid(10, 8, 3);
+	for (Point3D& q : cols) q.x += 4.5;
+	int m = rows.size(), n = cols.size();
+	TwoGridData two_grid = {&rows, &cols};
+	auto hmat = build_hmatrix(rows, cols, kernel_two_grid, &two_grid, params);
+
+	// Move a few points of both sets
+	vector<int> changed_rows = {3, 100}, changed_cols = {7, 8, 150};
+	for (int i : changed_rows) rows[i].z += 0.3;
+	for (int j : changed_cols) { cols[j].x += 0.2; cols[j].y -= 0.1; }
+	int nupdated = update_hmatrix(*hmat, rows, cols, changed_rows, changed_cols, kernel_two_grid, &two_grid, params);
+	auto fresh = build_hmatrix(rows, cols, kernel_two_grid, &two_grid, params);
+
+	vector<double> x(n), y(m), y_fresh(m), y_ref(m, 0.0);
+	for (int j = 0; j < n; j++) x[j] = sin(0.1 * j) + 0.5;
+	hmatrix_matvec(*hmat, x, y);
+	hmatrix_matvec(*fresh, x, y_fresh);
+	for (int i = 0; i < m; i++)
+		for (int j = 0; j < n; j++) y_ref[i] += kernel_two_grid(i, j, &two_grid) * x[j];
+
+	double err = relative_difference(y, y_ref);
+	double err_fresh = relative_difference(y_fresh, y_ref);
+	cout << "  Recomputed blocks: " << nupdated << " of " << hmat->blocks.size() << endl;
+	cout << "  Relative error: updated " << err << ", rebuilt " << err_fresh << endl;
+
+	// Nothing changed: no block is recomputed
+	int nnone = update_hmatrix(*hmat, rows, cols, {}, {}, kernel_two_grid, &two_grid, params);
+
+	return (nupdated > 0) && (nupdated < static_cast<int>(hmat->blocks.size())) && (nnone == 0) && (err < 1e-4);
+}
+
+// ============================================================================
+// Test 15: NUMA Block Placement and Thread Binding
+// ============================================================================
+
+bool test_numa_placement() {
+	cout << "\n" << string(70, '-') << endl;
+	cout << "Test 15: NUMA Block Placement and Thread Binding" << endl;
+	cout << string(70, '-') << endl;
+
+	ControlParams params;
+	params.leaf_size = 16;
+	params.split_type = 3;
+	params.eta = 1.0;
+	params.eps_aca = 1e-6;
+
+	vector<Point3D> rows = make_jittered_grid(12, 12, 2);
+	vector<Point3D> cols = make_jittered_grid(10, 8, 3);
+	for (Point3D& q : cols) q.x += 4.5;
+	int m = rows.size(), n = cols.size();
+	TwoGridData two_grid = {&rows, &cols};
+	auto hmat = build_hmatrix(rows, cols, kernel_two_grid, &two_grid, params);
+
+	vector<double> x(n), xt(m), y0(m), yt0(n), y1(m), yt1(n);
+	for (int j = 0; j < n; j++) x[j] = sin(0.1 * j) + 0.5;
+	for (int i = 0; i < m; i++) xt[i] = cos(0.07 * i) - 0.2;
+	hmatrix_matvec(*hmat, x, y0);
+	hmatrix_matvec(*hmat, xt, yt0, true);
+
+	// Four threads regardless of the machine; row ranges of different threads must not overlap
+	int nbound = bind_threads(2);
+	hmatrix_first_touch(*hmat, 4);
+	int nparts = static_cast<int>(hmat->thread_part.size()) - 1;
+	bool disjoint = (hmat->thread_part.front() == 0) && (hmat->thread_part.back() == static_cast<int>(hmat->blocks.size()));
+	for (int t = 1; t < nparts; t++) {
+		int max_end = 0;
+		for (int b = hmat->thread_part[t - 1]; b < hmat->thread_part[t]; b++)
+			max_end = max(max_end, hmat->blocks[b].nstrtl + hmat->blocks[b].ndl);
+		disjoint = disjoint && (max_end <= hmat->blocks[hmat->thread_part[t]].nstrtl);
+	}
+	hmatrix_matvec(*hmat, x, y1);
+	hmatrix_matvec(*hmat, xt, yt1, true);
+	bind_threads(0);
+
+	double err = max(relative_difference(y1, y0), relative_difference(yt1, yt0));
+	cout << "  NUMA nodes: " << numa_node_count() << ", bound threads: " << nbound << endl;
+	cout << "  Thread partitions: " << nparts << (disjoint ? " (disjoint row ranges)" : " (OVERLAPPING)") << endl;
+	cout << "  Relative difference to dynamic schedule: " << err << endl;
+
+	return disjoint && (nparts > 1) && (err < 1e-13);
+}
+
+bool test_error_estimate() {
+	cout << "\n" << string(70, '-') << endl;
+	cout << "Test 16: Randomised Accuracy Estimate" << endl;
+	cout << string(70, '-') << endl;
+
+	vector<Point3D> points = make_jittered_grid(16, 16, 3);
+	int nd = points.size();
+	ShiftedLaplaceData kernel_data = {&points, 10.0};
+
+	vector<double> x(nd), y(nd), y_ref(nd, 0.0);
+	for (int j = 0; j < nd; j++) x[j] = ((j * 37) % 11 < 5) ? 1.0 : -1.0;
+	for (int i = 0; i < nd; i++)
+		for (int j = 0; j < nd; j++) y_ref[i] += kernel_shifted_laplace(i, j, &kernel_data) * x[j];
+
+	// The estimate on a few sampled rows follows the true error over several orders of magnitude
+	bool success = true;
+	double last_estimate = 1.0;
+	for (double eps : {1e-2, 1e-4, 1e-7}) {
+		ControlParams params;
+		params.leaf_size = 16;
+		params.eps_aca = eps;
+		params.max_rank = 50;
+		auto hmat = build_hmatrix(points, points, kernel_shifted_laplace, &kernel_data, params);
+		hmatrix_matvec(*hmat, x, y);
+		double err = relative_difference(y, y_ref);
+		double estimate = hmatrix_estimate_error(*hmat, kernel_shifted_laplace, &kernel_data, 48, 2);
+		cout << "  eps=" << eps << ": true error " << err << ", estimate " << estimate << endl;
+		success = success && (estimate < 10.0 * err) && (estimate > 0.1 * err) && (estimate < last_estimate);
+		last_estimate = estimate;
+	}
+	return success;
+}
+
+bool test_plan_hmatrix() {
+	cout << "\n" << string(70, '-') << endl;
+	cout << "Test 17: H-Matrix Cost Plan" << endl;
+	cout << string(70, '-') << endl;
+
+	ControlParams params;
+	params.leaf_size = 16;
+	params.eps_aca = 1e-6;
+
+	vector<Point3D> points = make_jittered_grid(16, 16, 3);
+	ShiftedLaplaceData kernel_data = {&points, 10.0};
+	HMatrixPlan plan = plan_hmatrix(points, points, kernel_shifted_laplace, &kernel_data, params, 16);
+	auto hmat = build_hmatrix(points, points, kernel_shifted_laplace, &kernel_data, params);
+
+	// Block structure is exact, storage is estimated from the sampled ranks
+	long long near_entries = 0, far_blocks = 0;
+	for (const LowRankBlock& block : hmat->blocks) {
+		if (block.is_lowrank()) far_blocks++;
+		else near_entries += static_cast<long long>(block.ndl) * block.ndt;
+	}
+	double stored = 0.0;
+	for (const LowRankBlock& block : hmat->blocks) stored += block.a1.size() + block.a2.size();
+	double ratio = plan.stored_entries() / stored;
+
+	cout << "  Near-field entries: plan " << plan.near_entries << ", built " << near_entries << endl;
+	cout << "  Low-rank blocks: plan " << plan.far_blocks << ", built " << far_blocks << endl;
+	cout << "  Sampled rank " << plan.mean_rank << ", built max rank " << hmat->ktmax << endl;
+	cout << "  Stored entries: plan / built = " << ratio << " (" << plan.sample_kernel_calls << " kernel calls, "
+	     << plan.kernel_time * 1e9 << " ns per call)" << endl;
+	cout << "  Estimated construction time " << plan.build_time * 1e3 << " ms" << endl;
+
+	return (plan.near_entries == near_entries) && (plan.far_blocks == far_blocks)
+		&& (ratio > 0.67) && (ratio < 1.5) && (plan.kernel_time > 0.0) && (plan.build_time > 0.0);
+}
+
+// ============================================================================
+// Test 18: Admissibility with Symmetry Images
+// ============================================================================
+
+double kernel_mirror_x(int i, int j, void* data) {
+	auto* d = static_cast<ShiftedLaplaceData*>(data);
+	const Point3D& p = (*d->points)[i];
+	const Point3D& q = (*d->points)[j];
+	Point3D image(-q.x, q.y, q.z);
+	double value = 1.0 / point_distance(p, image);
+	if (i == j) return value + d->diag;
+	return value + 1.0 / point_distance(p, q);
+}
+
+bool test_symmetry_images() {
+	cout << "\n" << string(70, '-') << endl;
+	cout << "Test 18: Admissibility with Symmetry Images" << endl;
+	cout << string(70, '-') << endl;
+
+	// Mirror x -> -x: A row-major, then b
+	ControlParams params;
+	params.leaf_size = 16;
+	params.eps_aca = 1e-6;
+	params.target_images.push_back({-1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0});
+
+	// Boxes well separated directly, but the mirror image of the second overlaps the first
+	BoundingBox b1(3), b2(3);
+	for (int d = 0; d < 3; d++) {
+		b1.min[d] = 0.0; b1.max[d] = 1.0;
+		b2.min[d] = 0.0; b2.max[d] = 1.0;
+	}
+	b1.min[0] = 3.0; b1.max[0] = 4.0;
+	b2.min[0] = -4.0; b2.max[0] = -3.0;
+	bool direct = is_admissible(b1, b2, params.eta);
+	bool with_images = is_admissible(b1, b2, params);
+
+	// Points near the mirror plane, kernel sums the direct and mirrored source
+	vector<Point3D> points = make_jittered_grid(6, 20, 5);
+	for (Point3D& p : points) p.x += 0.25;
+	int n = points.size();
+	ShiftedLaplaceData kernel_data = {&points, 10.0};
+	auto hmat = build_hmatrix(points, points, kernel_mirror_x, &kernel_data, params);
+
+	vector<double> x(n), y(n), y_ref(n, 0.0);
+	for (int i = 0; i < n; i++) x[i] = sin(0.1 * i) + 0.5;
+	hmatrix_matvec(*hmat, x, y);
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++) {
+			y_ref[i] += kernel_mirror_x(i, j, &kernel_data) * x[j];
+		}
+	}
+	double err = relative_difference(y, y_ref);
+
+	cout << "  Mirrored boxes admissible: direct " << (direct ? "Yes" : "No")
+	     << ", with images " << (with_images ? "Yes" : "No") << endl;
+	cout << "  Number of points: " << n << ", blocks: " << hmat->blocks.size() << endl;
+	cout << "  Relative matvec error: " << err << endl;
+
+	return direct && !with_images && (err < 1e-5);
+}
+
 // ============================================================================
 // Main
 // ============================================================================
@@ -401,6 +1163,18 @@ int main(int argc, char** argv) {
 	results.report("ACA Low-Rank Approximation", test_aca());
 	results.report("H-Matrix Construction", test_hmatrix_construction());
 	results.report("Matrix-Vector Multiplication", test_matvec());
+	results.report("Block-Cluster Tree H-Matrix", test_hmatrix_tree());
+	results.report("H-Matrix Addition and Multiplication", test_harith());
+	results.report("H-LU Factorisation and Solve", test_hlu());
+	results.report("Principal-Axis and Balanced Splitting", test_cluster_splitting());
+	results.report("H2-Matrix with Nested Cluster Bases", test_h2matrix());
+	results.report("Transposed Matrix-Vector Products", test_transposed_matvec());
+	results.report("Dense Block Kernels", test_dense_kernels());
+	results.report("Incremental H-Matrix Update", test_incremental_update());
+	results.report("NUMA Block Placement and Thread Binding", test_numa_placement());
+	results.report("Randomised Accuracy Estimate", test_error_estimate());
+	results.report("H-Matrix Cost Plan", test_plan_hmatrix());
+	results.report("Admissibility with Symmetry Images", test_symmetry_images());
 
 	// Print summary
 	results.summary();
@@ -10,6 +10,10 @@
 
 #include "radentry.h"
 #include "rad_io_buffer.h"
+#include "rad_yield.h"
+
+#include <vector>
+#include <algorithm>
 
 //DEBUG
 //#include <mpi.h>
@@ -22,6 +26,36 @@
 static bool g_SolverHMatrixEnabled = false;
 static double g_SolverHMatrixEps = 1e-4;  // Phase 1: Relaxed from 1e-6 for better compression
 static int g_SolverHMatrixMaxRank = 30;   // Phase 1: Reduced from 50 for better compression
+static double g_SolverHMatrixEta = 1.0;   // Admissibility parameter of the cluster tree
+static int g_SolverHMatrixLeafSize = 10;
+static int g_SolverHMatrixSplitType = 3;  // Principal axis, median split
+static bool g_SolverHMatrixH2 = false;    // Nested cluster bases
+static double g_SolverHMatrixTargetError = 0.;  // Auto-tuning of eps / max_rank (0: off)
+static double g_SolverHMatrixTunedTarget = 0.;  // Result of the last auto-tuning
+static double g_SolverHMatrixTunedEps = -1.;
+static int g_SolverHMatrixTunedMaxRank = 0;
+static double g_SolverHMatrixTunedError = -1.;
+static double g_SolverHLUEps = 1e-4;      // H-LU accuracy for relaxation method 9
+static int g_SolverHLUMaxRank = 50;
+static bool g_SolverNUMAFirstTouch = true;  // Interaction storage initialized by the threads using it
+static int g_SolverThreadBind = 0;         // OpenMP thread binding: 0 - none, 1 - close, 2 - spread
+static bool g_SolverAutoBackend = false;   // Cost-model choice of dense / H-matrix / H2-matrix
+static double g_SolverMemoryBudget = 0.;   // MB (0: half of the physical memory)
+static int g_SolverPlanIterations = 100;
+static std::vector<double> g_SolverPlan;   // Estimates of the last choice
+static int g_SolverElemOrder = 0;          // Relaxable element order: 0 - input, 1 - Morton, 2 - Hilbert
+static bool g_SolverFMMEnabled = false;    // Fast multipole interaction operator
+static int g_SolverFMMOrder = 8;
+static double g_SolverFMMTheta = 0.5;
+static int g_SolverFMMLeafSize = 16;
+
+//-------------------------------------------------------------------------
+// Relaxation telemetry / monitor
+//-------------------------------------------------------------------------
+
+static RadRelaxIterCallback g_RlxMonitorFunc = 0;
+static void* g_RlxMonitorUserData = 0;
+static std::vector<RadRelaxIterInfo> g_RlxTelemetry;
 
 //-------------------------------------------------------------------------
 
@@ -101,6 +135,7 @@ void ManualRelax( int, int, int, double );
 //void AutoRelax( int, double, int, int );
 void AutoRelaxOpt( int, double, int, int, const char* );
 void UpdateSourcesForRelax( int );
+void InteractMatrixProduct( int, double*, int, int );
 void SolveGen( int, double, int, int );
 
 void FieldArbitraryPointsArray( long, const char*, double**, long );
@@ -117,7 +152,7 @@ void FocusingKickPerFormStrRep( double*,double*,double*,double*,double*, int,int
 void ParticleTrajectory( int, double, double,double,double,double, double,double, int );
 void FieldInt( int, char*, char*, double,double,double, double,double,double );
 void CompCriterium( double, double, double, double, double,double );
-void CompPrecisionOpt( const char*, const char*, const char*, const char*, const char*, const char*, const char*, const char* );
+void CompPrecisionOpt( const char*, const char*, const char*, const char*, const char*, const char*, const char*, const char*, const char* );
 void PhysicalUnits();
 void RandomizationOnOrOff( char* );
 void TolForConvergence( double, double, double );
@@ -143,6 +178,7 @@ void ProcMPI( const char*, double*, long*, long*, long*);
 //-------------------------------------------------------------------------
 
 extern radTIOBuffer ioBuffer;
+extern radTYield radYield;
 //radTIOBuffer ioBuffer; //OC, to place back!!!
 
 //-------------------------------------------------------------------------
@@ -177,6 +213,26 @@ int CALL RadUtiYeldFuncSet(int (*pExtFunc)())
 	return OK;
 }
 
+//-------------------------------------------------------------------------
+
+int CALL RadUtiCancel(int cancel)
+{
+	if(cancel != 0) radYield.RequestCancel();
+	else radYield.ClearCancel();
+	return OK;
+}
+
+//-------------------------------------------------------------------------
+
+int CALL RadUtiProgress(long long* pDone, long long* pTotal)
+{
+	long long Done = 0, Total = 0;
+	radYield.ProgressGet(Done, Total);
+	if(pDone != 0) *pDone = Done;
+	if(pTotal != 0) *pTotal = Total;
+	return OK;
+}
+
 //-------------------------------------------------------------------------
 // Copied from AlpDllEntry.cpp
 const char* CALL RadErrGet(int er)
@@ -1030,6 +1086,22 @@ EXP int CALL RadRlxUpdSrc(int intrc)
 
 //-------------------------------------------------------------------------
 
+int CALL RadRlxMatVec(double* H, int* nH, int intrc, double* M, int nM, int trans)
+{
+	InteractMatrixProduct(intrc, M, nM, trans);
+
+	int ErrStat = ioBuffer.OutErrorStatus();
+	if(ErrStat > 0) return ErrStat;
+
+	int Dims[20];
+	int NumDims;
+	ioBuffer.OutMultiDimArrayOfDouble(H, Dims, NumDims);
+	*nH = (NumDims == 2)? Dims[0]*Dims[1] : 0;
+	return ErrStat;
+}
+
+//-------------------------------------------------------------------------
+
 int CALL RadFld(double* pB, int* pNb, int Obj, char* ID, double* pCoord, int Np)
 {
 	double **PointsArray = new double*[Np];
@@ -1310,8 +1382,8 @@ int CALL RadFldCmpCrt(int* n, double PrcB, double PrcA, double PrcBInt, double P
 int CALL RadFldCmpPrc(int* n, char* Opt)
 {
 	//const char *Opt1=0, *Opt2=0, *Opt3=0, *Opt4=0, *Opt5=0, *Opt6=0, *Opt7=0, *Opt8=0;
-	const char *arOpt[8]; //OC18122019
-	for(int i=0; i<8; i++) arOpt[i] = 0;
+	const char *arOpt[9]; //OC18122019
+	for(int i=0; i<9; i++) arOpt[i] = 0;
 	vector<string> AuxStrings;
 	if(Opt != 0)
 	{
@@ -1322,6 +1394,7 @@ int CALL RadFldCmpPrc(int* n, char* Opt)
 		CAuxParse::StringSplitNested(sOptLoc, ";,", AuxStrings);
 		delete[] sOptLoc;
 		int AmOfOpt = (int)AuxStrings.size();
+		if(AmOfOpt > 9) AmOfOpt = 9;
 		for(int j=0; j<AmOfOpt; j++) arOpt[j] = (AuxStrings[j]).c_str();
 
 		//char *SepStrArr[] = {(char*)";", (char*)","}; //OC04082018 (to please GCC 4.9)
@@ -1337,7 +1410,7 @@ int CALL RadFldCmpPrc(int* n, char* Opt)
 		//if(AmOfTokens > 7) Opt8 = (AuxStrings[7]).c_str();
 	}
 
-	CompPrecisionOpt(arOpt[0], arOpt[1], arOpt[2], arOpt[3], arOpt[4], arOpt[5], arOpt[6], arOpt[7]); //OC18122019
+	CompPrecisionOpt(arOpt[0], arOpt[1], arOpt[2], arOpt[3], arOpt[4], arOpt[5], arOpt[6], arOpt[7], arOpt[8]); //OC18122019
 	//CompPrecisionOpt(Opt1, Opt2, Opt3, Opt4, Opt5, Opt6, Opt7, Opt8);
 
 	*n = ioBuffer.OutInt();
@@ -1772,6 +1845,105 @@ int CALL RadSolverHMatrixDisable()
 
 //-------------------------------------------------------------------------
 
+int CALL RadSolverHMatrixClustering(double eta, int leaf_size, int split_type)
+{
+	if((eta <= 0.) || (leaf_size <= 0) || (split_type < 1) || (split_type > 3)) { ioBuffer.StoreErrorMessage("Radia::Error000"); return ioBuffer.OutErrorStatus();}
+	g_SolverHMatrixEta = eta;
+	g_SolverHMatrixLeafSize = leaf_size;
+	g_SolverHMatrixSplitType = split_type;
+	return 0;
+}
+
+//-------------------------------------------------------------------------
+
+int CALL RadSolverHMatrixH2(int enable)
+{
+	g_SolverHMatrixH2 = (enable != 0);
+	return 0;
+}
+
+//-------------------------------------------------------------------------
+
+int CALL RadSolverHMatrixAccuracy(double rel_error)
+{
+	if(rel_error < 0.) { ioBuffer.StoreErrorMessage("Radia::Error000"); return ioBuffer.OutErrorStatus();}
+	g_SolverHMatrixTargetError = rel_error;
+	return 0;
+}
+
+//-------------------------------------------------------------------------
+
+int CALL RadSolverHMatrixTuned(double* pEps, int* pMaxRank, double* pError)
+{
+	if(pEps != 0) *pEps = g_SolverHMatrixTunedEps;
+	if(pMaxRank != 0) *pMaxRank = g_SolverHMatrixTunedMaxRank;
+	if(pError != 0) *pError = g_SolverHMatrixTunedError;
+	return 0;
+}
+
+//-------------------------------------------------------------------------
+
+int CALL RadSolverHLU(double eps, int max_rank)
+{
+	if((eps <= 0.) || (max_rank <= 0)) { ioBuffer.StoreErrorMessage("Radia::Error000"); return ioBuffer.OutErrorStatus();}
+	g_SolverHLUEps = eps;
+	g_SolverHLUMaxRank = max_rank;
+	return 0;
+}
+
+//-------------------------------------------------------------------------
+
+int CALL RadSolverNUMA(int first_touch, int bind)
+{
+	if((bind < 0) || (bind > 2)) { ioBuffer.StoreErrorMessage("Radia::Error000"); return ioBuffer.OutErrorStatus();}
+	g_SolverNUMAFirstTouch = (first_touch != 0);
+	g_SolverThreadBind = bind;
+	return 0;
+}
+
+//-------------------------------------------------------------------------
+
+int CALL RadSolverAuto(int enable, double memory_mb, int iterations)
+{
+	if((memory_mb < 0.) || (iterations < 1)) { ioBuffer.StoreErrorMessage("Radia::Error000"); return ioBuffer.OutErrorStatus();}
+	g_SolverAutoBackend = (enable != 0);
+	g_SolverMemoryBudget = memory_mb;
+	g_SolverPlanIterations = iterations;
+	return 0;
+}
+
+//-------------------------------------------------------------------------
+
+int CALL RadSolverPlan(double* pData, int* n)
+{
+	if(n != 0) *n = (int)g_SolverPlan.size();
+	if(pData != 0) std::copy(g_SolverPlan.begin(), g_SolverPlan.end(), pData);
+	return 0;
+}
+
+//-------------------------------------------------------------------------
+
+int CALL RadSolverElemOrder(int curve)
+{
+	if((curve < 0) || (curve > 2)) { ioBuffer.StoreErrorMessage("Radia::Error000"); return ioBuffer.OutErrorStatus();}
+	g_SolverElemOrder = curve;
+	return 0;
+}
+
+//-------------------------------------------------------------------------
+
+int CALL RadSolverFMM(int enable, int order, double theta, int leaf_size)
+{
+	if((order < 1) || (order > 30) || (theta <= 0.) || (theta >= 1.) || (leaf_size < 1)) { ioBuffer.StoreErrorMessage("Radia::Error000"); return ioBuffer.OutErrorStatus();}
+	g_SolverFMMEnabled = (enable != 0);
+	g_SolverFMMOrder = order;
+	g_SolverFMMTheta = theta;
+	g_SolverFMMLeafSize = leaf_size;
+	return 0;
+}
+
+//-------------------------------------------------------------------------
+
 // Accessor functions for radTInteraction to read global settings
 bool RadSolverGetHMatrixEnabled()
 {
@@ -1788,6 +1960,151 @@ int RadSolverGetHMatrixMaxRank()
 	return g_SolverHMatrixMaxRank;
 }
 
+double RadSolverGetHMatrixEta()
+{
+	return g_SolverHMatrixEta;
+}
+
+int RadSolverGetHMatrixLeafSize()
+{
+	return g_SolverHMatrixLeafSize;
+}
+
+int RadSolverGetHMatrixSplitType()
+{
+	return g_SolverHMatrixSplitType;
+}
+
+bool RadSolverGetHMatrixH2()
+{
+	return g_SolverHMatrixH2;
+}
+
+double RadSolverGetHMatrixTargetError()
+{
+	return g_SolverHMatrixTargetError;
+}
+
+bool RadSolverGetHMatrixTunedStart(double target, double& eps, int& max_rank)
+{
+	if((g_SolverHMatrixTunedEps <= 0.) || (g_SolverHMatrixTunedTarget != target)) return false;
+	eps = g_SolverHMatrixTunedEps;
+	max_rank = g_SolverHMatrixTunedMaxRank;
+	return true;
+}
+
+void RadSolverSetHMatrixTuned(double target, double eps, int max_rank, double est_error)
+{
+	g_SolverHMatrixTunedTarget = target;
+	g_SolverHMatrixTunedEps = eps;
+	g_SolverHMatrixTunedMaxRank = max_rank;
+	g_SolverHMatrixTunedError = est_error;
+}
+
+double RadSolverGetHLUEps()
+{
+	return g_SolverHLUEps;
+}
+
+int RadSolverGetHLUMaxRank()
+{
+	return g_SolverHLUMaxRank;
+}
+
+bool RadSolverGetNUMAFirstTouch()
+{
+	return g_SolverNUMAFirstTouch;
+}
+
+int RadSolverGetThreadBind()
+{
+	return g_SolverThreadBind;
+}
+
+bool RadSolverGetAutoBackend()
+{
+	return g_SolverAutoBackend;
+}
+
+double RadSolverGetMemoryBudget()
+{
+	return g_SolverMemoryBudget;
+}
+
+int RadSolverGetPlanIterations()
+{
+	return g_SolverPlanIterations;
+}
+
+void RadSolverSetPlan(const double* pData, int n)
+{
+	g_SolverPlan.assign(pData, pData + n);
+}
+
+int RadSolverGetElemOrder()
+{
+	return g_SolverElemOrder;
+}
+
+bool RadSolverGetFMMEnabled()
+{
+	return g_SolverFMMEnabled;
+}
+
+int RadSolverGetFMMOrder()
+{
+	return g_SolverFMMOrder;
+}
+
+double RadSolverGetFMMTheta()
+{
+	return g_SolverFMMTheta;
+}
+
+int RadSolverGetFMMLeafSize()
+{
+	return g_SolverFMMLeafSize;
+}
+
+//-------------------------------------------------------------------------
+// Relaxation telemetry / monitor
+//-------------------------------------------------------------------------
+
+int CALL RadRlxMonitor(RadRelaxIterCallback cb, void* user_data)
+{
+	g_RlxMonitorFunc = cb;
+	g_RlxMonitorUserData = (cb != 0)? user_data : 0;
+	return 0;
+}
+
+//-------------------------------------------------------------------------
+
+int CALL RadRlxTelemetry(RadRelaxIterInfo* pInfo, int* n)
+{
+	int nRec = (int)g_RlxTelemetry.size();
+	if(pInfo != 0)
+	{
+		for(int i=0; i<nRec; i++) pInfo[i] = g_RlxTelemetry[i];
+	}
+	if(n != 0) *n = nRec;
+	return 0;
+}
+
+//-------------------------------------------------------------------------
+
+// Accessor functions for the relaxation methods to report telemetry
+void RadRlxTelemetryReset()
+{
+	g_RlxTelemetry.clear();
+}
+
+bool RadRlxTelemetryPush(const RadRelaxIterInfo& info)
+{
+	g_RlxTelemetry.push_back(info);
+	if(g_RlxMonitorFunc == 0) return true;
+	return (g_RlxMonitorFunc(&info, g_RlxMonitorUserData) == 0);
+}
+
 //-------------------------------------------------------------------------
 
 int CALL RadPreRelax(int* n, int ElemKey, int SrcElemKey)
@@ -402,10 +402,106 @@ EXP int CALL RadSolverHMatrixCacheFull(int enable);
 EXP int CALL RadSolverHMatrixCacheSize(int max_mb);
 EXP int CALL RadSolverHMatrixCacheCleanup(int days);
 
+/** Sets the cluster tree parameters of the H-matrix used by the relaxation solver (see RadSolverHMatrixEnable).
+@param eta [in] admissibility parameter: a block is low-rank if the distance of its clusters is at least eta times the smaller cluster diameter (default 1.0)
+@param leaf_size [in] maximum number of elements in a leaf cluster (default 10)
+@param split_type [in] cluster splitting: 1 - longest bounding-box edge at its midpoint, 2 - principal axis of the element centers at the midpoint, 3 - principal axis at the median, i.e. halves of equal size (default 3)
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/
+EXP int CALL RadSolverHMatrixClustering(double eta, int leaf_size, int split_type);
+
+/** Selects the storage of the H-matrix used by the relaxation solver (see RadSolverHMatrixEnable).
+@param enable [in] 1 - H2-matrix: the low-rank blocks are recompressed into nested row and column cluster bases shared by all blocks of a cluster, so that storage and matrix-vector products grow as O(N) instead of O(N log N); 0 - H-matrix with independent low-rank factors per block (default)
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/
+EXP int CALL RadSolverHMatrixH2(int enable);
+
+/** Sets the target accuracy for which the H-matrix of the relaxation solver is tuned automatically (see RadSolverHMatrixEnable).
+At each relaxation setup, H-matrices are built with decreasing (or, if the target is met by a wide margin, once with increasing) ACA tolerance, and the maximal rank is doubled when it limits the accuracy. Their error is estimated by comparing the products with random magnetization vectors to exact products on randomly sampled rows, and the trial with the least storage meeting the target is used. The next relaxation starts from the parameters selected before.
+@param rel_error [in] target relative error of the interaction matrix products (e.g. 1e-3); 0 - no tuning, eps and max_rank of RadSolverHMatrixEnable are used (default); tuning is also done (with target 1e-3) if eps <= 0 is given to RadSolverHMatrixEnable
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/
+EXP int CALL RadSolverHMatrixAccuracy(double rel_error);
+
+/** Returns the H-matrix parameters selected by the last automatically tuned relaxation (see RadSolverHMatrixAccuracy).
+@param pEps [out] ACA tolerance (-1 if no relaxation was tuned)
+@param pMaxRank [out] maximal rank
+@param pError [out] estimated relative error of the interaction matrix products
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/
+EXP int CALL RadSolverHMatrixTuned(double* pEps, int* pMaxRank, double* pError);
+
+/** Sets the accuracy of the H-LU factorization used by relaxation method 9 (secant/Newton iteration with an H-LU factorized linearized system).
+@param eps [in] relative truncation accuracy of low-rank blocks in the H-matrix and its LU factors (default 1e-4)
+@param max_rank [in] maximum rank of low-rank blocks (default 50)
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/
+EXP int CALL RadSolverHLU(double eps, int max_rank);
+
+/** Sets the memory placement and thread binding used by the relaxation on NUMA (multi-socket) machines.
+@param first_touch [in] 1 - the dense interaction matrix and the H-matrix blocks are initialized by the thread that multiplies them in the relaxation (static row partition), so that their memory is on that thread's NUMA node (default); 0 - allocated by the calling thread
+@param bind [in] binding of the OpenMP threads to CPUs at the next relaxation setup (Linux): 0 - no binding / release a previous binding (default), 1 - close (fill NUMA nodes one after another), 2 - spread (round-robin over NUMA nodes)
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/
+EXP int CALL RadSolverNUMA(int first_touch, int bind);
+
+/** Enables the automatic choice of the relaxation interaction backend (dense matrix, H-matrix or H2-matrix) from a cost model.
+At each relaxation setup, the block structure of the H-matrix, the ACA ranks of a few sampled low-rank blocks, the time of the interaction kernel and the speed of matrix-vector products are measured; the backend with the least construction time + iterations * time per iteration whose memory fits into the budget is used (if none fits, the one with the least memory). The estimates of the last choice are returned by RadSolverPlan.
+@param enable [in] 1 - choose automatically (overrides RadSolverHMatrixEnable / RadSolverHMatrixH2), 0 - off (default)
+@param memory_mb [in] memory budget of the interaction operator in MB; 0 - half of the physical memory (default)
+@param iterations [in] expected number of relaxation iterations (default 100)
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/
+EXP int CALL RadSolverAuto(int enable, double memory_mb, int iterations);
+
+/** Returns the cost estimates of the last automatic backend choice (see RadSolverAuto).
+@param pData [out] array of *n values (may be 0 to query n): chosen backend (0 - dense, 1 - H-matrix, 2 - H2-matrix), kernel time per 3x3 block [s], matrix streaming rate [bytes/s], construction time [s] of the 3 backends, time per iteration [s] of the 3 backends, memory [bytes] of the 3 backends, memory budget [bytes], iterations, sampled mean rank
+@param n [out] number of values (0 if no choice was made yet)
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/
+EXP int CALL RadSolverPlan(double* pData, int* n);
+
+/** Sets the order of the relaxable elements in interaction objects created afterwards (RadSolve, RadRlxPre).
+Sorting the elements along a space-filling curve through their centres places elements near in space next to each other in the interaction matrix, the magnetization and field arrays and the H-matrix cluster order. Arrays passed to or returned by interaction functions (RadRlxMatVec, matrix and vector output) keep the input order. Interactions containing subdivided blocks relaxed together keep the input order; RadSetRelaxSubInterval is not supported for reordered interactions.
+@param curve [in] 0 - input order of the group tree (default), 1 - Morton (Z-order) curve, 2 - Hilbert curve
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/
+EXP int CALL RadSolverElemOrder(int curve);
+
+/** Enables the fast multipole method (FMM) as interaction operator of the relaxation (instead of the dense matrix or the H-matrix).
+The far field of the magnetized elements and all their symmetry images is evaluated from Cartesian Taylor expansions about the clusters of a tree of element centres, with the exact multipole moments of parallelepipeds and polyhedra (other shapes as point dipoles); pairs of elements in leaf clusters that are not well separated interact through their exact 3x3 interaction blocks, which are the only blocks stored. Construction, memory and matrix-vector products grow as O(N). Interactions containing subdivided blocks relaxed together use the H-matrix instead.
+@param enable [in] 1 - use the FMM (overrides RadSolverHMatrixEnable and RadSolverAuto), 0 - off (default)
+@param order [in] expansion order (total degree of the Taylor series, default 8)
+@param theta [in] separation ratio: two clusters of radii r1, r2 interact through expansions if r1 + r2 < theta * distance of their centres, 0 < theta < 1 (default 0.5)
+@param leaf_size [in] maximum number of elements in a leaf cluster (default 16)
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/
+EXP int CALL RadSolverFMM(int enable, int order, double theta, int leaf_size);
+
 // Accessor functions for global H-matrix solver settings
 bool RadSolverGetHMatrixEnabled();
 double RadSolverGetHMatrixEps();
 int RadSolverGetHMatrixMaxRank();
+double RadSolverGetHMatrixEta();
+int RadSolverGetHMatrixLeafSize();
+int RadSolverGetHMatrixSplitType();
+bool RadSolverGetHMatrixH2();
+double RadSolverGetHMatrixTargetError();
+bool RadSolverGetHMatrixTunedStart(double target, double& eps, int& max_rank); // parameters tuned before for the same target
+void RadSolverSetHMatrixTuned(double target, double eps, int max_rank, double est_error);
+double RadSolverGetHLUEps();
+int RadSolverGetHLUMaxRank();
+bool RadSolverGetNUMAFirstTouch();
+int RadSolverGetThreadBind();
+bool RadSolverGetAutoBackend();
+double RadSolverGetMemoryBudget(); // MB, 0 - half of the physical memory
+int RadSolverGetPlanIterations();
+void RadSolverSetPlan(const double* pData, int n);
+int RadSolverGetElemOrder();
+bool RadSolverGetFMMEnabled();
+int RadSolverGetFMMOrder();
+double RadSolverGetFMMTheta();
+int RadSolverGetFMMLeafSize();
 
 // Relaxation sub-interval control for LU decomposition solver
 EXP int CALL RadPreRelax(int* n, int ElemKey, int SrcElemKey);
@@ -819,6 +915,18 @@ EXP int CALL RadRlxAuto(double* D, int* n, int intrc, double prec, int iter, int
 */
 EXP int CALL RadRlxUpdSrc(int intrc);
 
+/** Multiplies a magnetization vector by the interaction matrix intrc or by its transpose, without the external field.
+The product uses the stored dense or H-matrix representation; no re-assembly is needed for the transposed (adjoint) product.
+@param H [out] field strength at the relaxable elements, 3 components per element (array of length nM)
+@param nH [out] length of array H
+@param intrc [in] an integer number referencing the interaction object
+@param M [in] magnetization of the relaxable elements, 3 components per element
+@param nM [in] length of array M (3 times the number of relaxable elements)
+@param trans [in] 0: H = N*M, 1: H = N^T*M
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/
+EXP int CALL RadRlxMatVec(double* H, int* nH, int intrc, double* M, int nM, int trans);
+
 /** Builds an interaction matrix and performs a relaxation procedure. 
 The relaxation stops whenever the change of magnetization (averaged over all sub-elements) between two successive iterations is smaller than prec or the number of iterations is larger than iter. The interaction matrix is deleted. 
 @param D [out] an array of four numbers specifying: [0] average absolute change in magnetization after previous iteration over all the objects participating in the relaxation, [1] maximum absolute value of magnetization over all the objects participating in the relaxation, [2] maximum absolute value of magnetic field strength over central points of all the objects participating in the relaxation, and [3] actual number of iterations done. The values [0]-[2] are those of last iteration.
@@ -832,6 +940,39 @@ The relaxation stops whenever the change of magnetization (averaged over all sub
 */ 
 EXP int CALL RadSolve(double* D, int* n, int obj, double prec, int iter, int meth);
 
+/** Per-iteration relaxation telemetry record (filled by the automatic relaxation methods 3, 4, 5, 8).
+*/
+typedef struct {
+	int iter; /* iteration number (starting from 1) */
+	double misfit; /* average absolute change in magnetization after this iteration */
+	double sweep_time; /* wall time of the iteration (sweep over all elements) [s] */
+	double matvec_time; /* part of sweep_time spent on interaction matrix - magnetization products [s] */
+	int num_changed; /* number of elements whose magnetization changed by more than the requested precision */
+	int num_elem; /* total number of relaxable elements */
+} RadRelaxIterInfo;
+
+/** Relaxation monitor callback; a non-zero return value terminates the relaxation after the current iteration.
+*/
+typedef int (CALL *RadRelaxIterCallback)(const RadRelaxIterInfo* info, void* user_data);
+
+/** Sets a callback to be called after every iteration of automatic relaxation (RadRlxAuto, RadSolve).
+@param cb [in] callback function, or 0 to remove the current callback
+@param user_data [in] pointer passed back to the callback unchanged
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/
+EXP int CALL RadRlxMonitor(RadRelaxIterCallback cb, void* user_data);
+
+/** Retrieves telemetry records of the last automatic relaxation.
+@param pInfo [out] array of records (should be allocated by calling function); if 0, only the number of records is returned
+@param n [out] number of records available
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/
+EXP int CALL RadRlxTelemetry(RadRelaxIterInfo* pInfo, int* n);
+
+// Accessor functions for the relaxation methods to report telemetry
+void RadRlxTelemetryReset();
+bool RadRlxTelemetryPush(const RadRelaxIterInfo& info); // returns false if termination was requested
+
 /** Computes magnetic field created by the object obj at one or many points.
 @param B [out] flat array of all computed values of the magnetic field components (should be allocated by calling function)
 @param nB [out] total number of calculated magnetic field component values
@@ -1152,6 +1293,20 @@ EXP int CALL RadUtiMPI(int* arPar, char* OnOrOff, double* arData=0, long* pnData
 
 EXP int CALL RadUtiYeldFuncSet(int (*pExtFunc)());
 
+/** Requests cancellation of the current computation (field, interaction matrix or relaxation); can be called from another thread or a signal handler.
+The computation stops at the next loop boundary and returns error 998 (execution aborted by user); the request is cleared when it is reported.
+@param cancel [in] 1 to request cancellation, 0 to withdraw a request that was not reported yet
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/ 
+EXP int CALL RadUtiCancel(int cancel);
+
+/** Reports the progress of the current (or last) computation: points of a field list, columns of an interaction matrix or relaxation iterations (out of the maximal number).
+@param pDone [out] number of completed items
+@param pTotal [out] total number of items
+@return integer error code (0 : no error, >0 : error number, <0 : warning number)
+*/ 
+EXP int CALL RadUtiProgress(long long* pDone, long long* pTotal);
+
 #ifdef __cplusplus  
 }
 #endif
@@ -16,13 +16,18 @@
 #include "radentry_hmat.h"
 #include "rad_application.h"
 #include "rad_hmatrix.h"
+#include "rad_intrc_hmat.h"
+#include "rad_fmm.h"
+#include "rad_field_batch.h"
 #include "rad_group.h"
 #include "rad_geometry_base.h"
 #include "rad_type_cast.h"
 #include "gmvect.h"
 #include <cstring>
+#include <fstream>
 #include <map>
 #include <memory>
+#include <vector>
 
 //-------------------------------------------------------------------------
 
@@ -35,9 +40,12 @@ extern radTApplication rad;
 struct HMatrixFieldGlobalState {
 	bool enabled;
 	double epsilon;
+	double eta;
+	int leaf_size;
+	int split_type;
 	std::map<int, std::shared_ptr<radTHMatrixFieldEvaluator>> cache;
 
-	HMatrixFieldGlobalState() : enabled(false), epsilon(1e-6) {}
+	HMatrixFieldGlobalState() : enabled(false), epsilon(1e-6), eta(2.0), leaf_size(10), split_type(3) {}
 
 	void Clear() {
 		cache.clear();
@@ -59,6 +67,9 @@ struct HMatrixFieldGlobalState {
 
 		radTHMatrixConfig config;
 		config.eps = epsilon;
+		config.eta = eta;
+		config.min_cluster_size = leaf_size;
+		config.split_type = split_type;
 
 		auto evaluator = std::make_shared<radTHMatrixFieldEvaluator>(config);
 
@@ -71,6 +82,7 @@ struct HMatrixFieldGlobalState {
 };
 
 static HMatrixFieldGlobalState g_hmatrix_field_state;
+static int g_hmatrix_updated_elem = -1;  // Elements recomputed by the incremental update of the last relaxation H-matrix (-1: full build)
 
 //-------------------------------------------------------------------------
 // API Implementation
@@ -118,8 +130,15 @@ EXP int CALL RadFldBatch(double* B, int* nB, int obj, char* id, double* Coords,
 
 		std::vector<TVector3d> field_out;
 
+		// Fast multipole method (H and B only; built for this call, settings of RadSolverFMM)
+		bool fmm_done = false;
+		if((use_hmatrix == 2) && ((field_comp == 'h') || (field_comp == 'b'))) {
+			radTFMMFieldEvaluator evaluator(RadSolverGetFMMOrder(), RadSolverGetFMMTheta(), RadSolverGetFMMLeafSize());
+			fmm_done = (evaluator.EvaluateField(g3d, obs_points, field_out, field_comp) != 0);
+		}
+
 		// Decide whether to use H-matrix
-		bool should_use_hmatrix = (use_hmatrix != 0) && g_hmatrix_field_state.enabled;
+		bool should_use_hmatrix = (use_hmatrix != 0) && (use_hmatrix != 2) && g_hmatrix_field_state.enabled;
 
 		if(should_use_hmatrix && group) {
 			// Try H-matrix accelerated evaluation
@@ -138,8 +157,20 @@ EXP int CALL RadFldBatch(double* B, int* nB, int obj, char* id, double* Coords,
 			should_use_hmatrix = false;
 		}
 
-		// Fallback to direct calculation if H-matrix not used
-		if(!should_use_hmatrix) {
+		// Homogeneous sets of magnetized blocks: batch kernel over all points, block by block
+		bool batch_done = false;
+		if(!should_use_hmatrix && !fmm_done && ((field_comp == 'h') || (field_comp == 'b'))) {
+			radTRecMagBatchField batch;
+			if(batch.Setup(g3d, false)) {
+				field_out.resize(np);
+				if(field_comp == 'b') batch.Compute(obs_points.data(), np, nullptr, field_out.data());
+				else batch.Compute(obs_points.data(), np, field_out.data(), nullptr);
+				batch_done = true;
+			}
+		}
+
+		// Fallback to direct calculation if H-matrix (or FMM) not used
+		if(!should_use_hmatrix && !fmm_done && !batch_done) {
 			field_out.resize(np, TVector3d(0, 0, 0));
 
 			// Direct calculation using existing Radia functions
@@ -206,9 +237,26 @@ EXP int CALL RadSetHMatrixFieldEval(int enabled, double tol)
 
 //-------------------------------------------------------------------------
 
+EXP int CALL RadSetHMatrixFieldEvalClustering(double eta, int leaf_size, int split_type)
+{
+	if(eta <= 0 || leaf_size <= 0 || split_type < 1 || split_type > 3) {
+		return -1;  // Error
+	}
+
+	g_hmatrix_field_state.eta = eta;
+	g_hmatrix_field_state.leaf_size = leaf_size;
+	g_hmatrix_field_state.split_type = split_type;
+	g_hmatrix_field_state.Clear();  // Cached H-matrices were built with the old tree
+
+	return 0;  // Success
+}
+
+//-------------------------------------------------------------------------
+
 EXP int CALL RadClearHMatrixCache(void)
 {
 	g_hmatrix_field_state.Clear();
+	radTHMatrixInteraction::ReleaseUpdateCache();
 	return 0;  // Success
 }
 
@@ -221,6 +269,7 @@ EXP int CALL RadGetHMatrixStats(double* stats, int* nstats)
 	// stats[0] = is_enabled
 	// stats[1] = num_cached
 	// stats[2] = total_memory_MB
+	// stats[3] = num_updated_elem (relaxation H-matrix)
 
 	stats[0] = g_hmatrix_field_state.enabled ? 1.0 : 0.0;
 	stats[1] = static_cast<double>(g_hmatrix_field_state.cache.size());
@@ -232,14 +281,120 @@ EXP int CALL RadGetHMatrixStats(double* stats, int* nstats)
 		}
 	}
 	stats[2] = total_memory / (1024.0 * 1024.0);  // Convert to MB
+	stats[3] = static_cast<double>(g_hmatrix_updated_elem);
 
-	*nstats = 3;
+	*nstats = 4;
 
 	return 0;  // Success
 }
 
 //-------------------------------------------------------------------------
 
+// Per-block report of the last built H-matrices, [0]: relaxation, [1]: field evaluation
+static std::vector<RadHMatrixBlockInfo> g_hmatrix_report[2];
+static bool g_hmatrix_report_stats = false;  // Count kernel calls and estimate block errors during construction
+
+void RadHMatrixReportReset(int source)
+{
+	if(source >= 0 && source < 2) g_hmatrix_report[source].clear();
+}
+
+void RadHMatrixReportPush(const RadHMatrixBlockInfo* pInfo)
+{
+	if(pInfo && pInfo->source >= 0 && pInfo->source < 2) g_hmatrix_report[pInfo->source].push_back(*pInfo);
+}
+
+void RadHMatrixReportUpdatedElem(int num_updated_elem)
+{
+	g_hmatrix_updated_elem = num_updated_elem;
+}
+
+bool RadHMatrixReportStatsEnabled()
+{
+	return g_hmatrix_report_stats;
+}
+
+//-------------------------------------------------------------------------
+
+EXP int CALL RadHMatrixReportStats(int on)
+{
+	g_hmatrix_report_stats = (on != 0);
+	return 0;
+}
+
+//-------------------------------------------------------------------------
+
+EXP int CALL RadHMatrixReport(RadHMatrixBlockInfo* pInfo, int* n)
+{
+	int nRec = 0;
+	for(int src = 0; src < 2; src++) {
+		for(const RadHMatrixBlockInfo& info : g_hmatrix_report[src]) {
+			if(pInfo) pInfo[nRec] = info;
+			nRec++;
+		}
+	}
+	if(n) *n = nRec;
+	return 0;
+}
+
+//-------------------------------------------------------------------------
+
+EXP int CALL RadHMatrixReportJSON(char* fileName)
+{
+	if(!fileName) return -1;
+	std::ofstream out(fileName);
+	if(!out) return -1;
+	out.precision(9);
+
+	const char* src_names[] = {"relaxation", "field"};
+	out << "{\n";
+	for(int src = 0; src < 2; src++) {
+		// Near / far-field breakdown and rank histogram of low-rank blocks
+		int nb[2] = {0, 0}, max_rank = 0;
+		long long calls[2] = {0, 0};
+		double mem[2] = {0., 0.}, time[2] = {0., 0.}, max_err = 0.;
+		std::vector<int> hist;
+		for(const RadHMatrixBlockInfo& info : g_hmatrix_report[src]) {
+			int f = info.low_rank ? 1 : 0;
+			nb[f]++; calls[f] += info.kernel_calls; mem[f] += info.memory; time[f] += info.build_time;
+			if(!f) continue;
+			if(info.rank >= (int)hist.size()) hist.resize(info.rank + 1, 0);
+			hist[info.rank]++;
+			if(info.rank > max_rank) max_rank = info.rank;
+			if(info.est_error > max_err) max_err = info.est_error;
+		}
+
+		out << "  \"" << src_names[src] << "\": {\n";
+		const char* part_names[] = {"near", "far"};
+		for(int f = 0; f < 2; f++) {
+			out << "    \"" << part_names[f] << "\": {\"blocks\": " << nb[f] << ", \"memory\": " << mem[f]
+			    << ", \"kernel_calls\": " << calls[f] << ", \"build_time\": " << time[f];
+			if(f) out << ", \"max_rank\": " << max_rank << ", \"max_est_error\": " << max_err;
+			out << "},\n";
+		}
+		out << "    \"rank_histogram\": [";
+		for(size_t k = 0; k < hist.size(); k++) out << (k ? ", " : "") << hist[k];
+		out << "],\n    \"blocks\": [";
+		bool first = true;
+		for(const RadHMatrixBlockInfo& info : g_hmatrix_report[src]) {
+			out << (first ? "\n" : ",\n") << "      {\"comp\": " << info.comp
+			    << ", \"row_start\": " << info.row_start << ", \"rows\": " << info.num_rows
+			    << ", \"col_start\": " << info.col_start << ", \"cols\": " << info.num_cols
+			    << ", \"low_rank\": " << info.low_rank << ", \"rank\": " << info.rank
+			    << ", \"kernel_calls\": " << info.kernel_calls << ", \"build_time\": " << info.build_time
+			    << ", \"est_error\": " << info.est_error << ", \"est_norm\": " << info.est_norm
+			    << ", \"memory\": " << info.memory << "}";
+			first = false;
+		}
+		out << (first ? "]\n" : "\n    ]\n") << "  }" << (src == 0 ? ",\n" : "\n");
+	}
+	out << "}\n";
+
+	return out.good() ? 0 : -1;
+}
+
+//-------------------------------------------------------------------------
+
 EXP int CALL RadUpdateHMatrixMagnetization(int obj)
 {
 	try {
@@ -31,7 +31,8 @@ extern "C" {
 * @param id [in] field type: "bx|by|bz|hx|hy|hz|b|h" etc.
 * @param Coords [in] observation points, flattened array [x1,y1,z1,x2,y2,z2,...]
 * @param np [in] number of observation points
-* @param use_hmatrix [in] 0=direct calculation, 1=H-matrix (if available)
+* @param use_hmatrix [in] 0=direct calculation, 1=H-matrix (if available), 2=fast multipole method for H and B
+*        (magnetized elements and their symmetry images by expansions, exact fields near them; parameters of RadSolverFMM)
 * @return integer error code (0: no error, >0: error number, <0: warning number)
 */
 EXP int CALL RadFldBatch(double* B, int* nB, int obj, char* id, double* Coords, int np, int use_hmatrix);
@@ -47,9 +48,21 @@ EXP int CALL RadFldBatch(double* B, int* nB, int obj, char* id, double* Coords,
 */
 EXP int CALL RadSetHMatrixFieldEval(int enabled, double tol);
 
+/** Set cluster tree parameters of H-matrix field evaluation
+*
+* Clears the H-matrix cache.
+*
+* @param eta [in] admissibility parameter: distance >= eta * smaller cluster diameter (default: 2.0)
+* @param leaf_size [in] maximum number of source elements in a leaf cluster (default: 10)
+* @param split_type [in] 1=longest bounding-box edge at midpoint, 2=principal axis at midpoint, 3=principal axis at median (default: 3)
+* @return integer error code (0: no error, -1: invalid argument)
+*/
+EXP int CALL RadSetHMatrixFieldEvalClustering(double eta, int leaf_size, int split_type);
+
 /** Clear H-matrix field evaluation cache
 *
-* Frees memory used by H-matrix cache.
+* Frees memory used by H-matrix cache, including the relaxation H-matrices
+* kept for incremental updates in the next relaxation.
 * Should be called after geometry modifications.
 *
 * @return integer error code (0: no error, >0: error number, <0: warning number)
@@ -58,14 +71,70 @@ EXP int CALL RadClearHMatrixCache(void);
 
 /** Get H-matrix field evaluation statistics
 *
-* Returns information about H-matrix cache usage.
+* Returns information about H-matrix cache usage and the number of elements recomputed
+* by the incremental update of the last relaxation H-matrix (-1: fully built).
 *
-* @param stats [out] array of statistics [is_enabled, num_cached, total_memory_MB, ...]
+* @param stats [out] array of statistics [is_enabled, num_cached, total_memory_MB, num_updated_elem]
 * @param nstats [out] number of statistics returned
 * @return integer error code (0: no error, >0: error number, <0: warning number)
 */
 EXP int CALL RadGetHMatrixStats(double* stats, int* nstats);
 
+/** Construction record of one H-matrix leaf block
+*/
+typedef struct {
+	int source; /* 0: relaxation interaction matrix, 1: field evaluation */
+	int comp; /* component: 3*row+col of the 3x3 interaction tensor (relaxation), 0/1/2 for x/y/z (field evaluation) */
+	int row_start, num_rows; /* rows of the block (cluster order) */
+	int col_start, num_cols; /* columns of the block (cluster order) */
+	int low_rank; /* 1: low-rank (far field), 0: full (near field) */
+	int rank; /* rank of a low-rank block, 0 for full blocks */
+	long long kernel_calls; /* kernel evaluations during construction (0 unless RadHMatrixReportStats(1)) */
+	double build_time; /* construction wall time [s] */
+	double est_error; /* relative Frobenius error estimated on sampled rows (0 for full blocks and unless RadHMatrixReportStats(1)) */
+	double est_norm; /* Frobenius norm of a low-rank block estimated on the same rows (0 for full blocks) */
+	double memory; /* storage [bytes] */
+} RadHMatrixBlockInfo;
+
+/** Record construction statistics of the H-matrix blocks built from now on
+*
+* When enabled, the kernel evaluations of every leaf block are counted and the relative error
+* and norm of low-rank blocks are estimated on four sampled rows (kernel_calls, est_error, est_norm
+* of RadHMatrixBlockInfo). Otherwise these fields are 0, which keeps the construction free of the
+* extra kernel calls and wrapper overhead.
+*
+* @param on [in] 1: record, 0: do not record (default)
+* @return integer error code (0: no error)
+*/
+EXP int CALL RadHMatrixReportStats(int on);
+
+/** Get per-block report of the last built H-matrices
+*
+* Contains the blocks of the last relaxation interaction matrix (H-matrix storage)
+* followed by those of the last H-matrix field evaluation.
+*
+* @param pInfo [out] array of records (should be allocated by calling function); if 0, only the number of records is returned
+* @param n [out] number of records available
+* @return integer error code (0: no error, >0: error number, <0: warning number)
+*/
+EXP int CALL RadHMatrixReport(RadHMatrixBlockInfo* pInfo, int* n);
+
+/** Write per-block H-matrix report to a JSON file
+*
+* The file contains a near/far-field summary, the rank histogram of low-rank blocks
+* and all block records of RadHMatrixReport().
+*
+* @param fileName [in] output file name
+* @return integer error code (0: no error, -1: file could not be written)
+*/
+EXP int CALL RadHMatrixReportJSON(char* fileName);
+
+// Accessor functions for the H-matrix builders to report blocks
+void RadHMatrixReportReset(int source);
+void RadHMatrixReportPush(const RadHMatrixBlockInfo* pInfo);
+void RadHMatrixReportUpdatedElem(int num_updated_elem);
+bool RadHMatrixReportStatsEnabled();
+
 /** Update magnetization without rebuilding H-matrix
 *
 * Fast update for non-linear relaxation: updates magnetic moments while keeping
@@ -62,10 +62,15 @@ static PyObject* radia_SetHMatrixFieldEval(PyObject* self, PyObject* args)
 	{
 		int enabled = 0;
 		double tol = 1e-6;  // HACApK ACA tolerance
+		double eta = 2.0;   // Admissibility parameter
+		int leaf_size = 10;
+		int split_type = 3; // Principal axis, median split
 
-		if(!PyArg_ParseTuple(args, "i|d:SetHMatrixFieldEval", &enabled, &tol))
+		if(!PyArg_ParseTuple(args, "i|ddii:SetHMatrixFieldEval", &enabled, &tol, &eta, &leaf_size, &split_type))
 			throw CombErStr(strEr_BadFuncArg, ": SetHMatrixFieldEval");
 
+		if(RadSetHMatrixFieldEvalClustering(eta, leaf_size, split_type) != 0)
+			throw CombErStr(strEr_BadFuncArg, ": SetHMatrixFieldEval");
 		g_pyParse.ProcRes(RadSetHMatrixFieldEval(enabled, tol));
 
 		Py_RETURN_NONE;
@@ -128,6 +133,103 @@ static PyObject* radia_GetHMatrixStats(PyObject* self, PyObject* args)
 	return oRes;
 }
 
+//-------------------------------------------------------------------------
+// HMatrixReport - Per-block H-matrix report
+//-------------------------------------------------------------------------
+static PyObject* HMatrixReportToPyDict(const std::vector<RadHMatrixBlockInfo>& vInfo, int source)
+{
+	PyObject *oBlocks = PyList_New(0);
+	PyObject *oHist = PyList_New(0);
+	if(!oBlocks || !oHist) { Py_XDECREF(oBlocks); Py_XDECREF(oHist); return NULL; }
+
+	// Near / far-field breakdown and rank histogram of low-rank blocks
+	int nb[2] = {0, 0}, max_rank = 0;
+	long long calls[2] = {0, 0};
+	double mem[2] = {0., 0.}, time[2] = {0., 0.}, max_err = 0.;
+	std::vector<long> hist;
+	for(const RadHMatrixBlockInfo& info : vInfo)
+	{
+		if(info.source != source) continue;
+
+		PyObject *oBlock = Py_BuildValue("{s:i,s:i,s:i,s:i,s:i,s:i,s:i,s:L,s:d,s:d,s:d,s:d}",
+			"comp", info.comp, "row_start", info.row_start, "rows", info.num_rows,
+			"col_start", info.col_start, "cols", info.num_cols, "low_rank", info.low_rank, "rank", info.rank,
+			"kernel_calls", info.kernel_calls, "build_time", info.build_time, "est_error", info.est_error, "est_norm", info.est_norm, "memory", info.memory);
+		if(oBlock) { PyList_Append(oBlocks, oBlock); Py_DECREF(oBlock);}
+
+		int f = info.low_rank ? 1 : 0;
+		nb[f]++; calls[f] += info.kernel_calls; mem[f] += info.memory; time[f] += info.build_time;
+		if(!f) continue;
+		if(info.rank >= (int)hist.size()) hist.resize(info.rank + 1, 0);
+		hist[info.rank]++;
+		if(info.rank > max_rank) max_rank = info.rank;
+		if(info.est_error > max_err) max_err = info.est_error;
+	}
+	for(long c : hist)
+	{
+		PyObject *oCount = PyLong_FromLong(c);
+		if(oCount) { PyList_Append(oHist, oCount); Py_DECREF(oCount);}
+	}
+
+	return Py_BuildValue("{s:{s:i,s:d,s:L,s:d},s:{s:i,s:d,s:L,s:d,s:i,s:d},s:N,s:N}",
+		"near", "blocks", nb[0], "memory", mem[0], "kernel_calls", calls[0], "build_time", time[0],
+		"far", "blocks", nb[1], "memory", mem[1], "kernel_calls", calls[1], "build_time", time[1], "max_rank", max_rank, "max_est_error", max_err,
+		"rank_histogram", oHist, "blocks", oBlocks);
+}
+
+static PyObject* radia_HMatrixReport(PyObject* self, PyObject* args)
+{
+	PyObject *oRes=0, *oFileName=0;
+
+	try
+	{
+		if(!PyArg_ParseTuple(args, "|O:HMatrixReport", &oFileName)) throw CombErStr(strEr_BadFuncArg, ": HMatrixReport");
+
+		int nRec = 0;
+		g_pyParse.ProcRes(RadHMatrixReport(0, &nRec));
+		std::vector<RadHMatrixBlockInfo> vInfo(nRec);
+		if(nRec > 0) g_pyParse.ProcRes(RadHMatrixReport(vInfo.data(), &nRec));
+
+		if(oFileName != 0)
+		{
+			char sFileName[1024];
+			CPyParse::CopyPyStringToC(oFileName, sFileName, 1024);
+			if(RadHMatrixReportJSON(sFileName) != 0) throw CombErStr(strEr_BadFuncArg, ": HMatrixReport: file could not be written");
+		}
+
+		PyObject *oRelax = HMatrixReportToPyDict(vInfo, 0);
+		PyObject *oField = HMatrixReportToPyDict(vInfo, 1);
+		if(oRelax && oField) oRes = Py_BuildValue("{s:N,s:N}", "relaxation", oRelax, "field", oField);
+		else { Py_XDECREF(oRelax); Py_XDECREF(oField);}
+		if(oRes == 0) throw CombErStr(strEr_BadFuncArg, ": HMatrixReport");
+	}
+	catch(const char* erText)
+	{
+		PyErr_SetString(PyExc_RuntimeError, erText);
+	}
+	return oRes;
+}
+
+//-------------------------------------------------------------------------
+// HMatrixReportStats - Record block statistics during construction
+//-------------------------------------------------------------------------
+static PyObject* radia_HMatrixReportStats(PyObject* self, PyObject* args)
+{
+	try
+	{
+		int on = 1;
+		if(!PyArg_ParseTuple(args, "|i:HMatrixReportStats", &on)) throw CombErStr(strEr_BadFuncArg, ": HMatrixReportStats");
+
+		g_pyParse.ProcRes(RadHMatrixReportStats(on));
+		Py_RETURN_NONE;
+	}
+	catch(const char* erText)
+	{
+		PyErr_SetString(PyExc_RuntimeError, erText);
+		return NULL;
+	}
+}
+
 //-------------------------------------------------------------------------
 // UpdateHMatrixMagnetization - Fast magnetization update
 //-------------------------------------------------------------------------
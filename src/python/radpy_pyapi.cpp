@@ -12,6 +12,8 @@
 #include "pyparse.h"
 #include "auxparse.h"
 #include <sstream>
+#include <vector>
+#include <csignal>
 
 /************************************************************************//**
  * Error messages related to Python interface functions
@@ -49,6 +51,52 @@ static char* CombErStr(const char* s1, const char* s2)
 	return g_strErTot;
 }
 
+/************************************************************************//**
+ * Cancellation of long computations (Fld, FldLst, RlxPre, RlxAuto, Solve): while one of them runs,
+ * Ctrl-C (SIGINT) requests cancellation through RadUtiCancel, the computation stops at the next loop
+ * boundary, and KeyboardInterrupt is raised instead of the result.
+ ***************************************************************************/
+static volatile sig_atomic_t g_sigIntReceived = 0;
+
+static void SigIntCancelHandler(int)
+{
+	g_sigIntReceived = 1;
+	RadUtiCancel(1);
+}
+
+class CRadCancelGuard {
+	PyOS_sighandler_t m_pPrevHandler;
+	bool m_HandlerIsSet;
+
+public:
+	CRadCancelGuard()
+	{
+		g_sigIntReceived = 0;
+		RadUtiCancel(0);
+		m_pPrevHandler = PyOS_getsig(SIGINT);
+		m_HandlerIsSet = (m_pPrevHandler != SIG_IGN) && (m_pPrevHandler != SIG_ERR);
+		if(m_HandlerIsSet) PyOS_setsig(SIGINT, SigIntCancelHandler);
+	}
+	~CRadCancelGuard() { Restore();}
+
+	void Restore()
+	{
+		if(!m_HandlerIsSet) return;
+		PyOS_setsig(SIGINT, m_pPrevHandler);
+		m_HandlerIsSet = false;
+	}
+
+	bool Interrupted(PyObject*& oRes)
+	{// Restores the previous SIGINT handler; after Ctrl-C, replaces the result (or the abort error) by KeyboardInterrupt
+		Restore();
+		if(g_sigIntReceived == 0) return false;
+		Py_CLEAR(oRes);
+		PyErr_Clear();
+		PyErr_SetNone(PyExc_KeyboardInterrupt);
+		return true;
+	}
+};
+
 /************************************************************************//**
  * Auxiliary function for parsing Orientation definition string
  ***************************************************************************/
@@ -961,15 +1009,23 @@ static PyObject* radia_SolverHMatrixEnable(PyObject* self, PyObject* args, PyObj
 	int enable = 1;
 	double eps = 1e-4;  // Phase 1: Relaxed from 1e-6 for better compression
 	int max_rank = 30;  // Phase 1: Reduced from 50 for better compression
+	double eta = 1.0;   // Admissibility parameter
+	int leaf_size = 10;
+	int split = 3;      // Principal axis, median split
+	int h2 = 0;         // Nested cluster bases
+	double target = 0.; // Target error of automatic eps / max_rank tuning (0: off)
 
-	static char *kwlist[] = {(char*)"enable", (char*)"eps", (char*)"max_rank", NULL};
+	static char *kwlist[] = {(char*)"enable", (char*)"eps", (char*)"max_rank", (char*)"eta", (char*)"leaf_size", (char*)"split", (char*)"h2", (char*)"target", NULL};
 
 	try
 	{
-		if(!PyArg_ParseTupleAndKeywords(args, kwds, "|idi:SolverHMatrixEnable", kwlist,
-		                                &enable, &eps, &max_rank))
+		if(!PyArg_ParseTupleAndKeywords(args, kwds, "|ididiiid:SolverHMatrixEnable", kwlist,
+		                                &enable, &eps, &max_rank, &eta, &leaf_size, &split, &h2, &target))
 			throw CombErStr(strEr_BadFuncArg, ": SolverHMatrixEnable");
 
+		g_pyParse.ProcRes(RadSolverHMatrixClustering(eta, leaf_size, split));
+		g_pyParse.ProcRes(RadSolverHMatrixH2(h2));
+		g_pyParse.ProcRes(RadSolverHMatrixAccuracy(target));
 		g_pyParse.ProcRes(RadSolverHMatrixEnable(enable, eps, max_rank));
 
 		oRes = Py_BuildValue("i", 0);
@@ -981,6 +1037,28 @@ static PyObject* radia_SolverHMatrixEnable(PyObject* self, PyObject* args, PyObj
 	return oRes;
 }
 
+/************************************************************************//**
+ * H-Matrix parameters selected by the last automatically tuned relaxation
+ ***************************************************************************/
+static PyObject* radia_SolverHMatrixTuned(PyObject* self, PyObject* args)
+{
+	PyObject *oRes=0;
+
+	try
+	{
+		double eps = -1., err = -1.;
+		int max_rank = 0;
+		g_pyParse.ProcRes(RadSolverHMatrixTuned(&eps, &max_rank, &err));
+
+		oRes = Py_BuildValue("[did]", eps, max_rank, err);
+	}
+	catch(const char* erText)
+	{
+		PyErr_SetString(PyExc_RuntimeError, erText);
+	}
+	return oRes;
+}
+
 /************************************************************************//**
  * Disable H-Matrix acceleration for relaxation solver
  ***************************************************************************/
@@ -1001,6 +1079,187 @@ static PyObject* radia_SolverHMatrixDisable(PyObject* self, PyObject* args)
 	return oRes;
 }
 
+/************************************************************************//**
+ * Set accuracy of H-LU factorization (relaxation method 9)
+ ***************************************************************************/
+static PyObject* radia_SolverHLU(PyObject* self, PyObject* args, PyObject* kwds)
+{
+	PyObject *oRes=0;
+	double eps = 1e-4;
+	int max_rank = 50;
+
+	static char *kwlist[] = {(char*)"eps", (char*)"max_rank", NULL};
+
+	try
+	{
+		if(!PyArg_ParseTupleAndKeywords(args, kwds, "|di:SolverHLU", kwlist, &eps, &max_rank))
+			throw CombErStr(strEr_BadFuncArg, ": SolverHLU");
+		if((eps <= 0.) || (max_rank <= 0))
+			throw CombErStr(strEr_BadFuncArg, ": SolverHLU");
+
+		g_pyParse.ProcRes(RadSolverHLU(eps, max_rank));
+
+		oRes = Py_BuildValue("i", 0);
+	}
+	catch(const char* erText)
+	{
+		PyErr_SetString(PyExc_RuntimeError, erText);
+	}
+	return oRes;
+}
+
+/************************************************************************//**
+ * Set NUMA placement of interaction storage and OpenMP thread binding
+ ***************************************************************************/
+static PyObject* radia_SolverNUMA(PyObject* self, PyObject* args, PyObject* kwds)
+{
+	PyObject *oRes=0;
+	int first_touch = 1;
+	int bind = 0;
+
+	static char *kwlist[] = {(char*)"first_touch", (char*)"bind", NULL};
+
+	try
+	{
+		if(!PyArg_ParseTupleAndKeywords(args, kwds, "|ii:SolverNUMA", kwlist, &first_touch, &bind))
+			throw CombErStr(strEr_BadFuncArg, ": SolverNUMA");
+		if((bind < 0) || (bind > 2))
+			throw CombErStr(strEr_BadFuncArg, ": SolverNUMA");
+
+		g_pyParse.ProcRes(RadSolverNUMA(first_touch, bind));
+
+		oRes = Py_BuildValue("i", 0);
+	}
+	catch(const char* erText)
+	{
+		PyErr_SetString(PyExc_RuntimeError, erText);
+	}
+	return oRes;
+}
+
+/************************************************************************//**
+ * Enable cost-model choice of the relaxation interaction backend
+ ***************************************************************************/
+static PyObject* radia_SolverAuto(PyObject* self, PyObject* args, PyObject* kwds)
+{
+	PyObject *oRes=0;
+	int enable = 1;
+	double memory_mb = 0.;
+	int iterations = 100;
+
+	static char *kwlist[] = {(char*)"enable", (char*)"memory_mb", (char*)"iterations", NULL};
+
+	try
+	{
+		if(!PyArg_ParseTupleAndKeywords(args, kwds, "|idi:SolverAuto", kwlist, &enable, &memory_mb, &iterations))
+			throw CombErStr(strEr_BadFuncArg, ": SolverAuto");
+		if((memory_mb < 0.) || (iterations < 1))
+			throw CombErStr(strEr_BadFuncArg, ": SolverAuto");
+
+		g_pyParse.ProcRes(RadSolverAuto(enable, memory_mb, iterations));
+
+		oRes = Py_BuildValue("i", 0);
+	}
+	catch(const char* erText)
+	{
+		PyErr_SetString(PyExc_RuntimeError, erText);
+	}
+	return oRes;
+}
+
+/************************************************************************//**
+ * Set the order of relaxable elements in interaction objects
+ ***************************************************************************/
+static PyObject* radia_SolverElemOrder(PyObject* self, PyObject* args, PyObject* kwds)
+{
+	PyObject *oRes=0;
+	int curve = 1;
+
+	static char *kwlist[] = {(char*)"curve", NULL};
+
+	try
+	{
+		if(!PyArg_ParseTupleAndKeywords(args, kwds, "|i:SolverElemOrder", kwlist, &curve))
+			throw CombErStr(strEr_BadFuncArg, ": SolverElemOrder");
+		if((curve < 0) || (curve > 2))
+			throw CombErStr(strEr_BadFuncArg, ": SolverElemOrder");
+
+		g_pyParse.ProcRes(RadSolverElemOrder(curve));
+
+		oRes = Py_BuildValue("i", 0);
+	}
+	catch(const char* erText)
+	{
+		PyErr_SetString(PyExc_RuntimeError, erText);
+	}
+	return oRes;
+}
+
+/************************************************************************//**
+ * Enable the fast multipole interaction operator of the relaxation
+ ***************************************************************************/
+static PyObject* radia_SolverFMM(PyObject* self, PyObject* args, PyObject* kwds)
+{
+	PyObject *oRes=0;
+	int enable = 1, order = 8, leaf_size = 16;
+	double theta = 0.5;
+
+	static char *kwlist[] = {(char*)"enable", (char*)"order", (char*)"theta", (char*)"leaf_size", NULL};
+
+	try
+	{
+		if(!PyArg_ParseTupleAndKeywords(args, kwds, "|iidi:SolverFMM", kwlist, &enable, &order, &theta, &leaf_size))
+			throw CombErStr(strEr_BadFuncArg, ": SolverFMM");
+		if((order < 1) || (order > 30) || (theta <= 0.) || (theta >= 1.) || (leaf_size < 1))
+			throw CombErStr(strEr_BadFuncArg, ": SolverFMM");
+
+		g_pyParse.ProcRes(RadSolverFMM(enable, order, theta, leaf_size));
+
+		oRes = Py_BuildValue("i", 0);
+	}
+	catch(const char* erText)
+	{
+		PyErr_SetString(PyExc_RuntimeError, erText);
+	}
+	return oRes;
+}
+
+/************************************************************************//**
+ * Cost estimates of the last automatic backend choice
+ ***************************************************************************/
+static PyObject* radia_SolverPlan(PyObject* self, PyObject* args)
+{
+	PyObject *oRes=0;
+
+	try
+	{
+		int n = 0;
+		g_pyParse.ProcRes(RadSolverPlan(0, &n));
+		if(n < 15) { Py_RETURN_NONE;}
+
+		std::vector<double> p(n);
+		g_pyParse.ProcRes(RadSolverPlan(p.data(), &n));
+
+		const char* backends[] = {"dense", "hmatrix", "h2"};
+		int b = (int)p[0];
+		oRes = Py_BuildValue("{s:s,s:d,s:d,s:[ddd],s:[ddd],s:[ddd],s:d,s:i,s:d}",
+			"backend", backends[(b >= 0 && b < 3)? b : 0],
+			"kernel_time", p[1],
+			"stream_rate", p[2],
+			"build_time", p[3], p[4], p[5],
+			"iter_time", p[6], p[7], p[8],
+			"memory", p[9], p[10], p[11],
+			"memory_budget", p[12],
+			"iterations", (int)p[13],
+			"mean_rank", p[14]);
+	}
+	catch(const char* erText)
+	{
+		PyErr_SetString(PyExc_RuntimeError, erText);
+	}
+	return oRes;
+}
+
 /************************************************************************//**
  * Pre-compute relaxation interaction matrix
  ***************************************************************************/
@@ -2446,6 +2705,7 @@ static PyObject* radia_MatMvsH(PyObject* self, PyObject* args)
 static PyObject* radia_RlxPre(PyObject* self, PyObject* args)
 {
 	PyObject *oResInd=0;
+	CRadCancelGuard cancelGuard;
 	try
 	{
 		int indObj = 0, indSrc = 0;
@@ -2464,6 +2724,7 @@ static PyObject* radia_RlxPre(PyObject* self, PyObject* args)
 		PyErr_SetString(PyExc_RuntimeError, erText);
 		//PyErr_PrintEx(1);
 	}
+	cancelGuard.Interrupted(oResInd);
 	return oResInd;
 }
 
@@ -2502,6 +2763,7 @@ static PyObject* radia_RlxMan(PyObject* self, PyObject* args)
 static PyObject* radia_RlxAuto(PyObject* self, PyObject* args)
 {
 	PyObject *oOpt=0, *oResInd=0;
+	CRadCancelGuard cancelGuard;
 	try
 	{
 		int ind=0, numIt=0, meth=4; //OC30122019
@@ -2517,6 +2779,7 @@ static PyObject* radia_RlxAuto(PyObject* self, PyObject* args)
 		double arRes[12];
 		int lenRes = 0;
 		g_pyParse.ProcRes(RadRlxAuto(arRes, &lenRes, ind, prec, numIt, meth, sOpt));
+		if(PyErr_Occurred()) return 0; //exception raised by RlxMonitor callback
 
 		if(lenRes == 1) oResInd = Py_BuildValue("d", *arRes);
 		else if(lenRes > 1) oResInd = CPyParse::SetDataListOfLists(arRes, lenRes, 1);
@@ -2527,6 +2790,7 @@ static PyObject* radia_RlxAuto(PyObject* self, PyObject* args)
 		PyErr_SetString(PyExc_RuntimeError, erText);
 		//PyErr_PrintEx(1);
 	}
+	cancelGuard.Interrupted(oResInd);
 	return oResInd;
 }
 
@@ -2557,12 +2821,143 @@ static PyObject* radia_RlxUpdSrc(PyObject* self, PyObject* args)
 	return oResInd;
 }
 
+/************************************************************************//**
+ * Magnetic Field Calculation Methods: Multiplies magnetization of the relaxable elements by the interaction matrix intrc or by its transpose.
+ ***************************************************************************/
+static PyObject* radia_RlxMatVec(PyObject* self, PyObject* args)
+{
+	PyObject *oM=0, *oResInd=0;
+	double *arM=0, *arH=0;
+	try
+	{
+		int ind=0, trans=0;
+		if(!PyArg_ParseTuple(args, "iO|i:RlxMatVec", &ind, &oM, &trans)) throw CombErStr(strEr_BadFuncArg, ": RlxMatVec");
+		if(ind == 0) throw CombErStr(strEr_BadFuncArg, ": RlxMatVec");
+
+		int nM=0;
+		if(!CPyParse::CopyPyNestedListElemsToNumAr(oM, 'd', arM, nM)) throw CombErStr(strEr_BadFuncArg, ": RlxMatVec, incorrect definition of magnetization vectors");
+
+		arH = new double[nM];
+		int nH = 0;
+		g_pyParse.ProcRes(RadRlxMatVec(arH, &nH, ind, arM, nM, trans));
+
+		oResInd = CPyParse::SetDataListOfLists(arH, nH, nH/3);
+	}
+	catch(const char* erText)
+	{
+		PyErr_SetString(PyExc_RuntimeError, erText);
+		//PyErr_PrintEx(1);
+	}
+	if(arM != 0) delete[] arM;
+	if(arH != 0) delete[] arH;
+	return oResInd;
+}
+
+/************************************************************************//**
+ * Relaxation telemetry: converts one per-iteration record to Python dictionary.
+ ***************************************************************************/
+static PyObject* RlxIterInfoToPyDict(const RadRelaxIterInfo& info)
+{
+	return Py_BuildValue("{s:i,s:d,s:d,s:d,s:i,s:i}", "iter", info.iter, "misfit", info.misfit,
+		"sweep_time", info.sweep_time, "matvec_time", info.matvec_time, "changed", info.num_changed, "elements", info.num_elem);
+}
+
+static PyObject* g_oRlxMonitor = 0;
+
+/************************************************************************//**
+ * Relaxation telemetry: C callback forwarding per-iteration records to the Python monitor.
+ * Returns non-zero (i.e. terminates the relaxation) if the monitor returns True or raises an exception;
+ * in the latter case the exception is re-raised by RlxAuto / Solve.
+ ***************************************************************************/
+static int CALL RlxMonitorCallback(const RadRelaxIterInfo* pInfo, void* pUserData)
+{
+	PyObject *oCallback = (PyObject*)pUserData;
+	if((oCallback == 0) || (pInfo == 0)) return 0;
+
+	PyGILState_STATE gstate = PyGILState_Ensure();
+	int stop = 1;
+	PyObject *oInfo = RlxIterInfoToPyDict(*pInfo);
+	if(oInfo != 0)
+	{
+		PyObject *oRes = PyObject_CallFunctionObjArgs(oCallback, oInfo, NULL);
+		Py_DECREF(oInfo);
+		if(oRes != 0)
+		{
+			stop = PyObject_IsTrue(oRes);
+			if(stop < 0) stop = 1;
+			Py_DECREF(oRes);
+		}
+	}
+	PyGILState_Release(gstate);
+	return stop;
+}
+
+/************************************************************************//**
+ * Relaxation telemetry: sets (or removes, if None) a Python callable to be called after each relaxation iteration.
+ ***************************************************************************/
+static PyObject* radia_RlxMonitor(PyObject* self, PyObject* args)
+{
+	PyObject *oCallback=0, *oRes=0;
+	try
+	{
+		if(!PyArg_ParseTuple(args, "O:RlxMonitor", &oCallback)) throw CombErStr(strEr_BadFuncArg, ": RlxMonitor");
+		if((oCallback != Py_None) && !PyCallable_Check(oCallback))
+			throw CombErStr(strEr_BadFuncArg, ": RlxMonitor requires callable or None");
+
+		if(oCallback == Py_None)
+		{
+			g_pyParse.ProcRes(RadRlxMonitor(0, 0));
+			Py_CLEAR(g_oRlxMonitor);
+		}
+		else
+		{
+			Py_INCREF(oCallback);
+			g_pyParse.ProcRes(RadRlxMonitor(RlxMonitorCallback, oCallback));
+			Py_XDECREF(g_oRlxMonitor);
+			g_oRlxMonitor = oCallback;
+		}
+
+		oRes = Py_BuildValue("i", 0);
+	}
+	catch(const char* erText)
+	{
+		PyErr_SetString(PyExc_RuntimeError, erText);
+	}
+	return oRes;
+}
+
+/************************************************************************//**
+ * Relaxation telemetry: returns per-iteration records of the last automatic relaxation.
+ ***************************************************************************/
+static PyObject* radia_RlxTelemetry(PyObject* self, PyObject* args)
+{
+	PyObject *oRes=0;
+	try
+	{
+		int nRec = 0;
+		g_pyParse.ProcRes(RadRlxTelemetry(0, &nRec));
+
+		std::vector<RadRelaxIterInfo> vInfo(nRec);
+		if(nRec > 0) g_pyParse.ProcRes(RadRlxTelemetry(vInfo.data(), &nRec));
+
+		oRes = PyList_New(nRec);
+		if(oRes == 0) throw CombErStr(strEr_BadFuncArg, ": RlxTelemetry");
+		for(int i=0; i<nRec; i++) PyList_SET_ITEM(oRes, i, RlxIterInfoToPyDict(vInfo[i]));
+	}
+	catch(const char* erText)
+	{
+		PyErr_SetString(PyExc_RuntimeError, erText);
+	}
+	return oRes;
+}
+
 /************************************************************************//**
  * Magnetic Field Calculation Methods: Builds an interaction matrix and performs a relaxation procedure.
  ***************************************************************************/
 static PyObject* radia_Solve(PyObject* self, PyObject* args)
 {
 	PyObject *oRes=0;
+	CRadCancelGuard cancelGuard;
 	try
 	{
 		int ind=0, numIt=1000, meth=4; //OC02112019
@@ -2574,6 +2969,7 @@ static PyObject* radia_Solve(PyObject* self, PyObject* args)
 		double arResSolve[12];
 		int lenResSolve = 4;
 		g_pyParse.ProcRes(RadSolve(arResSolve, &lenResSolve, ind, prec, numIt, meth));
+		if(PyErr_Occurred()) return 0; //exception raised by RlxMonitor callback
 
 		if(lenResSolve == 1) oRes = Py_BuildValue("d", *arResSolve);
 		else if(lenResSolve > 1) oRes = CPyParse::SetDataListOfLists(arResSolve, lenResSolve, 1);
@@ -2584,6 +2980,7 @@ static PyObject* radia_Solve(PyObject* self, PyObject* args)
 		PyErr_SetString(PyExc_RuntimeError, erText);
 		//PyErr_PrintEx(1);
 	}
+	cancelGuard.Interrupted(oRes);
 	return oRes;
 }
 
@@ -2594,6 +2991,7 @@ static PyObject* radia_Fld(PyObject* self, PyObject* args)
 {
 	PyObject *oCmpnId=0, *oP=0, *oResB=0;
 	double *arCoord=0, *arB=0;
+	CRadCancelGuard cancelGuard;
 	try
 	{
 		int ind=0;
@@ -2628,6 +3026,7 @@ static PyObject* radia_Fld(PyObject* self, PyObject* args)
 	}
 	if(arCoord != 0) delete[] arCoord;
 	if(arB != 0) delete[] arB;
+	cancelGuard.Interrupted(oResB);
 	return oResB;
 }
 
@@ -2639,6 +3038,7 @@ static PyObject* radia_FldLst(PyObject* self, PyObject* args)
 	PyObject *oCmpnId=0, *oP1=0, *oP2=0, *oOpt=0, *oResB=0;
 	//PyObject *oCmpnId=0, *oP1=0, *oP2=0, *oOpt=0, *oResB=0;
 	double *arB=0;
+	CRadCancelGuard cancelGuard;
 	try
 	{
 		int ind=0, nP=0;
@@ -2672,6 +3072,7 @@ static PyObject* radia_FldLst(PyObject* self, PyObject* args)
 		//PyErr_PrintEx(1);
 	}
 	if(arB != 0) delete[] arB;
+	cancelGuard.Interrupted(oResB);
 	return oResB;
 }
 
@@ -3054,7 +3455,7 @@ static PyObject* radia_FldCmpCrt(PyObject* self, PyObject* args)
 }
 
 /************************************************************************//**
- * Magnetic Field Calculation Methods: Sets general absolute accuracy levels for computation of magnetic field induction (PrcB), vector potential (PrcA), induction integral along straight line (PrcBInt), field force (PrcForce), torque (PrcTorque), energy (PrcEnergy); relativistic charged particle trajectory coordinates (PrcCoord) and angles (PrcAngle). The function works according to the mechanism of string options. The name(s) of the option(s) should be: PrcB, PrcA, PrcBInt, PrcForce, PrcTorque, PrcEnergy, PrcCoord, PrcAngle.
+ * Magnetic Field Calculation Methods: Sets general absolute accuracy levels for computation of magnetic field induction (PrcB), vector potential (PrcA), induction integral along straight line (PrcBInt), field force (PrcForce), torque (PrcTorque), energy (PrcEnergy); relativistic charged particle trajectory coordinates (PrcCoord) and angles (PrcAngle); relative accuracy of the multipole far field of groups at field computation over lists of points (PrcFar, off by default, a negative value switches it off). The function works according to the mechanism of string options. The name(s) of the option(s) should be: PrcB, PrcA, PrcBInt, PrcForce, PrcTorque, PrcEnergy, PrcCoord, PrcAngle, PrcFar.
  ***************************************************************************/
 static PyObject* radia_FldCmpPrc(PyObject* self, PyObject* args)
 {
@@ -3388,6 +3789,46 @@ static PyObject* radia_UtiVer(PyObject* self, PyObject* args)
 	return oVerNum;
 }
 
+/************************************************************************//**
+ * Utilities: Requests cancellation of the current computation (e.g. from a RlxMonitor callback), or withdraws the request.
+ ***************************************************************************/
+static PyObject* radia_UtiCancel(PyObject* self, PyObject* args)
+{
+	PyObject *oRes=0;
+	try
+	{
+		int cancel = 1;
+		if(!PyArg_ParseTuple(args, "|i:UtiCancel", &cancel)) throw CombErStr(strEr_BadFuncArg, ": UtiCancel");
+
+		g_pyParse.ProcRes(RadUtiCancel(cancel));
+		oRes = Py_BuildValue("i", cancel);
+	}
+	catch(const char* erText)
+	{
+		PyErr_SetString(PyExc_RuntimeError, erText);
+	}
+	return oRes;
+}
+
+/************************************************************************//**
+ * Utilities: Returns the progress [done, total] of the current or last computation.
+ ***************************************************************************/
+static PyObject* radia_UtiProgress(PyObject* self, PyObject* args)
+{
+	PyObject *oRes=0;
+	try
+	{
+		long long nDone = 0, nTotal = 0;
+		g_pyParse.ProcRes(RadUtiProgress(&nDone, &nTotal));
+		oRes = Py_BuildValue("[L,L]", nDone, nTotal);
+	}
+	catch(const char* erText)
+	{
+		PyErr_SetString(PyExc_RuntimeError, erText);
+	}
+	return oRes;
+}
+
 /************************************************************************//**
  * Utilities: Initializes or finishes MPI (to support parallel computation)
  ***************************************************************************/
@@ -3477,8 +3918,15 @@ static PyMethodDef radia_methods[] = {
 	// Temporarily disabled - field source H-matrix (has API compatibility issues)
 	// {"ObjHMatrix", (PyCFunction)radia_ObjHMatrix, METH_VARARGS | METH_KEYWORDS, "ObjHMatrix(grp, eps=1e-6, max_rank=50, min_cluster_size=10, use_openmp=1, num_threads=0) creates an H-matrix field source from group grp for fast field computation using hierarchical matrices and OpenMP parallelization. Parameters: grp (group object key), eps (ACA tolerance, default 1e-6), max_rank (maximum rank for low-rank blocks, default 50), min_cluster_size (minimum cluster size, default 10), use_openmp (enable OpenMP: 1=yes, 0=no, default 1), num_threads (number of threads, 0=automatic, default 0). Returns H-matrix object key."},
 	// {"HMatrixBuild", radia_HMatrixBuild, METH_VARARGS, "HMatrixBuild(hmat) builds the H-matrix structure for the H-matrix field source hmat. This must be called after creating the H-matrix object with ObjHMatrix. The building process constructs cluster trees and performs adaptive cross approximation (ACA) for fast field computation."},
-	{"SolverHMatrixEnable", (PyCFunction)radia_SolverHMatrixEnable, METH_VARARGS | METH_KEYWORDS, "SolverHMatrixEnable(enable=1, eps=1e-4, max_rank=30) enables H-matrix acceleration for the relaxation solver. Users must explicitly enable H-matrix to use OpenMP-parallelized operations, providing 4-10x speedup for large systems (N > 200 recommended). Parameters: enable (1=on, 0=off), eps (ACA tolerance, default 1e-4), max_rank (maximum rank for low-rank blocks, default 30)."},
+	{"SolverHMatrixEnable", (PyCFunction)radia_SolverHMatrixEnable, METH_VARARGS | METH_KEYWORDS, "SolverHMatrixEnable(enable=1, eps=1e-4, max_rank=30, eta=1.0, leaf_size=10, split=3, h2=0, target=0) enables H-matrix acceleration for the relaxation solver. Users must explicitly enable H-matrix to use OpenMP-parallelized operations, providing 4-10x speedup for large systems (N > 200 recommended). Parameters: enable (1=on, 0=off), eps (ACA tolerance, default 1e-4), max_rank (maximum rank for low-rank blocks, default 30), eta (admissibility parameter: a block is low-rank if the cluster distance is at least eta times the smaller cluster diameter, default 1.0), leaf_size (maximum number of elements in a leaf cluster, default 10), split (cluster splitting: 1 - longest bounding-box edge at midpoint, 2 - principal axis at midpoint, 3 - principal axis at median, default 3), h2 (1 - store as H2-matrix with nested cluster bases shared by all blocks of a cluster: O(N) instead of O(N log N) memory for large models, 0 - H-matrix, default 0), target (target relative error of the interaction matrix products: if > 0, eps and max_rank are tuned automatically at each relaxation setup, starting from the values tuned before, as the cheapest tried parameters whose error, estimated by comparing products with random vectors to exact products on randomly sampled rows, meets the target; tuning with target 1e-3 is also done if eps <= 0; default 0 - no tuning)."},
+	{"SolverHMatrixTuned", radia_SolverHMatrixTuned, METH_VARARGS, "SolverHMatrixTuned() returns [eps, max_rank, error]: the H-matrix parameters selected by the last automatically tuned relaxation (see SolverHMatrixEnable, target) and the estimated relative error of the interaction matrix products; eps = -1 if no relaxation was tuned."},
 	{"SolverHMatrixDisable", radia_SolverHMatrixDisable, METH_VARARGS, "SolverHMatrixDisable() disables H-matrix acceleration for the relaxation solver, falling back to the standard dense solver."},
+	{"SolverHLU", (PyCFunction)radia_SolverHLU, METH_VARARGS | METH_KEYWORDS, "SolverHLU(eps=1e-4, max_rank=50) sets the accuracy of the H-LU factorization used by relaxation method 9, which solves the linearized relaxation equations (I - Ksi*N) dM = r with a hierarchical-matrix LU decomposition in a secant/Newton iteration. Parameters: eps (relative truncation accuracy of low-rank blocks), max_rank (maximum rank of low-rank blocks)."},
+	{"SolverNUMA", (PyCFunction)radia_SolverNUMA, METH_VARARGS | METH_KEYWORDS, "SolverNUMA(first_touch=1, bind=0) sets the memory placement of the relaxation interaction storage on NUMA systems. first_touch=1: the dense interaction matrix rows and the H-matrix block factors are first written by the OpenMP threads that multiply them in the relaxation, so that their pages are allocated on these threads' nodes. bind: OpenMP thread binding applied at each Solve (0: none/restore the initial affinity, 1: close, threads fill the CPUs of one NUMA node after another, 2: spread, threads round-robin over NUMA nodes); binding is supported on Linux only."},
+	{"SolverAuto", (PyCFunction)radia_SolverAuto, METH_VARARGS | METH_KEYWORDS, "SolverAuto(enable=1, memory_mb=0, iterations=100) chooses the relaxation interaction backend (dense matrix, H-matrix or H2-matrix) at each Solve from a cost model: the H-matrix block structure, the ACA ranks of sampled low-rank blocks, the interaction kernel time and the matrix-vector product speed are measured, and the backend with the least construction time + iterations * time per iteration whose memory fits into memory_mb (0: half of the physical memory) is used. Overrides SolverHMatrixEnable/SolverHMatrixH2 while enabled; the estimates are returned by SolverPlan()."},
+	{"SolverElemOrder", (PyCFunction)radia_SolverElemOrder, METH_VARARGS | METH_KEYWORDS, "SolverElemOrder(curve=1) sets the order of the relaxable elements in interaction objects created afterwards (Solve, RlxPre): 0 - input order of the group tree (default), 1 - Morton (Z-order) curve, 2 - Hilbert curve through the element centres. Elements near in space become neighbours in the interaction matrix, the magnetization/field arrays and the H-matrix cluster order. RlxMatVec and the interaction matrix/vector output keep the input order; SetRelaxSubInterval is not supported for reordered interactions."},
+	{"SolverFMM", (PyCFunction)radia_SolverFMM, METH_VARARGS | METH_KEYWORDS, "SolverFMM(enable=1,order=8,theta=0.5,leaf_size=16) enables (1) or disables (0) the fast multipole method as interaction operator of the relaxation (Solve, RlxPre), overriding SolverHMatrixEnable and SolverAuto: the far field of the magnetized elements and their symmetry images is evaluated from Cartesian Taylor expansions of order order (exact moments of parallelepipeds and polyhedra), clusters of radii r1, r2 interact through expansions if r1 + r2 < theta * distance, and only the exact 3x3 blocks of near elements (leaf clusters of up to leaf_size elements) are stored, so that construction, memory and products grow as O(N). The same parameters are used by FldBatch with use_hmatrix=2."},
+	{"SolverPlan", radia_SolverPlan, METH_VARARGS, "SolverPlan() returns the cost estimates of the last automatic backend choice (see SolverAuto) as a dict: backend ('dense', 'hmatrix' or 'h2'), kernel_time [s per 3x3 block], stream_rate [bytes/s], build_time, iter_time [s] and memory [bytes] as lists over (dense, hmatrix, h2), memory_budget [bytes], iterations, mean_rank; None if no choice was made."},
 	{"ObjCnt", radia_ObjCnt, METH_VARARGS, "ObjCnt([obj1,obj2,...]) creates a container object for magnetic field source objects [obj1,obj2,...]."},
 	{"ObjAddToCnt", radia_ObjAddToCnt, METH_VARARGS, "ObjAddToCnt(cnt,[obj1,obj2,...]) adds objects [obj1,obj2,...] to the container object cnt."},
 	{"ObjCntStuf", radia_ObjCntStuf, METH_VARARGS, "ObjCntStuf(obj) returns list of general indexes of the objects present in container if obj is a container; or returns [obj] if obj is not a container."}, 
@@ -3523,14 +3971,19 @@ static PyMethodDef radia_methods[] = {
 	{"SetRelaxSubInterval", radia_SetRelaxSubInterval, METH_VARARGS, "SetRelaxSubInterval(intrc,start,fin,together:1) sets a relaxation sub-interval for interaction matrix intrc. Elements from index start to fin will be relaxed together (using LU decomposition) if together=1, or separately (using Gauss-Seidel) if together=0. This enables Method 5 solver with direct matrix inversion for groups of elements."},
 	{"RlxMan", radia_RlxMan, METH_VARARGS, "RlxMan(intrc,meth,iternum,rlxpar) executes manual relaxation procedure for interaction matrix intrc using method number meth (0-5), by making iternum iterations with relaxation parameter value rlxpar. Method 5 enables LU decomposition solver when used with SetRelaxSubInterval(intrc,start,fin,1)."},
 	{"RlxAuto", radia_RlxAuto, METH_VARARGS, "RlxAuto(intrc,prec,maxiter,meth:4,'ZeroM->True|False') executes automatic relaxation procedure with the interaction matrix intrc using the method number meth. Relaxation stops whenever the change in magnetization (averaged over all sub-elements) between two successive iterations is smaller than prec or the number of iterations is larger than maxiter. The option value 'ZeroM->True' (default) starts the relaxation by setting the magnetization values in all paricipating objects to zero; 'ZeroM->False' starts the relaxation with the existing magnetization values in the sub-volumes."},
+	{"RlxMonitor", radia_RlxMonitor, METH_VARARGS, "RlxMonitor(callback|None) sets a function to be called after each iteration of automatic relaxation (RlxAuto, Solve) with a dictionary {'iter','misfit','sweep_time','matvec_time','changed','elements'}: iteration number, average change in magnetization, wall time of the iteration [s], part of it spent on interaction matrix products [s], number of elements whose magnetization changed by more than prec, and total number of relaxable elements. If the callback returns True, the relaxation terminates after the current iteration. RlxMonitor(None) removes the callback."},
+	{"RlxTelemetry", radia_RlxTelemetry, METH_VARARGS, "RlxTelemetry() returns the list of per-iteration records (dictionaries, as passed to the RlxMonitor callback) of the last automatic relaxation."},
+	{"RlxMatVec", radia_RlxMatVec, METH_VARARGS, "RlxMatVec(intrc,[[mx1,my1,mz1],[mx2,my2,mz2],...],trans:0) multiplies the magnetization vectors of the relaxable elements of the interaction matrix intrc by the interaction matrix (trans=0) or by its transpose (trans=1), returning the field strength vectors without the external field. The transposed (adjoint) product reuses the stored dense or H-matrix representation."},
 	{"RlxUpdSrc", radia_RlxUpdSrc, METH_VARARGS, "RlxUpdSrc(intrc) updates external field data for the relaxation (to take into account e.g. modification of currents in coils, if any) without rebuilding the interaction matrix."},
-	{"Solve", radia_Solve, METH_VARARGS, "Solve(obj,prec,maxiter,meth:4) solves a magnetostatic problem, i.e. builds an interaction matrix for the object obj and performs a relaxation procedure using the method number meth (default is 4). The relaxation stops whenever the change in magnetization (averaged over all sub-elements) between two successive iterations is smaller than prec or the number of iterations is larger than maxiter."},
+	{"Solve", radia_Solve, METH_VARARGS, "Solve(obj,prec,maxiter,meth:4) solves a magnetostatic problem, i.e. builds an interaction matrix for the object obj and performs a relaxation procedure using the method number meth (default is 4; 9 selects a secant/Newton iteration with an H-LU factorized linearized system, see SolverHLU). The relaxation stops whenever the change in magnetization (averaged over all sub-elements) between two successive iterations is smaller than prec or the number of iterations is larger than maxiter."},
 
 	{"Fld", radia_Fld, METH_VARARGS,  "Fld(obj,'bx|by|bz|hx|hy|hz|ax|ay|az|mx|my|mz'|'',[x,y,z]|[[x1,y1,z1],[x2,y2,z2],...]) computes magnetic field created by the object obj in point(s) {x,y,z} ({x1,y1,z1},{x2,y2,z2},...). The field component is specified by the second input variable. The function accepts a list of 3D points of arbitrary nestness: in this case it returns the corresponding list of magnetic field values."},
-	{"FldBatch", radia_FldBatch, METH_VARARGS,  "FldBatch(obj,'bx|by|bz|hx|hy|hz|b|h|a|m'|'',[[x1,y1,z1],[x2,y2,z2],...],use_hmatrix:1) computes magnetic field in batch mode at multiple observation points with optional H-matrix acceleration. use_hmatrix=1 (default) uses H-matrix if globally enabled, use_hmatrix=0 forces direct calculation."},
-	{"SetHMatrixFieldEval", radia_SetHMatrixFieldEval, METH_VARARGS,  "SetHMatrixFieldEval(enabled:0|1,tol:1e-6) enables (1) or disables (0) H-matrix acceleration for field evaluation. tol sets HACApK ACA tolerance (smaller = more accurate). Enables caching for non-linear iterations."},
-	{"ClearHMatrixCache", radia_ClearHMatrixCache, METH_VARARGS,  "ClearHMatrixCache() clears H-matrix field evaluation cache and frees memory. Call after geometry modifications."},
-	{"GetHMatrixStats", radia_GetHMatrixStats, METH_VARARGS,  "GetHMatrixStats() returns H-matrix statistics: [is_enabled, num_cached, total_memory_MB]."},
+	{"FldBatch", radia_FldBatch, METH_VARARGS,  "FldBatch(obj,'bx|by|bz|hx|hy|hz|b|h|a|m'|'',[[x1,y1,z1],[x2,y2,z2],...],use_hmatrix:1) computes magnetic field in batch mode at multiple observation points with optional H-matrix acceleration. use_hmatrix=1 (default) uses H-matrix if globally enabled, use_hmatrix=0 forces direct calculation, use_hmatrix=2 uses the fast multipole method for H and B (parameters of SolverFMM)."},
+	{"SetHMatrixFieldEval", radia_SetHMatrixFieldEval, METH_VARARGS,  "SetHMatrixFieldEval(enabled:0|1,tol:1e-6,eta:2.0,leaf_size:10,split:3) enables (1) or disables (0) H-matrix acceleration for field evaluation. tol sets HACApK ACA tolerance (smaller = more accurate). eta is the admissibility parameter (a block is low-rank if the cluster distance is at least eta times the smaller cluster diameter), leaf_size the maximum number of sources in a leaf cluster, split the cluster splitting (1: longest bounding-box edge at midpoint, 2: principal axis at midpoint, 3: principal axis at median). Enables caching for non-linear iterations."},
+	{"ClearHMatrixCache", radia_ClearHMatrixCache, METH_VARARGS,  "ClearHMatrixCache() clears H-matrix field evaluation cache and the relaxation H-matrices kept for incremental updates, and frees memory. Call after geometry modifications."},
+	{"GetHMatrixStats", radia_GetHMatrixStats, METH_VARARGS,  "GetHMatrixStats() returns H-matrix statistics: [is_enabled, num_cached, total_memory_MB, num_updated_elem]; num_updated_elem is the number of elements recomputed by the incremental update of the H-matrix of the last relaxation (-1 if it was fully built)."},
+	{"HMatrixReport", radia_HMatrixReport, METH_VARARGS,  "HMatrixReport(file:'') returns the per-block report of the last built H-matrices as a dictionary with keys 'relaxation' (interaction matrix of Solve / RlxAuto) and 'field' (field evaluation); each has a near- and far-field breakdown ('near', 'far': number of blocks, memory, kernel calls, build time, maximal rank and estimated error; kernel calls and errors are recorded after HMatrixReportStats(1)), the rank histogram of low-rank blocks ('rank_histogram') and the list of blocks ('blocks': component, rows, columns, rank, kernel calls, build time, estimated relative error and norm, memory). If file is given, the report is also written to this file in JSON format."},
+	{"HMatrixReportStats", radia_HMatrixReportStats, METH_VARARGS,  "HMatrixReportStats(on:1) switches on (1) or off (0) the construction statistics of the H-matrix blocks built from then on: kernel calls of every block and the relative error and norm of low-rank blocks estimated on four sampled rows, as listed by HMatrixReport(). Off by default, since counting and sampling add kernel calls to every build."},
 	{"UpdateHMatrixMagnetization", radia_UpdateHMatrixMagnetization, METH_VARARGS,  "UpdateHMatrixMagnetization(obj) updates magnetization in cached H-matrix without rebuilding. For non-linear relaxation: much faster than rebuilding H-matrix. Must call FldBatch with use_hmatrix=1 first."},
 	{"FldLst", radia_FldLst, METH_VARARGS,  "FldLst(obj,'bx|by|bz|hx|hy|hz|ax|ay|az|mx|my|mz'|'',[x1,y1,z1],[x2,y2,z2],np,'arg|noarg':'noarg',strt:0.) computes magnetic field created by object obj in np equidistant points along a line segment from [x1,y1,z1] to [x2,y2,z2]; the field component is specified by the second input variable; the 'arg|noarg' string variable specifies whether to output a longitudinal position for each point where the field is computed, and strt gives the start-value for the longitudinal position."},
 	{"FldInt", radia_FldInt, METH_VARARGS, "FldInt(obj,'inf|fin','ibx|iby|ibz'|'',[x1,y1,z1],[x2,y2,z2]) computes magnetic field induction integral produced by the object obj along a straight line specified by points [x1,y1,z1] and [x2,y2,z2]; depending on the second variable value, the integral is infinite ('inf') or finite from [x1,y1,z1] to [x2,y2,z2] ('fin'); the field integral component is specified by the third input variable. The units are Tesla x millimeters."},
@@ -3543,7 +3996,7 @@ static PyMethodDef radia_methods[] = {
 	{"FldFocPot", radia_FldFocPot, METH_VARARGS, "FldFocPot(obj,[x1,y1,z1],[x2,y2,z2],np) computes \"focusing potential\" for trajectory of relativistic charged particle in magnetic field produced by the object obj. The integration is made from [x1,y1,z1] to [x2,y2,z2] with np equidistant points."},
 	{"FldFocKickPer", radia_FldFocKickPer, METH_VARARGS, "FldFocKickPer(obj,[x1,y1,z1],[nsx,nsy,nsz],per,nper,[n1x,n1y,n1z],r1,np1,r2,np2,com:'',[nh:1,nps:8,d1:0,d2:0],'T2m2|rad|microrad':'T2m2',en:1,'fix|tab':'fix') computes matrices of 2nd order kicks of trajectory of relativistic charged particle in periodic magnetic field produced by the object obj. The longitudinal integration along one period starts at point [x1,y1,z1] and is done along direction pointed by vector [nsx,nsy,nsz]; per is period length, nper is number of full periods; one direction of the transverse grid is pointed by vector [n1x,n1y,n1z], the other transverse direction is given by vector product of [n1x,n1y,n1z] and [nsx,nsy,nsz]; r1 and r2 are ranges of the transverse grid, np1 and np2 are corresponding numbers of points; com is arbitrary string comment; nh is maximum number of magnetic field harmonics to treat (default 1), nps is number of longitudinal points (default 8), d1 and d2 are steps of transverse differentiation (by default equal to the steps of the transverse grid); the 'T2m2|rad|microrad' string variable specifies the units for the resulting 2nd order kick values (default 'T2m2'); en is electron elergy in GeV (optional, required only if units are 'rad' or 'microrad'); the 'fix|tab' string variable specifies the format of the output data string (i.e. element [5] of the output list), 'fix' for fixed-width (default), 'tab' for tab-delimited. Returns list containing: [0]- matrix of kick values in the first transverse direction, [1]- matrix of kick values in the second transverse direction, [2]- matrix of longitudinally-integrated squared transverse magnetic field calculated on same transverse mesh as kicks, [3],[4]- lists of positions defining the transverse grid, [5]- formatted string containing the computed results (for saving into a text file)."},
 	{"FldCmpCrt", radia_FldCmpCrt, METH_VARARGS, "FldCmpCrt(prcB,prcA,prcBint,prcFrc,prcTrjCrd,prcTrjAng) sets general absolute accuracy levels for computation of field induction (prcB), vector potential (prcA), induction integrals along straight line (prcBint), field force (prcFrc), relativistic particle trajectory coordinates (prcTrjCrd) and angles (prcTrjAng)."},
-	{"FldCmpPrc", radia_FldCmpPrc, METH_VARARGS, "FldCmpPrc('PrcB->prb,PrcA->pra,PrcBInt->prbint,PrcForce->prfrc,PrcTorque->prtrq,PrcEnergy->pre,PrcCoord->prcrd,PrcAngle->prang') sets general absolute accuracy levels for computation of magnetic field induction, vector potential, induction integral along straight line, field force, torque, energy; relativistic charged particle trajectory coordinates and angles. The function works in line with the Mathematica mechanism of Options. PrcB, PrcA, PrcBInt, PrcForce, PrcTorque, PrcEnergy, PrcCoord, PrcAngle are names of the options; prb, pra, prbint, prfrc, prtrq, pre, prcrd, prang are the corresponding values (real numbers specifying the accuracy levels)."},
+	{"FldCmpPrc", radia_FldCmpPrc, METH_VARARGS, "FldCmpPrc('PrcB->prb,PrcA->pra,PrcBInt->prbint,PrcForce->prfrc,PrcTorque->prtrq,PrcEnergy->pre,PrcCoord->prcrd,PrcAngle->prang,PrcFar->prfar') sets general absolute accuracy levels for computation of magnetic field induction, vector potential, induction integral along straight line, field force, torque, energy; relativistic charged particle trajectory coordinates and angles; and the relative accuracy of the multipole far field of groups at field computation over lists of points (off by default; a negative value switches it off). The function works in line with the Mathematica mechanism of Options. PrcB, PrcA, PrcBInt, PrcForce, PrcTorque, PrcEnergy, PrcCoord, PrcAngle, PrcFar are names of the options; prb, pra, prbint, prfrc, prtrq, pre, prcrd, prang, prfar are the corresponding values (real numbers specifying the accuracy levels)."},
 	{"FldUnits", radia_FldUnits, METH_VARARGS, "FldUnits() shows the physical units currently in use."},
 	{"FldLenRndSw", radia_FldLenRndSw, METH_VARARGS, "FldLenRndSw('on|off') switches on or off the randomization of all the length values. The randomization magnitude can be set by the function FldLenTol."},
 	{"FldLenTol", radia_FldLenTol, METH_VARARGS, "FldLenTol(abs,rel,zero:0) sets absolute and relative randomization magnitudes for all the length values, including coordinates and dimensions of the objects producing magnetic field, and coordinates of points where the field is computed. Optimal values of the variables can be: rel=10^(-11), abs=L*rel, zero=abs, where L is the distance scale value (in mm) for the problem to be solved. Too small randomization magnitudes can result in run-time code errors."},
@@ -3554,6 +4007,8 @@ static PyMethodDef radia_methods[] = {
 	{"UtiDel", radia_UtiDel, METH_VARARGS, "UtiDel(elem) deletes element elem."},
 	{"UtiDelAll", radia_UtiDelAll, METH_VARARGS, "UtiDelAll() deletes all previously created elements."},
 	{"UtiVer", radia_UtiVer, METH_VARARGS, "UtiVer() returns version number of the Radia library."},
+	{"UtiCancel", radia_UtiCancel, METH_VARARGS, "UtiCancel(cancel:1) requests cancellation of the current computation (field, interaction matrix or relaxation), e.g. from a RlxMonitor callback; the computation stops at the next loop boundary with the error 'Execution aborted by User'. UtiCancel(0) withdraws the request. During Fld, FldLst, RlxPre, RlxAuto and Solve, Ctrl-C requests cancellation the same way and raises KeyboardInterrupt."},
+	{"UtiProgress", radia_UtiProgress, METH_VARARGS, "UtiProgress() returns the progress [done,total] of the current or last computation: points of a field list, columns of an interaction matrix, or relaxation iterations out of the maximal number."},
 	{"UtiMPI", radia_UtiMPI, METH_VARARGS, "UtiMPI('on|off|share',data,rankFrom,rankTo) initializes (if argument is 'on') or finalizes (in argument is 'off') the Message Passing Inteface (MPI) for parallel calculations and returns list of basic MPI process parameters (in the case of initialization): rank of a process and total number of processes. In the case of first argument is 'share', the function will send data (list or array) from rankFrom (by default 0) to all processes (by default) of to rankTo."},
 
 	{NULL, NULL}
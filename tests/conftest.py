@@ -11,6 +11,8 @@ import sys
 import os
 from pathlib import Path
 
+import pytest
+
 def setup_radia_path():
 	"""
 	Setup Python path to import radia module from build directory.
@@ -60,3 +62,53 @@ def pytest_configure(config):
 	config.addinivalue_line("markers", "comprehensive: comprehensive test suite")
 	config.addinivalue_line("markers", "slow: tests that take more than 10 seconds")
 	config.addinivalue_line("markers", "benchmark: performance benchmarks")
+
+# Shared test geometries
+@pytest.fixture(scope="session")
+def create_girder():
+	"""
+	Factory of an oblique row of 24 linear iron blocks above a permanent magnet (H-matrix tests).
+
+	create_girder() deletes all objects and returns the new container; its first 24 members
+	are the iron blocks.
+	"""
+	import radia as rad
+
+	def create():
+		rad.UtiDelAll()
+		rad.FldUnits('mm')
+
+		mat = rad.MatLin([1000, 1000], [0, 0, 1e-6])
+		blocks = []
+		for i in range(24):
+			blk = rad.ObjRecMag([12*i, 4*i, 0], [10, 10, 10], [0, 0, 0])
+			rad.ObjDivMag(blk, [2, 1, 3])
+			rad.MatApl(blk, mat)
+			blocks.append(blk)
+		magnet = rad.ObjRecMag([140, 46, -30], [300, 120, 20], [0, 0, 1.2])
+		return rad.ObjCnt(blocks + [magnet])
+
+	return create
+
+
+@pytest.fixture(scope="session")
+def create_iron_with_magnet():
+	"""
+	Factory of a subdivided iron block above a permanent magnet (relaxation tests).
+
+	create_iron_with_magnet(make_mat=None, div=(3, 3, 2)) deletes all objects and returns the
+	new container; make_mat() returns the iron material, by default a saturable isotropic iron.
+	"""
+	import radia as rad
+
+	def create(make_mat=None, div=(3, 3, 2)):
+		rad.UtiDelAll()
+		rad.FldUnits('mm')
+
+		magnet = rad.ObjRecMag([0, 0, -30], [20, 20, 20], [0, 0, 1.2])
+		iron = rad.ObjRecMag([0, 0, 0], [30, 30, 20], [0, 0, 0])
+		rad.ObjDivMag(iron, list(div))
+		rad.MatApl(iron, make_mat() if make_mat else rad.MatSatIsoFrm([20000, 2], [0.1, 2], [0.1, 2]))
+		return rad.ObjCnt([magnet, iron])
+
+	return create
@@ -0,0 +1,90 @@
+"""
+Unit tests for cancellation and progress reporting of long computations
+
+Tests that:
+- UtiProgress reports the points of a field list, the interaction matrix columns and the relaxation iterations
+- UtiCancel from a RlxMonitor callback aborts the relaxation, and later computations run normally
+- A cancellation request made between computations does not affect the next one
+- Ctrl-C (SIGINT) interrupts a long field computation with KeyboardInterrupt
+"""
+
+import sys
+import os
+import time
+import subprocess
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+
+def create_relax_problem():
+	"""Nonlinear blocks in the field of a current block"""
+	rad.UtiDelAll()
+	blocks = [rad.ObjRecMag([12*i, 0, 0], [10, 10, 10], [0, 0, 0]) for i in range(3)]
+	mag = rad.ObjCnt(blocks)
+	rad.ObjDivMag(mag, [2, 2, 2])
+	rad.MatApl(mag, rad.MatSatIsoFrm([20000, 2], [0.1, 2], [0.1, 2]))
+	src = rad.ObjRecCur([12, 0, 25], [20, 8, 4], [0, 2., 0])
+	return mag, src
+
+
+class TestCancelProgress:
+	"""Test cancellation requests and progress counters"""
+
+	def test_field_progress(self):
+		rad.UtiDelAll()
+		grp = rad.ObjCnt([rad.ObjRecMag([3*i, 0, 0], [2, 2, 2], [0, 0, 1]) for i in range(5)])
+		rad.Fld(grp, 'b', [[k, 1, 5] for k in range(300)])
+		assert rad.UtiProgress() == [300, 300]
+		rad.Fld(grp, 'bh', [1, 2, 3])
+		assert rad.UtiProgress() == [1, 1]
+
+	def test_relaxation_progress(self):
+		mag, src = create_relax_problem()
+		intrc = rad.RlxPre(mag, src)
+		assert rad.UtiProgress() == [24, 24]
+		res = rad.RlxAuto(intrc, 1e-5, 1000)
+		assert rad.UtiProgress() == [len(rad.RlxTelemetry()), 1000]
+		assert res[3] < 1000
+
+	def test_cancel_from_monitor(self):
+		mag, src = create_relax_problem()
+		intrc = rad.RlxPre(mag, src)
+		rad.RlxMonitor(lambda info: rad.UtiCancel() and False if info['iter'] == 2 else False)
+		try:
+			with pytest.raises(RuntimeError, match="aborted"):
+				rad.RlxAuto(intrc, 1e-9, 1000)
+		finally:
+			rad.RlxMonitor(None)
+		assert len(rad.RlxTelemetry()) == 2
+		res = rad.RlxAuto(intrc, 1e-5, 1000)
+		assert res[0] < 1e-5
+
+	def test_request_between_computations(self):
+		mag, src = create_relax_problem()
+		rad.UtiCancel()
+		res = rad.Solve(rad.ObjCnt([mag, src]), 1e-5, 1000)
+		assert res[0] < 1e-5
+
+	@pytest.mark.skipif(sys.platform == 'win32', reason="sends SIGINT with kill")
+	def test_ctrl_c_interrupts_field(self):
+		rad.UtiDelAll()
+		grp = rad.ObjCnt([rad.ObjRecMag([i, j, 0], [1, 1, 1], [0, 0, 1]) for i in range(40) for j in range(40)])
+		ref = rad.Fld(grp, 'b', [1, 2, 3])
+		pts = [[1e-4*k, 3, 5] for k in range(200000)]
+		killer = subprocess.Popen(['sh', '-c', 'sleep 0.3; kill -INT %d' % os.getpid()])
+		t = time.time()
+		try:
+			with pytest.raises(KeyboardInterrupt):
+				rad.Fld(grp, 'b', pts)
+		finally:
+			killer.wait()
+		assert time.time() - t < 10
+		done, total = rad.UtiProgress()
+		assert done < total
+		assert rad.Fld(grp, 'b', [1, 2, 3]) == ref
+
+
+if __name__ == "__main__":
+	pytest.main([__file__, "-v"])
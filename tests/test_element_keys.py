@@ -0,0 +1,53 @@
+"""
+Unit tests for the keys of new elements
+
+Tests that:
+- Objects created after an aborted computation get new keys and existing elements are kept
+- UtiDelAll restarts the keys at 1
+"""
+
+import sys
+import os
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+
+def create_problem():
+	"""Subdivided linear iron block above a permanent magnet"""
+	rad.UtiDelAll()
+	iron = rad.ObjRecMag([0, 0, 0], [10, 10, 10], [0, 0, 0])
+	rad.ObjDivMag(iron, [2, 2, 2])
+	rad.MatApl(iron, rad.MatLin([1000, 1000], [0, 0, 1e-6]))
+	magnet = rad.ObjRecMag([0, 0, 20], [10, 10, 5], [0, 0, 1])
+	return iron, magnet, rad.ObjCnt([iron, magnet])
+
+
+class TestElementKeys:
+	"""Test that keys of existing elements are not reused"""
+
+	def test_keys_after_abort(self):
+		iron, magnet, grp = create_problem()
+		intrc = rad.RlxPre(grp)
+		rad.RlxMonitor(lambda info: rad.UtiCancel() and False)
+		try:
+			with pytest.raises(RuntimeError, match="aborted"):
+				rad.RlxAuto(intrc, 1e-9, 100)
+		finally:
+			rad.RlxMonitor(None)
+
+		obj = rad.ObjRecMag([0, 0, -20], [1, 1, 1], [0, 0, 2])
+		assert obj > intrc
+		assert len(rad.ObjM(iron)) == 8
+		assert rad.ObjM(magnet)[1] == pytest.approx([0, 0, 1], abs=1e-8)
+		assert rad.ObjM(obj)[1] == pytest.approx([0, 0, 2], abs=1e-8)
+
+	def test_keys_after_delete_all(self):
+		create_problem()
+		rad.UtiDelAll()
+		assert rad.ObjRecMag([0, 0, 0], [1, 1, 1]) == 1
+
+
+if __name__ == "__main__":
+	pytest.main([__file__, "-v"])
@@ -0,0 +1,93 @@
+"""
+Unit tests for the flattened field evaluation plan of groups and transformations
+
+Tests that:
+- Field lists of nested groups with symmetries, mirrors and other sources match the point-by-point field
+- A multiplicity transformation gives the field of the explicitly transformed duplicates
+- Relaxation with an external source object gives the same result as the source in the relaxed container
+"""
+
+import sys
+import os
+import math
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+
+def create_tree(mult=4):
+	"""Blocks, tetrahedra, an arc current and a current block in nested groups with a mirror and a rotation symmetry"""
+	rad.UtiDelAll()
+	blocks = [rad.ObjRecMag([12*i + 3, 4, 1], [8, 6, 5], [0.2*i, 0.3, 1.0]) for i in range(3)]
+	rad.ObjDivMag(blocks[1], [2, 1, 2])
+	rad.TrfOrnt(blocks[2], rad.TrfRot([27, 4, 1], [1, 1, 0], 0.4))
+	tets = [rad.ObjPolyhdr([[x, 12, 0], [x + 4, 12, 0], [x, 16, 0], [x, 12, 4]], [[1, 3, 2], [1, 2, 4], [1, 4, 3], [2, 3, 4]], [0.5, -0.2, 0.7]) for x in (0, 6, 12)]
+	sub = rad.ObjCnt(tets)
+	rad.TrfZerPara(sub, [0, 10, 0], [0, 1, 0])
+	mag = rad.ObjCnt(blocks + [sub])
+	rad.TrfZerPerp(mag, [0, 0, -6], [0, 0, 1])
+	arc = rad.ObjArcCur([5, 5, 8], [6, 9], [0, 1.2], 3, 6, 0.8)
+	grp = rad.ObjCnt([mag, arc, rad.ObjRecCur([5, -10, 3], [6, 4, 2], [0.5, 0, 0])])
+	if mult > 1:
+		rad.TrfMlt(grp, rad.TrfRot([0, 0, 0], [0, 0, 1], 2*math.pi/mult), mult)
+	return grp
+
+
+def field_points():
+	return [[-35 + 0.9*k, 3 + 0.43*k, 2 - 0.07*k] for k in range(80)] + [[3, 4, 1], [16, 4, 1], [7, 4, 1]]
+
+
+def rel_err(ref, res):
+	num = sum((a - b)**2 for u, v in zip(ref, res) for a, b in zip(u, v))
+	den = sum(a*a for u in ref for a in u)
+	return math.sqrt(num/den)
+
+
+class TestFieldPlan:
+	"""Test the flattened plan against the point-by-point field and explicit duplicates"""
+
+	@pytest.mark.parametrize("field", ['b', 'h', 'a', 'm', 'bham'])
+	def test_field_list_matches_points(self, field):
+		grp = create_tree()
+		pts = field_points()
+		res = rad.Fld(grp, field, pts)
+		ref = [rad.Fld(grp, field, p) for p in pts]
+		assert rel_err(ref, res) < 1e-12
+
+	@pytest.mark.parametrize("field", ['b', 'h', 'a'])
+	def test_multiplicity_matches_duplicates(self, field):
+		grp = create_tree()
+		pts = field_points()
+		res = rad.Fld(grp, field, pts)
+		dpl = [create_tree(1)]
+		for k in range(1, 4):
+			d = rad.ObjDpl(dpl[0])
+			rad.TrfOrnt(d, rad.TrfRot([0, 0, 0], [0, 0, 1], k*math.pi/2))
+			dpl.append(d)
+		ref = rad.Fld(rad.ObjCnt(dpl), field, pts)
+		assert rel_err(ref, res) < 1e-8
+
+	def test_relaxation_with_external_source(self):
+		res = []
+		for external in (True, False):
+			rad.UtiDelAll()
+			els = []
+			for i in range(3):
+				b = rad.ObjRecMag([12*i, 0, 0], [10, 10, 10], [0, 0, 0])
+				rad.ObjDivMag(b, [2, 2, 2])
+				els.append(b)
+			mag = rad.ObjCnt(els)
+			rad.TrfZerPerp(mag, [0, 0, -8], [0, 0, 1])
+			rad.MatApl(mag, rad.MatLin(100))
+			src = rad.ObjCnt([rad.ObjRecCur([12, 0, 25], [20, 8, 4], [0, 2., 0]), rad.ObjRecMag([0, 30, 0], [5, 5, 5], [0, 1, 0.5])])
+			rad.TrfMlt(src, rad.TrfRot([12, 0, 0], [0, 0, 1], math.pi/2), 2)
+			rlx = rad.RlxPre(mag, src) if external else rad.RlxPre(rad.ObjCnt([mag, src]))
+			rad.RlxAuto(rlx, 1e-9, 1000)
+			res.append([m for e in els for p, m in rad.ObjM(e)])
+		assert max(abs(a) for m in res[0] for a in m) > 1e-3
+		assert rel_err(res[1], res[0]) < 1e-8
+
+
+if __name__ == "__main__":
+	pytest.main([__file__, "-v"])
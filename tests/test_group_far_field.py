@@ -0,0 +1,102 @@
+"""
+Unit tests for the treecode far field of groups (FldCmpPrc option PrcFar)
+
+Tests that:
+- Field lists of a large group agree with the exact field to the requested relative accuracy
+- Symmetry images, currents and background fields of the group are included
+- Points inside members get the exact B and H of the member (near field)
+- A negative PrcFar switches the treecode off (exact field again)
+- PrcFar can be given together with all other precision options
+"""
+
+import sys
+import os
+import math
+import random
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+
+@pytest.fixture(autouse=True)
+def exact_far_field():
+	yield
+	rad.FldCmpPrc('PrcFar->-1')
+
+
+def create_group(n=8):
+	"""Randomly magnetized blocks and tetrahedra, a mirror image, a current block and a background field"""
+	rad.UtiDelAll()
+	random.seed(7)
+	els = []
+	for i in range(n):
+		for j in range(n):
+			for k in range(3):
+				m = [random.uniform(-1, 1) for c in range(3)]
+				els.append(rad.ObjRecMag([i*10., j*10., k*10.], [8, 8, 8], m))
+	for i in range(20):
+		x = 5.*i
+		verts = [[x, -20, 0], [x + 4, -20, 0], [x, -16, 0], [x, -20, 4]]
+		els.append(rad.ObjPolyhdr(verts, [[1, 3, 2], [1, 2, 4], [1, 4, 3], [2, 3, 4]], [0.3, 0.5, -0.2]))
+	mag = rad.ObjCnt(els)
+	rad.TrfZerPerp(mag, [0, 0, -10], [0, 0, 1])
+	cur = rad.ObjRecCur([35, 35, 60], [20, 20, 5], [0, 1., 0])
+	grp = rad.ObjCnt([mag, cur, rad.ObjBckg([0.01, 0.02, 0.03])])
+	rad.TrfOrnt(grp, rad.TrfRot([0, 0, 0], [0, 0, 1], 0.3))
+	return grp
+
+
+def field_points(count=300):
+	random.seed(11)
+	return [[random.uniform(-40, 110), random.uniform(-40, 110), random.uniform(-50, 70)] for k in range(count)]
+
+
+def rms_err(ref, res):
+	num = sum(sum((a - b)**2 for a, b in zip(r, s)) for r, s in zip(ref, res))
+	den = sum(sum(a*a for a in r) for r in ref)
+	return math.sqrt(num/den)
+
+
+class TestGroupFarField:
+	"""Test field lists of groups evaluated with aggregated multipole moments"""
+
+	@pytest.mark.parametrize("prec", [1e-3, 1e-5])
+	@pytest.mark.parametrize("field", ['b', 'h', 'bh'])
+	def test_accuracy(self, prec, field):
+		grp = create_group()
+		pts = field_points()
+		ref = rad.Fld(grp, field, pts)
+		rad.FldCmpPrc('PrcFar->%g' % prec)
+		res = rad.Fld(grp, field, pts)
+		assert rms_err(ref, res) < prec
+		assert res != ref
+
+	def test_points_inside_members(self):
+		grp = create_group()
+		pts = [[10.5*i, 20.2, 10.3] for i in range(8)] + [[1 + 5.*i, -19, 1] for i in range(20)]
+		ref = rad.Fld(grp, 'bh', pts)
+		rad.FldCmpPrc('PrcFar->1e-4')
+		res = rad.Fld(grp, 'bh', pts)
+		for r, s in zip(ref, res):
+			assert rms_err([r[:3]], [s[:3]]) < 1e-2
+			m_ref = [r[c] - r[c + 3] for c in range(3)]
+			m_res = [s[c] - s[c + 3] for c in range(3)]
+			assert max(abs(a) for a in m_ref) > 0.01
+			assert max(abs(a - b) for a, b in zip(m_ref, m_res)) < 1e-9
+
+	def test_switch_off(self):
+		grp = create_group()
+		pts = field_points(150)
+		ref = rad.Fld(grp, 'b', pts)
+		rad.FldCmpPrc('PrcFar->1e-2')
+		assert rad.Fld(grp, 'b', pts) != ref
+		rad.FldCmpPrc('PrcFar->-1')
+		assert rad.Fld(grp, 'b', pts) == ref
+
+	def test_all_precision_options(self):
+		grp = create_group(4)
+		pts = field_points(100)
+		ref = rad.Fld(grp, 'b', pts)
+		rad.FldCmpPrc('PrcB->0.0001,PrcA->0.001,PrcBInt->0.001,PrcForce->1,PrcTorque->10,PrcEnergy->10,PrcCoord->-1,PrcAngle->-1,PrcFar->1e-6')
+		assert rms_err(ref, rad.Fld(grp, 'b', pts)) < 1e-6
@@ -0,0 +1,91 @@
+"""
+Unit tests for the automatic tuning of the relaxation H-matrix parameters
+
+Tests that:
+- The selected eps / max_rank meet the target relative error (a-posteriori estimate)
+- A tighter target selects a tighter eps
+- The next relaxation starts from the tuned parameters
+- The tuned solution agrees with a tightly approximated one
+"""
+
+import sys
+import os
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+
+def create_cube():
+	"""Subdivided linear iron cube on a permanent magnet (343 elements)"""
+	rad.UtiDelAll()
+	rad.FldUnits('mm')
+	cube = rad.ObjRecMag([0, 0, 0], [40, 40, 40], [0, 0, 0])
+	rad.ObjDivMag(cube, [7, 7, 7])
+	rad.MatApl(cube, rad.MatLin([10, 10], [0, 0, 1e-6]))
+	magnet = rad.ObjRecMag([0, 0, -40], [40, 40, 20], [0, 0, 1.2])
+	return rad.ObjCnt([cube, magnet])
+
+
+def solve(eps=1e-4, target=0.):
+	grp = create_cube()
+	rad.SolverHMatrixEnable(1, eps, 30, target=target)
+	try:
+		rad.Solve(grp, 0.0001, 1000)
+	finally:
+		rad.SolverHMatrixDisable()
+	return grp
+
+
+class TestHMatrixAutoTune:
+	"""Test automatic H-matrix parameter tuning"""
+
+	def test_target_met(self, capfd):
+		"""Tuned parameters meet the target, tighter targets give tighter eps"""
+		rad.ClearHMatrixCache()
+		solve(target=1e-2)
+		eps_loose, rank_loose, err_loose = rad.SolverHMatrixTuned()
+		solve(target=1e-4)
+		eps_tight, rank_tight, err_tight = rad.SolverHMatrixTuned()
+		out = capfd.readouterr().out
+
+		assert "[Auto-tune] Selected" in out
+		assert 0 < err_loose <= 1e-2
+		assert 0 < err_tight <= 1e-4
+		assert eps_tight < eps_loose
+
+	def test_restart_from_tuned(self, capfd):
+		"""The next relaxation with the same target builds with the tuned parameters first"""
+		solve(target=1e-3)
+		eps, max_rank, err = rad.SolverHMatrixTuned()
+		capfd.readouterr()
+		solve(target=1e-3)
+		out = capfd.readouterr().out
+
+		trials = [l for l in out.splitlines() if l.startswith("[Auto-tune] eps=")]
+		assert trials[0].startswith("[Auto-tune] eps=%g, max_rank=%d:" % (eps, max_rank))
+		assert rad.SolverHMatrixTuned()[2] <= 1e-3
+
+	def test_tuned_solution(self):
+		"""Field of the tuned relaxation agrees with a tightly approximated one"""
+		pts = [[0, 0, 30], [10, 5, 40], [35, 0, 0]]
+		rad.ClearHMatrixCache()
+		ref = [rad.Fld(solve(eps=1e-8), 'b', p) for p in pts]
+		rad.ClearHMatrixCache()
+		res = [rad.Fld(solve(target=1e-3), 'b', p) for p in pts]
+		scale = max(abs(x) for b in ref for x in b)
+		for br, b in zip(ref, res):
+			for r, x in zip(br, b):
+				assert x == pytest.approx(r, abs=1e-2*scale)
+
+	def test_no_tuning_by_default(self):
+		"""Without a target, eps and max_rank are used as given"""
+		rad.SolverHMatrixEnable(1, 1e-4, 30)
+		rad.SolverHMatrixDisable()
+		before = rad.SolverHMatrixTuned()
+		solve()
+		assert rad.SolverHMatrixTuned() == before
+
+
+if __name__ == "__main__":
+	pytest.main([__file__, "-v"])
@@ -0,0 +1,62 @@
+"""
+Unit tests for H-matrix cluster splitting and admissibility parameters
+
+Tests clustering controls of the H-matrix solver and field evaluation:
+- SolverHMatrixEnable() eta / leaf_size / split keyword arguments
+- Agreement of every splitting strategy with the dense solution
+- Validation of invalid clustering parameters
+- SetHMatrixFieldEval() clustering arguments
+"""
+
+import sys
+import os
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+
+def solve_and_probe(grp, use_hmatrix, **kwargs):
+	if use_hmatrix:
+		rad.SolverHMatrixEnable(1, 1e-6, 2, **kwargs)
+	else:
+		rad.SolverHMatrixDisable()
+	try:
+		rad.Solve(grp, 1e-8, 1000, 9)
+		return rad.Fld(grp, 'b', [140, 46, 15])
+	finally:
+		rad.SolverHMatrixDisable()
+
+
+class TestHMatrixClustering:
+	"""Test splitting strategies and clustering parameters"""
+
+	@pytest.mark.parametrize("split", [1, 2, 3])
+	def test_split_matches_dense(self, create_girder, split):
+		"""Each splitting strategy reproduces the dense solution"""
+		ref = solve_and_probe(create_girder(), False)
+		res = solve_and_probe(create_girder(), True, eta=1.5, leaf_size=8, split=split)
+		for r, b in zip(ref, res):
+			assert b == pytest.approx(r, rel=1e-4, abs=1e-6)
+
+	@pytest.mark.parametrize("kwargs", [
+		{'split': 0}, {'split': 4}, {'eta': 0.0}, {'eta': -1.0}, {'leaf_size': 0}])
+	def test_invalid_solver_parameters(self, kwargs):
+		"""Invalid clustering parameters are rejected"""
+		with pytest.raises(RuntimeError):
+			rad.SolverHMatrixEnable(1, 1e-6, 2, **kwargs)
+		rad.SolverHMatrixDisable()
+
+	def test_field_eval_clustering(self):
+		"""SetHMatrixFieldEval() accepts and validates clustering arguments"""
+		rad.SetHMatrixFieldEval(1, 1e-6, 2.0, 10, 2)
+		rad.SetHMatrixFieldEval(1, 1e-6)
+		with pytest.raises(RuntimeError):
+			rad.SetHMatrixFieldEval(1, 1e-6, 2.0, 10, 5)
+		with pytest.raises(RuntimeError):
+			rad.SetHMatrixFieldEval(1, 1e-6, 0.0, 10, 3)
+		rad.SetHMatrixFieldEval(0)
+
+
+if __name__ == "__main__":
+	pytest.main([__file__, "-v"])
@@ -0,0 +1,68 @@
+"""
+Unit tests for the H2-matrix (nested cluster basis) relaxation solver
+
+Tests SolverHMatrixEnable(..., h2=1):
+- Agreement of the H2-matrix solution with the dense solution
+- Agreement with the H-matrix solution for a non-symmetric geometry
+"""
+
+import sys
+import os
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+
+def create_yoke():
+	"""C-shaped linear iron yoke (subdivided) excited by a permanent magnet"""
+	rad.UtiDelAll()
+	rad.FldUnits('mm')
+
+	mat = rad.MatLin([2000, 2000], [0, 0, 1e-6])
+	parts = []
+	for (c, d, div) in [([0, 0, 40], [100, 20, 20], [10, 2, 2]),
+	                    ([0, 0, -40], [100, 20, 20], [10, 2, 2]),
+	                    ([-40, 0, 0], [20, 20, 60], [2, 2, 6])]:
+		blk = rad.ObjRecMag(c, d, [0, 0, 0])
+		rad.ObjDivMag(blk, div)
+		rad.MatApl(blk, mat)
+		parts.append(blk)
+	magnet = rad.ObjRecMag([40, 0, 20], [20, 20, 10], [0, 0, 1.2])
+	return rad.ObjCnt(parts + [magnet])
+
+
+def solve_and_probe(mode):
+	grp = create_yoke()
+	if mode == 'dense':
+		rad.SolverHMatrixDisable()
+	else:
+		rad.SolverHMatrixEnable(1, 1e-6, 50, leaf_size=16, h2=(1 if mode == 'h2' else 0))
+	try:
+		res = rad.Solve(grp, 1e-8, 1000, 9)
+		return res, rad.Fld(grp, 'b', [0, 0, 0]) + rad.Fld(grp, 'b', [20, 5, 10])
+	finally:
+		rad.SolverHMatrixDisable()
+
+
+class TestHMatrixH2:
+	"""Test H2-matrix relaxation"""
+
+	def test_h2_matches_dense(self):
+		"""H2-matrix relaxation reproduces the dense solution"""
+		res_ref, ref = solve_and_probe('dense')
+		res, b = solve_and_probe('h2')
+		assert res[0] < 1e-8
+		for r, v in zip(ref, b):
+			assert v == pytest.approx(r, rel=1e-4, abs=1e-6)
+
+	def test_h2_matches_hmatrix(self):
+		"""H2-matrix and H-matrix relaxation agree"""
+		_, ref = solve_and_probe('hmatrix')
+		_, b = solve_and_probe('h2')
+		for r, v in zip(ref, b):
+			assert v == pytest.approx(r, rel=1e-4, abs=1e-6)
+
+
+if __name__ == "__main__":
+	pytest.main([__file__, "-v"])
@@ -0,0 +1,75 @@
+"""
+Unit tests for the incremental update of the relaxation H-matrix
+
+Tests that a relaxation after moving part of the geometry:
+- Recomputes only the blocks of the moved elements
+- Gives the same solution as a relaxation with a rebuilt H-matrix
+- Rebuilds the H-matrix if most elements changed
+"""
+
+import sys
+import os
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+N_BLOCKS = 24
+
+
+def solve(grp):
+	rad.SolverHMatrixEnable(1, 1e-8, 50, eta=1.0, leaf_size=8)
+	try:
+		rad.Solve(grp, 0.0001, 1000)
+	finally:
+		rad.SolverHMatrixDisable()
+
+
+def field(grp):
+	return [rad.Fld(grp, 'b', [12*i + 3, 4*i, 8]) for i in range(0, N_BLOCKS, 3)]
+
+
+def assert_same_field(res, ref):
+	scale = max(abs(x) for b in ref for x in b)
+	for br, b in zip(ref, res):
+		for r, x in zip(br, b):
+			assert x == pytest.approx(r, abs=1e-4*scale)
+
+
+class TestHMatrixIncremental:
+	"""Test incremental update of the relaxation H-matrix"""
+
+	def test_moved_block(self, create_girder):
+		"""Moving one block updates the H-matrix and matches a rebuilt one"""
+		shift = (5, [0, 0, 3])
+
+		rad.ClearHMatrixCache()
+		grp = create_girder()
+		rad.TrfOrnt(rad.ObjCntStuf(grp)[shift[0]], rad.TrfTrsl(shift[1]))
+		solve(grp)
+		ref = field(grp)
+
+		rad.ClearHMatrixCache()
+		grp = create_girder()
+		solve(grp)
+		assert rad.GetHMatrixStats()[3] == -1
+		rad.TrfOrnt(rad.ObjCntStuf(grp)[shift[0]], rad.TrfTrsl(shift[1]))
+		solve(grp)
+		assert rad.GetHMatrixStats()[3] == 6
+
+		assert_same_field(field(grp), ref)
+
+	def test_new_geometry_rebuilds(self, create_girder):
+		"""A new geometry (all elements replaced) is not updated"""
+		grp = create_girder()
+		solve(grp)
+		rad.TrfOrnt(rad.ObjCntStuf(grp)[0], rad.TrfTrsl([0, 0, 3]))
+		solve(grp)
+		assert rad.GetHMatrixStats()[3] == 6
+		grp = create_girder()
+		solve(grp)
+		assert rad.GetHMatrixStats()[3] == -1
+
+
+if __name__ == "__main__":
+	pytest.main([__file__, "-v"])
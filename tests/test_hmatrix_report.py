@@ -0,0 +1,95 @@
+"""
+Unit tests for the per-block H-matrix report
+
+Tests HMatrixReport() and HMatrixReportStats():
+- Block records of the relaxation interaction matrix (9 tensor components)
+- Kernel calls and error estimates recorded only on request
+- Near/far-field breakdown and rank histogram consistent with the blocks
+- JSON export
+"""
+
+import sys
+import os
+import json
+import math
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+
+def build_report(grp, stats):
+	rad.HMatrixReportStats(stats)
+	rad.SolverHMatrixEnable(1, 1e-6, 30, eta=1.0, leaf_size=8)
+	try:
+		rad.Solve(grp, 1e-8, 1000, 9)
+	finally:
+		rad.SolverHMatrixDisable()
+		rad.HMatrixReportStats(0)
+	return rad.HMatrixReport()['relaxation']
+
+
+@pytest.fixture(scope="module")
+def report(create_girder):
+	return build_report(create_girder(), 1)
+
+
+class TestHMatrixReport:
+	"""Test per-block H-matrix report"""
+
+	def test_blocks_cover_matrix(self, report):
+		"""Blocks of every tensor component tile the N x N matrix"""
+		n = 24*6  # the magnet without material is not relaxed
+		for comp in range(9):
+			blocks = [b for b in report['blocks'] if b['comp'] == comp]
+			assert sum(b['rows']*b['cols'] for b in blocks) == n*n
+
+	def test_block_records(self, report):
+		"""Kernel calls, ranks and estimated errors of the blocks"""
+		far = [b for b in report['blocks'] if b['low_rank']]
+		near = [b for b in report['blocks'] if not b['low_rank']]
+		assert len(far) > 0 and len(near) > 0
+		for b in near:
+			assert b['kernel_calls'] == b['rows']*b['cols']
+			assert b['rank'] == 0 and b['est_error'] == 0
+		for b in far:
+			assert b['kernel_calls'] > 0
+			assert b['rank'] <= min(b['rows'], b['cols'])
+			assert 0 <= b['est_error'] <= 1.0 + 1e-12
+			# ACA drops residual entries below the (absolute) tolerance 1e-6
+			assert b['est_error']*b['est_norm'] < 10*1e-6*math.sqrt(b['rows']*b['cols'])
+
+	def test_breakdown(self, report):
+		"""Near/far-field breakdown and rank histogram match the blocks"""
+		far = [b for b in report['blocks'] if b['low_rank']]
+		assert report['far']['blocks'] == len(far)
+		assert report['near']['blocks'] == len(report['blocks']) - len(far)
+		assert report['far']['kernel_calls'] == sum(b['kernel_calls'] for b in far)
+		assert report['far']['max_rank'] == max(b['rank'] for b in far)
+		hist = report['rank_histogram']
+		assert sum(hist) == len(far)
+		assert len(hist) == report['far']['max_rank'] + 1
+
+	def test_stats_off_by_default(self, create_girder, report):
+		"""Without HMatrixReportStats the same blocks are built, but not counted or sampled"""
+		plain = build_report(create_girder(), 0)
+		assert len(plain['blocks']) == len(report['blocks'])
+		for b, r in zip(plain['blocks'], report['blocks']):
+			assert (b['rows'], b['cols'], b['rank']) == (r['rows'], r['cols'], r['rank'])
+			assert b['kernel_calls'] == 0 and b['est_error'] == 0 and b['est_norm'] == 0
+
+	def test_json_export(self, report, tmp_path):
+		"""JSON export contains the same report"""
+		path = str(tmp_path / "hmatrix_report.json")
+		rad.HMatrixReport(path)
+		with open(path) as f:
+			data = json.load(f)
+		relax = data['relaxation']
+		assert relax['rank_histogram'] == report['rank_histogram']
+		assert relax['far']['blocks'] == report['far']['blocks']
+		assert len(relax['blocks']) == len(report['blocks'])
+		assert relax['blocks'][0]['rows'] == report['blocks'][0]['rows']
+
+
+if __name__ == "__main__":
+	pytest.main([__file__, "-v"])
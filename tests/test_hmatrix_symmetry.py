@@ -0,0 +1,74 @@
+"""
+Unit tests for the relaxation H-matrix of models with symmetries
+
+Tests that:
+- The H-matrix of a 4-fold rotationally symmetric model reproduces the dense N*M product
+- The symmetry order of the irreducible elements is reported
+- Repeated H-matrix interactions are released cleanly at interpreter exit
+"""
+
+import sys
+import os
+import math
+import subprocess
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+N_SEG = 12
+N_ELEM = N_SEG*9
+
+
+def create_ring():
+	"""Quarter ring of linear iron blocks, completed by a 4-fold rotation, above a permanent magnet"""
+	rad.UtiDelAll()
+	rad.FldUnits('mm')
+	blocks = []
+	for s in range(N_SEG):
+		a = (s + 0.5)*(math.pi/2)/N_SEG
+		for r in range(3):
+			R = 40 + 12*r
+			for z in range(3):
+				blocks.append(rad.ObjRecMag([R*math.cos(a), R*math.sin(a), 12*z], [6, 6, 10], [0, 0, 0]))
+	iron = rad.ObjCnt(blocks)
+	rad.MatApl(iron, rad.MatLin([100, 100], [0, 0, 1e-6]))
+	rad.TrfMlt(iron, rad.TrfRot([0, 0, 0], [0, 0, 1], math.pi/2), 4)
+	magnet = rad.ObjRecMag([0, 0, -30], [150, 150, 10], [0, 0, 1.2])
+	return rad.ObjCnt([iron, magnet])
+
+
+def hmatrix_interaction(eps):
+	grp = create_ring()
+	rad.SolverHMatrixEnable(1, eps, 50)
+	try:
+		return rad.RlxPre(grp)
+	finally:
+		rad.SolverHMatrixDisable()
+
+
+class TestHMatrixSymmetry:
+	"""Test H-matrix relaxation of symmetric models"""
+
+	def test_matvec_matches_dense(self, capfd):
+		"""Images are summed in the kernel; the compressed product matches the dense one"""
+		m = [[0.3 + 0.01*i, -0.2 + 0.003*i, 0.5] for i in range(N_ELEM)]
+		ref = rad.RlxMatVec(rad.RlxPre(create_ring()), m)
+		rad.ClearHMatrixCache()
+		capfd.readouterr()
+		res = rad.RlxMatVec(hmatrix_interaction(1e-4), m)
+		out = capfd.readouterr().out
+		assert "up to 4 images per element" in out
+		num = sum((a - b)**2 for u, v in zip(ref, res) for a, b in zip(u, v))
+		den = sum(a*a for u in ref for a in u)
+		assert math.sqrt(num/den) < 2e-3
+
+	def test_clean_exit(self):
+		"""Interactions alive at exit are destroyed without touching released caches"""
+		script = (
+			"import sys; sys.path[:0] = %r\n"
+			"from test_hmatrix_symmetry import hmatrix_interaction\n"
+			"hmatrix_interaction(1e-3)\n"
+			"hmatrix_interaction(1e-4)\n" % ([os.path.dirname(os.path.abspath(__file__))] + sys.path))
+		proc = subprocess.run([sys.executable, "-c", script], capture_output=True, timeout=600)
+		assert proc.returncode == 0, proc.stderr.decode()
@@ -0,0 +1,84 @@
+"""
+Unit tests for transposed interaction matrix products
+
+Tests RlxMatVec(intrc, M, trans):
+- Adjoint identity <u, N v> = <N^T u, v> for the dense interaction matrix
+- Entries of N^T are the transposed entries of N
+- Agreement of the H-matrix transposed product with the dense one
+"""
+
+import sys
+import os
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+N_ELEM = 24*6  # the magnet without material is not relaxed
+
+
+def build_interaction(grp, use_hmatrix):
+	if use_hmatrix:
+		rad.SolverHMatrixEnable(1, 1e-8, 50, eta=1.0, leaf_size=8)
+	else:
+		rad.SolverHMatrixDisable()
+	try:
+		return rad.RlxPre(grp)
+	finally:
+		rad.SolverHMatrixDisable()
+
+
+def make_vectors():
+	u = [[0.3 + 0.01*i, -0.2, 0.05*(i % 7)] for i in range(N_ELEM)]
+	v = [[0.1*(i % 5), 0.4 - 0.002*i, 0.7] for i in range(N_ELEM)]
+	return u, v
+
+
+def dot(a, b):
+	return sum(x*y for va, vb in zip(a, b) for x, y in zip(va, vb))
+
+
+class TestIntrcTranspose:
+	"""Test transposed interaction matrix products"""
+
+	def test_adjoint_identity_dense(self, create_girder):
+		"""<u, N v> = <N^T u, v> for the dense matrix"""
+		intrc = build_interaction(create_girder(), False)
+		u, v = make_vectors()
+		nv = rad.RlxMatVec(intrc, v)
+		ntu = rad.RlxMatVec(intrc, u, 1)
+		assert len(nv) == N_ELEM and len(ntu) == N_ELEM
+		assert dot(u, nv) == pytest.approx(dot(ntu, v), rel=1e-6)
+
+	def test_transposed_entries(self, create_girder):
+		"""(N e_j)[i] = (N^T e_i)[j]"""
+		intrc = build_interaction(create_girder(), False)
+		zero = [[0, 0, 0] for _ in range(N_ELEM)]
+		for (i, ci, j, cj) in [(0, 2, 5, 0), (17, 1, 90, 2), (143, 0, 3, 1)]:
+			ej = [list(m) for m in zero]; ej[j][cj] = 1.0
+			ei = [list(m) for m in zero]; ei[i][ci] = 1.0
+			col = rad.RlxMatVec(intrc, ej)
+			row = rad.RlxMatVec(intrc, ei, 1)
+			assert col[i][ci] == pytest.approx(row[j][cj], rel=1e-6, abs=1e-12)
+
+	def test_hmatrix_matches_dense(self, create_girder):
+		"""H-matrix products N v and N^T u agree with the dense ones"""
+		u, v = make_vectors()
+		intrc = build_interaction(create_girder(), False)
+		ref = rad.RlxMatVec(intrc, v) + rad.RlxMatVec(intrc, u, 1)
+		intrc = build_interaction(create_girder(), True)
+		res = rad.RlxMatVec(intrc, v) + rad.RlxMatVec(intrc, u, 1)
+		scale = max(abs(x) for h in ref for x in h)
+		for hr, h in zip(ref, res):
+			for r, x in zip(hr, h):
+				assert x == pytest.approx(r, abs=1e-4*scale)
+
+	def test_wrong_length(self, create_girder):
+		"""Magnetization array of wrong length is rejected"""
+		intrc = build_interaction(create_girder(), False)
+		with pytest.raises(RuntimeError):
+			rad.RlxMatVec(intrc, [[0, 0, 1]])
+
+
+if __name__ == "__main__":
+	pytest.main([__file__, "-v"])
@@ -0,0 +1,75 @@
+"""
+Unit tests for the lean field kernels selected by the requested quantities
+
+Tests that:
+- B, H, B and H, and A alone (lean kernels) agree with the same components of a full 'bham' request
+- Points inside polyhedra and blocks get B = H + M from the lean kernels
+- Single points match field lists for each lean quantity
+"""
+
+import sys
+import os
+import math
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+
+def create_group():
+	"""Tetrahedra, a subdivided polyhedron and blocks with a mirror and a rotation symmetry"""
+	rad.UtiDelAll()
+	tets = [rad.ObjPolyhdr([[x, 0, 0], [x + 4, 0, 0], [x, 4, 0], [x, 0, 4]], [[1, 3, 2], [1, 2, 4], [1, 4, 3], [2, 3, 4]], [0.5, -0.2, 0.7]) for x in (0, 6, 12)]
+	cube = rad.ObjPolyhdr([[0, 8, 0], [3, 8, 0], [3, 11, 0], [0, 11, 0], [0, 8, 3], [3, 8, 3], [3, 11, 3], [0, 11, 3]],
+		[[1, 4, 3, 2], [5, 6, 7, 8], [1, 2, 6, 5], [2, 3, 7, 6], [3, 4, 8, 7], [4, 1, 5, 8]], [0.1, 0.9, -0.3])
+	rad.ObjDivMag(cube, [2, 2, 1])
+	blocks = [rad.ObjRecMag([6*i + 2, -6, 1], [4, 3, 2], [0.3, 0.2*i, 1.0]) for i in range(3)]
+	grp = rad.ObjCnt(tets + [cube] + blocks)
+	rad.TrfZerPerp(grp, [0, 0, -3], [0, 0, 1])
+	rad.TrfMlt(grp, rad.TrfRot([0, 0, 0], [0, 0, 1], math.pi/2), 4)
+	return grp
+
+
+def field_points():
+	pts = [[-20 + 0.5*k, -15 + 0.37*k, 1.5 - 0.04*k] for k in range(80)]
+	pts += [[1, 1, 1], [7, 0.5, 0.5], [1.2, 9.1, 1.4], [2, -6, 1], [-1, 1, 1]]  # Inside tetrahedra, the cube and a block; an image
+	return pts
+
+
+def max_rel_diff(ref, res):
+	scale = max(abs(a) for u in ref for a in u)
+	return max(abs(a - b) for u, v in zip(ref, res) for a, b in zip(u, v))/scale
+
+
+class TestLeanField:
+	"""Test lean kernels against the general field record path"""
+
+	@pytest.mark.parametrize("field,cols", [('b', slice(0, 3)), ('h', slice(3, 6)), ('a', slice(6, 9)), ('bh', slice(0, 6))])
+	def test_matches_full_request(self, field, cols):
+		grp = create_group()
+		pts = field_points()
+		full = rad.Fld(grp, 'bham', pts)
+		res = rad.Fld(grp, field, pts)
+		assert max_rel_diff([f[cols] for f in full], res) < 1e-13
+
+	def test_inside_b_equals_h_plus_m(self):
+		grp = create_group()
+		pts = field_points()[-5:]
+		b = rad.Fld(grp, 'b', pts)
+		h = rad.Fld(grp, 'h', pts)
+		m = rad.Fld(grp, 'm', pts)
+		for u, v, w in zip(b, h, m):
+			assert max(abs(x) for x in w) > 0.1
+			assert max(abs(x - (y + z)) for x, y, z in zip(u, v, w)) < 1e-12
+
+	@pytest.mark.parametrize("field", ['b', 'h', 'a', 'bh'])
+	def test_points_match_list(self, field):
+		grp = create_group()
+		pts = field_points()
+		res = rad.Fld(grp, field, pts)
+		for p, r in zip(pts, res):
+			assert r == rad.Fld(grp, field, p)
+
+
+if __name__ == "__main__":
+	pytest.main([__file__, "-v"])
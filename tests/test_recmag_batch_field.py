@@ -0,0 +1,88 @@
+"""
+Unit tests for the batch field kernel of rectangular magnet blocks
+
+Tests that:
+- Field lists of block sets (containers, subdivision, symmetries) match the point-by-point field
+- Points inside blocks and on their faces get the same B and H as the scalar kernel
+- FldBatch of block sets matches the direct evaluation; other sources keep the scalar path
+"""
+
+import sys
+import os
+import math
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+
+def create_blocks(sym=False, subdivide=False):
+	"""Rotated and translated permanent magnet blocks, optionally subdivided and completed by symmetries"""
+	rad.UtiDelAll()
+	rad.FldUnits('mm')
+	blocks = []
+	for i in range(6):
+		for j in range(4):
+			m = [0.3*math.cos(i + j), 0.2*math.sin(2*i), 1.1 - 0.1*j]
+			b = rad.ObjRecMag([14*i + 2, 12*j + 3, 0.5*i], [10, 8, 6 + j], m)
+			if subdivide:
+				rad.ObjDivMag(b, [2, 2, 1])
+			blocks.append(b)
+	grp = rad.ObjCnt(blocks)
+	rad.TrfOrnt(blocks[5], rad.TrfRot([20, 10, 0], [0, 0, 1], 0.3))
+	if sym:
+		rad.TrfZerPerp(grp, [0, 0, -10], [0, 0, 1])
+		rad.TrfMlt(grp, rad.TrfRot([0, 0, 0], [0, 0, 1], math.pi/2), 4)
+	return grp
+
+
+def field_points():
+	pts = [[-20 + 1.7*k, 7 + 0.31*k, 1 + 0.05*k*k % 9] for k in range(80)]
+	pts += [[2, 3, 0], [7, 3, 0], [16, 15, 0.5], [2, 7, 3.5]]  # Block centres, a face centre and an edge
+	return pts
+
+
+def rel_err(ref, res):
+	num = sum((a - b)**2 for u, v in zip(ref, res) for a, b in zip(u, v))
+	den = sum(a*a for u in ref for a in u)
+	return math.sqrt(num/den)
+
+
+class TestRecMagBatchField:
+	"""Test the batch kernel against the point-by-point field"""
+
+	@pytest.mark.parametrize("kw", [{}, {"subdivide": True}, {"sym": True}])
+	@pytest.mark.parametrize("field", ['b', 'h', 'bz'])
+	def test_field_list_matches_points(self, kw, field):
+		grp = create_blocks(**kw)
+		pts = field_points()
+		res = rad.Fld(grp, field, pts)
+		ref = [rad.Fld(grp, field, p) for p in pts]
+		if field == 'bz':
+			res = [[v] for v in res]
+			ref = [[v] for v in ref]
+		assert rel_err(ref, res) < 1e-12
+
+	def test_field_line_matches_points(self):
+		grp = create_blocks(sym=True)
+		res = rad.FldLst(grp, 'bxbz', [-30.7, 5.3, 2.1], [59.3, 5.3, 2.1], 31, 'arg', 0)  # Off the block faces
+		ref = [[x] + rad.Fld(grp, 'bxbz', [-30.7 + 3*k, 5.3, 2.1]) for k, x in enumerate(r[0] for r in res)]
+		assert rel_err(ref, res) < 1e-12
+
+	@pytest.mark.parametrize("field", ['b', 'h'])
+	def test_fldbatch_matches_direct(self, field):
+		"""FldBatch does not apply the transformations of the object itself; the symmetries belong to a member here"""
+		grp = rad.ObjCnt([create_blocks(sym=True)])
+		pts = field_points()
+		res = rad.FldBatch(grp, field, pts, 0)
+		ref = [rad.Fld(grp, field, p) for p in pts]
+		assert rel_err(ref, res) < 1e-12
+
+	def test_other_sources(self):
+		"""A coil in the container disables the batch kernel; the field is unchanged"""
+		grp = create_blocks()
+		rad.ObjAddToCnt(grp, [rad.ObjRaceTrk([30, 20, 40], [5, 10], [10, 10], 6, 3, 1.0)])
+		pts = field_points()
+		res = rad.Fld(grp, 'b', pts)
+		ref = [rad.Fld(grp, 'b', p) for p in pts]
+		assert rel_err(ref, res) < 1e-12
@@ -0,0 +1,102 @@
+"""
+Unit tests for the space-filling-curve order of relaxable elements
+
+Tests that:
+- Interaction matrix products (RlxMatVec) keep the input element order with Morton and Hilbert ordering
+- Dense and H-matrix relaxations with reordered elements give the same field
+- Relaxation sub-intervals are rejected for reordered interactions
+- Invalid curve types are rejected
+"""
+
+import sys
+import os
+import random
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+N_SIDE = 6
+N_ELEM = N_SIDE**3
+
+
+def create_shuffled_cubes():
+	"""Lattice of linear iron cubes added in random order, above a permanent magnet"""
+	rad.UtiDelAll()
+	rad.FldUnits('mm')
+	pos = [[12*i, 12*j, 12*k] for i in range(N_SIDE) for j in range(N_SIDE) for k in range(N_SIDE)]
+	random.Random(7).shuffle(pos)
+	cubes = [rad.ObjRecMag(p, [10, 10, 10], [0, 0, 0]) for p in pos]
+	iron = rad.ObjCnt(cubes)
+	rad.MatApl(iron, rad.MatLin([10, 10], [0, 0, 1e-6]))
+	magnet = rad.ObjRecMag([30, 30, -30], [80, 80, 20], [0, 0, 1.2])
+	return rad.ObjCnt([iron, magnet])
+
+
+def build_interaction(curve):
+	grp = create_shuffled_cubes()
+	rad.SolverElemOrder(curve)
+	try:
+		return rad.RlxPre(grp)
+	finally:
+		rad.SolverElemOrder(0)
+
+
+def solve(curve, use_hmatrix=False):
+	grp = create_shuffled_cubes()
+	rad.SolverElemOrder(curve)
+	if use_hmatrix:
+		rad.SolverHMatrixEnable(1, 1e-6, 50)
+	try:
+		rad.Solve(grp, 0.0001, 1000)
+	finally:
+		rad.SolverElemOrder(0)
+		rad.SolverHMatrixDisable()
+	return grp
+
+
+def field(grp):
+	return [rad.Fld(grp, 'b', p) for p in [[30, 30, 80], [-20, 10, 30], [90, 40, 20]]]
+
+
+def assert_close(ref, res, rel):
+	scale = max(abs(x) for b in ref for x in b)
+	for br, b in zip(ref, res):
+		for r, x in zip(br, b):
+			assert x == pytest.approx(r, abs=rel*scale)
+
+
+class TestRelaxElemOrder:
+	"""Test space-filling-curve ordering of relaxable elements"""
+
+	@pytest.mark.parametrize("curve", [1, 2])
+	def test_matvec_input_order(self, curve):
+		"""N*M in input order is unchanged by the internal order"""
+		m = [[0.1*(i % 5), 0.4 - 0.002*i, 0.7 + 0.01*(i % 3)] for i in range(N_ELEM)]
+		ref = rad.RlxMatVec(build_interaction(0), m)
+		res = rad.RlxMatVec(build_interaction(curve), m)
+		assert len(res) == N_ELEM
+		assert_close(ref, res, 1e-6)
+
+	@pytest.mark.parametrize("curve", [1, 2])
+	def test_solve(self, curve):
+		"""Relaxed field is independent of the element order"""
+		ref = field(solve(0))
+		assert_close(ref, field(solve(curve)), 1e-3)
+
+	def test_solve_hmatrix(self):
+		"""H-matrix relaxation with Hilbert order agrees with the input order"""
+		rad.ClearHMatrixCache()
+		ref = field(solve(0, use_hmatrix=True))
+		rad.ClearHMatrixCache()
+		assert_close(ref, field(solve(2, use_hmatrix=True)), 1e-3)
+
+	def test_sub_interval_rejected(self):
+		"""Sub-intervals refer to input element numbers, which are not contiguous after reordering"""
+		intrc = build_interaction(1)
+		with pytest.raises(RuntimeError):
+			rad.SetRelaxSubInterval(intrc, 0, 7)
+
+	def test_invalid_curve(self):
+		with pytest.raises(RuntimeError):
+			rad.SolverElemOrder(3)
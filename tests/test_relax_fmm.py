@@ -0,0 +1,120 @@
+"""
+Unit tests for the fast multipole method (relaxation operator and batch field evaluation)
+
+Tests that:
+- The FMM relaxation operator reproduces the dense N*M product (blocks, polyhedra, symmetry images)
+- A relaxation with the FMM operator converges to the dense solution
+- FldBatch with use_hmatrix=2 reproduces the direct H and B fields inside and outside the magnets
+"""
+
+import sys
+import os
+import math
+import random
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+N = 6
+
+
+def create_grid(poly=False, sym=False):
+	"""Jittered N^3 grid of linear iron blocks (every other one an extruded pentagon if poly)"""
+	rad.UtiDelAll()
+	rad.FldUnits('mm')
+	blocks = []
+	for i in range(N):
+		for j in range(N):
+			for k in range(N):
+				c = [12*i + 3*(j % 2) + 0.37*math.sin(7*i + 3*j + k), 12*j + 0.41*math.cos(5*i + j + 2*k), 12*k + 1.5*(i % 3) + 0.29*math.sin(i + 11*j + 5*k)]
+				if poly and (i + j + k) % 2 == 0:
+					pgn = [[c[1] - 4, c[2] - 4], [c[1] + 4, c[2] - 4], [c[1] + 5, c[2] + 1], [c[1], c[2] + 4], [c[1] - 5, c[2] + 1]]
+					blocks.append(rad.ObjThckPgn(c[0], 8, pgn, 'x', [0, 0, 0]))
+				else:
+					blocks.append(rad.ObjRecMag(c, [8, 9, 10], [0, 0, 0]))
+	iron = rad.ObjCnt(blocks)
+	rad.MatApl(iron, rad.MatLin([100, 100], [0, 0, 1e-6]))
+	if sym:
+		rad.TrfZerPerp(iron, [0, 0, -5], [0, 0, 1])
+	return iron
+
+
+def create_model(**kw):
+	"""Iron grid with a permanent magnet and a coil"""
+	iron = create_grid(**kw)
+	magnet = rad.ObjRecMag([30, 30, -40], [60, 60, 10], [0, 0, 1.2])
+	coil = rad.ObjRaceTrk([30, 30, 100], [5, 10], [10, 10], 6, 3, 1.0)
+	return rad.ObjCnt([iron, magnet, coil])
+
+
+def rel_err(ref, res):
+	num = sum((a - b)**2 for u, v in zip(ref, res) for a, b in zip(u, v))
+	den = sum(a*a for u in ref for a in u)
+	return math.sqrt(num/den)
+
+
+def fmm_interaction(grp, order=8):
+	rad.SolverFMM(1, order, 0.5, 8)
+	try:
+		return rad.RlxPre(grp)
+	finally:
+		rad.SolverFMM(0)
+
+
+class TestRelaxFMM:
+	"""Test the FMM relaxation operator"""
+
+	@pytest.mark.parametrize("kw", [{}, {"poly": True}, {"sym": True}])
+	def test_matvec_matches_dense(self, kw, capfd):
+		"""Far field by Taylor expansions, near field by the exact element kernels"""
+		m = [[0.3 + 0.01*math.sin(i), -0.2 + 0.003*i, 0.5*math.cos(i)] for i in range(N**3)]
+		ref = rad.RlxMatVec(rad.RlxPre(create_grid(**kw)), m)
+		capfd.readouterr()
+		res = rad.RlxMatVec(fmm_interaction(create_grid(**kw)), m)
+		assert "FMM order = 8" in capfd.readouterr().out
+		assert rel_err(ref, res) < 1e-4
+
+	def test_order_convergence(self):
+		"""The far-field error decreases with the expansion order"""
+		m = [[0.3, -0.2, 0.5]]*(N**3)
+		ref = rad.RlxMatVec(rad.RlxPre(create_grid()), m)
+		e4 = rel_err(ref, rad.RlxMatVec(fmm_interaction(create_grid(), 4), m))
+		e10 = rel_err(ref, rad.RlxMatVec(fmm_interaction(create_grid(), 10), m))
+		assert e10 < 0.1*e4
+
+	def test_solve_matches_dense(self):
+		"""Relaxation with the FMM operator converges to the dense magnetization"""
+		grp = create_model()
+		rad.Solve(grp, 1e-8, 1000, 9)
+		ref = rad.FldBatch(grp, 'b', [[30, 30, 20], [-20, 10, 30]], 0)
+		grp = create_model()
+		rad.SolverFMM(1)
+		try:
+			rad.Solve(grp, 1e-8, 1000, 9)
+		finally:
+			rad.SolverFMM(0)
+		res = rad.FldBatch(grp, 'b', [[30, 30, 20], [-20, 10, 30]], 0)
+		assert rel_err(ref, res) < 1e-5
+
+	def test_invalid_parameters(self):
+		with pytest.raises(RuntimeError):
+			rad.SolverFMM(1, 0)
+		with pytest.raises(RuntimeError):
+			rad.SolverFMM(1, 8, 1.5)
+
+
+class TestFldBatchFMM:
+	"""Test FMM batch field evaluation"""
+
+	@pytest.mark.parametrize("kw", [{}, {"poly": True}, {"sym": True}])
+	@pytest.mark.parametrize("field", ['h', 'b'])
+	def test_field_matches_direct(self, kw, field):
+		"""Magnetized elements by the FMM, the magnet block and the coil directly"""
+		grp = create_model(**kw)
+		rad.Solve(grp, 1e-8, 1000, 9)
+		rng = random.Random(1)
+		pts = [[rng.uniform(-50, 150), rng.uniform(-50, 150), rng.uniform(-60, 150)] for _ in range(1500)]
+		ref = rad.FldBatch(grp, field, pts, 0)
+		res = rad.FldBatch(grp, field, pts, 2)
+		assert rel_err(ref, res) < 1e-4
@@ -0,0 +1,83 @@
+"""
+Unit tests for relaxation method 9 (H-LU factorized secant/Newton iteration)
+
+Tests:
+- Agreement with the default relaxation method for linear and nonlinear materials
+- Convergence of linear problems in a few iterations
+- Same solution with H-matrix acceleration of the interaction matrix
+- Argument checks of SolverHLU()
+"""
+
+import sys
+import os
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+
+def solve_and_sample(grp, meth):
+	res = rad.Solve(grp, 1e-6, 1000, meth)
+	return res, rad.Fld(grp, 'b', [0, 0, 15])
+
+
+class TestRelaxHLU:
+	"""Method 9 against the default relaxation method"""
+
+	def setup_method(self):
+		rad.SolverHLU(1e-6, 50)
+
+	def teardown_method(self):
+		rad.SolverHLU()
+
+	def test_linear_material(self, create_iron_with_magnet):
+		"""Linear material: solved in a few iterations"""
+		mat = lambda: rad.MatLin([999, 999], [0, 0, 1])
+		grp = create_iron_with_magnet(mat, (4, 4, 3))
+		res4, b4 = solve_and_sample(grp, 4)
+		grp = create_iron_with_magnet(mat, (4, 4, 3))
+		res9, b9 = solve_and_sample(grp, 9)
+
+		assert res9[3] <= 3
+		assert res9[1] == pytest.approx(res4[1], rel=1e-4)
+		assert b9[2] == pytest.approx(b4[2], rel=1e-4)
+
+	def test_nonlinear_material(self, create_iron_with_magnet):
+		"""Saturable iron: same solution as method 4"""
+		mat = lambda: rad.MatSatIsoFrm([20000, 2], [0.1, 2], [0.1, 2])
+		grp = create_iron_with_magnet(mat, (4, 4, 3))
+		res4, b4 = solve_and_sample(grp, 4)
+		grp = create_iron_with_magnet(mat, (4, 4, 3))
+		res9, b9 = solve_and_sample(grp, 9)
+
+		assert res9[0] < 1e-6
+		assert res9[3] < res4[3]
+		assert res9[1] == pytest.approx(res4[1], rel=1e-4)
+		assert b9[2] == pytest.approx(b4[2], rel=1e-4)
+
+	def test_hmatrix_interaction(self, create_iron_with_magnet):
+		"""H-matrix interaction matrix: same solution as the dense one"""
+		mat = lambda: rad.MatSatIsoFrm([20000, 2], [0.1, 2], [0.1, 2])
+		grp = create_iron_with_magnet(mat, (6, 6, 4))
+		res_dense, b_dense = solve_and_sample(grp, 9)
+
+		rad.SolverHMatrixEnable(1, 1e-6, 30)
+		try:
+			grp = create_iron_with_magnet(mat, (6, 6, 4))
+			res_hmat, b_hmat = solve_and_sample(grp, 9)
+		finally:
+			rad.SolverHMatrixDisable()
+
+		assert res_hmat[0] < 1e-6
+		assert b_hmat[2] == pytest.approx(b_dense[2], rel=1e-4)
+
+	def test_invalid_arguments(self):
+		"""Non-positive accuracy or negative rank is rejected"""
+		with pytest.raises(RuntimeError):
+			rad.SolverHLU(0.0)
+		with pytest.raises(RuntimeError):
+			rad.SolverHLU(1e-4, -1)
+
+
+if __name__ == "__main__":
+	pytest.main([__file__, "-v"])
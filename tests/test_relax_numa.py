@@ -0,0 +1,81 @@
+"""
+Unit tests for the NUMA placement of the relaxation interaction storage
+
+Tests that:
+- First-touch placement does not change the relaxation result (dense and H-matrix)
+- Thread binding restricts the OpenMP threads to single CPUs and can be released
+- Invalid settings are rejected
+"""
+
+import sys
+import os
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+
+def create_cube():
+	"""Subdivided linear iron cube on a permanent magnet (512 elements)"""
+	rad.UtiDelAll()
+	rad.FldUnits('mm')
+	cube = rad.ObjRecMag([0, 0, 0], [40, 40, 40], [0, 0, 0])
+	rad.ObjDivMag(cube, [8, 8, 8])
+	rad.MatApl(cube, rad.MatLin([1000, 1000], [0, 0, 1e-6]))
+	magnet = rad.ObjRecMag([0, 0, -40], [40, 40, 20], [0, 0, 1.2])
+	return rad.ObjCnt([cube, magnet])
+
+
+def solve_field(first_touch, bind=0, hmatrix=False):
+	rad.SolverNUMA(first_touch, bind)
+	grp = create_cube()
+	if hmatrix:
+		rad.SolverHMatrixEnable(1, 1e-6, 50)
+	try:
+		rad.Solve(grp, 0.0001, 1000)
+	finally:
+		if hmatrix:
+			rad.SolverHMatrixDisable()
+		rad.SolverNUMA()
+	return [rad.Fld(grp, 'b', p) for p in ([0, 0, 30], [10, 5, 40], [35, 0, 0])]
+
+
+class TestRelaxNUMA:
+	"""Test NUMA placement and thread binding of the relaxation"""
+
+	@pytest.mark.parametrize("hmatrix", [False, True])
+	def test_first_touch_same_result(self, hmatrix):
+		"""First-touch placement gives the same field as serial allocation (within the relaxation precision)"""
+		rad.ClearHMatrixCache()
+		ref = solve_field(0, hmatrix=hmatrix)
+		rad.ClearHMatrixCache()
+		res = solve_field(1, hmatrix=hmatrix)
+		scale = max(abs(x) for b in ref for x in b)
+		for br, b in zip(ref, res):
+			for r, x in zip(br, b):
+				assert x == pytest.approx(r, abs=1e-3*scale)
+
+	@pytest.mark.skipif(not hasattr(os, "sched_getaffinity"), reason="thread binding is Linux only")
+	def test_bind_and_release(self):
+		"""Binding pins the calling thread to one CPU, bind=0 restores the affinity"""
+		initial = os.sched_getaffinity(0)
+
+		rad.SolverNUMA(1, 1)
+		rad.Solve(create_cube(), 0.0001, 1000)
+		assert len(os.sched_getaffinity(0)) == 1
+		assert os.sched_getaffinity(0) <= initial
+
+		rad.SolverNUMA(1, 0)
+		rad.Solve(create_cube(), 0.0001, 1000)
+		assert os.sched_getaffinity(0) == initial
+
+	def test_invalid_bind(self):
+		"""Only bind modes 0, 1, 2 are accepted"""
+		with pytest.raises(RuntimeError):
+			rad.SolverNUMA(1, 3)
+		with pytest.raises(RuntimeError):
+			rad.SolverNUMA(1, -1)
+
+
+if __name__ == "__main__":
+	pytest.main([__file__, "-v"])
@@ -0,0 +1,92 @@
+"""
+Unit tests for relaxation telemetry and monitor callback
+
+Tests per-iteration telemetry of automatic relaxation:
+- RlxTelemetry() records after Solve()
+- RlxMonitor() callback invocation
+- Early termination requested by the callback
+- Propagation of exceptions raised in the callback
+"""
+
+import sys
+import os
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+
+class TestRelaxTelemetry:
+	"""Test per-iteration telemetry records"""
+
+	def test_telemetry_after_solve(self, create_iron_with_magnet):
+		"""Each iteration of Solve() produces one record"""
+		rad.RlxMonitor(None)
+		grp = create_iron_with_magnet()
+		res = rad.Solve(grp, 0.0001, 1000)
+
+		records = rad.RlxTelemetry()
+		assert len(records) > 0
+		assert [r['iter'] for r in records] == list(range(1, len(records) + 1))
+
+		for r in records:
+			assert r['elements'] == 18
+			assert 0 <= r['changed'] <= r['elements']
+			assert r['sweep_time'] >= 0.0
+			assert 0.0 <= r['matvec_time'] <= r['sweep_time']
+
+		# Last record corresponds to the final misfit returned by Solve()
+		assert records[-1]['misfit'] == pytest.approx(res[0], rel=1e-6, abs=1e-12)
+		assert records[-1]['misfit'] < 0.0001
+
+	def test_monitor_receives_all_iterations(self, create_iron_with_magnet):
+		"""Monitor callback is called once per recorded iteration"""
+		seen = []
+
+		def monitor(info):
+			seen.append(info['iter'])
+			return False
+
+		rad.RlxMonitor(monitor)
+		try:
+			grp = create_iron_with_magnet()
+			rad.Solve(grp, 0.0001, 1000)
+		finally:
+			rad.RlxMonitor(None)
+
+		assert seen == [r['iter'] for r in rad.RlxTelemetry()]
+
+	def test_monitor_early_termination(self, create_iron_with_magnet):
+		"""Returning True from the monitor stops the relaxation"""
+		rad.RlxMonitor(lambda info: info['iter'] >= 2)
+		try:
+			grp = create_iron_with_magnet()
+			rad.Solve(grp, 1e-12, 1000)
+		finally:
+			rad.RlxMonitor(None)
+
+		assert len(rad.RlxTelemetry()) == 2
+
+	def test_monitor_exception_propagates(self, create_iron_with_magnet):
+		"""Exception raised in the monitor stops the relaxation and is re-raised"""
+		def monitor(info):
+			raise ValueError("stop")
+
+		rad.RlxMonitor(monitor)
+		try:
+			grp = create_iron_with_magnet()
+			with pytest.raises(ValueError):
+				rad.Solve(grp, 0.0001, 1000)
+		finally:
+			rad.RlxMonitor(None)
+
+		assert len(rad.RlxTelemetry()) == 1
+
+	def test_monitor_requires_callable(self):
+		"""Non-callable argument is rejected"""
+		with pytest.raises(RuntimeError):
+			rad.RlxMonitor(1)
+
+
+if __name__ == "__main__":
+	pytest.main([__file__, "-v"])
@@ -13,6 +13,8 @@ int main() {
     std::cout << "radTField: " << sizeof(radTField) << " bytes" << std::endl;
     std::cout << "radTFieldKey: " << sizeof(radTFieldKey) << " bytes" << std::endl;
     std::cout << "radTCompCriterium: " << sizeof(radTCompCriterium) << " bytes" << std::endl;
+    std::cout << "radTFieldB (lean): " << sizeof(radTFieldB) << " bytes" << std::endl;
+    std::cout << "radTFieldBH (lean): " << sizeof(radTFieldBH) << " bytes" << std::endl;
 
     std::cout << std::endl;
     std::cout << "radTField members:" << std::endl;
@@ -0,0 +1,95 @@
+"""
+Unit tests for the cost-model choice of the relaxation interaction backend
+
+Tests that:
+- A tight memory budget selects a compressed (H-matrix / H2-matrix) backend within the budget
+- A small model with an ample budget is solved with the dense matrix, as without the planner
+- The estimates of the last choice are returned by SolverPlan
+- Invalid arguments are rejected
+"""
+
+import sys
+import os
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "../build/Release"))
+
+import pytest
+import radia as rad
+
+
+def create_cube(ndiv):
+	"""Subdivided linear iron cube on a permanent magnet"""
+	rad.UtiDelAll()
+	rad.FldUnits('mm')
+	cube = rad.ObjRecMag([0, 0, 0], [40, 40, 40], [0, 0, 0])
+	rad.ObjDivMag(cube, [ndiv, ndiv, ndiv])
+	rad.MatApl(cube, rad.MatLin([10, 10], [0, 0, 1e-6]))
+	magnet = rad.ObjRecMag([0, 0, -40], [40, 40, 20], [0, 0, 1.2])
+	return rad.ObjCnt([cube, magnet])
+
+
+def create_row(n):
+	"""Row of n separated linear iron cubes (8 elements each) above a permanent magnet"""
+	rad.UtiDelAll()
+	rad.FldUnits('mm')
+	cubes = []
+	for i in range(n):
+		cube = rad.ObjRecMag([30*i, 0, 0], [10, 10, 10], [0, 0, 0])
+		rad.ObjDivMag(cube, [2, 2, 2])
+		cubes.append(cube)
+	iron = rad.ObjCnt(cubes)
+	rad.MatApl(iron, rad.MatLin([10, 10], [0, 0, 1e-6]))
+	magnet = rad.ObjRecMag([15*(n - 1), 0, -20], [30*n, 10, 10], [0, 0, 1.2])
+	return rad.ObjCnt([iron, magnet])
+
+
+def solve(grp, **auto):
+	if auto: rad.SolverAuto(**auto)
+	try:
+		rad.Solve(grp, 0.0001, 1000)
+	finally:
+		rad.SolverAuto(0)
+	return grp
+
+
+class TestSolverPlanner:
+	"""Test automatic choice of the interaction backend"""
+
+	def test_memory_budget(self, capfd):
+		"""Dense storage (5.8 MB) exceeds the budget: a compressed backend within the budget is chosen"""
+		rad.ClearHMatrixCache()
+		solve(create_row(50), memory_mb=2, iterations=100)
+		out = capfd.readouterr().out
+		plan = rad.SolverPlan()
+
+		assert "[Planner] Selected" in out
+		assert plan['backend'] in ('hmatrix', 'h2')
+		assert plan['memory'][0] == pytest.approx(400**2*9*4)
+		assert plan['memory_budget'] == 2*1024*1024
+		b = ('dense', 'hmatrix', 'h2').index(plan['backend'])
+		assert plan['memory'][b] <= plan['memory_budget']
+		assert plan['memory'][1] < plan['memory'][0]
+		assert plan['kernel_time'] > 0 and plan['stream_rate'] > 0 and plan['build_time'][1] > 0
+
+	def test_small_model_dense(self, capfd):
+		"""Few elements: the dense matrix is cheapest and the solution equals the plain dense one"""
+		pts = [[0, 0, 30], [10, 5, 40], [35, 0, 0]]
+		ref = [rad.Fld(solve(create_cube(3)), 'b', p) for p in pts]
+		capfd.readouterr()
+		res = [rad.Fld(solve(create_cube(3), memory_mb=1024, iterations=10), 'b', p) for p in pts]
+		out = capfd.readouterr().out
+		plan = rad.SolverPlan()
+
+		assert "[Planner] Selected dense" in out
+		assert plan['backend'] == 'dense'
+		assert plan['iterations'] == 10
+		scale = max(abs(x) for b in ref for x in b)
+		for br, b in zip(ref, res):
+			for r, x in zip(br, b):
+				assert x == pytest.approx(r, abs=1e-3*scale)
+
+	def test_invalid_arguments(self):
+		"""Negative budget and non-positive iteration count are rejected"""
+		with pytest.raises(RuntimeError):
+			rad.SolverAuto(1, memory_mb=-1)
+		with pytest.raises(RuntimeError):
+			rad.SolverAuto(1, iterations=0)
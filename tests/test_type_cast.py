@@ -5,6 +5,7 @@ Tests radTCast functionality:
 - InteractCast: Cast to radTInteraction
 - g3dCast: Cast to radTg3d
 - GroupCast: Cast to radTGroup
+- Casts of subdivided elements, materials and interactions (compared by static type IDs)
 """
 
 import sys
@@ -123,6 +124,41 @@ class TestTypeCasting:
 		assert not np.allclose(H, [0, 0, 0])
 
 
+class TestTypeIdentification:
+	"""Test objects identified by the static type IDs of their classes"""
+
+	@pytest.mark.parametrize("mat", ['lin_iso', 'lin_aniso', 'nonlin_iso'])
+	def test_subdivided_elements_relax(self, mat):
+		"""Subdivided blocks, extruded polygons and polyhedra are relaxed as their pieces"""
+		rad.UtiDelAll()
+		rec = rad.ObjRecMag([0, 0, 0], [10, 10, 10], [0, 0, 0])
+		pgn = rad.ObjThckPgn(20, 10, [[0, 0], [10, 0], [10, 10], [0, 10]], 'z', [0, 0, 0])
+		pol = rad.ObjPolyhdr([[-20, 0, 0], [-10, 0, 0], [-20, 10, 0], [-20, 0, 10]], [[1, 3, 2], [1, 2, 4], [1, 4, 3], [2, 3, 4]], [0, 0, 0])
+		for obj in (rec, pgn, pol):
+			rad.ObjDivMag(obj, [2, 2, 2])
+		grp = rad.ObjCnt([rec, pgn, pol])
+		if mat == 'lin_iso':
+			m = rad.MatLin(100)
+		elif mat == 'lin_aniso':
+			m = rad.MatLin([100, 10], [0, 0, 1])
+		else:
+			m = rad.MatSatIsoFrm([2000, 2], [0.1, 2], [0.1, 2])
+		rad.MatApl(grp, m)
+		rlx = rad.RlxPre(rad.ObjCnt([grp, rad.ObjBckg([0, 0, 0.5])]))
+		rad.RlxAuto(rlx, 1e-6, 1000)
+		for obj in (rec, pgn, pol):
+			mz = [mm[2] for p, mm in rad.ObjM(obj)]
+			assert len(mz) > 1
+			assert min(mz) > 0.01
+
+	def test_interaction_required(self):
+		"""Relaxation of an object that is not an interaction fails with an error"""
+		rad.UtiDelAll()
+		mag = rad.ObjRecMag([0, 0, 0], [10, 10, 10], [0, 0, 1])
+		with pytest.raises(Exception):
+			rad.RlxAuto(mag, 1e-4, 10)
+
+
 class TestInvalidCasting:
 	"""Test error handling for invalid casting"""
 